@@ -19,6 +19,9 @@
  */
 
 /*========== Includes ==========*/
+#if defined __linux__
+#define _GNU_SOURCE /*** for copy_file_range() ***/
+#endif
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -33,14 +36,28 @@
 #include <math.h>
 #if defined WIN32 || _WIN32 || WIN64 || _WIN64
 #include <windows.h>
+#include <io.h>
 #undef PlaySound
 #endif
+#if defined __linux__
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+#if defined __GLIBC__ && \
+	((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 27)))
+#define COPY_FILE_RANGE
+#endif
 
 #include <SDL.h>
 #include <SDL_audio.h>
 #include <SDL_thread.h>
 #include <SDL_ttf.h>
 #include <SDL_image.h>
+#if defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+#define RUNS_X86
+#include <immintrin.h>
+#endif
 /*========== Includes ==========*/
 
 /*========== Defines ==========*/
@@ -58,21 +75,71 @@
 #define EDITOR_VERSION "v1.0 (December 2022)"
 #define COPYRIGHT "Copyright (C) 2022 Norbert de Jonge"
 #define OFFSET_LEVEL0 0x1DCC4 /*** various ***/
+#define OFFSET_TABLE 0x1DC2C /*** Level start offsets. ***/
+#define OFFSET_BANK 0x18000 /*** The table offsets are relative to this. ***/
 #define MAX_LEVEL_SIZE 20000
+#define BENCH_RUNS 1000
+#define BENCH_INPUTS 1000 /*** Small inputs for the exhaustive search. ***/
+#define EXHAUSTIVE_MAX 10 /*** PlanExhaustive() tries up to 3^10 plans. ***/
 #define LEVELS 17
 #define ROOMS 24
 #define TILES 30
 #define EVENTS 256
 #define ROM_DIR "rom"
-#define BACKUP ROM_DIR SLASH "rom.bak"
+#define BACKUP_PREFIX "rom_" /*** rom_YYYYMMDD_HHMMSS_NN.bak, UTC ***/
+#define BACKUP_SUFFIX ".bak"
+#define BACKUPS 5 /*** Older backups are removed. ***/
+#define BACKUPS_MAX 100
+#define BACKUP_ORIGINAL "original.bak" /*** The ROM before the first save. ***/
+#define PATCH_IPS 1
+#define PATCH_BPS 2
+#define PATCH_AREAS 10
+#define IPS_RECORD 0xFFFF /*** Maximum record size. ***/
+#define IPS_GAP 5 /*** Fewer unchanged bytes are cheaper than a new record. ***/
+#define IPS_RUN 16 /*** Minimum run for an RLE record. ***/
+#define BPS_MATCH 4 /*** Minimum match for a copy action. ***/
 #define MAX_PATHFILE 200
-#define MAX_TOWRITE 720
 #define WINDOW_WIDTH 640 + 2 + 50 /*** 692 ***/
 #define WINDOW_HEIGHT 496 + 2 + 75 /*** 573 ***/
 #define MAX_IMG 200
 #define MAX_CON 30
 #define MAX_TYPE 10
-#define REFRESH 25 /*** That is 40 frames per second, 1000/25. ***/
+#define FLAME_MS 50 /*** That is 20 frames per second, 1000/50. ***/
+#define MAX_FLAMES 64
+#define MAX_CLIPS (MAX_FLAMES + 10)
+#define ROOM_LAYERS 6
+#define ATLAS_SIZE 2048
+#define ATLAS_MAX_AREA (128 * 1024) /*** Larger images are not packed. ***/
+#define MAX_ATLASES 8
+#define MAX_IMGS 1024 /*** LoadImage() calls. ***/
+#define TEXT_CACHE 256
+#define MAX_DRAWS 512
+#define MAX_BLOCKED 64 /*** FlushDraws() reorders no further than this. ***/
+#define TILE_NORMAL 0x00
+#define TILE_HIGH 0x01 /*** the highlighted (selected) image ***/
+#define PROFILE_FILE "profile.csv"
+#define PROFILE_FRAMES 20000 /*** The CSV file has the last this many. ***/
+#define PROFILE_WINDOW 120 /*** frames for the rolling min/avg/p99 ***/
+#define PROFILE_HUD_EVERY 10 /*** frames between overlay updates ***/
+#define PHASE_OTHER 0
+#define PHASE_SCREEN 1
+#define PHASE_CHANGE 2
+#define PHASE_EXE 3
+#define PHASES 4
+#define RECORD_MAGIC "LEGBOPRC"
+#define RECORD_MAGIC_SIZE 8
+#define RECORD_VERSION 1 /*** Increase if struct recordhead changes. ***/
+#define REPLAY_FAST 1
+#define REPLAY_REAL 2
+#define SHOT_MAIN 1
+#define SHOT_LINKS 2
+#define SHOT_EVENTS 3
+#define SHOT_TILES 4
+#define SHOT_EXE 5
+#define DRAW_ALL 0
+#define DRAW_LAYER 1 /*** into a room layer, without sprites ***/
+#define DRAW_RECORD 2 /*** only add the sprites to arClip ***/
+#define DRAW_CLIP 3 /*** only draw onto arClip ***/
 #define FONT_SIZE_15 15
 #define FONT_SIZE_11 11
 #define FONT_SIZE_20 20
@@ -84,10 +151,25 @@
 #define BYTE_SIZE 255
 #define UNKNOWN 145
 #define SAVE_SPACE 4
+#define RUNS_SCALAR 0
+#define RUNS_SSE2 1
+#define RUNS_AVX2 2
 #define WARN_BYTES_FREE 100
 #define MAX_WARNING 200
 #define MAX_ERROR 200
-#define MAX_INFO 200
+#define MAX_LINE 400
+#define MAX_TOKENS TILES + 5
+#define MAX_EXPORT 250000 /*** The text of all levels; about 180 KB at most. ***/
+#define MAX_RESULT 450 /*** "[FAILED] ", a path, ": " and an error. ***/
+#define SNAPSHOT_MAGIC "LEGBOPSN"
+#define SNAPSHOT_MAGIC_SIZE 8
+#define SNAPSHOT_VERSION 3 /*** Increase if struct snapshot changes. ***/
+#define SNAPSHOT_ORDER 0x01020304
+#define SNAPSHOT_EXE_AREAS 9 /*** The arPatchAreas before the levels. ***/
+#define SNAPSHOT_EXE 188 /*** Their bytes. ***/
+#define MAX_JOBS 256
+#define UNDO_BUDGET 256 /*** in KiB ***/
+#define UNDO_COALESCE 1000 /*** in ms ***/
 
 /*** Intro slides. ***/
 #define SLIDES 5
@@ -151,6 +233,7 @@
 #define OFFSET_TRAINING 0x664
 #define OFFSET_START 0x2E3
 #define OFFSET_REDORB 0x23E
+#define EVENT_GAME_DONE 1 /*** SDL_USEREVENT code; Mednafen quit ***/
 
 #ifndef O_BINARY
 #define O_BINARY 0
@@ -158,11 +241,12 @@
 /*========== Defines ==========*/
 
 int iDebug;
-unsigned char arLevel[MAX_LEVEL_SIZE + 2];
-unsigned char arLevelOut[MAX_LEVEL_SIZE + 2];
-int iLevelSize;
-int iLevelRead;
-char sPathFile[MAX_PATHFILE + 2];
+int iHeadless;
+int iROMMapped;
+int iROMMode;
+int iROMChanged;
+unsigned long long llBackupHash;
+int iBackupHashKnown;
 int iChanged;
 int iScreen;
 TTF_Font *font1;
@@ -170,6 +254,8 @@ TTF_Font *font2;
 TTF_Font *font3;
 SDL_Window *window;
 SDL_Renderer *ascreen;
+SDL_Surface *surfoffscreen; /*** what ascreen draws into, for --offscreen ***/
+SDL_Texture *imgscene; /*** ShowScreen() draws here; NULL if unsupported ***/
 int iScale;
 int iFullscreen;
 SDL_Cursor *curArrow;
@@ -194,8 +280,6 @@ int iLastTile;
 int iXPos, iYPos;
 int iInfo;
 int arMovingRooms[ROOMS + 1 + 2][ROOMS + 2];
-unsigned int gamespeed;
-Uint32 looptime;
 char cCurType;
 int arDone[ROOMS + 2];
 int iStartRoomsX, iStartRoomsY;
@@ -212,18 +296,23 @@ int iYesOn;
 int iNoOn;
 int iCopied;
 int iStartLevel;
-int iOutOffset;
-int iRepeatOffset;
-int iHighStore;
-unsigned char sUnknown[UNKNOWN + 2];
 int iCustomTile;
 int iEventTooltip, iEventTooltipOld;
 int iCustomHover, iCustomHoverOld;
 int iMednafen;
-char sInfo[MAX_INFO + 2];
 int iNoAnim;
 int iFlameFrame;
+/*** the torches drawn by the last full ShowScreen() ***/
+SDL_Rect arFlames[MAX_FLAMES + 2];
+int iFlames;
+SDL_Rect arClip[MAX_CLIPS + 2];
+int iClips;
+int iDrawMode;
+int iSprite;
+int iLayerClock;
 int iModified;
+int iShareLevels;
+int iRunsSIMD;
 
 /*** EXE ***/
 int iEXEMinutesLeft;
@@ -243,9 +332,42 @@ SDL_Color color_bl = {0x00, 0x00, 0x00, 255};
 SDL_Color color_wh = {0xff, 0xff, 0xff, 255};
 SDL_Color color_blue = {0x00, 0x00, 0xff, 255};
 SDL_Color color_red = {0xff, 0x00, 0x00, 255};
-SDL_Surface *message;
 SDL_Texture *messaget;
 SDL_Rect offset;
+struct text {
+	TTF_Font *font; /*** NULL if unused ***/
+	int iBlended;
+	Uint32 iFore, iBack;
+	unsigned long long llHash;
+	char sText[MAX_TEXT + 2];
+	SDL_Texture *img;
+	int iWidth, iHeight;
+	Uint32 iUsed;
+} arTexts[TEXT_CACHE + 2];
+Uint32 iTextClock;
+
+/*** for patches; what SaveLevels and EXESave write: offset, size ***/
+int arPatchAreas[PATCH_AREAS][2] = {
+	{ 0x191, 1 }, { 0x80D, 1 },
+	{ 0xB1A2, 6 }, { 0xB1E2, 6 }, { 0xB222, 6 },
+	{ 0xB262, 6 }, { 0xB2A2, 6 }, { 0xB2E2, 6 },
+	{ SLIDES_OFFSET, SLIDES_BYTES },
+	{ OFFSET_TABLE, 0x1FFFF - OFFSET_TABLE }
+};
+
+/*** for batches ***/
+char **arBatchPaths;
+int iBatchROMs;
+char (*arBatchResults)[MAX_RESULT + 2];
+int *arBatchOK;
+SDL_atomic_t atNextROM;
+
+/*** for undo; stUndoCur is the last step done, or NULL ***/
+struct undostep *stUndoOldest;
+struct undostep *stUndoCur;
+int iUndoOpen;
+int iUndoBytes;
+int iUndoBudget;
 
 /*** for copying ***/
 unsigned char arCopyPasteTile[TILES + 2];
@@ -262,110 +384,124 @@ Uint32 joyleft, joyright, joyup, joydown;
 Uint32 trigleft, trigright;
 int iXJoy1, iYJoy1, iXJoy2, iYJoy2;
 
-/*** These are the levels. ***/
-unsigned char arRoomTiles[LEVELS + 2][ROOMS + 2][TILES + 2];
-unsigned char arRoomLinks[LEVELS + 2][ROOMS + 2][4 + 2];
-unsigned char arStartLocation[LEVELS + 2][3 + 2];
-unsigned char arGuardTile[LEVELS + 2][ROOMS + 2];
-unsigned char arGuardDir[LEVELS + 2][ROOMS + 2];
-unsigned char arEventsFromRoom[LEVELS + 2][EVENTS + 2];
-unsigned char arEventsFromTile[LEVELS + 2][EVENTS + 2];
-unsigned char arEventsOpenClose[LEVELS + 2][EVENTS + 2];
-unsigned char arEventsToRoom[LEVELS + 2][EVENTS + 2];
-unsigned char arEventsToTile[LEVELS + 2][EVENTS + 2];
-int arNrEvents[LEVELS + 2];
+/*** These are the levels; each level is one block of memory. ***/
+struct level {
+	unsigned char arRoomTiles[ROOMS + 2][TILES + 2];
+	unsigned char arRoomLinks[ROOMS + 2][4 + 2];
+	unsigned char arStartLocation[3 + 2];
+	unsigned char arGuardTile[ROOMS + 2];
+	unsigned char arGuardDir[ROOMS + 2];
+	unsigned char arEventsFromRoom[EVENTS + 2];
+	unsigned char arEventsFromTile[EVENTS + 2];
+	unsigned char arEventsOpenClose[EVENTS + 2];
+	unsigned char arEventsToRoom[EVENTS + 2];
+	unsigned char arEventsToTile[EVENTS + 2];
+	int iNrEvents;
+};
+struct rom {
+	struct level arLevel[LEVELS + 2];
+	unsigned char sUnknown[UNKNOWN + 2]; /*** stored before level 16 ***/
+};
 
 int iDX, iDY, iTTP1, iTTPO;
 int iHor[10 + 2];
 int iVer0, iVer1, iVer2, iVer3, iVer4;
 
-SDL_Texture *imgloading;
-SDL_Texture *imgd[0xFF + 2][2 + 2];
-SDL_Texture *imgp[0xFF + 2][2 + 2];
-SDL_Texture *imgblack;
-SDL_Texture *imgprincel[2 + 2], *imgprincer[2 + 2];
-SDL_Texture *imgguardl[2 + 2], *imgguardr[2 + 2];
-SDL_Texture *imgskeletonl[2 + 2], *imgskeletonr[2 + 2];
-SDL_Texture *imgshadowl[2 + 2], *imgshadowr[2 + 2];
-SDL_Texture *imgjaffarl[2 + 2], *imgjaffarr[2 + 2];
-SDL_Texture *imgdisabled;
-SDL_Texture *imgunk[2 + 2];
-SDL_Texture *imgup_0;
-SDL_Texture *imgup_1;
-SDL_Texture *imgdown_0;
-SDL_Texture *imgdown_1;
-SDL_Texture *imgleft_0;
-SDL_Texture *imgleft_1;
-SDL_Texture *imgright_0;
-SDL_Texture *imgright_1;
-SDL_Texture *imgudno;
-SDL_Texture *imglrno;
-SDL_Texture *imgudnonfo;
-SDL_Texture *imgprevon_0;
-SDL_Texture *imgprevon_1;
-SDL_Texture *imgnexton_0;
-SDL_Texture *imgnexton_1;
-SDL_Texture *imgprevoff;
-SDL_Texture *imgnextoff;
-SDL_Texture *imgbar;
-SDL_Texture *imgextras[10 + 2];
-SDL_Texture *imgroomson_0;
-SDL_Texture *imgroomson_1;
-SDL_Texture *imgroomsoff;
-SDL_Texture *imgbroomson_0;
-SDL_Texture *imgbroomson_1;
-SDL_Texture *imgbroomsoff;
-SDL_Texture *imgeventson_0;
-SDL_Texture *imgeventson_1;
-SDL_Texture *imgeventsoff;
-SDL_Texture *imgsaveon_0;
-SDL_Texture *imgsaveon_1;
-SDL_Texture *imgsaveoff;
-SDL_Texture *imgquit_0;
-SDL_Texture *imgquit_1;
-SDL_Texture *imgrl;
-SDL_Texture *imgbrl;
-SDL_Texture *imgsrc;
-SDL_Texture *imgsrs;
-SDL_Texture *imgsrm;
-SDL_Texture *imgsrp;
-SDL_Texture *imgsrb;
-SDL_Texture *imgevents;
-SDL_Texture *imgsele;
-SDL_Texture *imgeventu;
-SDL_Texture *imgsell;
-SDL_Texture *imgdungeon;
-SDL_Texture *imgpalace;
-SDL_Texture *imgclosebig_0;
-SDL_Texture *imgclosebig_1;
-SDL_Texture *imgborderb;
-SDL_Texture *imgborders;
-SDL_Texture *imgbordersl;
-SDL_Texture *imgborderbl;
-SDL_Texture *imgfadedl;
-SDL_Texture *imgpopup;
-SDL_Texture *imgok[2 + 2];
-SDL_Texture *imgsave[2 + 2];
-SDL_Texture *imgpopup_yn;
-SDL_Texture *imgyes[2 + 2];
-SDL_Texture *imgno[2 + 2];
-SDL_Texture *imghelp;
-SDL_Texture *imgexe;
-SDL_Texture *imgexewarning;
-SDL_Texture *imgfadeds;
-SDL_Texture *imgroom[25 + 2]; /*** 25 is "?", for all high room links ***/
-SDL_Texture *imgetooltip;
-SDL_Texture *imgchover;
-SDL_Texture *imgmednafen;
-SDL_Texture *imglinkwarnlr;
-SDL_Texture *imglinkwarnud;
-SDL_Texture *imgspriteflamed;
-SDL_Texture *imgspriteflamep;
-SDL_Texture *imgalphabet[26 + 2];
-SDL_Texture *imgspace;
-SDL_Texture *imgunknown;
-SDL_Texture *imgseltextline;
-SDL_Texture *imgvwarning;
+/*** An image from png/; a part of an atlas, or a texture of its own. ***/
+struct img {
+	SDL_Texture *tex; /*** the atlas, once CreateAtlases() ran ***/
+	SDL_Rect src;
+	int iAtlas; /*** 0 if the texture is its own ***/
+} arImgs[MAX_IMGS + 2];
+int iImgs;
+
+struct img *imgloading;
+struct img *imgd[0xFF + 2][2 + 2];
+struct img *imgp[0xFF + 2][2 + 2];
+struct img *imgblack;
+struct img *imgprincel[2 + 2], *imgprincer[2 + 2];
+struct img *imgguardl[2 + 2], *imgguardr[2 + 2];
+struct img *imgskeletonl[2 + 2], *imgskeletonr[2 + 2];
+struct img *imgshadowl[2 + 2], *imgshadowr[2 + 2];
+struct img *imgjaffarl[2 + 2], *imgjaffarr[2 + 2];
+struct img *imgdisabled;
+struct img *imgunk[2 + 2];
+struct img *imgup_0;
+struct img *imgup_1;
+struct img *imgdown_0;
+struct img *imgdown_1;
+struct img *imgleft_0;
+struct img *imgleft_1;
+struct img *imgright_0;
+struct img *imgright_1;
+struct img *imgudno;
+struct img *imglrno;
+struct img *imgudnonfo;
+struct img *imgprevon_0;
+struct img *imgprevon_1;
+struct img *imgnexton_0;
+struct img *imgnexton_1;
+struct img *imgprevoff;
+struct img *imgnextoff;
+struct img *imgbar;
+struct img *imgextras[10 + 2];
+struct img *imgroomson_0;
+struct img *imgroomson_1;
+struct img *imgroomsoff;
+struct img *imgbroomson_0;
+struct img *imgbroomson_1;
+struct img *imgbroomsoff;
+struct img *imgeventson_0;
+struct img *imgeventson_1;
+struct img *imgeventsoff;
+struct img *imgsaveon_0;
+struct img *imgsaveon_1;
+struct img *imgsaveoff;
+struct img *imgquit_0;
+struct img *imgquit_1;
+struct img *imgrl;
+struct img *imgbrl;
+struct img *imgsrc;
+struct img *imgsrs;
+struct img *imgsrm;
+struct img *imgsrp;
+struct img *imgsrb;
+struct img *imgevents;
+struct img *imgsele;
+struct img *imgeventu;
+struct img *imgsell;
+struct img *imgdungeon;
+struct img *imgpalace;
+struct img *imgclosebig_0;
+struct img *imgclosebig_1;
+struct img *imgborderb;
+struct img *imgborders;
+struct img *imgbordersl;
+struct img *imgborderbl;
+struct img *imgfadedl;
+struct img *imgpopup;
+struct img *imgok[2 + 2];
+struct img *imgsave[2 + 2];
+struct img *imgpopup_yn;
+struct img *imgyes[2 + 2];
+struct img *imgno[2 + 2];
+struct img *imghelp;
+struct img *imgexe;
+struct img *imgexewarning;
+struct img *imgfadeds;
+struct img *imgroom[25 + 2]; /*** 25 is "?", for all high room links ***/
+struct img *imgetooltip;
+struct img *imgchover;
+struct img *imgmednafen;
+struct img *imglinkwarnlr;
+struct img *imglinkwarnud;
+struct img *imgspriteflamed;
+struct img *imgspriteflamep;
+struct img *imgalphabet[26 + 2];
+struct img *imgspace;
+struct img *imgunknown;
+struct img *imgseltextline;
+struct img *imgvwarning;
 
 struct sample {
 	Uint8 *data;
@@ -373,18 +509,222 @@ struct sample {
 	Uint32 dlen;
 } sounds[NUM_SOUNDS];
 
+/*** Images packed into atlases; see LoadImage(). ***/
+SDL_Surface *arAtlasSurfaces[MAX_ATLASES + 2];
+SDL_Texture *arAtlases[MAX_ATLASES + 2];
+int iAtlases;
+int iShelfX, iShelfY, iShelfH;
+int iNoAtlas;
+
+/* The copies of a frame, in the order they were requested. FlushDraws()
+ * submits them grouped by texture; sImageInfo is a string literal.
+ */
+struct draw {
+	SDL_Texture *img;
+	SDL_Rect src;
+	int iPart; /*** 0 = the entire texture, for text ***/
+	SDL_Rect dest;
+	char *sImageInfo;
+	int iDone;
+} arDraws[MAX_DRAWS + 2];
+int iDraws;
+
+/*** for --profile and the overlay (F3) ***/
+struct frame {
+	Uint32 arPhaseUs[PHASES]; /*** drawing, until SDL_RenderPresent() ***/
+	Uint32 iPresentUs;
+	int iCopies; /*** CustomRenderCopy() calls ***/
+	int iSwitches; /*** copies from another texture than the last copy ***/
+	int iRenders; /*** TTF_Render*() calls ***/
+	int iCreates; /*** textures created ***/
+} stFrame, arFrames[PROFILE_FRAMES + 2];
+int iFrames; /*** all frames; arFrames is a ring ***/
+int iProfile;
+int iProfileHUD;
+char sProfile[MAX_OPTION + 2];
+int iPhase;
+Uint64 llPhaseStart; /*** 0 if the frame is not being timed ***/
+SDL_Texture *imglastcopy;
+char arProfileText[9 + 2][MAX_TEXT + 2];
+
+/* for --record and --replay; a recording is a struct recordhead, followed
+ * by a struct recorded per event
+ */
+struct recordhead {
+	char sMagic[RECORD_MAGIC_SIZE];
+	int iVersion;
+	int iOrder; /*** SNAPSHOT_ORDER ***/
+	int iEventSize;
+	int iScale;
+	int iStartLevel;
+	int iNoAnim;
+	unsigned long long llROMHash;
+};
+struct recorded {
+	Uint32 iTicks; /*** since InputStart() ***/
+	SDL_Event event;
+};
+char sRecord[MAX_OPTION + 2];
+char sReplay[MAX_OPTION + 2];
+FILE *fRecord;
+Uint32 iRecordStart;
+struct recorded *arReplay;
+int iReplayEvents;
+int iReplayNext;
+int iReplay; /*** 0, REPLAY_FAST or REPLAY_REAL ***/
+int iRealTime;
+Uint32 iReplayClock; /*** Ticks() during a replay ***/
+Uint32 iReplayWall;
+Uint64 llReplayStart;
+int iShiftHeld;
+
+/*** for --offscreen, --screenshot and --screenshots ***/
+int iOffscreen;
+char sScreenshot[MAX_OPTION + 2];
+char sScreenshots[MAX_OPTION + 2];
+int iShotRoom;
+int iShotScreen;
+char sShot[MAX_PATHFILE + 2]; /*** Present() writes it, if not empty. ***/
+int iShots;
+
+/*** The tiles of a room and its surroundings, as last drawn. ***/
+struct roomlayer {
+	SDL_Texture *img;
+	int iLevel; /*** 0 if unused ***/
+	int iRoom;
+	int iInfo;
+	unsigned long long llHash;
+	Uint32 iUsed;
+	SDL_Rect arFlames[MAX_FLAMES + 2];
+	int iFlames;
+} arLayers[ROOM_LAYERS + 2];
+
+/*** A room as it was before a step; a step changes one or more rooms. ***/
+struct undoroom {
+	int iRoom;
+	unsigned char arTiles[TILES + 2];
+	unsigned char cGuardTile;
+	unsigned char cGuardDir;
+};
+struct undostep {
+	int iLevel;
+	int iRooms;
+	struct undoroom *arRooms;
+	unsigned char arStartLocation[3 + 2];
+	Uint32 iTicks; /*** of the last change ***/
+	struct undostep *stPrev;
+	struct undostep *stNext;
+};
+
+/* The editable state as a file, to be mapped, checked and copied. Bytes
+ * only, so it has no padding, and the numbers are little-endian.
+ */
+struct snapshot {
+	char sMagic[SNAPSHOT_MAGIC_SIZE];
+	unsigned char arVersion[2]; /*** little-endian ***/
+	unsigned char arOrder[4]; /*** SNAPSHOT_ORDER, little-endian ***/
+	unsigned char arNrEvents[LEVELS + 2][2]; /*** little-endian ***/
+	unsigned char arRoomTiles[LEVELS + 2][ROOMS + 2][TILES + 2];
+	unsigned char arRoomLinks[LEVELS + 2][ROOMS + 2][4 + 2];
+	unsigned char arStartLocation[LEVELS + 2][3 + 2];
+	unsigned char arGuardTile[LEVELS + 2][ROOMS + 2];
+	unsigned char arGuardDir[LEVELS + 2][ROOMS + 2];
+	unsigned char arEventsFromRoom[LEVELS + 2][EVENTS + 2];
+	unsigned char arEventsFromTile[LEVELS + 2][EVENTS + 2];
+	unsigned char arEventsOpenClose[LEVELS + 2][EVENTS + 2];
+	unsigned char arEventsToRoom[LEVELS + 2][EVENTS + 2];
+	unsigned char arEventsToTile[LEVELS + 2][EVENTS + 2];
+	unsigned char sUnknown[UNKNOWN + 2];
+	unsigned char sEXE[SNAPSHOT_EXE];
+};
+
+/*** A ROM and its levels; the editor has stEdit, a batch one per thread. ***/
+struct romctx {
+	char sPathFile[MAX_PATHFILE + 2];
+	unsigned char *sROM;
+	int iROMSize;
+	struct rom stRom;
+	unsigned char arLevelRaw[LEVELS + 2][MAX_LEVEL_SIZE + 2];
+	int arLevelRawSize[LEVELS + 2];
+	unsigned char arLevelOut[LEVELS + 2][MAX_LEVEL_SIZE + 2];
+	int arLevelOutSize[LEVELS + 2];
+	int arLevelDirty[LEVELS + 2]; /*** 0 = saved, 1 = changed, 2 = estimated ***/
+	int arLevelEstimate[LEVELS + 2];
+	int iBytes; /*** of the levels, as loaded ***/
+	int iFree; /*** after the levels, as loaded ***/
+} stEdit;
+
+struct packer {
+	unsigned char *sOut;
+	int iOutOffset;
+	int iRepeatOffset;
+	int iHighStore;
+};
+
 void ShowUsage (void);
 void GetPathFile (void);
-void LoadLevels (void);
-int DecompressLevel (int iFd, int iOffset);
-void SaveLevels (void);
+void ROMLoad (void);
+void ROMUnload (void);
+int ROMByte (int iOffset);
+int ROMWord (int iOffset);
+void ROMSetByte (int iOffset, int iByte);
+void ROMSetWord (int iOffset, int iWord);
+void ROMSetBytes (int iOffset, unsigned char *sBytes, int iBytes);
+void ROMFill (int iOffset, int iByte, int iBytes);
+int ROMFlush (void);
+int LoadLevels (struct romctx *stCtx, char *sError);
+int ParseLevel (struct romctx *stCtx, int iLevel);
+void LoadEditorLevels (void);
+int DecompressLevel (struct romctx *stCtx, int iLevel, int *iOffset);
+int DecodeLevel (unsigned char *sIn, int iInSize,
+	unsigned char *sOut, int iOutMax, int *iOutSize);
+int LevelAtLoop (int iLevelLoop);
+int LevelEntry (int iLevel);
+int LevelOffset (struct romctx *stCtx, int iEntry);
+int SaveLevels (void);
 void PrintTileName (int iLevel, int iRoom, int iTile, int iTileValue);
-void AddDuplicates (int iByteToWrite, int iNrDuplicates);
 void PrIfDe (char *sString);
 char cShowDirection (int iDirection);
 char cShowOpenClose (int iOpenClose);
-int CompressLevel (int iNrBytes);
-int AddRepeat (int iNrRepeated);
+int SerializeLevel (struct romctx *stCtx, int iLevel, unsigned char *sOut);
+void CompressLevels (void);
+int CompressLevel (unsigned char *sIn, int iNrBytes, unsigned char *sOut);
+void CountRuns (unsigned char *sIn, int iNrBytes, int *arCount,
+	int *arRuns, int *arSingles, int *arNibbles);
+void AddRun (unsigned char cByte, int iLength, int *arCount,
+	int *arRuns, int *arSingles, int *arNibbles);
+#ifdef RUNS_X86
+int RunsSSE2 (unsigned char *sIn, int iNrBytes, int *arCount,
+	int *arRuns, int *arSingles, int *arNibbles);
+int RunsAVX2 (unsigned char *sIn, int iNrBytes, int *arCount,
+	int *arRuns, int *arSingles, int *arNibbles);
+#endif
+int PlanGreedy (int *arCount, int *arRuns, int *arSingles, int *arNibbles,
+	unsigned char *arBytesRepeated, unsigned char *arBytesReplace);
+int AddRepeat (struct packer *stPacker, int iNrRepeated);
+int PlannedSize (int *arCount, int *arRuns, int *arSingles, int *arNibbles,
+	unsigned char *arBytesRepeated, int iRepeatedBytes);
+int PlanExhaustive (int *arCount, int *arRuns, int *arSingles,
+	int *arNibbles);
+int LevelSize (int iLevel);
+int FreeBytes (void);
+void BenchCodec (int iRuns);
+void BenchExhaustive (void);
+double Seconds (Uint64 iStart);
+void ExportLevels (char *sFile);
+int ExportLine (char *sText, int iText, char *sLine);
+char *ExportSymbol (char cSymbol, int iValue);
+void ImportLevels (char *sFile);
+int ImportValue (char *sToken, int iBase, int iMin, int iMax);
+int ImportSymbol (char *sToken, char cA, int iA, char cB, int iB);
+void ImportError (char *sFile, int iLine, char *sError);
+void SnapshotSave (char *sFile);
+void SnapshotLoad (char *sFile);
+void SnapshotCheck (struct snapshot *stSnap, char *sFile);
+void SnapshotError (char *sFile, int iLevel, char *sError);
+void Batch (char **arPaths, int iROMs, int iJobs);
+int BatchThread (void *unused);
+int BatchROM (struct romctx *stCtx, char *sResult);
 void Quit (void);
 void InitScreen (void);
 void InitPopUpSave (void);
@@ -393,8 +733,14 @@ void LoadFonts (void);
 void MixAudio (void *unused, Uint8 *stream, int iLen);
 void PlaySound (char *sFile);
 void PreLoadSet (char cTypeP, int iTile);
-void PreLoad (char *sPath, char *sPNG, SDL_Texture **imgImage);
+void PreLoad (char *sPath, char *sPNG, struct img **imgImage);
+struct img *LoadImage (char *sImage);
+void CreateAtlases (void);
 void ShowScreen (void);
+void ShowTiles (void);
+void ShowFlames (void);
+int RoomLayer (void);
+void DropRoomLayers (int iLevel);
 void InitPopUp (void);
 void ShowPopUp (void);
 void Help (void);
@@ -407,17 +753,23 @@ int StartGame (void *unused);
 void ClearRoom (void);
 void UseTile (int iTile, int iLocation, int iRoom);
 void Zoom (int iToggleFull);
+void SceneTexture (void);
 void LinkMinus (void);
 int BrokenRoomLinks (int iPrint);
 void ChangeEvent (int iAmount, int iChangePos);
 void ChangeCustom (int iAmount);
 void Prev (void);
 void Next (void);
-void CallSave (void);
+int CallSave (void);
 void Sprinkle (void);
 void SetLocation (int iRoom, int iLocation, int iTile);
 void FlipRoom (int iAxis);
 void CopyPaste (int iAction);
+void UndoRoom (int iRoom);
+void UndoEnd (void);
+void Undo (int iRedo);
+void UndoDrop (struct undostep *stStep);
+void UndoClear (void);
 int InArea (int iUpperLeftX, int iUpperLeftY,
 	int iLowerRightX, int iLowerRightY);
 int MouseSelectAdj (void);
@@ -428,10 +780,67 @@ void AddNewRoom (int iX, int iY, int iRoom);
 void LinkPlus (void);
 void EventRoom (int iRoom, int iFromTo);
 void EventTile (int iX, int iY, int iFromTo);
-void ShowImage (SDL_Texture *img, int iX, int iY, char *sImageInfo);
+void ShowImage (struct img *img, int iX, int iY, char *sImageInfo);
+void ShowTile (struct img *img, int iX, int iY, int iTile, int iFlags);
+void DrawImage (struct img *img, int iX, int iY, int iTile, int iFlags,
+	char *sImageInfo);
 void CustomRenderCopy (SDL_Texture* src, SDL_Rect* srcrect,
 	SDL_Rect *dstrect, char *sImageInfo);
+void QueueDraw (SDL_Texture *img, SDL_Rect *srcrect, SDL_Rect *dstrect,
+	char *sImageInfo);
+void SubmitDraw (struct draw *stDraw);
+void FlushDraws (void);
+void Present (void);
+void ProfilePhase (int iNewPhase);
+void ProfileCopy (SDL_Texture *img);
+void ProfileFrame (void);
+void ProfileText (void);
+void ProfileDump (void);
+Uint32 ProfileUs (Uint64 llTicks);
+int CompareTimes (const void *vA, const void *vB);
+int Profiling (void);
+Uint32 FrameUs (struct frame *stThis);
+Uint32 Percentile (Uint32 *arSorted, int iCount, int iPercent);
+void RecordOpen (char *sFile);
+void ReplayLoad (char *sFile);
+void InputStart (void);
+int PollEvent (SDL_Event *event);
+void WaitEvent (int iTimeout);
+Uint32 Ticks (void);
+int ShiftHeld (void);
+void ReplayEnd (void);
+void Screenshot (char *sFile);
+void Screenshots (void);
+void ShotTooLong (char *sDir);
+void ShotScreen (int iScreenShot, char *sFile);
+int Overlap (SDL_Rect *stA, SDL_Rect *stB);
+int ClipArea (int iX, int iY, int iW, int iH);
 void CreateBAK (void);
+int ListBackups (char arBackups[BACKUPS_MAX + 2][MAX_PATHFILE + 2]);
+int CompareNames (const void *vA, const void *vB);
+unsigned long long HashBytes (unsigned char *sBytes, int iBytes);
+int WriteBytes (char *sFile, unsigned char *sBytes, int iBytes);
+unsigned char *ReadBase (void);
+int ExportPatch (char *sFile, int iFormat);
+void ExportPatches (void);
+void ApplyPatch (char *sFile);
+int MakeIPS (unsigned char *sBase, unsigned char *sTarget,
+	unsigned char *sPatch);
+int IPSRecord (unsigned char *sPatch, int iSize, int iOffset, int iBytes);
+int ApplyIPS (unsigned char *sPatch, int iPatchSize, unsigned char *sTarget);
+int MakeBPS (unsigned char *sBase, unsigned char *sTarget,
+	unsigned char *sPatch);
+int BPSNumber (unsigned char *sPatch, int iSize, unsigned long long llNumber);
+int BPSReadNumber (unsigned char *sPatch, int iEnd, int *iOffset,
+	int *iNumber);
+int BPSLiteral (unsigned char *sPatch, int iSize,
+	unsigned char *sBytes, int iBytes);
+int ApplyBPS (unsigned char *sPatch, int iPatchSize,
+	unsigned char *sSource, unsigned char *sTarget);
+int MatchLength (unsigned char *sA, unsigned char *sB, int iMax);
+unsigned long CRC32 (unsigned char *sBytes, int iBytes);
+int PutCRC32 (unsigned char *sOut, int iSize, unsigned long lCRC);
+unsigned long GetCRC32 (unsigned char *sIn);
 void DisplayText (int iStartX, int iStartY, int iFontSize,
 	char arText[9 + 2][MAX_TEXT + 2], int iLines, TTF_Font *font);
 void InitRooms (void);
@@ -444,13 +853,16 @@ int OnTile (void);
 void ChangePosAction (char *sAction);
 void DisableSome (void);
 int IsDisabled (int iTile);
+SDL_Texture *TextTexture (TTF_Font *font, char *sText, SDL_Color fore,
+	SDL_Color back, int iBlended, int *iWidth, int *iHeight);
+void DropTexts (void);
 void CenterNumber (int iNumber, int iX, int iY,
 	SDL_Color fore, int iHex);
 int Unused (int iTile);
 int RaiseDropEvent (int iTile, int iEvent, int iAmount);
 void OpenURL (char *sURL);
 void EXELoad (void);
-void EXESave (void);
+int EXESave (void);
 int PlusMinus (int *iWhat, int iX, int iY,
 	int iMin, int iMax, int iChange, int iAddChanged);
 void ColorRect (int iX, int iY, int iW, int iH, int iR, int iG, int iB);
@@ -459,7 +871,7 @@ void TotalEvents (int iAmount);
 void GetOptionValue (char *sArgv, char *sValue);
 int IsEven (int iValue);
 void IntroSlides (void);
-void ModifyForMednafen (int iLevel);
+int ModifyForMednafen (int iLevel);
 void ModifyBack (void);
 
 /*****************************************************************************/
@@ -470,6 +882,18 @@ int main (int argc, char *argv[])
 	SDL_version verc, verl;
 	time_t tm;
 	char sStartLevel[MAX_OPTION + 2];
+	char sRuns[MAX_OPTION + 2];
+	int iBenchRuns;
+	char sApply[MAX_OPTION + 2];
+	char sIPS[MAX_OPTION + 2];
+	char sBPS[MAX_OPTION + 2];
+	char sExport[MAX_OPTION + 2];
+	char sImport[MAX_OPTION + 2];
+	char sSnapshot[MAX_OPTION + 2];
+	char sRestore[MAX_OPTION + 2];
+	char sJobs[MAX_OPTION + 2];
+	int iJobs;
+	int iBatchFirst;
 
 	iDebug = 0;
 	iExtras = 0;
@@ -479,6 +903,7 @@ int main (int argc, char *argv[])
 	iOnTile = 1;
 	iCopied = 0;
 	iNoAudio = 0;
+	iNoAtlas = 0;
 	iFullscreen = 0;
 	iNoController = 0;
 	iStartLevel = 1;
@@ -486,6 +911,30 @@ int main (int argc, char *argv[])
 	iMednafen = 0;
 	iNoAnim = 0;
 	iModified = 0;
+	iShareLevels = 0;
+	iBenchRuns = 0;
+	iUndoBudget = UNDO_BUDGET;
+	snprintf (sApply, MAX_OPTION, "%s", "");
+	snprintf (sIPS, MAX_OPTION, "%s", "");
+	snprintf (sBPS, MAX_OPTION, "%s", "");
+	snprintf (sExport, MAX_OPTION, "%s", "");
+	snprintf (sImport, MAX_OPTION, "%s", "");
+	snprintf (sSnapshot, MAX_OPTION, "%s", "");
+	snprintf (sRestore, MAX_OPTION, "%s", "");
+	iJobs = 0;
+	iBatchFirst = 0;
+	iProfile = 0;
+	iProfileHUD = 0;
+	snprintf (sRecord, MAX_OPTION, "%s", "");
+	snprintf (sReplay, MAX_OPTION, "%s", "");
+	iRealTime = 0;
+	iOffscreen = 0;
+	snprintf (sScreenshot, MAX_OPTION, "%s", "");
+	snprintf (sScreenshots, MAX_OPTION, "%s", "");
+	iShotRoom = 0;
+	iShotScreen = SHOT_MAIN;
+	snprintf (sShot, MAX_PATHFILE, "%s", "");
+	snprintf (sProfile, MAX_OPTION, "%s", PROFILE_FILE);
 
 	if (argc > 1)
 	{
@@ -513,6 +962,10 @@ int main (int argc, char *argv[])
 			{
 				iNoAudio = 1;
 			}
+			else if (strcmp (argv[iArgLoop], "--noatlas") == 0)
+			{
+				iNoAtlas = 1;
+			}
 			else if ((strcmp (argv[iArgLoop], "-z") == 0) ||
 				(strcmp (argv[iArgLoop], "--zoom") == 0))
 			{
@@ -543,6 +996,115 @@ int main (int argc, char *argv[])
 			{
 				iNoController = 1;
 			}
+			else if (strcmp (argv[iArgLoop], "--share-levels") == 0)
+			{
+				iShareLevels = 1;
+			}
+			else if (strcmp (argv[iArgLoop], "--bench-codec") == 0)
+			{
+				iBenchRuns = BENCH_RUNS;
+			}
+			else if (strncmp (argv[iArgLoop], "--bench-codec=", 14) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sRuns);
+				iBenchRuns = atoi (sRuns);
+				if (iBenchRuns < 1) { iBenchRuns = BENCH_RUNS; }
+			}
+			else if (strcmp (argv[iArgLoop], "--profile") == 0)
+			{
+				iProfile = 1;
+			}
+			else if (strncmp (argv[iArgLoop], "--profile=", 10) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sProfile);
+				iProfile = 1;
+			}
+			else if (strncmp (argv[iArgLoop], "--record=", 9) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sRecord);
+			}
+			else if (strncmp (argv[iArgLoop], "--replay=", 9) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sReplay);
+			}
+			else if (strcmp (argv[iArgLoop], "--realtime") == 0)
+			{
+				iRealTime = 1;
+			}
+			else if (strcmp (argv[iArgLoop], "--offscreen") == 0)
+			{
+				iOffscreen = 1;
+			}
+			else if (strncmp (argv[iArgLoop], "--screenshot=", 13) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sScreenshot);
+			}
+			else if (strncmp (argv[iArgLoop], "--screenshots=", 14) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sScreenshots);
+			}
+			else if (strncmp (argv[iArgLoop], "--room=", 7) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sRuns);
+				iShotRoom = atoi (sRuns);
+				if ((iShotRoom < 1) || (iShotRoom > ROOMS)) { ShowUsage(); }
+			}
+			else if (strncmp (argv[iArgLoop], "--screen=", 9) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sRuns);
+				if (strcmp (sRuns, "main") == 0) { iShotScreen = SHOT_MAIN; }
+				else if (strcmp (sRuns, "links") == 0) { iShotScreen = SHOT_LINKS; }
+				else if (strcmp (sRuns, "events") == 0) { iShotScreen = SHOT_EVENTS; }
+				else if (strcmp (sRuns, "tiles") == 0) { iShotScreen = SHOT_TILES; }
+				else if (strcmp (sRuns, "exe") == 0) { iShotScreen = SHOT_EXE; }
+				else { ShowUsage(); }
+			}
+			else if (strncmp (argv[iArgLoop], "--undo-budget=", 14) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sRuns);
+				iUndoBudget = atoi (sRuns);
+				if (iUndoBudget < 1) { iUndoBudget = UNDO_BUDGET; }
+			}
+			else if (strncmp (argv[iArgLoop], "--apply=", 8) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sApply);
+			}
+			else if (strncmp (argv[iArgLoop], "--ips=", 6) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sIPS);
+			}
+			else if (strncmp (argv[iArgLoop], "--bps=", 6) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sBPS);
+			}
+			else if (strncmp (argv[iArgLoop], "--export=", 9) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sExport);
+			}
+			else if (strncmp (argv[iArgLoop], "--import=", 9) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sImport);
+			}
+			else if (strncmp (argv[iArgLoop], "--snapshot=", 11) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sSnapshot);
+			}
+			else if (strncmp (argv[iArgLoop], "--restore=", 10) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sRestore);
+			}
+			else if (strncmp (argv[iArgLoop], "--jobs=", 7) == 0)
+			{
+				GetOptionValue (argv[iArgLoop], sJobs);
+				iJobs = atoi (sJobs);
+			}
+			else if (strcmp (argv[iArgLoop], "--batch") == 0)
+			{
+				/*** All other arguments are ROMs. ***/
+				iBatchFirst = iArgLoop + 1;
+				if (iBatchFirst == argc) { ShowUsage(); }
+				break;
+			}
 			else
 			{
 				ShowUsage();
@@ -550,11 +1112,82 @@ int main (int argc, char *argv[])
 		}
 	}
 
+	/*** Modes that only handle data; no window, no audio, no message boxes. ***/
+	if ((iBenchRuns != 0) || (iBatchFirst != 0) ||
+		(strcmp (sIPS, "") != 0) || (strcmp (sBPS, "") != 0) ||
+		(strcmp (sExport, "") != 0) || (strcmp (sImport, "") != 0) ||
+		(strcmp (sSnapshot, "") != 0) || (strcmp (sRestore, "") != 0))
+	{
+		iHeadless = 1;
+		iNoAudio = 1;
+	}
+
+	/*** Screenshots need no display; they are drawn into memory. ***/
+	if ((strcmp (sScreenshot, "") != 0) || (strcmp (sScreenshots, "") != 0))
+		{ iOffscreen = 1; }
+	else if ((iOffscreen == 1) && (strcmp (sReplay, "") == 0)) { ShowUsage(); }
+
+	/*** A replay uses no display, audio or controllers. ***/
+	if ((strcmp (sReplay, "") != 0) || (iOffscreen == 1))
+	{
+		iNoAudio = 1;
+		iNoController = 1;
+		iFullscreen = 0;
+	}
+
+	/*** Find runs in levels with vectors, if the CPU has them. ***/
+	iRunsSIMD = RUNS_SCALAR;
+	if (SDL_HasSSE2() == SDL_TRUE) { iRunsSIMD = RUNS_SSE2; }
+	if (SDL_HasAVX2() == SDL_TRUE) { iRunsSIMD = RUNS_AVX2; }
+
+	/*** Check the given ROMs, instead of the one in the rom directory. ***/
+	if (iBatchFirst != 0)
+	{
+		Batch (&argv[iBatchFirst], argc - iBatchFirst, iJobs);
+		exit (EXIT_NORMAL);
+	}
+
 	GetPathFile();
 
+	/*** Benchmark the level codec, without starting SDL. ***/
+	if (iBenchRuns != 0)
+	{
+		BenchCodec (iBenchRuns);
+		exit (EXIT_NORMAL);
+	}
+
+	/*** A patch changes the ROM image; the levels are loaded from it. ***/
+	if (strcmp (sApply, "") != 0)
+	{
+		ApplyPatch (sApply);
+		iChanged = 1;
+	}
+
 	srand ((unsigned)time(&tm));
 
-	LoadLevels();
+	LoadEditorLevels();
+
+	/*** Import, export and create patches, without starting SDL. ***/
+	if (iHeadless == 1)
+	{
+		if (strcmp (sRestore, "") != 0) { SnapshotLoad (sRestore); }
+		if (strcmp (sImport, "") != 0) { ImportLevels (sImport); }
+		if (strcmp (sExport, "") != 0) { ExportLevels (sExport); }
+		if (strcmp (sSnapshot, "") != 0) { SnapshotSave (sSnapshot); }
+		if ((strcmp (sIPS, "") != 0) && (ExportPatch (sIPS, PATCH_IPS) == 0))
+			{ exit (EXIT_ERROR); }
+		if ((strcmp (sBPS, "") != 0) && (ExportPatch (sBPS, PATCH_BPS) == 0))
+			{ exit (EXIT_ERROR); }
+		ROMUnload();
+		exit (EXIT_NORMAL);
+	}
+
+	if (strcmp (sReplay, "") != 0)
+	{
+		ReplayLoad (sReplay);
+	} else if (strcmp (sRecord, "") != 0) {
+		RecordOpen (sRecord);
+	}
 
 	/*** Show the SDL version used for compiling and linking. ***/
 	if (iDebug == 1)
@@ -582,11 +1215,51 @@ void ShowUsage (void)
 		" exit\n");
 	printf ("  -d,        --debug          also show levels on the console\n");
 	printf ("  -n,        --noaudio        do not play sound effects\n");
+	printf ("             --noatlas        give every image its own texture\n");
 	printf ("  -z,        --zoom           double the interface size\n");
 	printf ("  -f,        --fullscreen     start in fullscreen mode\n");
 	printf ("  -l=NR,     --level=NR       start in level NR\n");
 	printf ("  -s,        --static         do not display animations\n");
 	printf ("  -k,        --keyboard       do not use a game controller\n");
+	printf ("             --share-levels   let identical levels share their"
+		" data when saving\n");
+	printf ("             --undo-budget=KB keep at most KB KiB of undo"
+		" history\n");
+	printf ("             --profile[=FILE] time every frame; write them to"
+		" FILE (" PROFILE_FILE ") on exit\n");
+	printf ("             --record=FILE    write all input to FILE\n");
+	printf ("             --replay=FILE    replay the input in FILE, offscreen,"
+		" and exit\n");
+	printf ("             --realtime       replay with the recorded timing,"
+		" instead of at full speed\n");
+	printf ("             --offscreen      draw into memory, without a window;"
+		" for --replay\n");
+	printf ("             --screenshot=FILE write a PNG of --level, --room and"
+		" --screen, and exit\n");
+	printf ("             --screenshots=DIR write PNGs of all rooms and"
+		" screens to DIR, and exit\n");
+	printf ("             --room=NR        the room for --screenshot\n");
+	printf ("             --screen=NAME    main, links, events, tiles or exe;"
+		" for --screenshot\n");
+	printf ("             --bench-codec=N  decode and re-encode all levels N"
+		" times and exit\n");
+	printf ("             --apply=FILE     apply an IPS or BPS patch before"
+		" editing\n");
+	printf ("             --ips=FILE       create an IPS patch of the changes"
+		" and exit\n");
+	printf ("             --bps=FILE       create a BPS patch of the changes"
+		" and exit\n");
+	printf ("             --export=FILE    write all levels to a text file"
+		" and exit\n");
+	printf ("             --import=FILE    read levels from a text file, save"
+		" and exit\n");
+	printf ("             --snapshot=FILE  write the levels to a binary"
+		" snapshot and exit\n");
+	printf ("             --restore=FILE   read levels from a snapshot, save"
+		" and exit\n");
+	printf ("             --jobs=N         use N threads for --batch\n");
+	printf ("             --batch ROM...   load, check and recompress ROMs,"
+		" and exit\n");
 	printf ("\n");
 	exit (EXIT_NORMAL);
 }
@@ -599,9 +1272,6 @@ void GetPathFile (void)
 	struct dirent *stDirent;
 	char sExtension[100 + 2];
 	char sError[MAX_ERROR + 2];
-	char sVerify[VERIFY_SIZE + 2];
-	int iFd;
-
 	iFound = 0;
 
 	dDir = opendir (ROM_DIR);
@@ -625,11 +1295,12 @@ void GetPathFile (void)
 					(toupper (sExtension[3]) == 'C'))
 				{
 					iFound = 1;
-					snprintf (sPathFile, MAX_PATHFILE, "%s%s%s", ROM_DIR, SLASH,
-						stDirent->d_name);
+					snprintf (stEdit.sPathFile, MAX_PATHFILE, "%s%s%s", ROM_DIR,
+						SLASH, stDirent->d_name);
 					if (iDebug == 1)
 					{
-						printf ("[  OK  ] Found Game Boy Color ROM \"%s\".\n", sPathFile);
+						printf ("[  OK  ] Found Game Boy Color ROM \"%s\".\n",
+							stEdit.sPathFile);
 					}
 				}
 			}
@@ -643,588 +1314,860 @@ void GetPathFile (void)
 		snprintf (sError, MAX_ERROR, "Cannot find a .gbc ROM in"
 			" directory \"%s\"!", ROM_DIR);
 		printf ("[FAILED] %s\n", sError);
-		SDL_ShowSimpleMessageBox (SDL_MESSAGEBOX_ERROR,
-			"Error", sError, NULL);
+		if (iHeadless == 0)
+		{
+			SDL_ShowSimpleMessageBox (SDL_MESSAGEBOX_ERROR,
+				"Error", sError, NULL);
+		}
 		exit (EXIT_ERROR);
 	}
 
 	/*** Is the file accessible? ***/
-	if (access (sPathFile, R_OK|W_OK) == -1)
+	if (access (stEdit.sPathFile, R_OK|W_OK) == -1)
 	{
 		printf ("[FAILED] Cannot access \"%s\": %s!\n",
-			sPathFile, strerror (errno));
+			stEdit.sPathFile, strerror (errno));
 		exit (EXIT_ERROR);
 	}
 
+	/*** All reading and writing goes through the ROM image. ***/
+	ROMLoad();
+
 	/*** Is the file a PoP1 for GBC ROM file? ***/
-	iFd = open (sPathFile, O_RDONLY|O_BINARY);
+	if ((stEdit.iROMSize < VERIFY_OFFSET + VERIFY_SIZE) ||
+		(memcmp (&stEdit.sROM[VERIFY_OFFSET], VERIFY_TEXT, VERIFY_SIZE) != 0))
+	{
+		snprintf (sError, MAX_ERROR, "File %s is not a Prince of Persia"
+			" for GBC ROM!", stEdit.sPathFile);
+		printf ("[FAILED] %s\n", sError);
+		if (iHeadless == 0)
+		{
+			SDL_ShowSimpleMessageBox (SDL_MESSAGEBOX_ERROR,
+				"Error", sError, NULL);
+		}
+		exit (EXIT_ERROR);
+	}
+}
+/*****************************************************************************/
+void ROMLoad (void)
+/*****************************************************************************/
+{
+	int iFd;
+	struct stat stStat;
+
+	iFd = open (stEdit.sPathFile, O_RDONLY|O_BINARY);
 	if (iFd == -1)
 	{
 		printf ("[FAILED] Could not open \"%s\": %s!\n",
-			sPathFile, strerror (errno));
+			stEdit.sPathFile, strerror (errno));
+		exit (EXIT_ERROR);
+	}
+	if (fstat (iFd, &stStat) == -1)
+	{
+		printf ("[FAILED] Could not stat \"%s\": %s!\n",
+			stEdit.sPathFile, strerror (errno));
 		exit (EXIT_ERROR);
 	}
-	lseek (iFd, VERIFY_OFFSET, SEEK_SET);
-	read (iFd, sVerify, VERIFY_SIZE);
+	stEdit.iROMSize = stStat.st_size;
+	iROMMode = stStat.st_mode & 0777;
+
+	/* The image is private; changes only reach the file via ROMFlush().
+	 * If mapping fails, the file is read at once instead.
+	 */
+	iROMMapped = 0;
+#if defined __linux__
+	stEdit.sROM = mmap (NULL, stEdit.iROMSize, PROT_READ|PROT_WRITE,
+		MAP_PRIVATE, iFd, 0);
+	if (stEdit.sROM != MAP_FAILED) { iROMMapped = 1; }
+#endif
+	if (iROMMapped == 0)
+	{
+		stEdit.sROM = malloc (stEdit.iROMSize);
+		if (stEdit.sROM == NULL)
+		{
+			printf ("[FAILED] Could not allocate %i bytes!\n", stEdit.iROMSize);
+			exit (EXIT_ERROR);
+		}
+		if (read (iFd, stEdit.sROM, stEdit.iROMSize) != stEdit.iROMSize)
+		{
+			printf ("[FAILED] Could not read from \"%s\": %s!\n",
+				stEdit.sPathFile, strerror (errno));
+			exit (EXIT_ERROR);
+		}
+	}
 	close (iFd);
-	sVerify[VERIFY_SIZE] = '\0';
-	if (strcmp (sVerify, VERIFY_TEXT) != 0)
+
+	iROMChanged = 0;
+}
+/*****************************************************************************/
+void ROMUnload (void)
+/*****************************************************************************/
+{
+	if (stEdit.sROM == NULL) { return; }
+#if defined __linux__
+	if (iROMMapped == 1)
 	{
-		snprintf (sError, MAX_ERROR, "File %s is not a Prince of Persia"
-			" for GBC ROM!", sPathFile);
-		printf ("[FAILED] %s\n", sError);
-		SDL_ShowSimpleMessageBox (SDL_MESSAGEBOX_ERROR,
-			"Error", sError, NULL);
+		munmap (stEdit.sROM, stEdit.iROMSize);
+		stEdit.sROM = NULL;
+		return;
+	}
+#endif
+	free (stEdit.sROM);
+	stEdit.sROM = NULL;
+}
+/*****************************************************************************/
+int ROMByte (int iOffset)
+/*****************************************************************************/
+{
+	if ((iOffset < 0) || (iOffset >= stEdit.iROMSize))
+	{
+		printf ("[FAILED] Offset 0x%02x is not in \"%s\"!\n",
+			iOffset, stEdit.sPathFile);
 		exit (EXIT_ERROR);
 	}
+
+	return (stEdit.sROM[iOffset]);
 }
 /*****************************************************************************/
-void LoadLevels (void)
+int ROMWord (int iOffset)
 /*****************************************************************************/
 {
-	int iFd;
+	/*** Little-endian. ***/
+	return (ROMByte (iOffset) + (ROMByte (iOffset + 1) << 8));
+}
+/*****************************************************************************/
+void ROMSetByte (int iOffset, int iByte)
+/*****************************************************************************/
+{
+	ROMByte (iOffset); /*** Checks the offset. ***/
+	stEdit.sROM[iOffset] = iByte & 0xFF;
+	iROMChanged = 1;
+}
+/*****************************************************************************/
+void ROMSetWord (int iOffset, int iWord)
+/*****************************************************************************/
+{
+	ROMSetByte (iOffset, (iWord >> 0) & 0xFF);
+	ROMSetByte (iOffset + 1, (iWord >> 8) & 0xFF);
+}
+/*****************************************************************************/
+void ROMSetBytes (int iOffset, unsigned char *sBytes, int iBytes)
+/*****************************************************************************/
+{
+	if (iBytes <= 0) { return; }
+	ROMSetByte (iOffset, sBytes[0]);
+	ROMSetByte (iOffset + iBytes - 1, sBytes[iBytes - 1]);
+	memcpy (&stEdit.sROM[iOffset], sBytes, iBytes);
+}
+/*****************************************************************************/
+void ROMFill (int iOffset, int iByte, int iBytes)
+/*****************************************************************************/
+{
+	if (iBytes <= 0) { return; }
+	ROMSetByte (iOffset, iByte);
+	ROMSetByte (iOffset + iBytes - 1, iByte);
+	memset (&stEdit.sROM[iOffset], iByte, iBytes);
+}
+/*****************************************************************************/
+int ROMFlush (void)
+/*****************************************************************************/
+{
+	if (iROMChanged == 0) { return (1); }
+	if (iReplay != 0) { return (1); } /*** A replay leaves the ROM alone. ***/
+
+	/*** If this fails, the image stays changed and the ROM stays as it was. ***/
+	if (WriteBytes (stEdit.sPathFile, stEdit.sROM, stEdit.iROMSize) == 0)
+		{ return (0); }
+
+	iROMChanged = 0;
+
+	return (1);
+}
+/*****************************************************************************/
+int LoadLevels (struct romctx *stCtx, char *sError)
+/*****************************************************************************/
+{
+	int arOffsetStart[LEVELS + 2];
 	int iOffsetStart;
 	int iOffsetEnd;
+	int iConsumed;
 	int iLevel;
-	int iTileValue;
-	int iTiles;
-	int iTemp;
-	int iEventStart;
+	int iUnknown;
+	int iShared;
 
 	/*** Used for looping. ***/
-	int iRoomLoop;
-	int iTileLoop;
 	int iByteLoop;
-	int iSideLoop;
-	int iGuardLoop;
-	int iEventLoop;
 	int iUnknownLoop;
 	int iLevelLoop;
+	int iSameLoop;
 
-	iFd = open (sPathFile, O_RDONLY|O_BINARY);
-	if (iFd == -1)
+	if (stCtx->iROMSize < 0x1FFFF)
 	{
-		printf ("[FAILED] Could not open \"%s\": %s!\n",
-			sPathFile, strerror (errno));
-		exit (EXIT_ERROR);
+		snprintf (sError, MAX_ERROR, "The ROM has only %i bytes",
+			stCtx->iROMSize);
+		return (0);
 	}
 
-	iOffsetStart = OFFSET_LEVEL0;
-
+	/*** The levels are decoded straight from the ROM image. ***/
+	stCtx->iBytes = 0;
+	stCtx->iFree = 0x1FFFF - OFFSET_LEVEL0;
 	for (iLevelLoop = 1; iLevelLoop <= LEVELS; iLevelLoop++)
 	{
-		/*** We present level 0 to users as level 15. ***/
-		switch (iLevelLoop)
-		{
-			case 1: iLevel = 15; break;
-			case 16: iLevel = 16; break;
-			case 17: iLevel = 17; break;
-			default: iLevel = iLevelLoop - 1; break;
-		}
+		iLevel = LevelAtLoop (iLevelLoop);
 
 		/*** This is the princess room during the ending. ***/
 		if (iLevel == 16)
 		{
-			read (iFd, sUnknown, UNKNOWN);
-			iOffsetStart+=UNKNOWN;
+			iUnknown = LevelOffset (stCtx, 15);
+			if ((iUnknown < OFFSET_LEVEL0) || (iUnknown + UNKNOWN > 0x1FFFF))
+			{
+				snprintf (sError, MAX_ERROR, "The princess room has offset"
+					" 0x%02x", iUnknown);
+				return (0);
+			}
+			memcpy (stCtx->stRom.sUnknown, &stCtx->sROM[iUnknown], UNKNOWN);
 			if (iDebug == 1)
 			{
 				for (iUnknownLoop = 0; iUnknownLoop < UNKNOWN; iUnknownLoop++)
 				{
-					printf ("0x%02x ", sUnknown[iUnknownLoop]);
+					printf ("0x%02x ", stCtx->stRom.sUnknown[iUnknownLoop]);
 				}
 				printf ("\n\n");
 			}
 		}
 
-		/*** Decompress the level into arLevel. ***/
-		if (iDebug == 1)
+		/*** Decompress the level into arLevelRaw. ***/
+		iConsumed = DecompressLevel (stCtx, iLevel, &iOffsetStart);
+		if (iConsumed == -1)
 		{
-			printf ("[ INFO ] Level %i starts at offset 0x%02x (%i).\n",
-				iLevel, iOffsetStart, iOffsetStart);
+			snprintf (sError, MAX_ERROR, "Level %i at offset 0x%02x is damaged",
+				iLevel, iOffsetStart);
+			return (0);
+		}
+		iOffsetEnd = iOffsetStart + iConsumed - 1;
+
+		/*** Levels saved with --share-levels may use the same data. ***/
+		arOffsetStart[iLevelLoop] = iOffsetStart;
+		iShared = 0;
+		for (iSameLoop = 1; iSameLoop < iLevelLoop; iSameLoop++)
+		{
+			if (arOffsetStart[iSameLoop] == iOffsetStart) { iShared = 1; }
 		}
-		iOffsetEnd = DecompressLevel (iFd, iOffsetStart);
+		if (iShared == 0) { stCtx->iBytes+=iConsumed; }
+		if (0x1FFFF - (iOffsetEnd + 1) < stCtx->iFree)
+			{ stCtx->iFree = 0x1FFFF - (iOffsetEnd + 1); }
+
+		/*** Keep the compressed level, until it is changed. ***/
+		memcpy (stCtx->arLevelOut[iLevel], &stCtx->sROM[iOffsetStart],
+			iConsumed);
+		stCtx->arLevelOutSize[iLevel] = iConsumed;
+		stCtx->arLevelDirty[iLevel] = 0;
 
 		if (iDebug == 1)
 		{
+			printf ("[ INFO ] Level %i starts at offset 0x%02x (%i).\n",
+				iLevel, iOffsetStart, iOffsetStart);
 			printf ("[ INFO ] Level %i ends at offset 0x%02x (%i).\n",
 				iLevel, iOffsetEnd, iOffsetEnd);
 			printf ("[ INFO ] Compressed level size: %i\n",
 				iOffsetEnd - iOffsetStart + 1);
 			printf ("\n");
-			for (iByteLoop = 0; iByteLoop < iLevelSize; iByteLoop++)
+			for (iByteLoop = 0; iByteLoop < stCtx->arLevelRawSize[iLevel];
+				iByteLoop++)
 			{
-				printf ("0x%02x ", arLevel[iByteLoop]);
+				printf ("0x%02x ", stCtx->arLevelRaw[iLevel][iByteLoop]);
 			}
 			printf ("\n");
 		}
 
-		iOffsetStart = iOffsetEnd + 1;
-
-		/*** Extract tiles. ***/
-		iTiles = -1;
-		for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+		if (ParseLevel (stCtx, iLevel) == 0)
 		{
-			if (iDebug == 1)
-			{
-				printf ("\n[Level %i] Room %i:\n\n", iLevel, iRoomLoop);
-			}
-			for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-			{
-				iTiles++;
-				iTileValue = arLevel[iTiles];
-				arRoomTiles[iLevel][iRoomLoop][iTileLoop] = iTileValue;
-
-				/*** Debug. ***/
-				if (iDebug == 1)
-				{
-					if (iTileValue == 0xFF)
-					{
-						printf ("Unused room.\n");
-					} else {
-						PrintTileName (iLevel, iRoomLoop, iTileLoop, iTileValue);
-						if ((iTileLoop == 10) || (iTileLoop == 20))
-						{
-							printf ("\n");
-							for (iTemp = 1; iTemp <= 79; iTemp++) { printf ("-"); }
-							printf ("\n");
-						} else if (iTileLoop != 30) { printf ("|"); }
-					}
-				}
-
-				if (iTileValue == 0xFF) { break; }
-			}
-			PrIfDe ("\n");
+			snprintf (sError, MAX_ERROR, "Level %i at offset 0x%02x is damaged",
+				iLevel, iOffsetStart);
+			return (0);
 		}
 
-		/*** Extract room links. ***/
-		PrIfDe ("[  OK  ] Loading: Room Links\n");
-		for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+		if (iDebug == 1)
 		{
-			for (iSideLoop = 1; iSideLoop <= 4; iSideLoop++)
-			{
-				iTiles++;
-				arRoomLinks[iLevel][iRoomLoop][iSideLoop] = arLevel[iTiles];
-			}
-			if (iDebug == 1)
-			{
-				printf ("[ INFO ] Room %i is connected to room (0 = none):"
-					" l%i, r%i, u%i, d%i\n", iRoomLoop,
-					arRoomLinks[iLevel][iRoomLoop][1],
-					arRoomLinks[iLevel][iRoomLoop][2],
-					arRoomLinks[iLevel][iRoomLoop][3],
-					arRoomLinks[iLevel][iRoomLoop][4]);
-			}
+			printf ("[  OK  ] Done processing level %i.\n\n", iLevel);
 		}
+	}
 
-		/*** Extract start location. ***/
-		iTiles++;
-		arStartLocation[iLevel][1] = arLevel[iTiles]; /*** Room. ***/
-		iTiles++;
-		arStartLocation[iLevel][2] = arLevel[iTiles] + 1; /*** Tile. ***/
-		iTiles++;
-		arStartLocation[iLevel][3] = arLevel[iTiles]; /*** Direction. ***/
+	return (1);
+}
+/*****************************************************************************/
+int ParseLevel (struct romctx *stCtx, int iLevel)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	unsigned char *arLevel;
+	int iSize;
+	int iTileValue;
+	int iTiles;
+	int iTemp;
+	int iEventStart;
+
+	/*** Used for looping. ***/
+	int iRoomLoop;
+	int iTileLoop;
+	int iSideLoop;
+	int iGuardLoop;
+	int iEventLoop;
+
+	/*** The layout of SerializeLevel; 0 if the level ends too early. ***/
+	stLevel = &stCtx->stRom.arLevel[iLevel];
+	arLevel = stCtx->arLevelRaw[iLevel];
+	iSize = stCtx->arLevelRawSize[iLevel];
+
+	/*** Extract tiles. ***/
+	iTiles = -1;
+	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+	{
 		if (iDebug == 1)
 		{
-			printf ("[ INFO ] The prince starts in room: %i, tile %i, turned: %c\n",
-				arStartLocation[iLevel][1], arStartLocation[iLevel][2],
-				cShowDirection (arStartLocation[iLevel][3]));
+			printf ("\n[Level %i] Room %i:\n\n", iLevel, iRoomLoop);
 		}
-
-		/*** Extract guards. ***/
-		for (iGuardLoop = 1; iGuardLoop <= ROOMS; iGuardLoop++)
+		for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
 		{
 			iTiles++;
-			arGuardTile[iLevel][iGuardLoop] = arLevel[iTiles];
-			/*** This forces the direction bit to 0. Thanks Stack Overflow. ***/
-			arGuardTile[iLevel][iGuardLoop]
-				^= (-0 ^ arGuardTile[iLevel][iGuardLoop]) & (1 << 7);
-			arGuardTile[iLevel][iGuardLoop]++;
-			/*** Get the direction bit. ***/
-			if (arLevel[iTiles] >= 128)
-			{
-				arGuardDir[iLevel][iGuardLoop] = 0xFF; /*** l ***/
-			} else {
-				arGuardDir[iLevel][iGuardLoop] = 0x00; /*** r ***/
-			}
-/***
-			switch (arLevel[iTiles] & 1) // 1 = 00000001
-			{
-				case 1: arGuardDir[iLevel][iGuardLoop] = 0xFF; break; // l
-				case 0: arGuardDir[iLevel][iGuardLoop] = 0x00; break; // r
-			}
-***/
+			if (iTiles >= iSize) { return (0); }
+			iTileValue = arLevel[iTiles];
+			stLevel->arRoomTiles[iRoomLoop][iTileLoop] = iTileValue;
 
+			/*** Debug. ***/
 			if (iDebug == 1)
 			{
-				if (arGuardTile[iLevel][iGuardLoop] <= TILES)
+				if (iTileValue == 0xFF)
 				{
-					printf ("[ INFO ] A guard in room: %i, tile %i, turned: %c\n",
-						iGuardLoop, arGuardTile[iLevel][iGuardLoop],
-						cShowDirection (arGuardDir[iLevel][iGuardLoop]));
+					printf ("Unused room.\n");
+				} else {
+					PrintTileName (iLevel, iRoomLoop, iTileLoop, iTileValue);
+					if ((iTileLoop == 10) || (iTileLoop == 20))
+					{
+						printf ("\n");
+						for (iTemp = 1; iTemp <= 79; iTemp++) { printf ("-"); }
+						printf ("\n");
+					} else if (iTileLoop != 30) { printf ("|"); }
 				}
 			}
+
+			if (iTileValue == 0xFF) { break; }
 		}
+		PrIfDe ("\n");
+	}
 
-		/*** Extract events. ***/
-		arNrEvents[iLevel] = 0;
-		for (iEventLoop = 1; iEventLoop <= EVENTS; iEventLoop++)
-		{
-			iEventStart = iTiles + ((iEventLoop - 1) * 5);
-			if (arLevel[iEventStart + 1] == 0xFF) { break; }
-			arEventsFromRoom[iLevel][iEventLoop] = arLevel[iEventStart + 1];
-			arEventsFromTile[iLevel][iEventLoop] = arLevel[iEventStart + 2] + 1;
-			arEventsOpenClose[iLevel][iEventLoop] = arLevel[iEventStart + 3];
-			arEventsToRoom[iLevel][iEventLoop] = arLevel[iEventStart + 4];
-			arEventsToTile[iLevel][iEventLoop] = arLevel[iEventStart + 5] + 1;
-			arNrEvents[iLevel]++;
+	/*** Room links, start location and guards; then at least the end. ***/
+	if (iTiles + (ROOMS * 4) + 3 + ROOMS + 1 >= iSize) { return (0); }
 
-			if (iDebug == 1)
-			{
-				printf ("[ INFO ] Event: room %i, tile %i -%c- room %i tile %i\n",
-					arEventsFromRoom[iLevel][iEventLoop],
-					arEventsFromTile[iLevel][iEventLoop],
-					cShowOpenClose (arEventsOpenClose[iLevel][iEventLoop]),
-					arEventsToRoom[iLevel][iEventLoop],
-					arEventsToTile[iLevel][iEventLoop]);
+	/*** Extract room links. ***/
+	PrIfDe ("[  OK  ] Loading: Room Links\n");
+	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+	{
+		for (iSideLoop = 1; iSideLoop <= 4; iSideLoop++)
+		{
+			iTiles++;
+			stLevel->arRoomLinks[iRoomLoop][iSideLoop] = arLevel[iTiles];
+		}
+		if (iDebug == 1)
+		{
+			printf ("[ INFO ] Room %i is connected to room (0 = none):"
+				" l%i, r%i, u%i, d%i\n", iRoomLoop,
+				stLevel->arRoomLinks[iRoomLoop][1],
+				stLevel->arRoomLinks[iRoomLoop][2],
+				stLevel->arRoomLinks[iRoomLoop][3],
+				stLevel->arRoomLinks[iRoomLoop][4]);
+		}
+	}
+
+	/*** Extract start location. ***/
+	if ((arLevel[iTiles + 1] < 1) || (arLevel[iTiles + 1] > ROOMS) ||
+		(arLevel[iTiles + 2] >= TILES)) { return (0); }
+	iTiles++;
+	stLevel->arStartLocation[1] = arLevel[iTiles]; /*** Room. ***/
+	iTiles++;
+	stLevel->arStartLocation[2] = arLevel[iTiles] + 1; /*** Tile. ***/
+	iTiles++;
+	stLevel->arStartLocation[3] = arLevel[iTiles]; /*** Direction. ***/
+	if (iDebug == 1)
+	{
+		printf ("[ INFO ] The prince starts in room: %i, tile %i, turned: %c\n",
+			stLevel->arStartLocation[1], stLevel->arStartLocation[2],
+			cShowDirection (stLevel->arStartLocation[3]));
+	}
+
+	/*** Extract guards. ***/
+	for (iGuardLoop = 1; iGuardLoop <= ROOMS; iGuardLoop++)
+	{
+		iTiles++;
+		stLevel->arGuardTile[iGuardLoop] = arLevel[iTiles];
+		/*** This forces the direction bit to 0. Thanks Stack Overflow. ***/
+		stLevel->arGuardTile[iGuardLoop]
+			^= (-0 ^ stLevel->arGuardTile[iGuardLoop]) & (1 << 7);
+		stLevel->arGuardTile[iGuardLoop]++;
+		/*** Get the direction bit. ***/
+		if (arLevel[iTiles] >= 128)
+		{
+			stLevel->arGuardDir[iGuardLoop] = 0xFF; /*** l ***/
+		} else {
+			stLevel->arGuardDir[iGuardLoop] = 0x00; /*** r ***/
+		}
+/***
+		switch (arLevel[iTiles] & 1) // 1 = 00000001
+		{
+			case 1: stLevel->arGuardDir[iGuardLoop] = 0xFF; break; // l
+			case 0: stLevel->arGuardDir[iGuardLoop] = 0x00; break; // r
+		}
+***/
+
+		if (iDebug == 1)
+		{
+			if (stLevel->arGuardTile[iGuardLoop] <= TILES)
+			{
+				printf ("[ INFO ] A guard in room: %i, tile %i, turned: %c\n",
+					iGuardLoop, stLevel->arGuardTile[iGuardLoop],
+					cShowDirection (stLevel->arGuardDir[iGuardLoop]));
 			}
 		}
+	}
 
-		PrIfDe ("[  OK  ] Checking for broken room links.\n");
-		arBrokenRoomLinks[iLevel] = BrokenRoomLinks (1);
+	/*** Extract events, up to the 0xFF. ***/
+	stLevel->iNrEvents = 0;
+	for (iEventLoop = 1; iEventLoop <= EVENTS + 1; iEventLoop++)
+	{
+		iEventStart = iTiles + ((iEventLoop - 1) * 5);
+		if (iEventStart + 1 >= iSize) { return (0); }
+		if (arLevel[iEventStart + 1] == 0xFF) { break; }
+		if ((iEventLoop > EVENTS) || (iEventStart + 5 >= iSize)) { return (0); }
+		stLevel->arEventsFromRoom[iEventLoop] = arLevel[iEventStart + 1];
+		stLevel->arEventsFromTile[iEventLoop] = arLevel[iEventStart + 2] + 1;
+		stLevel->arEventsOpenClose[iEventLoop] = arLevel[iEventStart + 3];
+		stLevel->arEventsToRoom[iEventLoop] = arLevel[iEventStart + 4];
+		stLevel->arEventsToTile[iEventLoop] = arLevel[iEventStart + 5] + 1;
+		stLevel->iNrEvents++;
 
 		if (iDebug == 1)
 		{
-			printf ("[  OK  ] Done processing level %i.\n\n", iLevel);
+			printf ("[ INFO ] Event: room %i, tile %i -%c- room %i tile %i\n",
+				stLevel->arEventsFromRoom[iEventLoop],
+				stLevel->arEventsFromTile[iEventLoop],
+				cShowOpenClose (stLevel->arEventsOpenClose[iEventLoop]),
+				stLevel->arEventsToRoom[iEventLoop],
+				stLevel->arEventsToTile[iEventLoop]);
 		}
 	}
 
-	close (iFd);
+	return (1);
+}
+/*****************************************************************************/
+void LoadEditorLevels (void)
+/*****************************************************************************/
+{
+	char sError[MAX_ERROR + 2];
+	int iLevelWas;
+
+	/*** Used for looping. ***/
+	int iLevelLoop;
+
+	if (LoadLevels (&stEdit, sError) == 0)
+	{
+		printf ("[FAILED] \"%s\": %s!\n", stEdit.sPathFile, sError);
+		exit (EXIT_ERROR);
+	}
+
+	/*** BrokenRoomLinks() checks the current level. ***/
+	PrIfDe ("[  OK  ] Checking for broken room links.\n");
+	iLevelWas = iCurLevel;
+	for (iLevelLoop = 1; iLevelLoop <= LEVELS; iLevelLoop++)
+	{
+		iCurLevel = iLevelLoop;
+		arBrokenRoomLinks[iLevelLoop] = BrokenRoomLinks (1);
+	}
+	iCurLevel = iLevelWas;
+}
+/*****************************************************************************/
+int DecompressLevel (struct romctx *stCtx, int iLevel, int *iOffset)
+/*****************************************************************************/
+{
+	/* Use the offsets table, since levels with identical data may share
+	 * their offset (see SaveLevels). Returns the bytes used, or -1.
+	 */
+	*iOffset = LevelOffset (stCtx, LevelEntry (iLevel));
+	if ((*iOffset < OFFSET_LEVEL0) || (*iOffset >= 0x1FFFF)) { return (-1); }
+
+	return (DecodeLevel (&stCtx->sROM[*iOffset], 0x1FFFF - *iOffset,
+		stCtx->arLevelRaw[iLevel], MAX_LEVEL_SIZE,
+		&stCtx->arLevelRawSize[iLevel]));
 }
 /*****************************************************************************/
-int DecompressLevel (int iFd, int iOffset)
+int DecodeLevel (unsigned char *sIn, int iInSize,
+	unsigned char *sOut, int iOutMax, int *iOutSize)
 /*****************************************************************************/
 {
-	int iRead;
-	unsigned char sRead[2 + 2];
-	int iEOF;
-	int iSection;
+	int iIn;
+	int iOut;
 	int iRepeatedBytes;
-	int iSubLoop;
-	int arSubFrom[256 + 2];
-	int arSubTo[256 + 2];
+	int iSize;
+	int iByte;
+	int iByteToWrite;
 	int iNrDuplicates;
 	int iNrDuplicatesNext;
-	int iHighNibble, iLowNibble;
-	int iNeedDuplicates;
-	int iByteToWrite;
-	int iDone;
+	unsigned char arSub[256 + 2];
+	unsigned char arNeedRepeat[256 + 2];
 
-	/*** Used for the level size. ***/
-	int iLevelSizeA;
-	int iLevelSizeB;
-	char sLevelSize[10 + 2];
+	/*** Used for looping. ***/
+	int iSubLoop;
 
-	lseek (iFd, iOffset, SEEK_SET);
-	iEOF = 0;
-	iSection = 0;
-	iLevelRead = 0;
-	iNrDuplicates = -1;
-	iNrDuplicatesNext = -1;
-	iRepeatedBytes = 0; /*** To prevent warnings. ***/
-	do {
-		iRead = read (iFd, sRead, 1);
-		iOffset++;
+	/*** The number of repeated bytes that have single byte replacements. ***/
+	if (iInSize < 1) { return (-1); }
+	iRepeatedBytes = sIn[0];
+	iIn = 1 + (iRepeatedBytes * 2);
+	if (iIn + 2 > iInSize) { return (-1); }
 
-		switch (iRead)
+	/* Store the repeated bytes and their single byte replacements. Walk
+	 * the pairs backwards, so that the first substitution for a byte wins.
+	 */
+	for (iByte = 0; iByte <= 0xFF; iByte++)
+	{
+		arSub[iByte] = iByte;
+		arNeedRepeat[iByte] = 0;
+	}
+	for (iSubLoop = iRepeatedBytes; iSubLoop >= 1; iSubLoop--)
+	{
+		arSub[sIn[iSubLoop * 2]] = sIn[(iSubLoop * 2) - 1];
+		arNeedRepeat[sIn[(iSubLoop * 2) - 1]] = 1;
+	}
+	if (iDebug == 1)
+	{
+		for (iSubLoop = 1; iSubLoop <= iRepeatedBytes; iSubLoop++)
 		{
-			case -1:
-				printf ("[FAILED] Could not read from \"%s\": %s!\n",
-					sPathFile, strerror (errno));
-				exit (EXIT_ERROR);
-				break;
-			case 0: iEOF = 1; break;
-			default:
-				switch (iSection)
-				{
-					case 0:
-						/* The number of repeated bytes that have single
-						 * byte replacements.
-						 */
-						iRepeatedBytes = sRead[0];
-
-						/* Store the repeated bytes and their single
-						 * byte replacements.
-						 */
-						for (iSubLoop = 1; iSubLoop <= iRepeatedBytes; iSubLoop++)
-						{
-							iRead = read (iFd, sRead, 2);
-							iOffset+=2;
-							arSubFrom[iSubLoop] = sRead[1];
-							arSubTo[iSubLoop] = sRead[0];
-							if (iDebug == 1)
-							{
-								printf ("[ INFO ] Substitute: 0x%02x -> 0x%02x\n",
-									sRead[1], sRead[0]);
-							}
-						}
-						iSection++;
-						break;
-					case 1:
-						/*** Uncompressed level size. ***/
-						iLevelSizeA = sRead[0];
-						iRead = read (iFd, sRead, 1);
-						iOffset++;
-						iLevelSizeB = sRead[0];
-						snprintf (sLevelSize, 10, "%02x%02x", iLevelSizeB, iLevelSizeA);
-						iLevelSize = strtoul (sLevelSize, NULL, 16);
-						if (iDebug == 1)
-						{
-							printf ("[ INFO ] Uncompressed level size: %i (0x%02x 0x%02x)\n",
-								iLevelSize, iLevelSizeB, iLevelSizeA);
-						}
-						iSection++;
-						break;
-					case 2:
-						/*** Level. ***/
+			printf ("[ INFO ] Substitute: 0x%02x -> 0x%02x\n",
+				sIn[iSubLoop * 2], sIn[(iSubLoop * 2) - 1]);
+		}
+	}
 
-						/*** Write the byte. ***/
-						iByteToWrite = sRead[0];
-						for (iSubLoop = 1; iSubLoop <= iRepeatedBytes; iSubLoop++)
-						{
-							if (arSubFrom[iSubLoop] == iByteToWrite)
-							{
-								iByteToWrite = arSubTo[iSubLoop];
-								break;
-							}
-						}
-						arLevel[iLevelRead] = iByteToWrite;
-						iLevelRead++;
+	/*** Uncompressed level size. ***/
+	iSize = sIn[iIn] + (sIn[iIn + 1] << 8);
+	if (iDebug == 1)
+	{
+		printf ("[ INFO ] Uncompressed level size: %i (0x%02x 0x%02x)\n",
+			iSize, sIn[iIn + 1], sIn[iIn]);
+	}
+	iIn+=2;
 
-						/*** Does the last byte need duplicates? ***/
-						iNeedDuplicates = 0;
-						for (iSubLoop = 1; iSubLoop <= iRepeatedBytes; iSubLoop++)
-						{
-							if (arSubTo[iSubLoop] == sRead[0])
-							{
-								iNeedDuplicates = 1;
-							}
-						}
+	/*** Level. ***/
+	iOut = 0;
+	iNrDuplicatesNext = -1;
+	while (iOut < iSize)
+	{
+		if ((iIn >= iInSize) || (iOut >= iOutMax)) { return (-1); }
 
-						/*** Add duplicates. ***/
-						if (iNeedDuplicates == 1)
-						{
-							iDone = 0;
-							do {
-								if ((iNrDuplicates == -1) && (iNrDuplicatesNext != -1))
-								{
-									iNrDuplicates = iNrDuplicatesNext;
-									iNrDuplicatesNext = -1;
-								}
+		/*** Write the byte. ***/
+		iByte = sIn[iIn];
+		iIn++;
+		iByteToWrite = arSub[iByte];
+		sOut[iOut] = iByteToWrite;
+		iOut++;
 
-								if (iNrDuplicates == -1)
-								{
-									iRead = read (iFd, sRead, 1);
-									iOffset++;
-									iHighNibble = sRead[0] >> 4;
-									iLowNibble = sRead[0] & 0x0F; /*** 0F = 00001111 ***/
-									if (iDebug == 1)
-									{
-										printf ("[ INFO ] Duplicate (0x%02x): hi %i lo %i\n",
-											sRead[0], iHighNibble, iLowNibble);
-									}
-									iNrDuplicates = iHighNibble;
-									iNrDuplicatesNext = iLowNibble;
-								}
-								AddDuplicates (iByteToWrite, iNrDuplicates);
-								if (iNrDuplicates != 0x0F) { iDone = 1; }
-								iNrDuplicates = -1;
-							} while (iDone == 0);
-						}
-						break;
+		/*** Does the last byte need duplicates? ***/
+		if (arNeedRepeat[iByte] == 0) { continue; }
+
+		/*** Add duplicates. ***/
+		do {
+			if (iNrDuplicatesNext != -1)
+			{
+				iNrDuplicates = iNrDuplicatesNext;
+				iNrDuplicatesNext = -1;
+			} else {
+				if (iIn >= iInSize) { return (-1); }
+				iNrDuplicates = sIn[iIn] >> 4;
+				iNrDuplicatesNext = sIn[iIn] & 0x0F; /*** 0F = 00001111 ***/
+				if (iDebug == 1)
+				{
+					printf ("[ INFO ] Duplicate (0x%02x): hi %i lo %i\n",
+						sIn[iIn], iNrDuplicates, iNrDuplicatesNext);
 				}
-				break;
-		}
-	} while ((iEOF == 0) && ((iLevelRead < iLevelSize) || (iLevelSize == 0)));
-	iOffset--;
+				iIn++;
+			}
+			if (iOut + iNrDuplicates > iOutMax) { return (-1); }
+			memset (&sOut[iOut], iByteToWrite, iNrDuplicates);
+			iOut+=iNrDuplicates;
+		} while (iNrDuplicates == 0x0F);
+	}
+	*iOutSize = iOut;
 
-	return (iOffset);
+	return (iIn);
 }
 /*****************************************************************************/
-void SaveLevels (void)
+int LevelAtLoop (int iLevelLoop)
 /*****************************************************************************/
 {
-	int iFd;
-	int iByte;
-	int iBit;
+	/*** The order in the ROM. We present level 0 to users as level 15. ***/
+	switch (iLevelLoop)
+	{
+		case 1: return (15); break;
+		case 16: return (16); break;
+		case 17: return (17); break;
+	}
+	return (iLevelLoop - 1);
+}
+/*****************************************************************************/
+int LevelEntry (int iLevel)
+/*****************************************************************************/
+{
+	/*** Entry 15 is the princess room, and entry 16 is level 0 again. ***/
+	switch (iLevel)
+	{
+		case 15: return (0); break;
+		case 16: return (17); break;
+		case 17: return (18); break;
+	}
+	return (iLevel);
+}
+/*****************************************************************************/
+int LevelOffset (struct romctx *stCtx, int iEntry)
+/*****************************************************************************/
+{
+	/*** Little-endian; LoadLevels checks that the table is there. ***/
+	return (OFFSET_BANK + stCtx->sROM[OFFSET_TABLE + (iEntry * 2)] +
+		(stCtx->sROM[OFFSET_TABLE + (iEntry * 2) + 1] << 8));
+}
+/*****************************************************************************/
+int SaveLevels (void)
+/*****************************************************************************/
+{
+	int iOffset;
 	int iBytesOut;
-	int iBytesOutTotal;
-	char sToWrite[MAX_TOWRITE + 2];
+	int iBytesShared;
 	int iLevel;
-	off_t oOffset;
 	int arRelativeOffset[LEVELS + 2];
-	int iNrFF, iNrFFLoop;
+	int iRelativeOffset;
+	int iUnknownOffset;
+	int iSame;
+	int iNrFF;
 	char sWarning[MAX_WARNING + 2];
+	unsigned char arTable[(LEVELS + 2) * 2];
+	int iTable;
 
 	/*** Used for looping. ***/
-	int iRoomLoop;
-	int iTileLoop;
-	int iEventLoop;
-	int iByteLoop;
 	int iLevelLoop;
+	int iSameLoop;
 
-	iFd = open (sPathFile, O_WRONLY|O_BINARY);
-	if (iFd == -1)
+	/*** Serialize and compress the changed levels. ***/
+	for (iLevel = 1; iLevel <= LEVELS; iLevel++)
 	{
-		printf ("[ WARN ] Could not open \"%s\": %s!\n",
-			sPathFile, strerror (errno));
+		if (stEdit.arLevelDirty[iLevel] == 0) { continue; }
+		stEdit.arLevelRawSize[iLevel] = SerializeLevel (&stEdit, iLevel,
+			stEdit.arLevelRaw[iLevel]);
+		if (iDebug == 1)
+			{ printf ("[ INFO ] Compressing changed level %i.\n", iLevel); }
 	}
+	CompressLevels();
 
-	lseek (iFd, OFFSET_LEVEL0, SEEK_SET);
-	iBytesOutTotal = 0;
+	iOffset = OFFSET_LEVEL0;
+	iBytesShared = 0;
+	iRelativeOffset = OFFSET_LEVEL0 - OFFSET_BANK;
+	iUnknownOffset = 0; /*** To prevent warnings. ***/
 
 	for (iLevelLoop = 1; iLevelLoop <= LEVELS; iLevelLoop++)
 	{
-		switch (iLevelLoop)
-		{
-			case 1: iLevel = 15; break;
-			case 16: iLevel = 16; break;
-			case 17: iLevel = 17; break;
-			default: iLevel = iLevelLoop - 1; break;
-		}
+		iLevel = LevelAtLoop (iLevelLoop);
 
 		if (iLevel == 16)
 		{
-			write (iFd, sUnknown, UNKNOWN);
+			iUnknownOffset = iRelativeOffset;
+			ROMSetBytes (iOffset, stEdit.stRom.sUnknown, UNKNOWN);
+			iOffset+=UNKNOWN;
+			iRelativeOffset+=UNKNOWN;
 		}
 
 		/*** Remember the new level start offsets. ***/
-		arRelativeOffset[iLevelLoop] = 0x5CC4 + iBytesOutTotal;
-
-		iByte = 0;
-		for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-		{
-			for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-			{
-				arLevel[iByte] = arRoomTiles[iLevel][iRoomLoop][iTileLoop];
-				if (arLevel[iByte] == 0xFF) { iTileLoop+=29; }
-				iByte++;
-			}
-		}
-
-		/*** Room links. ***/
-		for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-		{
-			arLevel[iByte] = arRoomLinks[iLevel][iRoomLoop][1];
-			arLevel[iByte + 1] = arRoomLinks[iLevel][iRoomLoop][2];
-			arLevel[iByte + 2] = arRoomLinks[iLevel][iRoomLoop][3];
-			arLevel[iByte + 3] = arRoomLinks[iLevel][iRoomLoop][4];
-			iByte+=4;
-		}
+		arRelativeOffset[iLevelLoop] = iRelativeOffset;
 
-		/*** Start location. ***/
-		arLevel[iByte] = arStartLocation[iLevel][1];
-		arLevel[iByte + 1] = arStartLocation[iLevel][2] - 1;
-		arLevel[iByte + 2] = arStartLocation[iLevel][3];
-		iByte+=3;
+		iBytesOut = stEdit.arLevelOutSize[iLevel];
 
-		/*** Guards. ***/
-		for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+		/* With --share-levels, a level that is identical to a level that has
+		 * already been written simply gets the same offset.
+		 */
+		if (iShareLevels == 1)
 		{
-			arLevel[iByte] = arGuardTile[iLevel][iRoomLoop] - 1;
-
-			/*** Make room for - by setting - the direction bit. ***/
-			arLevel[iByte] = arLevel[iByte] + 128;
-
-			/*** Obtain direction bit. ***/
-			switch (arGuardDir[iLevel][iRoomLoop])
+			for (iSameLoop = 1; iSameLoop < iLevelLoop; iSameLoop++)
 			{
-				case 0xFF: iBit = 1; break; /*** l ***/
-				case 0x00: iBit = 0; break; /*** r ***/
-				default:
-					printf ("[FAILED] Incorrect direction: 0x%02x\n",
-						arGuardDir[iLevel][iRoomLoop]);
-					exit (EXIT_ERROR);
+				iSame = LevelAtLoop (iSameLoop);
+				if ((stEdit.arLevelOutSize[iSame] == iBytesOut) &&
+					(memcmp (stEdit.arLevelOut[iSame], stEdit.arLevelOut[iLevel],
+					iBytesOut) == 0))
+				{
+					arRelativeOffset[iLevelLoop] = arRelativeOffset[iSameLoop];
+					iBytesShared+=iBytesOut;
+					iBytesOut = 0;
+					if (iDebug == 1)
+					{
+						printf ("[ INFO ] Level %i shares the data of level %i.\n",
+							iLevel, iSame);
+					}
 					break;
+				}
 			}
-
-			/*** Set direction bit. Again, thanks Stack Overflow. ***/
-			arLevel[iByte]
-				^= (-iBit ^ arLevel[iByte]) & (1 << 7);
-
-			iByte++;
-		}
-
-		/*** Events. ***/
-		for (iEventLoop = 1; iEventLoop <= arNrEvents[iLevel]; iEventLoop++)
-		{
-			arLevel[iByte] = arEventsFromRoom[iLevel][iEventLoop];
-			arLevel[iByte + 1] = arEventsFromTile[iLevel][iEventLoop] - 1;
-			arLevel[iByte + 2] = arEventsOpenClose[iLevel][iEventLoop];
-			arLevel[iByte + 3] = arEventsToRoom[iLevel][iEventLoop];
-			arLevel[iByte + 4] = arEventsToTile[iLevel][iEventLoop] - 1;
-			iByte+=5;
-		}
-
-		/*** End. ***/
-		arLevel[iByte] = 0xFF;
-		iByte++;
-
-		iBytesOut = CompressLevel (iByte);
-
-		for (iByteLoop = 0; iByteLoop < iBytesOut; iByteLoop++)
-		{
-			snprintf (sToWrite, MAX_TOWRITE, "%c", arLevelOut[iByteLoop]);
-			write (iFd, sToWrite, 1);
 		}
 
-		iBytesOutTotal+=iBytesOut;
+		ROMSetBytes (iOffset, stEdit.arLevelOut[iLevel], iBytesOut);
+		iOffset+=iBytesOut;
+		iRelativeOffset+=iBytesOut;
 	}
 
 	/*** Fill the rest with 0xFF. ***/
-	oOffset = lseek (iFd, 0, SEEK_CUR);
-	iNrFF = 0x1FFFF - oOffset;
-	snprintf (sToWrite, MAX_TOWRITE, "%c", 0xFF);
-	for (iNrFFLoop = 1; iNrFFLoop <= iNrFF; iNrFFLoop++)
-		{ write (iFd, sToWrite, 1); }
+	iNrFF = 0x1FFFF - iOffset;
+	ROMFill (iOffset, 0xFF, iNrFF);
 	if (iNrFF <= WARN_BYTES_FREE)
 	{
 		snprintf (sWarning, MAX_WARNING,
 			"All levels combined leave only %i free bytes! Use fewer rooms.", iNrFF);
 		printf ("[ WARN ] %s\n", sWarning);
-		SDL_ShowSimpleMessageBox (SDL_MESSAGEBOX_WARNING,
-			"Warning", sWarning, window);
+		if (iHeadless == 0)
+		{
+			SDL_ShowSimpleMessageBox (SDL_MESSAGEBOX_WARNING,
+				"Warning", sWarning, window);
+		}
 	} else if (iDebug == 1) {
 		printf ("[ INFO ] Free bytes left in the levels area: %i\n", iNrFF);
 	}
 
 	/*** Store the new level start offsets to the offsets table. ***/
-	lseek (iFd, 0x1DC2C, SEEK_SET);
-	/*** 0-15 ***/
-	for (iLevelLoop = 1; iLevelLoop < LEVELS; iLevelLoop++)
+	iTable = 0;
+	/*** 0-14 ***/
+	for (iLevelLoop = 1; iLevelLoop < 16; iLevelLoop++)
 	{
-		sToWrite[0] = (arRelativeOffset[iLevelLoop] >> 0) & 0xFF;
-		sToWrite[1] = (arRelativeOffset[iLevelLoop] >> 8) & 0xFF;
-		write (iFd, sToWrite, 2);
+		arTable[iTable++] = (arRelativeOffset[iLevelLoop] >> 0) & 0xFF;
+		arTable[iTable++] = (arRelativeOffset[iLevelLoop] >> 8) & 0xFF;
 	}
+	/*** The princess room. ***/
+	arTable[iTable++] = (iUnknownOffset >> 0) & 0xFF;
+	arTable[iTable++] = (iUnknownOffset >> 8) & 0xFF;
 	/*** 0 ***/
-	sToWrite[0] = (arRelativeOffset[1] >> 0) & 0xFF;
-	sToWrite[1] = (arRelativeOffset[1] >> 8) & 0xFF;
-	write (iFd, sToWrite, 2);
+	arTable[iTable++] = (arRelativeOffset[1] >> 0) & 0xFF;
+	arTable[iTable++] = (arRelativeOffset[1] >> 8) & 0xFF;
 	/*** 16 ***/
-	sToWrite[0] = ((arRelativeOffset[16] + UNKNOWN) >> 0) & 0xFF;
-	sToWrite[1] = ((arRelativeOffset[16] + UNKNOWN) >> 8) & 0xFF;
-	write (iFd, sToWrite, 2);
+	arTable[iTable++] = (arRelativeOffset[16] >> 0) & 0xFF;
+	arTable[iTable++] = (arRelativeOffset[16] >> 8) & 0xFF;
 	/*** 17 ***/
-	sToWrite[0] = ((arRelativeOffset[17] + UNKNOWN) >> 0) & 0xFF;
-	sToWrite[1] = ((arRelativeOffset[17] + UNKNOWN) >> 8) & 0xFF;
-	write (iFd, sToWrite, 2);
+	arTable[iTable++] = (arRelativeOffset[17] >> 0) & 0xFF;
+	arTable[iTable++] = (arRelativeOffset[17] >> 8) & 0xFF;
+	ROMSetBytes (OFFSET_TABLE, arTable, iTable);
 
-	close (iFd);
+	/* Replace the ROM with the image, all at once. If that fails, the levels
+	 * stay marked as changed, so that saving can be tried again.
+	 */
+	if (ROMFlush() == 0)
+	{
+		printf ("[FAILED] Could not save the levels!\n");
+		if (iHeadless == 0)
+		{
+			SDL_ShowSimpleMessageBox (SDL_MESSAGEBOX_ERROR, "Error",
+				"Could not save the levels. See the console for details.", window);
+		}
+		return (0);
+	}
+
+	if (iShareLevels == 1)
+	{
+		printf ("[ INFO ] Sharing identical levels saved %i bytes.\n",
+			iBytesShared);
+	}
 
 	PlaySound ("wav/save.wav");
 
+	/*** The compressed levels now match the file. ***/
+	for (iLevel = 1; iLevel <= LEVELS; iLevel++)
+		{ stEdit.arLevelDirty[iLevel] = 0; }
 	iChanged = 0;
+
+	return (1);
+}
+/*****************************************************************************/
+int SerializeLevel (struct romctx *stCtx, int iLevel, unsigned char *sOut)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	int iByte;
+	int iBit;
+
+	/*** Used for looping. ***/
+	int iRoomLoop;
+	int iTileLoop;
+	int iEventLoop;
+
+	stLevel = &stCtx->stRom.arLevel[iLevel];
+
+	iByte = 0;
+	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+	{
+		for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+		{
+			sOut[iByte] = stLevel->arRoomTiles[iRoomLoop][iTileLoop];
+			if (sOut[iByte] == 0xFF) { iTileLoop+=29; }
+			iByte++;
+		}
+	}
+
+	/*** Room links. ***/
+	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+	{
+		sOut[iByte] = stLevel->arRoomLinks[iRoomLoop][1];
+		sOut[iByte + 1] = stLevel->arRoomLinks[iRoomLoop][2];
+		sOut[iByte + 2] = stLevel->arRoomLinks[iRoomLoop][3];
+		sOut[iByte + 3] = stLevel->arRoomLinks[iRoomLoop][4];
+		iByte+=4;
+	}
+
+	/*** Start location. ***/
+	sOut[iByte] = stLevel->arStartLocation[1];
+	sOut[iByte + 1] = stLevel->arStartLocation[2] - 1;
+	sOut[iByte + 2] = stLevel->arStartLocation[3];
+	iByte+=3;
+
+	/*** Guards. ***/
+	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+	{
+		sOut[iByte] = stLevel->arGuardTile[iRoomLoop] - 1;
+
+		/*** Make room for - by setting - the direction bit. ***/
+		sOut[iByte] = sOut[iByte] + 128;
+
+		/*** Obtain direction bit. ***/
+		switch (stLevel->arGuardDir[iRoomLoop])
+		{
+			case 0xFF: iBit = 1; break; /*** l ***/
+			case 0x00: iBit = 0; break; /*** r ***/
+			default:
+				printf ("[FAILED] Incorrect direction: 0x%02x\n",
+					stLevel->arGuardDir[iRoomLoop]);
+				exit (EXIT_ERROR);
+				break;
+		}
+
+		/*** Set direction bit. Again, thanks Stack Overflow. ***/
+		sOut[iByte]
+			^= (-iBit ^ sOut[iByte]) & (1 << 7);
+
+		iByte++;
+	}
+
+	/*** Events. ***/
+	for (iEventLoop = 1; iEventLoop <= stLevel->iNrEvents; iEventLoop++)
+	{
+		sOut[iByte] = stLevel->arEventsFromRoom[iEventLoop];
+		sOut[iByte + 1] = stLevel->arEventsFromTile[iEventLoop] - 1;
+		sOut[iByte + 2] = stLevel->arEventsOpenClose[iEventLoop];
+		sOut[iByte + 3] = stLevel->arEventsToRoom[iEventLoop];
+		sOut[iByte + 4] = stLevel->arEventsToTile[iEventLoop] - 1;
+		iByte+=5;
+	}
+
+	/*** End. ***/
+	sOut[iByte] = 0xFF;
+	iByte++;
+
+	return (iByte);
 }
 /*****************************************************************************/
 void PrintTileName (int iLevel, int iRoom, int iTile, int iTileValue)
@@ -1300,18 +2243,6 @@ void PrintTileName (int iLevel, int iRoom, int iTile, int iTileValue)
 	}
 }
 /*****************************************************************************/
-void AddDuplicates (int iByteToWrite, int iNrDuplicates)
-/*****************************************************************************/
-{
-	int iDupLoop;
-
-	for (iDupLoop = 1; iDupLoop <= iNrDuplicates; iDupLoop++)
-	{
-		arLevel[iLevelRead] = iByteToWrite;
-		iLevelRead++;
-	}
-}
-/*****************************************************************************/
 void PrIfDe (char *sString)
 /*****************************************************************************/
 {
@@ -1340,66 +2271,284 @@ char cShowOpenClose (int iOpenClose)
 	return ('?');
 }
 /*****************************************************************************/
-int CompressLevel (int iNrBytes)
+void CompressLevels (void)
+/*****************************************************************************/
+{
+	int iLevel;
+
+	/*** Unchanged levels keep their compressed data. ***/
+	for (iLevel = 1; iLevel <= LEVELS; iLevel++)
+	{
+		if (stEdit.arLevelDirty[iLevel] == 0) { continue; }
+		stEdit.arLevelOutSize[iLevel] = CompressLevel (stEdit.arLevelRaw[iLevel],
+			stEdit.arLevelRawSize[iLevel], stEdit.arLevelOut[iLevel]);
+	}
+}
+/*****************************************************************************/
+int CompressLevel (unsigned char *sIn, int iNrBytes, unsigned char *sOut)
 /*****************************************************************************/
 {
-	unsigned char cLastByte;
+	struct packer stPacker;
 	unsigned char cProcessingByte;
-	unsigned char arBytesUnused[BYTE_SIZE + 2];
 	unsigned char arBytesRepeated[BYTE_SIZE + 2];
 	unsigned char arBytesReplace[BYTE_SIZE + 2];
-	int arBytesSame[BYTE_SIZE + 2];
-	int arBytesNotSame[BYTE_SIZE + 2];
-	int arCouldSave[BYTE_SIZE + 2];
+	int arCount[BYTE_SIZE + 2];
+	int arRuns[BYTE_SIZE + 2];
+	int arSingles[BYTE_SIZE + 2];
+	int arNibbles[BYTE_SIZE + 2];
 	int iNrRepeated;
 	int iByte;
-	int iCouldSave;
 	int iRepeatedBytes;
 
 	/*** Used for looping. ***/
 	int iByteLoop;
-	int iByteLoop2;
 
-	/*** Defaults. ***/
-	iOutOffset = 0;
-	iRepeatedBytes = 0;
-	iByte = 1;
-	cLastByte = arLevel[0];
+	CountRuns (sIn, iNrBytes, arCount, arRuns, arSingles, arNibbles);
+	iRepeatedBytes = PlanGreedy (arCount, arRuns, arSingles, arNibbles,
+		arBytesRepeated, arBytesReplace);
+
+	/* The number of repeated bytes that have single
+	 * byte replacements.
+	 */
+	stPacker.sOut = sOut;
+	stPacker.iOutOffset = 0;
+	sOut[stPacker.iOutOffset] = iRepeatedBytes;
+	stPacker.iOutOffset++;
+
+	/*** Add the repeated bytes and their single byte replacements. ***/
+	if (iRepeatedBytes > 0)
+	{
+		for (iByteLoop = 0; iByteLoop <= BYTE_SIZE; iByteLoop++)
+		{
+			if (arBytesRepeated[iByteLoop] != 0)
+			{
+				sOut[stPacker.iOutOffset] = iByteLoop;
+				sOut[stPacker.iOutOffset + 1] = arBytesReplace[iByteLoop];
+				stPacker.iOutOffset+=2;
+			}
+		}
+	}
+
+	/*** Uncompressed level size. ***/
+	sOut[stPacker.iOutOffset] = (iNrBytes >> 0) & 0xFF;
+	sOut[stPacker.iOutOffset + 1] = (iNrBytes >> 8) & 0xFF;
+	stPacker.iOutOffset+=2;
+
+	stPacker.iRepeatOffset = 0;
+	stPacker.iHighStore = 0;
+	iByte = 0;
+	while (iByte < iNrBytes)
+	{
+		cProcessingByte = sIn[iByte];
+		iByte++;
+		sOut[stPacker.iOutOffset] = cProcessingByte;
+		stPacker.iOutOffset++;
+		if (arBytesRepeated[cProcessingByte] != 0)
+		{
+			iNrRepeated = 0;
+			while (sIn[iByte] == cProcessingByte)
+			{
+				iByte++;
+				iNrRepeated++;
+			}
+
+			if (iNrRepeated != 0)
+			{
+				/* Separate repeat counts never exceed 0x0F, because half a
+				 * byte is 4 bits, which is 15.
+				 */
+				while (iNrRepeated >= 0x0F)
+				{
+					AddRepeat (&stPacker, 0x0F);
+					iNrRepeated-=0x0F;
+				}
+				AddRepeat (&stPacker, iNrRepeated);
+			} else {
+				if (arBytesRepeated[cProcessingByte] == 1)
+				{
+					AddRepeat (&stPacker, 0);
+				} else {
+					/*** Replace single occurrences of bytes that get repeat counts. ***/
+					sOut[stPacker.iOutOffset - 1] = arBytesReplace[cProcessingByte];
+				}
+			}
+		}
+	}
+
+	/* If we are still remembering a repeat count (iHighStore), we must
+	 * add it to the level. By itself, without another repeat count.
+	 */
+	if (stPacker.iRepeatOffset != 0) { AddRepeat (&stPacker, 0); }
+
+	return (stPacker.iOutOffset);
+}
+/*****************************************************************************/
+void CountRuns (unsigned char *sIn, int iNrBytes, int *arCount,
+	int *arRuns, int *arSingles, int *arNibbles)
+/*****************************************************************************/
+{
+	unsigned char cByte;
+	int iByte;
+	int iLength;
+
+	/*** Used for looping. ***/
+	int iByteLoop;
+
 	for (iByteLoop = 0; iByteLoop <= BYTE_SIZE; iByteLoop++)
 	{
-		arBytesUnused[iByteLoop] = 0;
-		arCouldSave[iByteLoop] = 0;
-		arBytesRepeated[iByteLoop] = 0;
-		arBytesSame[iByteLoop] = 0;
-		arBytesNotSame[iByteLoop] = 0;
+		arCount[iByteLoop] = 0;
+		arRuns[iByteLoop] = 0;
+		arSingles[iByteLoop] = 0;
+		arNibbles[iByteLoop] = 0;
 	}
 
 	/*** Force the very last byte to be different from the previous. ***/
-	switch (arLevel[iNrBytes - 1])
+	switch (sIn[iNrBytes - 1])
 	{
-		case 0: arLevel[iNrBytes] = 1; break;
-		default: arLevel[iNrBytes] = 0; break;
+		case 0: sIn[iNrBytes] = 1; break;
+		default: sIn[iNrBytes] = 0; break;
 	}
 
-	/* For all bytes, check how many times they are the same as previous bytes
-	 * and how many of them are not.
+	/* For every run of identical bytes, remember its length, and how many
+	 * (half byte) repeat counts it would need. If the CPU allows it, most
+	 * runs are found with vectors; these return where the last run they
+	 * did not finish starts.
+	 */
+	iByte = 0;
+#ifdef RUNS_X86
+	switch (iRunsSIMD)
+	{
+		case RUNS_SSE2: iByte = RunsSSE2 (sIn, iNrBytes,
+			arCount, arRuns, arSingles, arNibbles); break;
+		case RUNS_AVX2: iByte = RunsAVX2 (sIn, iNrBytes,
+			arCount, arRuns, arSingles, arNibbles); break;
+	}
+#endif
+	while (iByte < iNrBytes)
+	{
+		cByte = sIn[iByte];
+		iLength = 1;
+		while (sIn[iByte + iLength] == cByte) { iLength++; }
+		AddRun (cByte, iLength, arCount, arRuns, arSingles, arNibbles);
+		iByte+=iLength;
+	}
+}
+/*****************************************************************************/
+void AddRun (unsigned char cByte, int iLength, int *arCount,
+	int *arRuns, int *arSingles, int *arNibbles)
+/*****************************************************************************/
+{
+	arCount[cByte]+=iLength;
+	arRuns[cByte]++;
+	if (iLength == 1) { arSingles[cByte]++; }
+	arNibbles[cByte]+=((iLength - 1) / 0x0F) + 1;
+}
+#ifdef RUNS_X86
+/*****************************************************************************/
+__attribute__((target("sse2")))
+int RunsSSE2 (unsigned char *sIn, int iNrBytes, int *arCount,
+	int *arRuns, int *arSingles, int *arNibbles)
+/*****************************************************************************/
+{
+	__m128i vThis, vNext;
+	unsigned int iEnds;
+	int iStart;
+	int iEnd;
+
+	/*** Used for looping. ***/
+	int iByteLoop;
+
+	/* Comparing 16 bytes with the 16 bytes that follow them gives a bit
+	 * for every byte that ends a run. Because of the extra byte that
+	 * CountRuns adds, sIn[iNrBytes] may be read.
 	 */
-	while (iByte <= iNrBytes)
+	iStart = 0;
+	for (iByteLoop = 0; iByteLoop + 16 <= iNrBytes; iByteLoop+=16)
 	{
-		iNrRepeated = 0;
-		while (arLevel[iByte++] == cLastByte)
+		vThis = _mm_loadu_si128 ((__m128i *)&sIn[iByteLoop]);
+		vNext = _mm_loadu_si128 ((__m128i *)&sIn[iByteLoop + 1]);
+		iEnds = ~(unsigned int)_mm_movemask_epi8
+			(_mm_cmpeq_epi8 (vThis, vNext)) & 0xFFFF;
+		while (iEnds != 0)
 		{
-			/*** Do not move iByte++ here. ***/
-			iNrRepeated++;
+			iEnd = iByteLoop + __builtin_ctz (iEnds);
+			AddRun (sIn[iEnd], iEnd - iStart + 1,
+				arCount, arRuns, arSingles, arNibbles);
+			iStart = iEnd + 1;
+			iEnds&=iEnds - 1; /*** Clear the lowest bit. ***/
 		}
-		if (iNrRepeated != 0)
+	}
+
+	return (iStart);
+}
+/*****************************************************************************/
+__attribute__((target("avx2")))
+int RunsAVX2 (unsigned char *sIn, int iNrBytes, int *arCount,
+	int *arRuns, int *arSingles, int *arNibbles)
+/*****************************************************************************/
+{
+	__m256i vThis, vNext;
+	unsigned int iEnds;
+	int iStart;
+	int iEnd;
+
+	/*** Used for looping. ***/
+	int iByteLoop;
+
+	/*** The same as RunsSSE2, with 32 bytes at a time. ***/
+	iStart = 0;
+	for (iByteLoop = 0; iByteLoop + 32 <= iNrBytes; iByteLoop+=32)
+	{
+		vThis = _mm256_loadu_si256 ((__m256i *)&sIn[iByteLoop]);
+		vNext = _mm256_loadu_si256 ((__m256i *)&sIn[iByteLoop + 1]);
+		iEnds = ~(unsigned int)_mm256_movemask_epi8
+			(_mm256_cmpeq_epi8 (vThis, vNext));
+		while (iEnds != 0)
 		{
-			arBytesSame[cLastByte] = arBytesSame[cLastByte]
-				+ (iNrRepeated * 2) - ((iNrRepeated / 0x0F) + 1);
-		} else {
-			arBytesNotSame[cLastByte]++;
+			iEnd = iByteLoop + __builtin_ctz (iEnds);
+			AddRun (sIn[iEnd], iEnd - iStart + 1,
+				arCount, arRuns, arSingles, arNibbles);
+			iStart = iEnd + 1;
+			iEnds&=iEnds - 1; /*** Clear the lowest bit. ***/
 		}
-		cLastByte = arLevel[iByte - 1];
+	}
+
+	return (iStart);
+}
+#endif
+/*****************************************************************************/
+int PlanGreedy (int *arCount, int *arRuns, int *arSingles, int *arNibbles,
+	unsigned char *arBytesRepeated, unsigned char *arBytesReplace)
+/*****************************************************************************/
+{
+	unsigned char arBytesUnused[BYTE_SIZE + 2];
+	int arBytesSame[BYTE_SIZE + 2];
+	int arBytesNotSame[BYTE_SIZE + 2];
+	int arCouldSave[BYTE_SIZE + 2];
+	int iByte;
+	int iCouldSave;
+	int iRepeatedBytes;
+
+	/*** Used for looping. ***/
+	int iByteLoop;
+	int iByteLoop2;
+
+	/* For all bytes, check how many times they are the same as previous bytes
+	 * and how many of them are not.
+	 * The cost of every byte only depends on its own choice, except that
+	 * each replacement needs an unused byte. Handing the unused bytes to
+	 * the largest arCouldSave[] values therefore gives the smallest output
+	 * there is for this format.
+	 */
+	iRepeatedBytes = 0;
+	for (iByteLoop = 0; iByteLoop <= BYTE_SIZE; iByteLoop++)
+	{
+		arBytesUnused[iByteLoop] = 0;
+		arCouldSave[iByteLoop] = 0;
+		arBytesRepeated[iByteLoop] = 0;
+		arBytesSame[iByteLoop] = ((arCount[iByteLoop] - arRuns[iByteLoop]) * 2)
+			- (arNibbles[iByteLoop] - arSingles[iByteLoop]);
+		arBytesNotSame[iByteLoop] = arSingles[iByteLoop];
 	}
 
 	/*** Mark unused bytes for later use. ***/
@@ -1451,6 +2600,9 @@ int CompressLevel (int iNrBytes)
 				}
 			}
 
+			/*** Nothing left to save, for any of the other unused bytes. ***/
+			if (iCouldSave == 0) { break; }
+
 			if (arCouldSave[iByte] > 0)
 			{
 				/*** iByteLoop will replace iByte. ***/
@@ -1471,2185 +2623,4968 @@ int CompressLevel (int iNrBytes)
 		}
 	}
 
-	/* The number of repeated bytes that have single
-	 * byte replacements.
-	 */
-	arLevelOut[iOutOffset] = iRepeatedBytes;
-	iOutOffset++;
-
-	/*** Add the repeated bytes and their single byte replacements. ***/
-	if (iRepeatedBytes > 0)
-	{
-		for (iByteLoop = 0; iByteLoop <= BYTE_SIZE; iByteLoop++)
-		{
-			if (arBytesRepeated[iByteLoop] != 0)
-			{
-				arLevelOut[iOutOffset] = iByteLoop;
-				arLevelOut[iOutOffset + 1] = arBytesReplace[iByteLoop];
-				iOutOffset+=2;
-			}
-		}
-	}
-
-	/*** Uncompressed level size. ***/
-	arLevelOut[iOutOffset] = (iNrBytes >> 0) & 0xFF;
-	arLevelOut[iOutOffset + 1] = (iNrBytes >> 8) & 0xFF;
-	iOutOffset+=2;
-
-	iRepeatOffset = 0;
-	iByte = 0;
-	while (iByte < iNrBytes)
-	{
-		cProcessingByte = arLevel[iByte];
-		iByte++;
-		arLevelOut[iOutOffset] = cProcessingByte;
-		iOutOffset++;
-		if (arBytesRepeated[cProcessingByte] != 0)
-		{
-			iNrRepeated = 0;
-			while (arLevel[iByte] == cProcessingByte)
-			{
-				iByte++;
-				iNrRepeated++;
-			}
-
-			if (iNrRepeated != 0)
-			{
-				/* Separate repeat counts never exceed 0x0F, because half a
-				 * byte is 4 bits, which is 15.
-				 */
-				while (iNrRepeated >= 0x0F)
-				{
-					AddRepeat (0x0F);
-					iNrRepeated-=0x0F;
-				}
-				AddRepeat (iNrRepeated);
-			} else {
-				if (arBytesRepeated[cProcessingByte] == 1)
-				{
-					AddRepeat (0);
-				} else {
-					/*** Replace single occurrences of bytes that get repeat counts. ***/
-					arLevelOut[iOutOffset - 1] = arBytesReplace[cProcessingByte];
-				}
-			}
-		}
-	}
-
-	/* If we are still remembering a repeat count (iHighStore), we must
-	 * add it to the level. By itself, without another repeat count.
-	 */
-	if (iRepeatOffset != 0) { AddRepeat (0); }
-
-	return (iOutOffset);
+	return (iRepeatedBytes);
 }
 /*****************************************************************************/
-int AddRepeat (int iNrRepeated)
+int AddRepeat (struct packer *stPacker, int iNrRepeated)
 /*****************************************************************************/
 {
-	if (iRepeatOffset != 0)
+	if (stPacker->iRepeatOffset != 0)
 	{
 		/* Store both the previous (iHighStore) and current repeat counts at
 		 * iRepeatOffset; after the byte that required a repeat.
 		 */
-		arLevelOut[iRepeatOffset] = (iHighStore << 4) + iNrRepeated;
-		iRepeatOffset = 0;
+		stPacker->sOut[stPacker->iRepeatOffset] =
+			(stPacker->iHighStore << 4) + iNrRepeated;
+		stPacker->iRepeatOffset = 0;
 	} else {
 		/*** Remember the repeat count. ***/
-		iHighStore = iNrRepeated;
-		iRepeatOffset = iOutOffset;
-		iOutOffset++;
+		stPacker->iHighStore = iNrRepeated;
+		stPacker->iRepeatOffset = stPacker->iOutOffset;
+		stPacker->iOutOffset++;
 	}
 
 	return (0);
 }
 /*****************************************************************************/
-void Quit (void)
+int PlannedSize (int *arCount, int *arRuns, int *arSingles, int *arNibbles,
+	unsigned char *arBytesRepeated, int iRepeatedBytes)
 /*****************************************************************************/
 {
-	if (iChanged != 0) { InitPopUpSave(); }
-	if (iModified == 1) { ModifyBack(); }
-	TTF_CloseFont (font1);
-	TTF_CloseFont (font2);
-	TTF_CloseFont (font3);
-	TTF_Quit();
-	SDL_Quit();
-	exit (EXIT_NORMAL);
+	int iBytes;
+	int iNibbles;
+
+	/*** Used for looping. ***/
+	int iByteLoop;
+
+	/* What CompressLevel would write: the pairs, the level size, a byte
+	 * per run of a repeated byte, other bytes as is, and two repeat
+	 * counts per byte. Single replaced bytes need no repeat count.
+	 */
+	iBytes = 1 + (iRepeatedBytes * 2) + 2;
+	iNibbles = 0;
+	for (iByteLoop = 0; iByteLoop <= BYTE_SIZE; iByteLoop++)
+	{
+		switch (arBytesRepeated[iByteLoop])
+		{
+			case 0:
+				iBytes+=arCount[iByteLoop]; break;
+			case 1:
+				iBytes+=arRuns[iByteLoop];
+				iNibbles+=arNibbles[iByteLoop];
+				break;
+			case 2:
+				iBytes+=arRuns[iByteLoop];
+				iNibbles+=arNibbles[iByteLoop] - arSingles[iByteLoop];
+				break;
+		}
+	}
+	iBytes+=(iNibbles + 1) / 2;
+
+	return (iBytes);
 }
 /*****************************************************************************/
-void InitScreen (void)
+int PlanExhaustive (int *arCount, int *arRuns, int *arSingles,
+	int *arNibbles)
 /*****************************************************************************/
 {
-	SDL_AudioSpec fmt;
-	char sImage[MAX_IMG + 2];
-	SDL_Surface *imgicon;
-	int iJoyNr;
-	SDL_Event event;
-	int iOldXPos, iOldYPos;
-	const Uint8 *keystate;
-	Uint32 oldticks, newticks;
-	int iEventRoom;
+	unsigned char arBytesRepeated[BYTE_SIZE + 2];
+	unsigned char arCandidates[BYTE_SIZE + 2];
+	int arChoice[EXHAUSTIVE_MAX + 2];
+	int iCandidates;
+	int iUnused;
+	int iReplaced;
+	int iRepeatedBytes;
+	int iSize;
+	int iSmallest;
+	int iDone;
 
 	/*** Used for looping. ***/
-	int iRoomLoop;
-	int iRoomLoop2;
-	int iTileLoop;
-	int iColLoop, iRowLoop;
-	int iAlphabetLoop;
+	int iByteLoop;
+	int iCandLoop;
 
-	if (SDL_Init (SDL_INIT_AUDIO|SDL_INIT_VIDEO|
-		SDL_INIT_GAMECONTROLLER|SDL_INIT_HAPTIC) < 0)
+	/* Returns the smallest PlannedSize() of all plans, or -1 if there are
+	 * too many candidates. A byte can only gain from repeat counts, with
+	 * or without a replacement, if it repeats more than SAVE_SPACE half
+	 * bytes; all other bytes are written as is in every smallest plan.
+	 */
+	iCandidates = 0;
+	iUnused = 0;
+	for (iByteLoop = 0; iByteLoop <= BYTE_SIZE; iByteLoop++)
 	{
-		printf ("[FAILED] Unable to init SDL: %s!\n", SDL_GetError());
-		exit (EXIT_ERROR);
+		arBytesRepeated[iByteLoop] = 0;
+		if (arCount[iByteLoop] == 0) { iUnused++; continue; }
+		if (((arCount[iByteLoop] - arRuns[iByteLoop]) * 2) -
+			(arNibbles[iByteLoop] - arSingles[iByteLoop]) > SAVE_SPACE)
+		{
+			if (iCandidates == EXHAUSTIVE_MAX) { return (-1); }
+			arCandidates[iCandidates] = iByteLoop;
+			arChoice[iCandidates] = 0;
+			iCandidates++;
+		}
 	}
-	atexit (SDL_Quit);
 
-	window = SDL_CreateWindow (EDITOR_NAME " " EDITOR_VERSION,
-		SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-		(WINDOW_WIDTH) * iScale, (WINDOW_HEIGHT) * iScale, iFullscreen);
-	if (window == NULL)
-	{
-		printf ("[FAILED] Unable to create a window: %s!\n", SDL_GetError());
-		exit (EXIT_ERROR);
-	}
-	ascreen = SDL_CreateRenderer (window, -1, 0);
-	if (ascreen == NULL)
-	{
-		printf ("[FAILED] Unable to set video mode: %s!\n", SDL_GetError());
-		exit (EXIT_ERROR);
-	}
-	/*** Some people may prefer linear, but we're going old school. ***/
-	SDL_SetHint (SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
-	if (iFullscreen != 0)
+	/* Try every plan: each candidate is written as is (0), gets repeat
+	 * counts (1), or gets repeat counts and a replacement (2). Every
+	 * replacement needs its own unused byte.
+	 */
+	iSmallest = -1;
+	iDone = 0;
+	while (iDone == 0)
 	{
-		SDL_RenderSetLogicalSize (ascreen, (WINDOW_WIDTH) * iScale,
-			(WINDOW_HEIGHT) * iScale);
-	}
+		iReplaced = 0;
+		iRepeatedBytes = 0;
+		for (iCandLoop = 0; iCandLoop < iCandidates; iCandLoop++)
+		{
+			arBytesRepeated[arCandidates[iCandLoop]] = arChoice[iCandLoop];
+			if (arChoice[iCandLoop] != 0) { iRepeatedBytes++; }
+			if (arChoice[iCandLoop] == 2) { iReplaced++; }
+		}
+		if (iReplaced <= iUnused)
+		{
+			iSize = PlannedSize (arCount, arRuns, arSingles, arNibbles,
+				arBytesRepeated, iRepeatedBytes);
+			if ((iSmallest == -1) || (iSize < iSmallest)) { iSmallest = iSize; }
+		}
 
-	if (TTF_Init() == -1)
+		/*** The next plan, counting in base 3. ***/
+		iCandLoop = 0;
+		while ((iCandLoop < iCandidates) && (arChoice[iCandLoop] == 2))
+		{
+			arChoice[iCandLoop] = 0;
+			iCandLoop++;
+		}
+		if (iCandLoop == iCandidates) { iDone = 1; }
+			else { arChoice[iCandLoop]++; }
+	}
+
+	return (iSmallest);
+}
+/*****************************************************************************/
+int LevelSize (int iLevel)
+/*****************************************************************************/
+{
+	unsigned char arRaw[MAX_LEVEL_SIZE + 2];
+	unsigned char arBytesRepeated[BYTE_SIZE + 2];
+	unsigned char arBytesReplace[BYTE_SIZE + 2];
+	int arCount[BYTE_SIZE + 2];
+	int arRuns[BYTE_SIZE + 2];
+	int arSingles[BYTE_SIZE + 2];
+	int arNibbles[BYTE_SIZE + 2];
+	int iNrBytes;
+	int iRepeatedBytes;
+
+	/*** Unchanged levels have their compressed size. ***/
+	if (stEdit.arLevelDirty[iLevel] == 0)
+		{ return (stEdit.arLevelOutSize[iLevel]); }
+
+	/* Changed levels are planned again after every edit, but not written;
+	 * this is fast enough to do while drawing.
+	 */
+	if (stEdit.arLevelDirty[iLevel] == 1)
 	{
-		printf ("[FAILED] Could not initialize TTF!\n");
+		iNrBytes = SerializeLevel (&stEdit, iLevel, arRaw);
+		CountRuns (arRaw, iNrBytes, arCount, arRuns, arSingles, arNibbles);
+		iRepeatedBytes = PlanGreedy (arCount, arRuns, arSingles, arNibbles,
+			arBytesRepeated, arBytesReplace);
+		stEdit.arLevelEstimate[iLevel] = PlannedSize (arCount, arRuns, arSingles,
+			arNibbles, arBytesRepeated, iRepeatedBytes);
+		stEdit.arLevelDirty[iLevel] = 2;
+	}
+
+	return (stEdit.arLevelEstimate[iLevel]);
+}
+/*****************************************************************************/
+int FreeBytes (void)
+/*****************************************************************************/
+{
+	int iFree;
+
+	/*** Used for looping. ***/
+	int iLevelLoop;
+
+	/*** The same as iNrFF in SaveLevels. ***/
+	iFree = 0x1FFFF - OFFSET_LEVEL0 - UNKNOWN;
+	for (iLevelLoop = 1; iLevelLoop <= LEVELS; iLevelLoop++)
+	{
+		iFree-=LevelSize (iLevelLoop);
+	}
+
+	return (iFree);
+}
+/*****************************************************************************/
+void BenchCodec (int iRuns)
+/*****************************************************************************/
+{
+	int arOrigSize[LEVELS + 2];
+	unsigned char arCheck[MAX_LEVEL_SIZE + 2];
+	int iCheckSize;
+	int iOffset;
+	int iLevel;
+	int iBytesRaw, iBytesOrig, iBytesOut;
+	Uint64 iStart;
+	double dDecode, dEncode;
+
+	/*** Used for looping. ***/
+	int iLevelLoop;
+	int iRunLoop;
+
+	/* No SDL_Init() is needed here; the performance counter works without
+	 * it. The level buffers of SaveLevels are reused.
+	 */
+	if (iRuns < 1) { iRuns = 1; }
+
+	/*** Decode every level once, to find the sizes. ***/
+	if (stEdit.iROMSize < 0x1FFFF)
+	{
+		printf ("[FAILED] \"%s\" has only %i bytes!\n",
+			stEdit.sPathFile, stEdit.iROMSize);
 		exit (EXIT_ERROR);
 	}
+	for (iLevel = 1; iLevel <= LEVELS; iLevel++)
+	{
+		arOrigSize[iLevel] = DecompressLevel (&stEdit, iLevel, &iOffset);
+		if (arOrigSize[iLevel] == -1)
+		{
+			printf ("[FAILED] Level %i in \"%s\" is damaged!\n",
+				iLevel, stEdit.sPathFile);
+			exit (EXIT_ERROR);
+		}
+	}
 
-	LoadFonts();
+	/*** Decode. ***/
+	iStart = SDL_GetPerformanceCounter();
+	for (iRunLoop = 1; iRunLoop <= iRuns; iRunLoop++)
+	{
+		for (iLevel = 1; iLevel <= LEVELS; iLevel++)
+			{ DecompressLevel (&stEdit, iLevel, &iOffset); }
+	}
+	dDecode = Seconds (iStart);
 
-	curArrow = SDL_CreateSystemCursor (SDL_SYSTEM_CURSOR_ARROW);
-	curWait = SDL_CreateSystemCursor (SDL_SYSTEM_CURSOR_WAIT);
-	curHand = SDL_CreateSystemCursor (SDL_SYSTEM_CURSOR_HAND);
-	curText = SDL_CreateSystemCursor (SDL_SYSTEM_CURSOR_IBEAM);
+	/*** Encode. ***/
+	iStart = SDL_GetPerformanceCounter();
+	for (iRunLoop = 1; iRunLoop <= iRuns; iRunLoop++)
+	{
+		for (iLevel = 1; iLevel <= LEVELS; iLevel++)
+		{
+			stEdit.arLevelOutSize[iLevel] = CompressLevel (
+				stEdit.arLevelRaw[iLevel], stEdit.arLevelRawSize[iLevel],
+				stEdit.arLevelOut[iLevel]);
+		}
+	}
+	dEncode = Seconds (iStart);
 
-	if (iNoAudio != 1)
+	/*** Verify the round trip and show the sizes. ***/
+	printf ("Level  Raw  Original  Re-encoded  Ratio\n");
+	iBytesRaw = 0;
+	iBytesOrig = 0;
+	iBytesOut = 0;
+	for (iLevelLoop = 1; iLevelLoop <= LEVELS; iLevelLoop++)
 	{
-		PrIfDe ("[  OK  ] Initializing Audio\n");
-		fmt.freq = 44100;
-		fmt.format = AUDIO_S16;
-		fmt.channels = 2;
-		fmt.samples = 512;
-		fmt.callback = MixAudio;
-		fmt.userdata = NULL;
-		if (SDL_OpenAudio (&fmt, NULL) < 0)
+		iLevel = LevelAtLoop (iLevelLoop);
+
+		if ((DecodeLevel (stEdit.arLevelOut[iLevel],
+			stEdit.arLevelOutSize[iLevel], arCheck, MAX_LEVEL_SIZE,
+			&iCheckSize) != stEdit.arLevelOutSize[iLevel]) ||
+			(iCheckSize != stEdit.arLevelRawSize[iLevel]) ||
+			(memcmp (arCheck, stEdit.arLevelRaw[iLevel], iCheckSize) != 0))
 		{
-			printf ("[FAILED] Unable to open audio: %s!\n", SDL_GetError());
+			printf ("[FAILED] Level %i does not survive a round trip!\n", iLevel);
 			exit (EXIT_ERROR);
 		}
-		SDL_PauseAudio (0);
+
+		printf ("%5i %5i %9i %11i %5.1f%%\n", iLevel,
+			stEdit.arLevelRawSize[iLevel], arOrigSize[iLevel],
+			stEdit.arLevelOutSize[iLevel], 100.0 * stEdit.arLevelOutSize[iLevel] /
+			stEdit.arLevelRawSize[iLevel]);
+		iBytesRaw+=stEdit.arLevelRawSize[iLevel];
+		iBytesOrig+=arOrigSize[iLevel];
+		iBytesOut+=stEdit.arLevelOutSize[iLevel];
 	}
+	printf ("Total %5i %9i %11i %5.1f%%\n", iBytesRaw, iBytesOrig, iBytesOut,
+		100.0 * iBytesOut / iBytesRaw);
+	printf ("\n[  OK  ] All %i levels survive a round trip.\n", LEVELS);
+	if (iBytesOut > iBytesOrig)
+	{
+		printf ("[ WARN ] Re-encoding is %i bytes larger than the original!\n",
+			iBytesOut - iBytesOrig);
+	}
+	BenchExhaustive();
 
-	/*** icon ***/
-	snprintf (sImage, MAX_IMG, "png%svarious%slegbop_icon.png",
-		SLASH, SLASH);
-	imgicon = IMG_Load (sImage);
-	if (imgicon == NULL)
+	/*** Throughput, in decoded megabytes. ***/
+	printf ("[ INFO ] Runs: %i\n", iRuns);
+	switch (iRunsSIMD)
 	{
-		printf ("[ WARN ] Could not load \"%s\": %s!\n", sImage, strerror (errno));
+		case RUNS_SSE2: printf ("[ INFO ] Finding runs with: SSE2\n"); break;
+		case RUNS_AVX2: printf ("[ INFO ] Finding runs with: AVX2\n"); break;
+		default: printf ("[ INFO ] Finding runs with: scalar\n"); break;
+	}
+	printf ("[ INFO ] Decode: %.3f s, %.1f MB/s\n", dDecode,
+		(double)iBytesRaw * iRuns / (1024 * 1024) / dDecode);
+	printf ("[ INFO ] Encode: %.3f s, %.1f MB/s\n", dEncode,
+		(double)iBytesRaw * iRuns / (1024 * 1024) / dEncode);
+}
+/*****************************************************************************/
+void BenchExhaustive (void)
+/*****************************************************************************/
+{
+	unsigned char arIn[MAX_LEVEL_SIZE + 2];
+	unsigned char arOut[MAX_LEVEL_SIZE + 2];
+	unsigned char arCheck[MAX_LEVEL_SIZE + 2];
+	unsigned char arBytesRepeated[BYTE_SIZE + 2];
+	unsigned char arBytesReplace[BYTE_SIZE + 2];
+	int arCount[BYTE_SIZE + 2];
+	int arRuns[BYTE_SIZE + 2];
+	int arSingles[BYTE_SIZE + 2];
+	int arNibbles[BYTE_SIZE + 2];
+	unsigned int iSeed;
+	int iInputs;
+	int iLevels;
+	int iNrBytes;
+	int iBytes;
+	int iAlphabet;
+	int iFiller;
+	int iLength;
+	int iByte;
+	int iCheckSize;
+	int iRepeatedBytes;
+	int iGreedy;
+	int iSmallest;
+	int iSaved;
+
+	/*** Used for looping. ***/
+	int iInputLoop;
+	int iByteLoop;
+	int iRunLoop;
+
+	/* Greedy is checked against PlanExhaustive(): on the levels that have
+	 * few enough candidate bytes, and on small generated inputs. These use
+	 * most byte values once, so that few unused bytes are left for the
+	 * replacements, which is where greedy could go wrong. The generator is
+	 * seeded, so every run checks the same inputs.
+	 */
+	iSeed = 1;
+	iInputs = 0;
+	iLevels = 0;
+	iSaved = 0;
+	for (iInputLoop = 1; iInputLoop <= LEVELS + BENCH_INPUTS; iInputLoop++)
+	{
+		if (iInputLoop <= LEVELS)
+		{
+			iNrBytes = stEdit.arLevelRawSize[iInputLoop];
+			memcpy (arIn, stEdit.arLevelRaw[iInputLoop], iNrBytes);
+		} else {
+			iSeed = (iSeed * 1103515245) + 12345;
+			iAlphabet = 1 + ((iSeed >> 16) % EXHAUSTIVE_MAX);
+			iSeed = (iSeed * 1103515245) + 12345;
+			iFiller = BYTE_SIZE + 1 - iAlphabet - ((iSeed >> 16) % 5);
+			iNrBytes = 0;
+			for (iByteLoop = 0; iByteLoop < iFiller; iByteLoop++)
+			{
+				arIn[iNrBytes] = iAlphabet + iByteLoop;
+				iNrBytes++;
+			}
+			for (iRunLoop = 1; iRunLoop <= 60; iRunLoop++)
+			{
+				iSeed = (iSeed * 1103515245) + 12345;
+				iByte = (iSeed >> 16) % iAlphabet;
+				iSeed = (iSeed * 1103515245) + 12345;
+				iLength = 1 + ((iSeed >> 16) % 20);
+				memset (&arIn[iNrBytes], iByte, iLength);
+				iNrBytes+=iLength;
+			}
+		}
+
+		CountRuns (arIn, iNrBytes, arCount, arRuns, arSingles, arNibbles);
+		iSmallest = PlanExhaustive (arCount, arRuns, arSingles, arNibbles);
+		if (iSmallest == -1) { continue; }
+		iRepeatedBytes = PlanGreedy (arCount, arRuns, arSingles, arNibbles,
+			arBytesRepeated, arBytesReplace);
+		iGreedy = PlannedSize (arCount, arRuns, arSingles, arNibbles,
+			arBytesRepeated, iRepeatedBytes);
+
+		/*** The planned size has to be what is written. ***/
+		iBytes = CompressLevel (arIn, iNrBytes, arOut);
+		if ((iBytes != iGreedy) ||
+			(DecodeLevel (arOut, iBytes, arCheck, MAX_LEVEL_SIZE,
+			&iCheckSize) != iBytes) || (iCheckSize != iNrBytes) ||
+			(memcmp (arCheck, arIn, iNrBytes) != 0))
+		{
+			printf ("[FAILED] Input %i does not survive a round trip!\n",
+				iInputLoop);
+			exit (EXIT_ERROR);
+		}
+
+		iSaved+=iGreedy - iSmallest;
+		if (iInputLoop <= LEVELS) { iLevels++; } else { iInputs++; }
+	}
+	if (iSaved == 0)
+	{
+		printf ("[  OK  ] An exhaustive search saved 0 bytes vs greedy, on %i"
+			" level(s) and %i small inputs.\n", iLevels, iInputs);
 	} else {
-		SDL_SetWindowIcon (window, imgicon);
+		printf ("[ WARN ] An exhaustive search saved %i bytes vs greedy, on %i"
+			" level(s) and %i small inputs!\n", iSaved, iLevels, iInputs);
 	}
+}
+/*****************************************************************************/
+double Seconds (Uint64 iStart)
+/*****************************************************************************/
+{
+	double dSeconds;
 
-	/*** Open the first available controller. ***/
-	iController = 0;
-	if (iNoController != 1)
+	dSeconds = (double)(SDL_GetPerformanceCounter() - iStart) /
+		SDL_GetPerformanceFrequency();
+	if (dSeconds <= 0) { dSeconds = 0.000001; } /*** To prevent dividing by 0. ***/
+
+	return (dSeconds);
+}
+/*****************************************************************************/
+void ExportLevels (char *sFile)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	char *sText;
+	char sLine[MAX_LINE + 2];
+	int iText;
+	int iLine;
+
+	/*** Used for looping. ***/
+	int iLevelLoop;
+	int iRoomLoop;
+	int iTileLoop;
+	int iEventLoop;
+
+	/* The text is made in memory and written at once, so that a failure
+	 * never leaves a partial file for --import.
+	 */
+	sText = malloc (MAX_EXPORT + 2);
+	if (sText == NULL)
 	{
-		for (iJoyNr = 0; iJoyNr < SDL_NumJoysticks(); iJoyNr++)
+		printf ("[FAILED] Could not allocate %i bytes!\n", MAX_EXPORT + 2);
+		exit (EXIT_ERROR);
+	}
+	iText = 0;
+
+	snprintf (sLine, MAX_LINE, "# %s %s, levels of %s\n", EDITOR_NAME,
+		EDITOR_VERSION, stEdit.sPathFile);
+	iText = ExportLine (sText, iText, sLine);
+	iText = ExportLine (sText, iText, "# start ROOM TILE l|r\n");
+	iText = ExportLine (sText, iText,
+		"# room NR tiles HEX... (a room ends at ff)\n");
+	iText = ExportLine (sText, iText,
+		"# room NR links LEFT RIGHT UP DOWN\n");
+	iText = ExportLine (sText, iText, "# room NR guard TILE l|r\n");
+	iText = ExportLine (sText, iText,
+		"# event FROMROOM FROMTILE o|c TOROOM TOTILE\n");
+	for (iLevelLoop = 1; iLevelLoop <= LEVELS; iLevelLoop++)
+	{
+		stLevel = &stEdit.stRom.arLevel[iLevelLoop];
+		snprintf (sLine, MAX_LINE, "\nlevel %i\n", iLevelLoop);
+		iText = ExportLine (sText, iText, sLine);
+		snprintf (sLine, MAX_LINE, "start %i %i %s\n",
+			stLevel->arStartLocation[1], stLevel->arStartLocation[2],
+			ExportSymbol (cShowDirection (stLevel->arStartLocation[3]),
+			stLevel->arStartLocation[3]));
+		iText = ExportLine (sText, iText, sLine);
+		for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
 		{
-			if (SDL_IsGameController (iJoyNr))
+			/*** Like in SerializeLevel. ***/
+			iLine = snprintf (sLine, MAX_LINE, "room %i tiles", iRoomLoop);
+			for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
 			{
-				controller = SDL_GameControllerOpen (iJoyNr);
-				if (controller)
-				{
-					snprintf (sControllerName, MAX_CON, "%s",
-						SDL_GameControllerName (controller));
-					if (iDebug == 1)
-					{
-						printf ("[ INFO ] Found a controller \"%s\"; \"%s\".\n",
-							sControllerName, SDL_GameControllerNameForIndex (iJoyNr));
-					}
-					joystick = SDL_GameControllerGetJoystick (controller);
-					iController = 1;
+				iLine+=snprintf (&sLine[iLine], MAX_LINE - iLine, " %02x",
+					stLevel->arRoomTiles[iRoomLoop][iTileLoop]);
+				if (stLevel->arRoomTiles[iRoomLoop][iTileLoop] == 0xFF) { break; }
+			}
+			snprintf (&sLine[iLine], MAX_LINE - iLine, "\n");
+			iText = ExportLine (sText, iText, sLine);
+			snprintf (sLine, MAX_LINE, "room %i links %i %i %i %i\n", iRoomLoop,
+				stLevel->arRoomLinks[iRoomLoop][1],
+				stLevel->arRoomLinks[iRoomLoop][2],
+				stLevel->arRoomLinks[iRoomLoop][3],
+				stLevel->arRoomLinks[iRoomLoop][4]);
+			iText = ExportLine (sText, iText, sLine);
+			snprintf (sLine, MAX_LINE, "room %i guard %i %s\n", iRoomLoop,
+				stLevel->arGuardTile[iRoomLoop],
+				ExportSymbol (cShowDirection (stLevel->arGuardDir[iRoomLoop]),
+				stLevel->arGuardDir[iRoomLoop]));
+			iText = ExportLine (sText, iText, sLine);
+		}
+		for (iEventLoop = 1; iEventLoop <= stLevel->iNrEvents; iEventLoop++)
+		{
+			snprintf (sLine, MAX_LINE, "event %i %i %s %i %i\n",
+				stLevel->arEventsFromRoom[iEventLoop],
+				stLevel->arEventsFromTile[iEventLoop],
+				ExportSymbol (cShowOpenClose
+				(stLevel->arEventsOpenClose[iEventLoop]),
+				stLevel->arEventsOpenClose[iEventLoop]),
+				stLevel->arEventsToRoom[iEventLoop],
+				stLevel->arEventsToTile[iEventLoop]);
+			iText = ExportLine (sText, iText, sLine);
+		}
+	}
+
+	/*** If this fails, an older export stays as it was. ***/
+	if (WriteBytes (sFile, (unsigned char *)sText, iText) == 0)
+	{
+		printf ("[FAILED] Could not export the levels!\n");
+		exit (EXIT_ERROR);
+	}
+	free (sText);
+	printf ("[  OK  ] Exported %i levels to \"%s\".\n", LEVELS, sFile);
+}
+/*****************************************************************************/
+int ExportLine (char *sText, int iText, char *sLine)
+/*****************************************************************************/
+{
+	int iLength;
 
-					/*** Just for fun, use haptic. ***/
-					if (SDL_JoystickIsHaptic (joystick))
+	/*** Appends sLine to sText, and returns the new length. ***/
+	iLength = strlen (sLine);
+	if (iText + iLength > MAX_EXPORT)
+	{
+		printf ("[FAILED] The export is larger than %i bytes!\n", MAX_EXPORT);
+		exit (EXIT_ERROR);
+	}
+	memcpy (&sText[iText], sLine, iLength);
+
+	return (iText + iLength);
+}
+/*****************************************************************************/
+char *ExportSymbol (char cSymbol, int iValue)
+/*****************************************************************************/
+{
+	static char sSymbol[10 + 2];
+
+	/*** Values without a symbol are written as numbers. ***/
+	if (cSymbol == '?')
+	{
+		snprintf (sSymbol, 10, "%i", iValue);
+	} else {
+		snprintf (sSymbol, 10, "%c", cSymbol);
+	}
+
+	return (sSymbol);
+}
+/*****************************************************************************/
+void ImportLevels (char *sFile)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	FILE *fIn;
+	char sLine[MAX_LINE + 2];
+	char *arToken[MAX_TOKENS + 2];
+	int iTokens;
+	int iLine;
+	int iLevel;
+	int iRoom;
+	int iEvent;
+	int iLevels;
+	int iFree;
+	int arValue[MAX_TOKENS + 2];
+
+	/*** Used for looping. ***/
+	int iTokenLoop;
+	int iTileLoop;
+
+	fIn = fopen (sFile, "r");
+	if (fIn == NULL)
+	{
+		printf ("[FAILED] Could not open \"%s\": %s!\n",
+			sFile, strerror (errno));
+		exit (EXIT_ERROR);
+	}
+
+	/* A level in the file replaces what is listed for it; its events are
+	 * replaced by the listed events. Other levels stay as they are.
+	 */
+	iLine = 0;
+	iLevel = 0;
+	stLevel = NULL;
+	iLevels = 0;
+	while (fgets (sLine, MAX_LINE, fIn) != NULL)
+	{
+		iLine++;
+		iTokens = 0;
+		arToken[iTokens] = strtok (sLine, " \t\r\n");
+		while ((arToken[iTokens] != NULL) && (iTokens < MAX_TOKENS))
+		{
+			iTokens++;
+			arToken[iTokens] = strtok (NULL, " \t\r\n");
+		}
+		if ((iTokens == 0) || (arToken[0][0] == '#')) { continue; }
+
+		if (strcmp (arToken[0], "level") == 0)
+		{
+			if (iTokens != 2)
+				{ ImportError (sFile, iLine, "Expected: level NR"); }
+			iLevel = ImportValue (arToken[1], 10, 1, LEVELS);
+			if (iLevel == -1)
+				{ ImportError (sFile, iLine, "Incorrect level number"); }
+			stLevel = &stEdit.stRom.arLevel[iLevel];
+			stLevel->iNrEvents = 0;
+			stEdit.arLevelDirty[iLevel] = 1;
+			iLevels++;
+		} else if (iLevel == 0) {
+			ImportError (sFile, iLine, "Expected a level first");
+		} else if (strcmp (arToken[0], "start") == 0) {
+			if (iTokens != 4)
+				{ ImportError (sFile, iLine, "Expected: start ROOM TILE l|r"); }
+			arValue[1] = ImportValue (arToken[1], 10, 1, ROOMS);
+			arValue[2] = ImportValue (arToken[2], 10, 1, TILES);
+			arValue[3] = ImportSymbol (arToken[3], 'l', 0xFF, 'r', 0x00);
+			if ((arValue[1] == -1) || (arValue[2] == -1) || (arValue[3] == -1))
+				{ ImportError (sFile, iLine, "Incorrect start location"); }
+			stLevel->arStartLocation[1] = arValue[1];
+			stLevel->arStartLocation[2] = arValue[2];
+			stLevel->arStartLocation[3] = arValue[3];
+		} else if (strcmp (arToken[0], "room") == 0) {
+			if (iTokens < 4)
+				{ ImportError (sFile, iLine, "Expected: room NR tiles|links|guard"); }
+			iRoom = ImportValue (arToken[1], 10, 1, ROOMS);
+			if (iRoom == -1)
+				{ ImportError (sFile, iLine, "Incorrect room number"); }
+			if (strcmp (arToken[2], "tiles") == 0)
+			{
+				if (iTokens - 3 > TILES)
+					{ ImportError (sFile, iLine, "Too many tiles"); }
+				for (iTokenLoop = 3; iTokenLoop < iTokens; iTokenLoop++)
+				{
+					arValue[iTokenLoop] = ImportValue (arToken[iTokenLoop], 16,
+						0x00, 0xFF);
+					if (arValue[iTokenLoop] == -1)
+						{ ImportError (sFile, iLine, "Incorrect tile"); }
+					if ((arValue[iTokenLoop] == 0xFF) && (iTokenLoop != iTokens - 1))
+						{ ImportError (sFile, iLine, "Tiles after the end (ff)"); }
+				}
+				if ((iTokens - 3 < TILES) && (arValue[iTokens - 1] != 0xFF))
+					{ ImportError (sFile, iLine, "Too few tiles, without end (ff)"); }
+				for (iTileLoop = 1; iTileLoop <= iTokens - 3; iTileLoop++)
+				{
+					stLevel->arRoomTiles[iRoom][iTileLoop] = arValue[iTileLoop + 2];
+				}
+			} else if (strcmp (arToken[2], "links") == 0) {
+				if (iTokens != 7)
+				{
+					ImportError (sFile, iLine,
+						"Expected: room NR links LEFT RIGHT UP DOWN");
+				}
+				/*** No link, a room, or a high link as in the original levels. ***/
+				for (iTokenLoop = 3; iTokenLoop <= 6; iTokenLoop++)
+				{
+					arValue[iTokenLoop] = ImportValue (arToken[iTokenLoop], 10,
+						0, 0xFF);
+					if ((arValue[iTokenLoop] == -1) ||
+						((arValue[iTokenLoop] > ROOMS) && (arValue[iTokenLoop] < 0x80)))
 					{
-						haptic = SDL_HapticOpenFromJoystick (joystick);
-						if (SDL_HapticRumbleInit (haptic) == 0)
-						{
-							SDL_HapticRumblePlay (haptic, 1.0, 1000);
-						} else {
-							printf ("[ WARN ] Could not initialize the haptic device: %s!\n",
-								SDL_GetError());
-						}
-					} else {
-						PrIfDe ("[ INFO ] The game controller is not haptic.\n");
+						ImportError (sFile, iLine,
+							"Incorrect room link (0-24, or 128-255)");
 					}
-				} else {
-					printf ("[ WARN ] Could not open game controller %i: %s!\n",
-						iController, SDL_GetError());
+					stLevel->arRoomLinks[iRoom][iTokenLoop - 2] = arValue[iTokenLoop];
+				}
+			} else if (strcmp (arToken[2], "guard") == 0) {
+				if (iTokens != 5)
+					{ ImportError (sFile, iLine, "Expected: room NR guard TILE l|r"); }
+				/*** A tile, or TILES + 1 for no guard. ***/
+				arValue[3] = ImportValue (arToken[3], 10, 1, TILES + 1);
+				arValue[4] = ImportSymbol (arToken[4], 'l', 0xFF, 'r', 0x00);
+				if ((arValue[3] == -1) || ((arValue[4] != 0xFF) &&
+					(arValue[4] != 0x00)))
+				{
+					ImportError (sFile, iLine,
+						"Incorrect guard (tile 1-31, l or r)");
 				}
+				stLevel->arGuardTile[iRoom] = arValue[3];
+				stLevel->arGuardDir[iRoom] = arValue[4];
+			} else {
+				ImportError (sFile, iLine, "Expected: room NR tiles|links|guard");
 			}
+		} else if (strcmp (arToken[0], "event") == 0) {
+			if (iTokens != 6)
+			{
+				ImportError (sFile, iLine,
+					"Expected: event FROMROOM FROMTILE o|c TOROOM TOTILE");
+			}
+			if (stLevel->iNrEvents == EVENTS)
+				{ ImportError (sFile, iLine, "Too many events"); }
+			/*** A from room of 0xFF would end the events; see SerializeLevel. ***/
+			arValue[1] = ImportValue (arToken[1], 10, 0, 0xFE);
+			arValue[2] = ImportValue (arToken[2], 10, 1, 0x100);
+			arValue[3] = ImportSymbol (arToken[3], 'o', 0x01, 'c', 0x00);
+			arValue[4] = ImportValue (arToken[4], 10, 0, 0xFE);
+			arValue[5] = ImportValue (arToken[5], 10, 1, 0x100);
+			if ((arValue[1] == -1) || (arValue[4] == -1))
+				{ ImportError (sFile, iLine, "Incorrect event room (0-254)"); }
+			if ((arValue[2] == -1) || (arValue[5] == -1))
+				{ ImportError (sFile, iLine, "Incorrect event tile (1-256)"); }
+			if (arValue[3] == -1)
+				{ ImportError (sFile, iLine, "Incorrect event o|c"); }
+			stLevel->iNrEvents++;
+			iEvent = stLevel->iNrEvents;
+			stLevel->arEventsFromRoom[iEvent] = arValue[1];
+			stLevel->arEventsFromTile[iEvent] = arValue[2];
+			stLevel->arEventsOpenClose[iEvent] = arValue[3];
+			stLevel->arEventsToRoom[iEvent] = arValue[4];
+			stLevel->arEventsToTile[iEvent] = arValue[5];
+		} else {
+			ImportError (sFile, iLine, "Unknown line");
 		}
-		if (iController != 1) { PrIfDe ("[ INFO ] No controller found.\n"); }
-	} else {
-		PrIfDe ("[ INFO ] Using keyboard and mouse.\n");
 	}
+	fclose (fIn);
 
-	/*******************/
-	/* Preload images. */
-	/*******************/
+	/*** Everything must fit, before anything is saved. ***/
+	iFree = FreeBytes();
+	if (iFree < 0)
+	{
+		printf ("[FAILED] The levels need %i bytes more than the ROM has!\n",
+			-iFree);
+		exit (EXIT_ERROR);
+	}
 
-	/*** Loading... ***/
-	PreLoad (PNG_VARIOUS, "loading.png", &imgloading);
-	ShowImage (imgloading, 0, 0, "imgloading");
-	SDL_RenderPresent (ascreen);
+	if (CallSave() == 0) { exit (EXIT_ERROR); }
+	printf ("[  OK  ] Imported %i level(s) from \"%s\".\n", iLevels, sFile);
+}
+/*****************************************************************************/
+int ImportValue (char *sToken, int iBase, int iMin, int iMax)
+/*****************************************************************************/
+{
+	long lValue;
+	char *sEnd;
 
-	iPreLoaded = 0;
-	SDL_SetCursor (curWait);
+	/*** Returns -1 if the token is not a number from iMin to iMax. ***/
+	lValue = strtol (sToken, &sEnd, iBase);
+	if ((*sEnd != '\0') || (sEnd == sToken) ||
+		(lValue < iMin) || (lValue > iMax)) { return (-1); }
 
-	/*** Dungeon and palace tiles. ***/
-	PreLoadSet ('d', 0x00); PreLoadSet ('p', 0x00);
-	PreLoadSet ('d', 0x01); PreLoadSet ('p', 0x01);
-	PreLoadSet ('d', 0x02); PreLoadSet ('p', 0x02);
-	PreLoadSet ('d', 0x03); PreLoadSet ('p', 0x03);
-	PreLoadSet ('d', 0x05); PreLoadSet ('p', 0x05);
-	PreLoadSet ('d', 0x06); PreLoadSet ('p', 0x06);
-	PreLoadSet ('d', 0x07); PreLoadSet ('p', 0x07);
-	PreLoadSet ('d', 0x08); PreLoadSet ('p', 0x08);
-	PreLoadSet ('d', 0x09); PreLoadSet ('p', 0x09);
-	PreLoadSet ('d', 0x0A); PreLoadSet ('p', 0x0A);
-	PreLoadSet ('d', 0x0B); PreLoadSet ('p', 0x0B);
-	PreLoadSet ('d', 0x0C); PreLoadSet ('p', 0x0C);
-	PreLoadSet ('d', 0x0D); PreLoadSet ('p', 0x0D);
-	PreLoadSet ('d', 0x0E); PreLoadSet ('p', 0x0E);
-	PreLoadSet ('d', 0x0F); PreLoadSet ('p', 0x0F);
-	PreLoadSet ('d', 0x10); PreLoadSet ('p', 0x10);
-	PreLoadSet ('d', 0x11); PreLoadSet ('p', 0x11);
-	PreLoadSet ('d', 0x12); PreLoadSet ('p', 0x12);
-	PreLoadSet ('d', 0x13); PreLoadSet ('p', 0x13);
-	PreLoadSet ('d', 0x14); PreLoadSet ('p', 0x14);
-	PreLoadSet ('d', 0x15); PreLoadSet ('p', 0x15);
-	PreLoadSet ('d', 0x16); PreLoadSet ('p', 0x16);
-	PreLoadSet ('d', 0x17); PreLoadSet ('p', 0x17);
-	PreLoadSet ('d', 0x18); PreLoadSet ('p', 0x18);
-	PreLoadSet ('d', 0x19); PreLoadSet ('p', 0x19);
-	PreLoadSet ('d', 0x1A); PreLoadSet ('p', 0x1A);
-	PreLoadSet ('d', 0x1B); PreLoadSet ('p', 0x1B);
-	PreLoadSet ('d', 0x1C); PreLoadSet ('p', 0x1C);
-	PreLoadSet ('d', 0x1D); PreLoadSet ('p', 0x1D);
-	PreLoadSet ('d', 0x1F); PreLoadSet ('p', 0x1F);
-	PreLoadSet ('d', 0x20); PreLoadSet ('p', 0x20);
-	PreLoadSet ('d', 0x21); PreLoadSet ('p', 0x21);
-	PreLoadSet ('d', 0x24); PreLoadSet ('p', 0x24);
-	PreLoadSet ('d', 0x27); PreLoadSet ('p', 0x27);
-	PreLoadSet ('d', 0x2A); PreLoadSet ('p', 0x2A);
-	PreLoadSet ('d', 0x2B); PreLoadSet ('p', 0x2B);
-	PreLoadSet ('d', 0x2C); PreLoadSet ('p', 0x2C);
-	PreLoadSet ('d', 0x34); PreLoadSet ('p', 0x34);
-	PreLoadSet ('d', 0x40); PreLoadSet ('p', 0x40);
-	PreLoadSet ('d', 0x41); PreLoadSet ('p', 0x41);
-	PreLoadSet ('d', 0x44); PreLoadSet ('p', 0x44);
-	PreLoadSet ('d', 0x47); PreLoadSet ('p', 0x47);
-	PreLoadSet ('d', 0x4A); PreLoadSet ('p', 0x4A);
-	PreLoadSet ('d', 0x4C); PreLoadSet ('p', 0x4C);
-	PreLoadSet ('d', 0x50); PreLoadSet ('p', 0x50);
-	PreLoadSet ('d', 0x60); PreLoadSet ('p', 0x60);
-	PreLoadSet ('d', 0x6A); PreLoadSet ('p', 0x6A);
-	PreLoadSet ('d', 0x8A); PreLoadSet ('p', 0x8A);
-	PreLoadSet ('d', 0xAA); PreLoadSet ('p', 0xAA);
-	PreLoadSet ('d', 0xE0); PreLoadSet ('p', 0xE0);
-	PreLoadSet ('d', 0xE1); PreLoadSet ('p', 0xE1);
-	PreLoad ("dungeon", "0x13_sprite.png", &imgspriteflamed);
-	PreLoad ("palace", "0x13_sprite.png", &imgspriteflamep);
+	return (lValue);
+}
+/*****************************************************************************/
+int ImportSymbol (char *sToken, char cA, int iA, char cB, int iB)
+/*****************************************************************************/
+{
+	if ((sToken[0] == cA) && (sToken[1] == '\0')) { return (iA); }
+	if ((sToken[0] == cB) && (sToken[1] == '\0')) { return (iB); }
 
-	/*** various ***/
-	PreLoad (PNG_VARIOUS, "black.png", &imgblack);
-	PreLoad (PNG_VARIOUS, "disabled.png", &imgdisabled);
-	PreLoad (PNG_VARIOUS, "unknown.png", &imgunk[1]);
-	PreLoad (PNG_VARIOUS, "sel_unknown.png", &imgunk[2]);
-	PreLoad (PNG_VARIOUS, "sel_room_current.png", &imgsrc);
-	PreLoad (PNG_VARIOUS, "sel_room_start.png", &imgsrs);
-	PreLoad (PNG_VARIOUS, "sel_room_moving.png", &imgsrm);
-	PreLoad (PNG_VARIOUS, "sel_room_cross.png", &imgsrp);
-	PreLoad (PNG_VARIOUS, "sel_room_broken.png", &imgsrb);
-	PreLoad (PNG_VARIOUS, "sel_event.png", &imgsele);
-	PreLoad (PNG_VARIOUS, "event_unused.png", &imgeventu);
-	PreLoad (PNG_VARIOUS, "sel_level.png", &imgsell);
-	PreLoad (PNG_VARIOUS, "border_small_live.png", &imgbordersl);
-	PreLoad (PNG_VARIOUS, "border_big_live.png", &imgborderbl);
-	PreLoad (PNG_VARIOUS, "faded_l.png", &imgfadedl);
-	PreLoad (PNG_VARIOUS, "popup_yn.png", &imgpopup_yn);
-	PreLoad (PNG_VARIOUS, "help.png", &imghelp);
-	PreLoad (PNG_VARIOUS, "exe.png", &imgexe);
-	PreLoad (PNG_VARIOUS, "exe_warning.png", &imgexewarning);
-	PreLoad (PNG_VARIOUS, "faded_s.png", &imgfadeds);
-	PreLoad (PNG_VARIOUS, "event_tooltip.png", &imgetooltip);
-	PreLoad (PNG_VARIOUS, "custom_hover.png", &imgchover);
-	PreLoad (PNG_VARIOUS, "Mednafen.png", &imgmednafen);
-	PreLoad (PNG_VARIOUS, "link_warn_lr.png", &imglinkwarnlr);
-	PreLoad (PNG_VARIOUS, "link_warn_ud.png", &imglinkwarnud);
-	PreLoad (PNG_VARIOUS, "sel_textline.png", &imgseltextline);
-	PreLoad (PNG_VARIOUS, "various_warning.png", &imgvwarning);
-	if (iController != 1)
-	{
-		PreLoad (PNG_VARIOUS, "border_big.png", &imgborderb);
-		PreLoad (PNG_VARIOUS, "border_small.png", &imgborders);
-		PreLoad (PNG_VARIOUS, "broken_room_links.png", &imgbrl);
-		PreLoad (PNG_VARIOUS, "dungeon.png", &imgdungeon);
-		PreLoad (PNG_VARIOUS, "events.png", &imgevents);
-		PreLoad (PNG_VARIOUS, "level_bar.png", &imgbar);
-		PreLoad (PNG_VARIOUS, "palace.png", &imgpalace);
-		PreLoad (PNG_VARIOUS, "popup.png", &imgpopup);
-		PreLoad (PNG_VARIOUS, "room_links.png", &imgrl);
-	} else {
-		PreLoad (PNG_GAMEPAD, "border_big.png", &imgborderb);
-		PreLoad (PNG_GAMEPAD, "border_small.png", &imgborders);
-		PreLoad (PNG_GAMEPAD, "broken_room_links.png", &imgbrl);
-		PreLoad (PNG_GAMEPAD, "dungeon.png", &imgdungeon);
-		PreLoad (PNG_GAMEPAD, "events.png", &imgevents);
-		PreLoad (PNG_GAMEPAD, "level_bar.png", &imgbar);
-		PreLoad (PNG_GAMEPAD, "palace.png", &imgpalace);
-		PreLoad (PNG_GAMEPAD, "popup.png", &imgpopup);
-		PreLoad (PNG_GAMEPAD, "room_links.png", &imgrl);
-	}
+	/*** As written by ExportSymbol, for values without a symbol. ***/
+	return (ImportValue (sToken, 10, 0, 0xFF));
+}
+/*****************************************************************************/
+void ImportError (char *sFile, int iLine, char *sError)
+/*****************************************************************************/
+{
+	printf ("[FAILED] Line %i of \"%s\": %s!\n", iLine, sFile, sError);
+	exit (EXIT_ERROR);
+}
+/*****************************************************************************/
+void SnapshotSave (char *sFile)
+/*****************************************************************************/
+{
+	struct snapshot *stSnap;
+	struct level *stLevel;
+	int iByte;
 
-	/*** (s)living ***/
-	PreLoad (PNG_LIVING, "prince_l.png", &imgprincel[1]);
-	PreLoad (PNG_SLIVING, "prince_l.png", &imgprincel[2]);
-	PreLoad (PNG_LIVING, "prince_r.png", &imgprincer[1]);
-	PreLoad (PNG_SLIVING, "prince_r.png", &imgprincer[2]);
-	PreLoad (PNG_LIVING, "guard_l.png", &imgguardl[1]);
-	PreLoad (PNG_SLIVING, "guard_l.png", &imgguardl[2]);
-	PreLoad (PNG_LIVING, "guard_r.png", &imgguardr[1]);
-	PreLoad (PNG_SLIVING, "guard_r.png", &imgguardr[2]);
-	PreLoad (PNG_LIVING, "skeleton_l.png", &imgskeletonl[1]);
-	PreLoad (PNG_SLIVING, "skeleton_l.png", &imgskeletonl[2]);
-	PreLoad (PNG_LIVING, "skeleton_r.png", &imgskeletonr[1]);
-	PreLoad (PNG_SLIVING, "skeleton_r.png", &imgskeletonr[2]);
-	PreLoad (PNG_LIVING, "shadow_l.png", &imgshadowl[1]);
-	PreLoad (PNG_SLIVING, "shadow_l.png", &imgshadowl[2]);
-	PreLoad (PNG_LIVING, "shadow_r.png", &imgshadowr[1]);
-	PreLoad (PNG_SLIVING, "shadow_r.png", &imgshadowr[2]);
-	PreLoad (PNG_LIVING, "jaffar_l.png", &imgjaffarl[1]);
-	PreLoad (PNG_SLIVING, "jaffar_l.png", &imgjaffarl[2]);
-	PreLoad (PNG_LIVING, "jaffar_r.png", &imgjaffarr[1]);
-	PreLoad (PNG_SLIVING, "jaffar_r.png", &imgjaffarr[2]);
+	/*** Used for looping. ***/
+	int iLevelLoop;
+	int iAreaLoop;
 
-	/*** buttons ***/
-	PreLoad (PNG_BUTTONS, "up_0.png", &imgup_0);
-	PreLoad (PNG_BUTTONS, "up_1.png", &imgup_1);
-	PreLoad (PNG_BUTTONS, "down_0.png", &imgdown_0);
-	PreLoad (PNG_BUTTONS, "down_1.png", &imgdown_1);
-	PreLoad (PNG_BUTTONS, "left_0.png", &imgleft_0);
-	PreLoad (PNG_BUTTONS, "left_1.png", &imgleft_1);
-	PreLoad (PNG_BUTTONS, "right_0.png", &imgright_0);
-	PreLoad (PNG_BUTTONS, "right_1.png", &imgright_1);
-	PreLoad (PNG_BUTTONS, "up_down_no.png", &imgudno);
-	PreLoad (PNG_BUTTONS, "left_right_no.png", &imglrno);
-	if (iController != 1)
+	/*** Zeroed, so that files with equal levels are equal. ***/
+	stSnap = calloc (1, sizeof (struct snapshot));
+	if (stSnap == NULL)
 	{
-		PreLoad (PNG_BUTTONS, "broken_rooms_off.png", &imgbroomsoff);
-		PreLoad (PNG_BUTTONS, "broken_rooms_on_0.png", &imgbroomson_0);
-		PreLoad (PNG_BUTTONS, "broken_rooms_on_1.png", &imgbroomson_1);
-		PreLoad (PNG_BUTTONS, "close_big_0.png", &imgclosebig_0);
-		PreLoad (PNG_BUTTONS, "close_big_1.png", &imgclosebig_1);
-		PreLoad (PNG_BUTTONS, "events_off.png", &imgeventsoff);
-		PreLoad (PNG_BUTTONS, "events_on_0.png", &imgeventson_0);
-		PreLoad (PNG_BUTTONS, "events_on_1.png", &imgeventson_1);
-		PreLoad (PNG_BUTTONS, "next_off.png", &imgnextoff);
-		PreLoad (PNG_BUTTONS, "next_on_0.png", &imgnexton_0);
-		PreLoad (PNG_BUTTONS, "next_on_1.png", &imgnexton_1);
-		PreLoad (PNG_BUTTONS, "No.png", &imgno[1]);
-		PreLoad (PNG_BUTTONS, "OK.png", &imgok[1]);
-		PreLoad (PNG_BUTTONS, "previous_off.png", &imgprevoff);
-		PreLoad (PNG_BUTTONS, "previous_on_0.png", &imgprevon_0);
-		PreLoad (PNG_BUTTONS, "previous_on_1.png", &imgprevon_1);
-		PreLoad (PNG_BUTTONS, "quit_0.png", &imgquit_0);
-		PreLoad (PNG_BUTTONS, "quit_1.png", &imgquit_1);
-		PreLoad (PNG_BUTTONS, "rooms_off.png", &imgroomsoff);
-		PreLoad (PNG_BUTTONS, "rooms_on_0.png", &imgroomson_0);
-		PreLoad (PNG_BUTTONS, "rooms_on_1.png", &imgroomson_1);
-		PreLoad (PNG_BUTTONS, "save_off.png", &imgsaveoff);
-		PreLoad (PNG_BUTTONS, "save_on_0.png", &imgsaveon_0);
-		PreLoad (PNG_BUTTONS, "save_on_1.png", &imgsaveon_1);
-		PreLoad (PNG_BUTTONS, "Save.png", &imgsave[1]);
-		PreLoad (PNG_BUTTONS, "sel_No.png", &imgno[2]);
-		PreLoad (PNG_BUTTONS, "sel_OK.png", &imgok[2]);
-		PreLoad (PNG_BUTTONS, "sel_Save.png", &imgsave[2]);
-		PreLoad (PNG_BUTTONS, "sel_Yes.png", &imgyes[2]);
-		PreLoad (PNG_BUTTONS, "up_down_no_nfo.png", &imgudnonfo);
-		PreLoad (PNG_BUTTONS, "Yes.png", &imgyes[1]);
-	} else {
-		PreLoad (PNG_GAMEPAD, "broken_rooms_off.png", &imgbroomsoff);
-		PreLoad (PNG_GAMEPAD, "broken_rooms_on_0.png", &imgbroomson_0);
-		PreLoad (PNG_GAMEPAD, "broken_rooms_on_1.png", &imgbroomson_1);
-		PreLoad (PNG_GAMEPAD, "close_big_0.png", &imgclosebig_0);
-		PreLoad (PNG_GAMEPAD, "close_big_1.png", &imgclosebig_1);
-		PreLoad (PNG_GAMEPAD, "events_off.png", &imgeventsoff);
-		PreLoad (PNG_GAMEPAD, "events_on_0.png", &imgeventson_0);
-		PreLoad (PNG_GAMEPAD, "events_on_1.png", &imgeventson_1);
-		PreLoad (PNG_GAMEPAD, "next_off.png", &imgnextoff);
-		PreLoad (PNG_GAMEPAD, "next_on_0.png", &imgnexton_0);
-		PreLoad (PNG_GAMEPAD, "next_on_1.png", &imgnexton_1);
-		PreLoad (PNG_GAMEPAD, "No.png", &imgno[1]);
-		PreLoad (PNG_GAMEPAD, "OK.png", &imgok[1]);
-		PreLoad (PNG_GAMEPAD, "previous_off.png", &imgprevoff);
-		PreLoad (PNG_GAMEPAD, "previous_on_0.png", &imgprevon_0);
-		PreLoad (PNG_GAMEPAD, "previous_on_1.png", &imgprevon_1);
-		PreLoad (PNG_GAMEPAD, "quit_0.png", &imgquit_0);
-		PreLoad (PNG_GAMEPAD, "quit_1.png", &imgquit_1);
-		PreLoad (PNG_GAMEPAD, "rooms_off.png", &imgroomsoff);
-		PreLoad (PNG_GAMEPAD, "rooms_on_0.png", &imgroomson_0);
-		PreLoad (PNG_GAMEPAD, "rooms_on_1.png", &imgroomson_1);
-		PreLoad (PNG_GAMEPAD, "save_off.png", &imgsaveoff);
-		PreLoad (PNG_GAMEPAD, "save_on_0.png", &imgsaveon_0);
-		PreLoad (PNG_GAMEPAD, "save_on_1.png", &imgsaveon_1);
-		PreLoad (PNG_GAMEPAD, "Save.png", &imgsave[1]);
-		PreLoad (PNG_GAMEPAD, "sel_No.png", &imgno[2]);
-		PreLoad (PNG_GAMEPAD, "sel_OK.png", &imgok[2]);
-		PreLoad (PNG_GAMEPAD, "sel_Save.png", &imgsave[2]);
-		PreLoad (PNG_GAMEPAD, "sel_Yes.png", &imgyes[2]);
-		PreLoad (PNG_GAMEPAD, "up_down_no_nfo.png", &imgudnonfo);
-		PreLoad (PNG_GAMEPAD, "Yes.png", &imgyes[1]);
+		printf ("[FAILED] Could not allocate %i bytes!\n",
+			(int)sizeof (struct snapshot));
+		exit (EXIT_ERROR);
+	}
+	memcpy (stSnap->sMagic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+	stSnap->arVersion[0] = SNAPSHOT_VERSION & 0xFF;
+	stSnap->arVersion[1] = (SNAPSHOT_VERSION >> 8) & 0xFF;
+	stSnap->arOrder[0] = (SNAPSHOT_ORDER >> 0) & 0xFF;
+	stSnap->arOrder[1] = (SNAPSHOT_ORDER >> 8) & 0xFF;
+	stSnap->arOrder[2] = (SNAPSHOT_ORDER >> 16) & 0xFF;
+	stSnap->arOrder[3] = (SNAPSHOT_ORDER >> 24) & 0xFF;
+	for (iLevelLoop = 1; iLevelLoop <= LEVELS; iLevelLoop++)
+	{
+		stLevel = &stEdit.stRom.arLevel[iLevelLoop];
+		stSnap->arNrEvents[iLevelLoop][0] = stLevel->iNrEvents & 0xFF;
+		stSnap->arNrEvents[iLevelLoop][1] = (stLevel->iNrEvents >> 8) & 0xFF;
+		memcpy (stSnap->arRoomTiles[iLevelLoop], stLevel->arRoomTiles,
+			sizeof (stLevel->arRoomTiles));
+		memcpy (stSnap->arRoomLinks[iLevelLoop], stLevel->arRoomLinks,
+			sizeof (stLevel->arRoomLinks));
+		memcpy (stSnap->arStartLocation[iLevelLoop], stLevel->arStartLocation,
+			sizeof (stLevel->arStartLocation));
+		memcpy (stSnap->arGuardTile[iLevelLoop], stLevel->arGuardTile,
+			sizeof (stLevel->arGuardTile));
+		memcpy (stSnap->arGuardDir[iLevelLoop], stLevel->arGuardDir,
+			sizeof (stLevel->arGuardDir));
+		memcpy (stSnap->arEventsFromRoom[iLevelLoop], stLevel->arEventsFromRoom,
+			sizeof (stLevel->arEventsFromRoom));
+		memcpy (stSnap->arEventsFromTile[iLevelLoop], stLevel->arEventsFromTile,
+			sizeof (stLevel->arEventsFromTile));
+		memcpy (stSnap->arEventsOpenClose[iLevelLoop],
+			stLevel->arEventsOpenClose, sizeof (stLevel->arEventsOpenClose));
+		memcpy (stSnap->arEventsToRoom[iLevelLoop], stLevel->arEventsToRoom,
+			sizeof (stLevel->arEventsToRoom));
+		memcpy (stSnap->arEventsToTile[iLevelLoop], stLevel->arEventsToTile,
+			sizeof (stLevel->arEventsToTile));
+	}
+	memcpy (stSnap->sUnknown, stEdit.stRom.sUnknown,
+		sizeof (stEdit.stRom.sUnknown));
+
+	/*** The EXE fields, as stored in the ROM. ***/
+	iByte = 0;
+	for (iAreaLoop = 0; iAreaLoop < SNAPSHOT_EXE_AREAS; iAreaLoop++)
+	{
+		ROMByte (arPatchAreas[iAreaLoop][0] +
+			arPatchAreas[iAreaLoop][1] - 1); /*** Checks the offset. ***/
+		memcpy (&stSnap->sEXE[iByte], &stEdit.sROM[arPatchAreas[iAreaLoop][0]],
+			arPatchAreas[iAreaLoop][1]);
+		iByte+=arPatchAreas[iAreaLoop][1];
 	}
 
-	/*** extras ***/
-	PreLoad (PNG_EXTRAS, "extras_00.png", &imgextras[0]);
-	PreLoad (PNG_EXTRAS, "extras_01.png", &imgextras[1]);
-	PreLoad (PNG_EXTRAS, "extras_02.png", &imgextras[2]);
-	PreLoad (PNG_EXTRAS, "extras_03.png", &imgextras[3]);
-	PreLoad (PNG_EXTRAS, "extras_04.png", &imgextras[4]);
-	PreLoad (PNG_EXTRAS, "extras_05.png", &imgextras[5]);
-	PreLoad (PNG_EXTRAS, "extras_06.png", &imgextras[6]);
-	PreLoad (PNG_EXTRAS, "extras_07.png", &imgextras[7]);
-	PreLoad (PNG_EXTRAS, "extras_08.png", &imgextras[8]);
-	PreLoad (PNG_EXTRAS, "extras_09.png", &imgextras[9]);
-	PreLoad (PNG_EXTRAS, "extras_10.png", &imgextras[10]);
+	/*** If this fails, an older snapshot stays as it was. ***/
+	if (WriteBytes (sFile, (unsigned char *)stSnap,
+		sizeof (struct snapshot)) == 0)
+	{
+		printf ("[FAILED] Could not save the snapshot!\n");
+		exit (EXIT_ERROR);
+	}
+	free (stSnap);
+	printf ("[  OK  ] Saved a snapshot of %i levels to \"%s\".\n",
+		LEVELS, sFile);
+}
+/*****************************************************************************/
+void SnapshotLoad (char *sFile)
+/*****************************************************************************/
+{
+	struct snapshot *stSnap;
+	struct level *stLevel;
+	struct stat stStat;
+	int iFd;
+	int iMapped;
+	int iByte;
+	int iFree;
 
-	/*** rooms ***/
-	PreLoad (PNG_ROOMS, "room1.png", &imgroom[1]);
-	PreLoad (PNG_ROOMS, "room2.png", &imgroom[2]);
-	PreLoad (PNG_ROOMS, "room3.png", &imgroom[3]);
-	PreLoad (PNG_ROOMS, "room4.png", &imgroom[4]);
-	PreLoad (PNG_ROOMS, "room5.png", &imgroom[5]);
-	PreLoad (PNG_ROOMS, "room6.png", &imgroom[6]);
-	PreLoad (PNG_ROOMS, "room7.png", &imgroom[7]);
-	PreLoad (PNG_ROOMS, "room8.png", &imgroom[8]);
-	PreLoad (PNG_ROOMS, "room9.png", &imgroom[9]);
-	PreLoad (PNG_ROOMS, "room10.png", &imgroom[10]);
-	PreLoad (PNG_ROOMS, "room11.png", &imgroom[11]);
-	PreLoad (PNG_ROOMS, "room12.png", &imgroom[12]);
-	PreLoad (PNG_ROOMS, "room13.png", &imgroom[13]);
-	PreLoad (PNG_ROOMS, "room14.png", &imgroom[14]);
-	PreLoad (PNG_ROOMS, "room15.png", &imgroom[15]);
-	PreLoad (PNG_ROOMS, "room16.png", &imgroom[16]);
-	PreLoad (PNG_ROOMS, "room17.png", &imgroom[17]);
-	PreLoad (PNG_ROOMS, "room18.png", &imgroom[18]);
-	PreLoad (PNG_ROOMS, "room19.png", &imgroom[19]);
-	PreLoad (PNG_ROOMS, "room20.png", &imgroom[20]);
-	PreLoad (PNG_ROOMS, "room21.png", &imgroom[21]);
-	PreLoad (PNG_ROOMS, "room22.png", &imgroom[22]);
-	PreLoad (PNG_ROOMS, "room23.png", &imgroom[23]);
-	PreLoad (PNG_ROOMS, "room24.png", &imgroom[24]);
-	PreLoad (PNG_ROOMS, "room25.png", &imgroom[25]); /*** "?"; high links ***/
+	/*** Used for looping. ***/
+	int iLevelLoop;
+	int iAreaLoop;
 
-	/*** alphabet ***/
-	for (iAlphabetLoop = 1; iAlphabetLoop <= 26; iAlphabetLoop++)
+	iFd = open (sFile, O_RDONLY|O_BINARY);
+	if (iFd == -1)
 	{
-		snprintf (sImage, MAX_IMG, "%c.png", iAlphabetLoop + 0x40);
-		PreLoad (PNG_ALPHABET, sImage, &imgalphabet[iAlphabetLoop]);
+		printf ("[FAILED] Could not open \"%s\": %s!\n",
+			sFile, strerror (errno));
+		exit (EXIT_ERROR);
+	}
+	if ((fstat (iFd, &stStat) == -1) ||
+		(stStat.st_size != (off_t)sizeof (struct snapshot)))
+	{
+		printf ("[FAILED] \"%s\" is not a snapshot of this version!\n", sFile);
+		exit (EXIT_ERROR);
 	}
-	PreLoad (PNG_ALPHABET, "space.png", &imgspace);
-	PreLoad (PNG_ALPHABET, "unknown.png", &imgunknown);
 
-	if (iDebug == 1)
-		{ printf ("[ INFO ] Preloaded images: %i\n", iPreLoaded); }
-	SDL_SetCursor (curArrow);
+	/* The file is the struct; it is checked, but not parsed. Like in
+	 * ROMLoad, the file is read at once if it cannot be mapped.
+	 */
+	iMapped = 0;
+#if defined __linux__
+	stSnap = mmap (NULL, sizeof (struct snapshot), PROT_READ, MAP_PRIVATE,
+		iFd, 0);
+	if (stSnap != MAP_FAILED) { iMapped = 1; }
+#endif
+	if (iMapped == 0)
+	{
+		stSnap = malloc (sizeof (struct snapshot));
+		if ((stSnap == NULL) ||
+			(read (iFd, stSnap, sizeof (struct snapshot)) !=
+			(int)sizeof (struct snapshot)))
+		{
+			printf ("[FAILED] Could not read from \"%s\"!\n", sFile);
+			exit (EXIT_ERROR);
+		}
+	}
+	close (iFd);
 
-	/*** Defaults. ***/
-	iCurLevel = iStartLevel;
-	iCurRoom = arStartLocation[iCurLevel][1];
-	iDownAt = 0;
-	iSelected = 1; /*** Start with the upper left selected. ***/
-	iScreen = 1;
-	iChangeEvent = 1;
-	iFlameFrame = 1;
-	oldticks = 0;
+	/*** Nothing changes, unless all of the snapshot is correct. ***/
+	SnapshotCheck (stSnap, sFile);
+	for (iLevelLoop = 1; iLevelLoop <= LEVELS; iLevelLoop++)
+	{
+		stLevel = &stEdit.stRom.arLevel[iLevelLoop];
+		stLevel->iNrEvents = stSnap->arNrEvents[iLevelLoop][0] +
+			(stSnap->arNrEvents[iLevelLoop][1] << 8);
+		memcpy (stLevel->arRoomTiles, stSnap->arRoomTiles[iLevelLoop],
+			sizeof (stLevel->arRoomTiles));
+		memcpy (stLevel->arRoomLinks, stSnap->arRoomLinks[iLevelLoop],
+			sizeof (stLevel->arRoomLinks));
+		memcpy (stLevel->arStartLocation, stSnap->arStartLocation[iLevelLoop],
+			sizeof (stLevel->arStartLocation));
+		memcpy (stLevel->arGuardTile, stSnap->arGuardTile[iLevelLoop],
+			sizeof (stLevel->arGuardTile));
+		memcpy (stLevel->arGuardDir, stSnap->arGuardDir[iLevelLoop],
+			sizeof (stLevel->arGuardDir));
+		memcpy (stLevel->arEventsFromRoom, stSnap->arEventsFromRoom[iLevelLoop],
+			sizeof (stLevel->arEventsFromRoom));
+		memcpy (stLevel->arEventsFromTile, stSnap->arEventsFromTile[iLevelLoop],
+			sizeof (stLevel->arEventsFromTile));
+		memcpy (stLevel->arEventsOpenClose,
+			stSnap->arEventsOpenClose[iLevelLoop],
+			sizeof (stLevel->arEventsOpenClose));
+		memcpy (stLevel->arEventsToRoom, stSnap->arEventsToRoom[iLevelLoop],
+			sizeof (stLevel->arEventsToRoom));
+		memcpy (stLevel->arEventsToTile, stSnap->arEventsToTile[iLevelLoop],
+			sizeof (stLevel->arEventsToTile));
+		stEdit.arLevelDirty[iLevelLoop] = 1;
+	}
+	memcpy (stEdit.stRom.sUnknown, stSnap->sUnknown,
+		sizeof (stEdit.stRom.sUnknown));
+	iByte = 0;
+	for (iAreaLoop = 0; iAreaLoop < SNAPSHOT_EXE_AREAS; iAreaLoop++)
+	{
+		ROMSetBytes (arPatchAreas[iAreaLoop][0], &stSnap->sEXE[iByte],
+			arPatchAreas[iAreaLoop][1]);
+		iByte+=arPatchAreas[iAreaLoop][1];
+	}
 
-	iTTP1 = TTPD_1;
-	iTTPO = TTPD_O;
-	iDX = DD_X;
-	iDY = DD_Y;
-	iHor[0] = (iDX * -1) + OFFSETD_X;
-	iHor[1] = (iDX * 0) + OFFSETD_X;
-	iHor[2] = (iDX * 1) + OFFSETD_X;
-	iHor[3] = (iDX * 2) + OFFSETD_X;
-	iHor[4] = (iDX * 3) + OFFSETD_X;
-	iHor[5] = (iDX * 4) + OFFSETD_X;
-	iHor[6] = (iDX * 5) + OFFSETD_X;
-	iHor[7] = (iDX * 6) + OFFSETD_X;
-	iHor[8] = (iDX * 7) + OFFSETD_X;
-	iHor[9] = (iDX * 8) + OFFSETD_X;
-	iHor[10] = (iDX * 9) + OFFSETD_X;
-	iVer0 = OFFSETD_Y - iTTP1 - (iDY * 1);
-	iVer1 = OFFSETD_Y - iTTP1 + (iDY * 0);
-	iVer2 = OFFSETD_Y - iTTP1 + (iDY * 1);
-	iVer3 = OFFSETD_Y - iTTP1 + (iDY * 2);
-	iVer4 = OFFSETD_Y - iTTP1 + (iDY * 3);
+#if defined __linux__
+	if (iMapped == 1) { munmap (stSnap, sizeof (struct snapshot)); }
+#endif
+	if (iMapped == 0) { free (stSnap); }
 
-	ShowScreen();
-	InitPopUp();
-	while (1)
+	/*** Everything must fit, before anything is saved. ***/
+	iFree = FreeBytes();
+	if (iFree < 0)
 	{
-		if (iNoAnim == 0)
+		printf ("[FAILED] The levels need %i bytes more than the ROM has!\n",
+			-iFree);
+		exit (EXIT_ERROR);
+	}
+
+	if (CallSave() == 0) { exit (EXIT_ERROR); }
+	printf ("[  OK  ] Restored a snapshot of %i levels from \"%s\".\n",
+		LEVELS, sFile);
+}
+/*****************************************************************************/
+void SnapshotCheck (struct snapshot *stSnap, char *sFile)
+/*****************************************************************************/
+{
+	int iNrEvents;
+	int iLevel;
+	int iLink;
+
+	/*** Used for looping. ***/
+	int iRoomLoop;
+	int iSideLoop;
+	int iEventLoop;
+
+	if ((memcmp (stSnap->sMagic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) != 0) ||
+		(stSnap->arVersion[0] + (stSnap->arVersion[1] << 8) !=
+		SNAPSHOT_VERSION) ||
+		(stSnap->arOrder[0] != ((SNAPSHOT_ORDER >> 0) & 0xFF)) ||
+		(stSnap->arOrder[1] != ((SNAPSHOT_ORDER >> 8) & 0xFF)) ||
+		(stSnap->arOrder[2] != ((SNAPSHOT_ORDER >> 16) & 0xFF)) ||
+		(stSnap->arOrder[3] != ((SNAPSHOT_ORDER >> 24) & 0xFF)))
+	{
+		printf ("[FAILED] \"%s\" is not a snapshot of this version!\n", sFile);
+		exit (EXIT_ERROR);
+	}
+
+	/*** The ranges of ImportLevels; SerializeLevel trusts them. ***/
+	for (iLevel = 1; iLevel <= LEVELS; iLevel++)
+	{
+		iNrEvents = stSnap->arNrEvents[iLevel][0] +
+			(stSnap->arNrEvents[iLevel][1] << 8);
+		if (iNrEvents > EVENTS)
+			{ SnapshotError (sFile, iLevel, "number of events"); }
+		if ((stSnap->arStartLocation[iLevel][1] < 1) ||
+			(stSnap->arStartLocation[iLevel][1] > ROOMS) ||
+			(stSnap->arStartLocation[iLevel][2] < 1) ||
+			(stSnap->arStartLocation[iLevel][2] > TILES) ||
+			((stSnap->arStartLocation[iLevel][3] != 0x00) &&
+			(stSnap->arStartLocation[iLevel][3] != 0xFF)))
+			{ SnapshotError (sFile, iLevel, "start location"); }
+		for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
 		{
-			/* This is for the animation; 20 fps (1000/50). The GBC runs at
-			 * about 60 fps, but changes the torch flames every 3 frames.
-			 */
-			newticks = SDL_GetTicks();
-			if (newticks > oldticks + 50)
+			for (iSideLoop = 1; iSideLoop <= 4; iSideLoop++)
 			{
-				iFlameFrame++;
-				if (iFlameFrame == 5) { iFlameFrame = 1; }
-				ShowScreen();
-				oldticks = newticks;
+				iLink = stSnap->arRoomLinks[iLevel][iRoomLoop][iSideLoop];
+				if ((iLink > ROOMS) && (iLink < 0x80))
+					{ SnapshotError (sFile, iLevel, "room link"); }
 			}
+			if ((stSnap->arGuardTile[iLevel][iRoomLoop] < 1) ||
+				(stSnap->arGuardTile[iLevel][iRoomLoop] > TILES + 1) ||
+				((stSnap->arGuardDir[iLevel][iRoomLoop] != 0x00) &&
+				(stSnap->arGuardDir[iLevel][iRoomLoop] != 0xFF)))
+				{ SnapshotError (sFile, iLevel, "guard"); }
+		}
+		for (iEventLoop = 1; iEventLoop <= iNrEvents; iEventLoop++)
+		{
+			if ((stSnap->arEventsFromRoom[iLevel][iEventLoop] == 0xFF) ||
+				(stSnap->arEventsToRoom[iLevel][iEventLoop] == 0xFF) ||
+				(stSnap->arEventsOpenClose[iLevel][iEventLoop] > 0x01))
+				{ SnapshotError (sFile, iLevel, "event"); }
 		}
+	}
+}
+/*****************************************************************************/
+void SnapshotError (char *sFile, int iLevel, char *sError)
+/*****************************************************************************/
+{
+	printf ("[FAILED] Level %i in \"%s\" has an incorrect %s!\n",
+		iLevel, sFile, sError);
+	exit (EXIT_ERROR);
+}
+/*****************************************************************************/
+void Batch (char **arPaths, int iROMs, int iJobs)
+/*****************************************************************************/
+{
+	SDL_Thread **arThreads;
+	Uint64 iStart;
+	int iFailed;
+
+	/*** Used for looping. ***/
+	int iThreadLoop;
+	int iROMLoop;
+
+	arBatchPaths = arPaths;
+	iBatchROMs = iROMs;
+	arBatchResults = malloc (iROMs * sizeof (*arBatchResults));
+	arBatchOK = malloc (iROMs * sizeof (int));
+	if ((iJobs < 1) || (iJobs > MAX_JOBS)) { iJobs = SDL_GetCPUCount(); }
+	if (iJobs > iROMs) { iJobs = iROMs; }
+	arThreads = malloc ((iJobs + 1) * sizeof (SDL_Thread *));
+	if ((arBatchResults == NULL) || (arBatchOK == NULL) || (arThreads == NULL))
+	{
+		printf ("[FAILED] Could not allocate memory for %i ROMs!\n", iROMs);
+		exit (EXIT_ERROR);
+	}
 
-		while (SDL_PollEvent (&event))
+	/* Like CompressLevels, every thread takes the next ROM until none are
+	 * left. Each ROM gets its own context, so threads share nothing.
+	 */
+	iStart = SDL_GetPerformanceCounter();
+	SDL_AtomicSet (&atNextROM, 0);
+	for (iThreadLoop = 1; iThreadLoop <= iJobs - 1; iThreadLoop++)
+	{
+		arThreads[iThreadLoop] = SDL_CreateThread (BatchThread,
+			"BatchThread", NULL);
+		if (arThreads[iThreadLoop] == NULL)
 		{
-			switch (event.type)
-			{
-				case SDL_CONTROLLERBUTTONDOWN:
-					/*** Nothing for now. ***/
-					break;
-				case SDL_CONTROLLERBUTTONUP:
-					switch (event.cbutton.button)
-					{
-						case SDL_CONTROLLER_BUTTON_A:
-							InitScreenAction ("enter");
-							break;
-						case SDL_CONTROLLER_BUTTON_B:
-							switch (iScreen)
-							{
-								case 1:
-									Quit(); break;
-								case 2:
-									arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
-									iScreen = 1; break;
-								case 3:
-									iScreen = 1; break;
-							}
-							break;
-						case SDL_CONTROLLER_BUTTON_X:
-							if (iScreen != 2)
-							{
-								iScreen = 2;
-								iMovingRoom = 0;
-								iMovingNewBusy = 0;
-								iChangingBrokenRoom = iCurRoom;
-								iChangingBrokenSide = 1;
-								PlaySound ("wav/screen2or3.wav");
-							} else if (arBrokenRoomLinks[iCurLevel] == 0) {
-								arBrokenRoomLinks[iCurLevel] = 1;
-								PlaySound ("wav/screen2or3.wav");
-							}
-							break;
-						case SDL_CONTROLLER_BUTTON_Y:
-							if (iScreen == 2)
-							{
-								arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
-							}
-							if (iScreen != 3)
-							{
-								iScreen = 3;
-								if (iChangeEvent > arNrEvents[iCurLevel])
-									{ iChangeEvent = arNrEvents[iCurLevel]; }
-								PlaySound ("wav/screen2or3.wav");
-							} else {
-								switch (arEventsOpenClose[iCurLevel][iChangeEvent])
-								{
-									case 0x00:
-										arEventsOpenClose[iCurLevel][iChangeEvent] = 0x01;
-										break;
-									case 0x01:
-										arEventsOpenClose[iCurLevel][iChangeEvent] = 0x00;
-										break;
-								}
-								PlaySound ("wav/check_box.wav");
-								iChanged++;
-							}
-							break;
-						case SDL_CONTROLLER_BUTTON_BACK:
-							if ((iScreen == 2) && (arBrokenRoomLinks[iCurLevel] == 1))
-							{
-								LinkMinus();
-							}
-							if (iScreen == 3)
-							{
-								iEventRoom = arEventsFromRoom[iCurLevel][iChangeEvent];
-								if ((iEventRoom >= 1) && (iEventRoom <= 23))
-								{
-									EventRoom (iEventRoom + 1, 0);
-								} else {
-									EventRoom (1, 0);
-								}
-							}
-							break;
-						case SDL_CONTROLLER_BUTTON_GUIDE:
-							if (iChanged != 0) { CallSave(); } break;
-						case SDL_CONTROLLER_BUTTON_START:
-							RunLevel (iCurLevel);
-							break;
-						case SDL_CONTROLLER_BUTTON_LEFTSHOULDER:
-							if (iCurLevel != 1)
-							{
-								if (iChanged != 0) { InitPopUpSave(); }
-								Prev();
-							}
-							break;
-						case SDL_CONTROLLER_BUTTON_RIGHTSHOULDER:
-							if (iCurLevel != LEVELS)
-							{
-								if (iChanged != 0) { InitPopUpSave(); }
-								Next();
-							}
-							break;
-						case SDL_CONTROLLER_BUTTON_DPAD_LEFT:
-							InitScreenAction ("left"); break;
-						case SDL_CONTROLLER_BUTTON_DPAD_RIGHT:
-							InitScreenAction ("right"); break;
-						case SDL_CONTROLLER_BUTTON_DPAD_UP:
-							InitScreenAction ("up"); break;
-						case SDL_CONTROLLER_BUTTON_DPAD_DOWN:
-							InitScreenAction ("down"); break;
-					}
-					ShowScreen();
-					break;
-				case SDL_CONTROLLERAXISMOTION: /*** triggers and analog sticks ***/
-					iXJoy1 = SDL_JoystickGetAxis (joystick, 0);
-					iYJoy1 = SDL_JoystickGetAxis (joystick, 1);
-					iXJoy2 = SDL_JoystickGetAxis (joystick, 3);
-					iYJoy2 = SDL_JoystickGetAxis (joystick, 4);
-					if ((iXJoy1 < -30000) || (iXJoy2 < -30000)) /*** left ***/
-					{
-						if ((SDL_GetTicks() - joyleft) > 300)
-						{
-							if (iScreen == 1)
-							{
-								if (arRoomLinks[iCurLevel][iCurRoom][1] != 0)
-								{
-									iCurRoom = arRoomLinks[iCurLevel][iCurRoom][1];
-									PlaySound ("wav/scroll.wav");
-								}
-							}
-							if (iScreen == 3)
-							{
-								InitScreenAction ("left from");
-							}
-							joyleft = SDL_GetTicks();
-						}
-					}
-					if ((iXJoy1 > 30000) || (iXJoy2 > 30000)) /*** right ***/
-					{
-						if ((SDL_GetTicks() - joyright) > 300)
-						{
-							if (iScreen == 1)
-							{
-								if (arRoomLinks[iCurLevel][iCurRoom][2] != 0)
-								{
-									iCurRoom = arRoomLinks[iCurLevel][iCurRoom][2];
-									PlaySound ("wav/scroll.wav");
-								}
-							}
-							if (iScreen == 3)
-							{
-								InitScreenAction ("right from");
-							}
-							joyright = SDL_GetTicks();
-						}
-					}
-					if ((iYJoy1 < -30000) || (iYJoy2 < -30000)) /*** up ***/
-					{
-						if ((SDL_GetTicks() - joyup) > 300)
-						{
-							if (iScreen == 1)
-							{
-								if (arRoomLinks[iCurLevel][iCurRoom][3] != 0)
-								{
-									iCurRoom = arRoomLinks[iCurLevel][iCurRoom][3];
-									PlaySound ("wav/scroll.wav");
-								}
-							}
-							if (iScreen == 3)
-							{
-								InitScreenAction ("up from");
-							}
-							joyup = SDL_GetTicks();
-						}
-					}
-					if ((iYJoy1 > 30000) || (iYJoy2 > 30000)) /*** down ***/
-					{
-						if ((SDL_GetTicks() - joydown) > 300)
-						{
-							if (iScreen == 1)
-							{
-								if (arRoomLinks[iCurLevel][iCurRoom][4] != 0)
-								{
-									iCurRoom = arRoomLinks[iCurLevel][iCurRoom][4];
-									PlaySound ("wav/scroll.wav");
-								}
-							}
-							if (iScreen == 3)
-							{
-								InitScreenAction ("down from");
-							}
-							joydown = SDL_GetTicks();
-						}
-					}
-					if (event.caxis.axis == SDL_CONTROLLER_AXIS_TRIGGERLEFT)
+			printf ("[ WARN ] Could not create thread: %s!\n", SDL_GetError());
+		}
+	}
+	BatchThread (NULL); /*** This thread works too. ***/
+	for (iThreadLoop = 1; iThreadLoop <= iJobs - 1; iThreadLoop++)
+	{
+		if (arThreads[iThreadLoop] != NULL)
+			{ SDL_WaitThread (arThreads[iThreadLoop], NULL); }
+	}
+
+	/*** One line per ROM, in the order given. ***/
+	iFailed = 0;
+	for (iROMLoop = 0; iROMLoop < iROMs; iROMLoop++)
+	{
+		printf ("%s\n", arBatchResults[iROMLoop]);
+		if (arBatchOK[iROMLoop] == 0) { iFailed++; }
+	}
+	printf ("[ INFO ] %i ROM(s), %i failed, %.3f s with %i thread(s).\n",
+		iROMs, iFailed, Seconds (iStart), iJobs);
+
+	free (arThreads);
+	free (arBatchResults);
+	free (arBatchOK);
+	if (iFailed != 0) { exit (EXIT_ERROR); }
+}
+/*****************************************************************************/
+int BatchThread (void *unused)
+/*****************************************************************************/
+{
+	struct romctx *stCtx;
+	int iROM;
+
+	if (unused != NULL) { } /*** To prevent warnings. ***/
+
+	/*** The decoded levels are too large for the stack. ***/
+	stCtx = malloc (sizeof (struct romctx));
+	if (stCtx == NULL)
+	{
+		printf ("[ WARN ] Could not allocate a ROM context!\n");
+		return (0);
+	}
+	while ((iROM = SDL_AtomicAdd (&atNextROM, 1)) < iBatchROMs)
+	{
+		snprintf (stCtx->sPathFile, MAX_PATHFILE, "%s", arBatchPaths[iROM]);
+		arBatchOK[iROM] = BatchROM (stCtx, arBatchResults[iROM]);
+	}
+	free (stCtx);
+
+	return (0);
+}
+/*****************************************************************************/
+int BatchROM (struct romctx *stCtx, char *sResult)
+/*****************************************************************************/
+{
+	struct stat stStat;
+	char sError[MAX_ERROR + 2];
+	unsigned char arCheck[MAX_LEVEL_SIZE + 2];
+	struct level *stLevel;
+	int iFd;
+	int iLevel;
+	int iBytes;
+	int iBytesGreedy;
+	int iCheckSize;
+	int iRooms, iEvents;
+
+	/*** Used for looping. ***/
+	int iRoomLoop;
+
+	/*** Load. ***/
+	iFd = open (stCtx->sPathFile, O_RDONLY|O_BINARY);
+	if ((iFd == -1) || (fstat (iFd, &stStat) == -1))
+	{
+		snprintf (sResult, MAX_RESULT, "[FAILED] %s: %s", stCtx->sPathFile,
+			strerror (errno));
+		if (iFd != -1) { close (iFd); }
+		return (0);
+	}
+	stCtx->iROMSize = stStat.st_size;
+	stCtx->sROM = malloc (stCtx->iROMSize + 1);
+	if ((stCtx->sROM == NULL) ||
+		(read (iFd, stCtx->sROM, stCtx->iROMSize) != stCtx->iROMSize))
+	{
+		snprintf (sResult, MAX_RESULT, "[FAILED] %s: Could not read the ROM",
+			stCtx->sPathFile);
+		free (stCtx->sROM);
+		close (iFd);
+		return (0);
+	}
+	close (iFd);
+
+	/*** Validate, and load the levels like the editor does. ***/
+	if ((stCtx->iROMSize < VERIFY_OFFSET + VERIFY_SIZE) ||
+		(memcmp (&stCtx->sROM[VERIFY_OFFSET], VERIFY_TEXT, VERIFY_SIZE) != 0))
+	{
+		snprintf (sResult, MAX_RESULT, "[FAILED] %s: Not a Prince of Persia"
+			" for GBC ROM", stCtx->sPathFile);
+		free (stCtx->sROM);
+		return (0);
+	}
+	if (LoadLevels (stCtx, sError) == 0)
+	{
+		snprintf (sResult, MAX_RESULT, "[FAILED] %s: %s", stCtx->sPathFile,
+			sError);
+		free (stCtx->sROM);
+		return (0);
+	}
+
+	/*** Save the levels again, and verify both round trips. ***/
+	iBytesGreedy = 0;
+	iRooms = 0;
+	iEvents = 0;
+	for (iLevel = 1; iLevel <= LEVELS; iLevel++)
+	{
+		iCheckSize = SerializeLevel (stCtx, iLevel, arCheck);
+		if ((iCheckSize != stCtx->arLevelRawSize[iLevel]) ||
+			(memcmp (arCheck, stCtx->arLevelRaw[iLevel], iCheckSize) != 0))
+		{
+			snprintf (sResult, MAX_RESULT, "[FAILED] %s: Level %i does not"
+				" survive a round trip", stCtx->sPathFile, iLevel);
+			free (stCtx->sROM);
+			return (0);
+		}
+		iBytes = CompressLevel (stCtx->arLevelRaw[iLevel],
+			stCtx->arLevelRawSize[iLevel], stCtx->arLevelOut[iLevel]);
+		iBytesGreedy+=iBytes;
+		if ((DecodeLevel (stCtx->arLevelOut[iLevel], iBytes, arCheck,
+			MAX_LEVEL_SIZE, &iCheckSize) != iBytes) ||
+			(iCheckSize != stCtx->arLevelRawSize[iLevel]) ||
+			(memcmp (arCheck, stCtx->arLevelRaw[iLevel], iCheckSize) != 0))
+		{
+			snprintf (sResult, MAX_RESULT, "[FAILED] %s: Level %i does not"
+				" survive a round trip", stCtx->sPathFile, iLevel);
+			free (stCtx->sROM);
+			return (0);
+		}
+
+		stLevel = &stCtx->stRom.arLevel[iLevel];
+		for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+		{
+			if (stLevel->arRoomTiles[iRoomLoop][1] != 0xFF) { iRooms++; }
+		}
+		iEvents+=stLevel->iNrEvents;
+	}
+
+	/*** Stats. ***/
+	snprintf (sResult, MAX_RESULT, "[  OK  ] %s: levels %i B, greedy %i B,"
+		" free %i B, %i rooms, %i events", stCtx->sPathFile,
+		stCtx->iBytes, iBytesGreedy, stCtx->iFree, iRooms, iEvents);
+	free (stCtx->sROM);
+
+	return (1);
+}
+/*****************************************************************************/
+void Quit (void)
+/*****************************************************************************/
+{
+	if (iChanged != 0) { InitPopUpSave(); }
+	if (iReplay != 0) { ReplayEnd(); }
+	if (fRecord != NULL) { fclose (fRecord); fRecord = NULL; }
+	if (iModified == 1) { ModifyBack(); }
+	ProfileDump();
+	ROMUnload();
+	TTF_CloseFont (font1);
+	TTF_CloseFont (font2);
+	TTF_CloseFont (font3);
+	TTF_Quit();
+	SDL_Quit();
+	exit (EXIT_NORMAL);
+}
+/*****************************************************************************/
+void InitScreen (void)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	SDL_AudioSpec fmt;
+	char sImage[MAX_IMG + 2];
+	SDL_Surface *imgicon;
+	int iJoyNr;
+	SDL_Event event;
+	int iOldXPos, iOldYPos;
+	Uint32 oldticks, newticks;
+	int iWait;
+	Uint32 iWindowFlags;
+	Uint32 iInitFlags;
+	SDL_RendererInfo info;
+	int iEventRoom;
+
+	/*** Used for looping. ***/
+	int iRoomLoop;
+	int iRoomLoop2;
+	int iTileLoop;
+	int iColLoop, iRowLoop;
+	int iAlphabetLoop;
+
+	/*** Offscreen, on a machine without a display, audio or controllers. ***/
+	iInitFlags = SDL_INIT_AUDIO|SDL_INIT_VIDEO|
+		SDL_INIT_GAMECONTROLLER|SDL_INIT_HAPTIC;
+	if (iOffscreen == 1)
+	{
+		if (SDL_getenv ("SDL_VIDEODRIVER") == NULL)
+			{ SDL_setenv ("SDL_VIDEODRIVER", "dummy", 0); }
+		iInitFlags = SDL_INIT_VIDEO;
+	}
+
+	if (SDL_Init (iInitFlags) < 0)
+	{
+		printf ("[FAILED] Unable to init SDL: %s!\n", SDL_GetError());
+		exit (EXIT_ERROR);
+	}
+	atexit (SDL_Quit);
+
+	if (iOffscreen == 1)
+	{
+		/*** The software renderer draws into surfoffscreen; no window. ***/
+		window = NULL;
+		surfoffscreen = SDL_CreateRGBSurfaceWithFormat (0,
+			(WINDOW_WIDTH) * iScale, (WINDOW_HEIGHT) * iScale, 32,
+			SDL_PIXELFORMAT_ARGB8888);
+		if (surfoffscreen == NULL)
+		{
+			printf ("[FAILED] Unable to create a surface: %s!\n", SDL_GetError());
+			exit (EXIT_ERROR);
+		}
+		ascreen = SDL_CreateSoftwareRenderer (surfoffscreen);
+	} else {
+		/*** A replay draws into a window that is never shown. ***/
+		iWindowFlags = iFullscreen;
+		if (iReplay != 0) { iWindowFlags = SDL_WINDOW_HIDDEN; }
+		window = SDL_CreateWindow (EDITOR_NAME " " EDITOR_VERSION,
+			SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+			(WINDOW_WIDTH) * iScale, (WINDOW_HEIGHT) * iScale, iWindowFlags);
+		if (window == NULL)
+		{
+			printf ("[FAILED] Unable to create a window: %s!\n", SDL_GetError());
+			exit (EXIT_ERROR);
+		}
+		ascreen = SDL_CreateRenderer (window, -1, 0);
+	}
+	if (ascreen == NULL)
+	{
+		printf ("[FAILED] Unable to set video mode: %s!\n", SDL_GetError());
+		exit (EXIT_ERROR);
+	}
+	/*** Some people may prefer linear, but we're going old school. ***/
+	SDL_SetHint (SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+	if (iFullscreen != 0)
+	{
+		SDL_RenderSetLogicalSize (ascreen, (WINDOW_WIDTH) * iScale,
+			(WINDOW_HEIGHT) * iScale);
+	}
+	imgscene = NULL;
+	SceneTexture();
+
+	/*** Atlases need large textures; see LoadImage(). ***/
+	if ((SDL_GetRendererInfo (ascreen, &info) == 0) &&
+		(info.max_texture_width != 0) &&
+		((info.max_texture_width < ATLAS_SIZE) ||
+		(info.max_texture_height < ATLAS_SIZE))) { iNoAtlas = 1; }
+
+	if (TTF_Init() == -1)
+	{
+		printf ("[FAILED] Could not initialize TTF!\n");
+		exit (EXIT_ERROR);
+	}
+
+	LoadFonts();
+
+	curArrow = SDL_CreateSystemCursor (SDL_SYSTEM_CURSOR_ARROW);
+	curWait = SDL_CreateSystemCursor (SDL_SYSTEM_CURSOR_WAIT);
+	curHand = SDL_CreateSystemCursor (SDL_SYSTEM_CURSOR_HAND);
+	curText = SDL_CreateSystemCursor (SDL_SYSTEM_CURSOR_IBEAM);
+
+	if (iNoAudio != 1)
+	{
+		PrIfDe ("[  OK  ] Initializing Audio\n");
+		fmt.freq = 44100;
+		fmt.format = AUDIO_S16;
+		fmt.channels = 2;
+		fmt.samples = 512;
+		fmt.callback = MixAudio;
+		fmt.userdata = NULL;
+		if (SDL_OpenAudio (&fmt, NULL) < 0)
+		{
+			printf ("[FAILED] Unable to open audio: %s!\n", SDL_GetError());
+			exit (EXIT_ERROR);
+		}
+		SDL_PauseAudio (0);
+	}
+
+	/*** icon ***/
+	snprintf (sImage, MAX_IMG, "png%svarious%slegbop_icon.png",
+		SLASH, SLASH);
+	imgicon = IMG_Load (sImage);
+	if (imgicon == NULL)
+	{
+		printf ("[ WARN ] Could not load \"%s\": %s!\n", sImage, strerror (errno));
+	} else if (window != NULL) {
+		SDL_SetWindowIcon (window, imgicon);
+	}
+
+	/*** Open the first available controller. ***/
+	iController = 0;
+	if (iNoController != 1)
+	{
+		for (iJoyNr = 0; iJoyNr < SDL_NumJoysticks(); iJoyNr++)
+		{
+			if (SDL_IsGameController (iJoyNr))
+			{
+				controller = SDL_GameControllerOpen (iJoyNr);
+				if (controller)
+				{
+					snprintf (sControllerName, MAX_CON, "%s",
+						SDL_GameControllerName (controller));
+					if (iDebug == 1)
 					{
-						if ((SDL_GetTicks() - trigleft) > 300)
-						{
-							if (iScreen == 2)
-							{
-								if (arBrokenRoomLinks[iCurLevel] == 0)
-								{
-									iMovingNewBusy = 0;
-									switch (iMovingRoom)
-									{
-										case 0: iMovingRoom = ROOMS; break; /*** If disabled. ***/
-										case 1: iMovingRoom = ROOMS; break;
-										default: iMovingRoom--; break;
-									}
-								}
-							}
-							if (iScreen == 3)
-							{
-								if (arNrEvents[iCurLevel] < 20) /*** Randomly picked max. ***/
-								{
-									TotalEvents (1);
-								} else {
-									arNrEvents[iCurLevel] = 0;
-									PlaySound ("wav/plus_minus.wav");
-									iChanged++;
-								}
-							}
-							trigleft = SDL_GetTicks();
-						}
+						printf ("[ INFO ] Found a controller \"%s\"; \"%s\".\n",
+							sControllerName, SDL_GameControllerNameForIndex (iJoyNr));
 					}
-					if (event.caxis.axis == SDL_CONTROLLER_AXIS_TRIGGERRIGHT)
+					joystick = SDL_GameControllerGetJoystick (controller);
+					iController = 1;
+
+					/*** Just for fun, use haptic. ***/
+					if (SDL_JoystickIsHaptic (joystick))
 					{
-						if ((SDL_GetTicks() - trigright) > 300)
+						haptic = SDL_HapticOpenFromJoystick (joystick);
+						if (SDL_HapticRumbleInit (haptic) == 0)
 						{
-							if (iScreen == 2)
-							{
-								if (arBrokenRoomLinks[iCurLevel] == 0)
-								{
-									iMovingNewBusy = 0;
-									switch (iMovingRoom)
-									{
-										case 0: iMovingRoom = 1; break; /*** If disabled. ***/
-										case 24: iMovingRoom = 1; break;
-										default: iMovingRoom++; break;
-									}
-								}
-							}
-							if (iScreen == 3)
-							{
-								if (iChangeEvent < arNrEvents[iCurLevel])
-								{
-									ChangeEvent (1, 0);
-								} else {
-									iChangeEvent = 1;
-									PlaySound ("wav/plus_minus.wav");
-								}
-							}
-							trigright = SDL_GetTicks();
+							SDL_HapticRumblePlay (haptic, 1.0, 1000);
+						} else {
+							printf ("[ WARN ] Could not initialize the haptic device: %s!\n",
+								SDL_GetError());
 						}
+					} else {
+						PrIfDe ("[ INFO ] The game controller is not haptic.\n");
 					}
-					ShowScreen();
-					break;
-				case SDL_KEYDOWN: /*** https://wiki.libsdl.org/SDL2/SDL_Keycode ***/
-					switch (event.key.keysym.sym)
-					{
-						case SDLK_F1:
-							if (iScreen == 1)
+				} else {
+					printf ("[ WARN ] Could not open game controller %i: %s!\n",
+						iController, SDL_GetError());
+				}
+			}
+		}
+		if (iController != 1) { PrIfDe ("[ INFO ] No controller found.\n"); }
+	} else {
+		PrIfDe ("[ INFO ] Using keyboard and mouse.\n");
+	}
+
+	/*******************/
+	/* Preload images. */
+	/*******************/
+
+	/*** Loading... ***/
+	PreLoad (PNG_VARIOUS, "loading.png", &imgloading);
+	ShowImage (imgloading, 0, 0, "imgloading");
+	Present();
+
+	iPreLoaded = 0;
+	SDL_SetCursor (curWait);
+
+	/*** Dungeon and palace tiles. ***/
+	PreLoadSet ('d', 0x00); PreLoadSet ('p', 0x00);
+	PreLoadSet ('d', 0x01); PreLoadSet ('p', 0x01);
+	PreLoadSet ('d', 0x02); PreLoadSet ('p', 0x02);
+	PreLoadSet ('d', 0x03); PreLoadSet ('p', 0x03);
+	PreLoadSet ('d', 0x05); PreLoadSet ('p', 0x05);
+	PreLoadSet ('d', 0x06); PreLoadSet ('p', 0x06);
+	PreLoadSet ('d', 0x07); PreLoadSet ('p', 0x07);
+	PreLoadSet ('d', 0x08); PreLoadSet ('p', 0x08);
+	PreLoadSet ('d', 0x09); PreLoadSet ('p', 0x09);
+	PreLoadSet ('d', 0x0A); PreLoadSet ('p', 0x0A);
+	PreLoadSet ('d', 0x0B); PreLoadSet ('p', 0x0B);
+	PreLoadSet ('d', 0x0C); PreLoadSet ('p', 0x0C);
+	PreLoadSet ('d', 0x0D); PreLoadSet ('p', 0x0D);
+	PreLoadSet ('d', 0x0E); PreLoadSet ('p', 0x0E);
+	PreLoadSet ('d', 0x0F); PreLoadSet ('p', 0x0F);
+	PreLoadSet ('d', 0x10); PreLoadSet ('p', 0x10);
+	PreLoadSet ('d', 0x11); PreLoadSet ('p', 0x11);
+	PreLoadSet ('d', 0x12); PreLoadSet ('p', 0x12);
+	PreLoadSet ('d', 0x13); PreLoadSet ('p', 0x13);
+	PreLoadSet ('d', 0x14); PreLoadSet ('p', 0x14);
+	PreLoadSet ('d', 0x15); PreLoadSet ('p', 0x15);
+	PreLoadSet ('d', 0x16); PreLoadSet ('p', 0x16);
+	PreLoadSet ('d', 0x17); PreLoadSet ('p', 0x17);
+	PreLoadSet ('d', 0x18); PreLoadSet ('p', 0x18);
+	PreLoadSet ('d', 0x19); PreLoadSet ('p', 0x19);
+	PreLoadSet ('d', 0x1A); PreLoadSet ('p', 0x1A);
+	PreLoadSet ('d', 0x1B); PreLoadSet ('p', 0x1B);
+	PreLoadSet ('d', 0x1C); PreLoadSet ('p', 0x1C);
+	PreLoadSet ('d', 0x1D); PreLoadSet ('p', 0x1D);
+	PreLoadSet ('d', 0x1F); PreLoadSet ('p', 0x1F);
+	PreLoadSet ('d', 0x20); PreLoadSet ('p', 0x20);
+	PreLoadSet ('d', 0x21); PreLoadSet ('p', 0x21);
+	PreLoadSet ('d', 0x24); PreLoadSet ('p', 0x24);
+	PreLoadSet ('d', 0x27); PreLoadSet ('p', 0x27);
+	PreLoadSet ('d', 0x2A); PreLoadSet ('p', 0x2A);
+	PreLoadSet ('d', 0x2B); PreLoadSet ('p', 0x2B);
+	PreLoadSet ('d', 0x2C); PreLoadSet ('p', 0x2C);
+	PreLoadSet ('d', 0x34); PreLoadSet ('p', 0x34);
+	PreLoadSet ('d', 0x40); PreLoadSet ('p', 0x40);
+	PreLoadSet ('d', 0x41); PreLoadSet ('p', 0x41);
+	PreLoadSet ('d', 0x44); PreLoadSet ('p', 0x44);
+	PreLoadSet ('d', 0x47); PreLoadSet ('p', 0x47);
+	PreLoadSet ('d', 0x4A); PreLoadSet ('p', 0x4A);
+	PreLoadSet ('d', 0x4C); PreLoadSet ('p', 0x4C);
+	PreLoadSet ('d', 0x50); PreLoadSet ('p', 0x50);
+	PreLoadSet ('d', 0x60); PreLoadSet ('p', 0x60);
+	PreLoadSet ('d', 0x6A); PreLoadSet ('p', 0x6A);
+	PreLoadSet ('d', 0x8A); PreLoadSet ('p', 0x8A);
+	PreLoadSet ('d', 0xAA); PreLoadSet ('p', 0xAA);
+	PreLoadSet ('d', 0xE0); PreLoadSet ('p', 0xE0);
+	PreLoadSet ('d', 0xE1); PreLoadSet ('p', 0xE1);
+	PreLoad ("dungeon", "0x13_sprite.png", &imgspriteflamed);
+	PreLoad ("palace", "0x13_sprite.png", &imgspriteflamep);
+
+	/*** various ***/
+	PreLoad (PNG_VARIOUS, "black.png", &imgblack);
+	PreLoad (PNG_VARIOUS, "disabled.png", &imgdisabled);
+	PreLoad (PNG_VARIOUS, "unknown.png", &imgunk[1]);
+	PreLoad (PNG_VARIOUS, "sel_unknown.png", &imgunk[2]);
+	PreLoad (PNG_VARIOUS, "sel_room_current.png", &imgsrc);
+	PreLoad (PNG_VARIOUS, "sel_room_start.png", &imgsrs);
+	PreLoad (PNG_VARIOUS, "sel_room_moving.png", &imgsrm);
+	PreLoad (PNG_VARIOUS, "sel_room_cross.png", &imgsrp);
+	PreLoad (PNG_VARIOUS, "sel_room_broken.png", &imgsrb);
+	PreLoad (PNG_VARIOUS, "sel_event.png", &imgsele);
+	PreLoad (PNG_VARIOUS, "event_unused.png", &imgeventu);
+	PreLoad (PNG_VARIOUS, "sel_level.png", &imgsell);
+	PreLoad (PNG_VARIOUS, "border_small_live.png", &imgbordersl);
+	PreLoad (PNG_VARIOUS, "border_big_live.png", &imgborderbl);
+	PreLoad (PNG_VARIOUS, "faded_l.png", &imgfadedl);
+	PreLoad (PNG_VARIOUS, "popup_yn.png", &imgpopup_yn);
+	PreLoad (PNG_VARIOUS, "help.png", &imghelp);
+	PreLoad (PNG_VARIOUS, "exe.png", &imgexe);
+	PreLoad (PNG_VARIOUS, "exe_warning.png", &imgexewarning);
+	PreLoad (PNG_VARIOUS, "faded_s.png", &imgfadeds);
+	PreLoad (PNG_VARIOUS, "event_tooltip.png", &imgetooltip);
+	PreLoad (PNG_VARIOUS, "custom_hover.png", &imgchover);
+	PreLoad (PNG_VARIOUS, "Mednafen.png", &imgmednafen);
+	PreLoad (PNG_VARIOUS, "link_warn_lr.png", &imglinkwarnlr);
+	PreLoad (PNG_VARIOUS, "link_warn_ud.png", &imglinkwarnud);
+	PreLoad (PNG_VARIOUS, "sel_textline.png", &imgseltextline);
+	PreLoad (PNG_VARIOUS, "various_warning.png", &imgvwarning);
+	if (iController != 1)
+	{
+		PreLoad (PNG_VARIOUS, "border_big.png", &imgborderb);
+		PreLoad (PNG_VARIOUS, "border_small.png", &imgborders);
+		PreLoad (PNG_VARIOUS, "broken_room_links.png", &imgbrl);
+		PreLoad (PNG_VARIOUS, "dungeon.png", &imgdungeon);
+		PreLoad (PNG_VARIOUS, "events.png", &imgevents);
+		PreLoad (PNG_VARIOUS, "level_bar.png", &imgbar);
+		PreLoad (PNG_VARIOUS, "palace.png", &imgpalace);
+		PreLoad (PNG_VARIOUS, "popup.png", &imgpopup);
+		PreLoad (PNG_VARIOUS, "room_links.png", &imgrl);
+	} else {
+		PreLoad (PNG_GAMEPAD, "border_big.png", &imgborderb);
+		PreLoad (PNG_GAMEPAD, "border_small.png", &imgborders);
+		PreLoad (PNG_GAMEPAD, "broken_room_links.png", &imgbrl);
+		PreLoad (PNG_GAMEPAD, "dungeon.png", &imgdungeon);
+		PreLoad (PNG_GAMEPAD, "events.png", &imgevents);
+		PreLoad (PNG_GAMEPAD, "level_bar.png", &imgbar);
+		PreLoad (PNG_GAMEPAD, "palace.png", &imgpalace);
+		PreLoad (PNG_GAMEPAD, "popup.png", &imgpopup);
+		PreLoad (PNG_GAMEPAD, "room_links.png", &imgrl);
+	}
+
+	/*** (s)living ***/
+	PreLoad (PNG_LIVING, "prince_l.png", &imgprincel[1]);
+	PreLoad (PNG_SLIVING, "prince_l.png", &imgprincel[2]);
+	PreLoad (PNG_LIVING, "prince_r.png", &imgprincer[1]);
+	PreLoad (PNG_SLIVING, "prince_r.png", &imgprincer[2]);
+	PreLoad (PNG_LIVING, "guard_l.png", &imgguardl[1]);
+	PreLoad (PNG_SLIVING, "guard_l.png", &imgguardl[2]);
+	PreLoad (PNG_LIVING, "guard_r.png", &imgguardr[1]);
+	PreLoad (PNG_SLIVING, "guard_r.png", &imgguardr[2]);
+	PreLoad (PNG_LIVING, "skeleton_l.png", &imgskeletonl[1]);
+	PreLoad (PNG_SLIVING, "skeleton_l.png", &imgskeletonl[2]);
+	PreLoad (PNG_LIVING, "skeleton_r.png", &imgskeletonr[1]);
+	PreLoad (PNG_SLIVING, "skeleton_r.png", &imgskeletonr[2]);
+	PreLoad (PNG_LIVING, "shadow_l.png", &imgshadowl[1]);
+	PreLoad (PNG_SLIVING, "shadow_l.png", &imgshadowl[2]);
+	PreLoad (PNG_LIVING, "shadow_r.png", &imgshadowr[1]);
+	PreLoad (PNG_SLIVING, "shadow_r.png", &imgshadowr[2]);
+	PreLoad (PNG_LIVING, "jaffar_l.png", &imgjaffarl[1]);
+	PreLoad (PNG_SLIVING, "jaffar_l.png", &imgjaffarl[2]);
+	PreLoad (PNG_LIVING, "jaffar_r.png", &imgjaffarr[1]);
+	PreLoad (PNG_SLIVING, "jaffar_r.png", &imgjaffarr[2]);
+
+	/*** buttons ***/
+	PreLoad (PNG_BUTTONS, "up_0.png", &imgup_0);
+	PreLoad (PNG_BUTTONS, "up_1.png", &imgup_1);
+	PreLoad (PNG_BUTTONS, "down_0.png", &imgdown_0);
+	PreLoad (PNG_BUTTONS, "down_1.png", &imgdown_1);
+	PreLoad (PNG_BUTTONS, "left_0.png", &imgleft_0);
+	PreLoad (PNG_BUTTONS, "left_1.png", &imgleft_1);
+	PreLoad (PNG_BUTTONS, "right_0.png", &imgright_0);
+	PreLoad (PNG_BUTTONS, "right_1.png", &imgright_1);
+	PreLoad (PNG_BUTTONS, "up_down_no.png", &imgudno);
+	PreLoad (PNG_BUTTONS, "left_right_no.png", &imglrno);
+	if (iController != 1)
+	{
+		PreLoad (PNG_BUTTONS, "broken_rooms_off.png", &imgbroomsoff);
+		PreLoad (PNG_BUTTONS, "broken_rooms_on_0.png", &imgbroomson_0);
+		PreLoad (PNG_BUTTONS, "broken_rooms_on_1.png", &imgbroomson_1);
+		PreLoad (PNG_BUTTONS, "close_big_0.png", &imgclosebig_0);
+		PreLoad (PNG_BUTTONS, "close_big_1.png", &imgclosebig_1);
+		PreLoad (PNG_BUTTONS, "events_off.png", &imgeventsoff);
+		PreLoad (PNG_BUTTONS, "events_on_0.png", &imgeventson_0);
+		PreLoad (PNG_BUTTONS, "events_on_1.png", &imgeventson_1);
+		PreLoad (PNG_BUTTONS, "next_off.png", &imgnextoff);
+		PreLoad (PNG_BUTTONS, "next_on_0.png", &imgnexton_0);
+		PreLoad (PNG_BUTTONS, "next_on_1.png", &imgnexton_1);
+		PreLoad (PNG_BUTTONS, "No.png", &imgno[1]);
+		PreLoad (PNG_BUTTONS, "OK.png", &imgok[1]);
+		PreLoad (PNG_BUTTONS, "previous_off.png", &imgprevoff);
+		PreLoad (PNG_BUTTONS, "previous_on_0.png", &imgprevon_0);
+		PreLoad (PNG_BUTTONS, "previous_on_1.png", &imgprevon_1);
+		PreLoad (PNG_BUTTONS, "quit_0.png", &imgquit_0);
+		PreLoad (PNG_BUTTONS, "quit_1.png", &imgquit_1);
+		PreLoad (PNG_BUTTONS, "rooms_off.png", &imgroomsoff);
+		PreLoad (PNG_BUTTONS, "rooms_on_0.png", &imgroomson_0);
+		PreLoad (PNG_BUTTONS, "rooms_on_1.png", &imgroomson_1);
+		PreLoad (PNG_BUTTONS, "save_off.png", &imgsaveoff);
+		PreLoad (PNG_BUTTONS, "save_on_0.png", &imgsaveon_0);
+		PreLoad (PNG_BUTTONS, "save_on_1.png", &imgsaveon_1);
+		PreLoad (PNG_BUTTONS, "Save.png", &imgsave[1]);
+		PreLoad (PNG_BUTTONS, "sel_No.png", &imgno[2]);
+		PreLoad (PNG_BUTTONS, "sel_OK.png", &imgok[2]);
+		PreLoad (PNG_BUTTONS, "sel_Save.png", &imgsave[2]);
+		PreLoad (PNG_BUTTONS, "sel_Yes.png", &imgyes[2]);
+		PreLoad (PNG_BUTTONS, "up_down_no_nfo.png", &imgudnonfo);
+		PreLoad (PNG_BUTTONS, "Yes.png", &imgyes[1]);
+	} else {
+		PreLoad (PNG_GAMEPAD, "broken_rooms_off.png", &imgbroomsoff);
+		PreLoad (PNG_GAMEPAD, "broken_rooms_on_0.png", &imgbroomson_0);
+		PreLoad (PNG_GAMEPAD, "broken_rooms_on_1.png", &imgbroomson_1);
+		PreLoad (PNG_GAMEPAD, "close_big_0.png", &imgclosebig_0);
+		PreLoad (PNG_GAMEPAD, "close_big_1.png", &imgclosebig_1);
+		PreLoad (PNG_GAMEPAD, "events_off.png", &imgeventsoff);
+		PreLoad (PNG_GAMEPAD, "events_on_0.png", &imgeventson_0);
+		PreLoad (PNG_GAMEPAD, "events_on_1.png", &imgeventson_1);
+		PreLoad (PNG_GAMEPAD, "next_off.png", &imgnextoff);
+		PreLoad (PNG_GAMEPAD, "next_on_0.png", &imgnexton_0);
+		PreLoad (PNG_GAMEPAD, "next_on_1.png", &imgnexton_1);
+		PreLoad (PNG_GAMEPAD, "No.png", &imgno[1]);
+		PreLoad (PNG_GAMEPAD, "OK.png", &imgok[1]);
+		PreLoad (PNG_GAMEPAD, "previous_off.png", &imgprevoff);
+		PreLoad (PNG_GAMEPAD, "previous_on_0.png", &imgprevon_0);
+		PreLoad (PNG_GAMEPAD, "previous_on_1.png", &imgprevon_1);
+		PreLoad (PNG_GAMEPAD, "quit_0.png", &imgquit_0);
+		PreLoad (PNG_GAMEPAD, "quit_1.png", &imgquit_1);
+		PreLoad (PNG_GAMEPAD, "rooms_off.png", &imgroomsoff);
+		PreLoad (PNG_GAMEPAD, "rooms_on_0.png", &imgroomson_0);
+		PreLoad (PNG_GAMEPAD, "rooms_on_1.png", &imgroomson_1);
+		PreLoad (PNG_GAMEPAD, "save_off.png", &imgsaveoff);
+		PreLoad (PNG_GAMEPAD, "save_on_0.png", &imgsaveon_0);
+		PreLoad (PNG_GAMEPAD, "save_on_1.png", &imgsaveon_1);
+		PreLoad (PNG_GAMEPAD, "Save.png", &imgsave[1]);
+		PreLoad (PNG_GAMEPAD, "sel_No.png", &imgno[2]);
+		PreLoad (PNG_GAMEPAD, "sel_OK.png", &imgok[2]);
+		PreLoad (PNG_GAMEPAD, "sel_Save.png", &imgsave[2]);
+		PreLoad (PNG_GAMEPAD, "sel_Yes.png", &imgyes[2]);
+		PreLoad (PNG_GAMEPAD, "up_down_no_nfo.png", &imgudnonfo);
+		PreLoad (PNG_GAMEPAD, "Yes.png", &imgyes[1]);
+	}
+
+	/*** extras ***/
+	PreLoad (PNG_EXTRAS, "extras_00.png", &imgextras[0]);
+	PreLoad (PNG_EXTRAS, "extras_01.png", &imgextras[1]);
+	PreLoad (PNG_EXTRAS, "extras_02.png", &imgextras[2]);
+	PreLoad (PNG_EXTRAS, "extras_03.png", &imgextras[3]);
+	PreLoad (PNG_EXTRAS, "extras_04.png", &imgextras[4]);
+	PreLoad (PNG_EXTRAS, "extras_05.png", &imgextras[5]);
+	PreLoad (PNG_EXTRAS, "extras_06.png", &imgextras[6]);
+	PreLoad (PNG_EXTRAS, "extras_07.png", &imgextras[7]);
+	PreLoad (PNG_EXTRAS, "extras_08.png", &imgextras[8]);
+	PreLoad (PNG_EXTRAS, "extras_09.png", &imgextras[9]);
+	PreLoad (PNG_EXTRAS, "extras_10.png", &imgextras[10]);
+
+	/*** rooms ***/
+	PreLoad (PNG_ROOMS, "room1.png", &imgroom[1]);
+	PreLoad (PNG_ROOMS, "room2.png", &imgroom[2]);
+	PreLoad (PNG_ROOMS, "room3.png", &imgroom[3]);
+	PreLoad (PNG_ROOMS, "room4.png", &imgroom[4]);
+	PreLoad (PNG_ROOMS, "room5.png", &imgroom[5]);
+	PreLoad (PNG_ROOMS, "room6.png", &imgroom[6]);
+	PreLoad (PNG_ROOMS, "room7.png", &imgroom[7]);
+	PreLoad (PNG_ROOMS, "room8.png", &imgroom[8]);
+	PreLoad (PNG_ROOMS, "room9.png", &imgroom[9]);
+	PreLoad (PNG_ROOMS, "room10.png", &imgroom[10]);
+	PreLoad (PNG_ROOMS, "room11.png", &imgroom[11]);
+	PreLoad (PNG_ROOMS, "room12.png", &imgroom[12]);
+	PreLoad (PNG_ROOMS, "room13.png", &imgroom[13]);
+	PreLoad (PNG_ROOMS, "room14.png", &imgroom[14]);
+	PreLoad (PNG_ROOMS, "room15.png", &imgroom[15]);
+	PreLoad (PNG_ROOMS, "room16.png", &imgroom[16]);
+	PreLoad (PNG_ROOMS, "room17.png", &imgroom[17]);
+	PreLoad (PNG_ROOMS, "room18.png", &imgroom[18]);
+	PreLoad (PNG_ROOMS, "room19.png", &imgroom[19]);
+	PreLoad (PNG_ROOMS, "room20.png", &imgroom[20]);
+	PreLoad (PNG_ROOMS, "room21.png", &imgroom[21]);
+	PreLoad (PNG_ROOMS, "room22.png", &imgroom[22]);
+	PreLoad (PNG_ROOMS, "room23.png", &imgroom[23]);
+	PreLoad (PNG_ROOMS, "room24.png", &imgroom[24]);
+	PreLoad (PNG_ROOMS, "room25.png", &imgroom[25]); /*** "?"; high links ***/
+
+	/*** alphabet ***/
+	for (iAlphabetLoop = 1; iAlphabetLoop <= 26; iAlphabetLoop++)
+	{
+		snprintf (sImage, MAX_IMG, "%c.png", iAlphabetLoop + 0x40);
+		PreLoad (PNG_ALPHABET, sImage, &imgalphabet[iAlphabetLoop]);
+	}
+	PreLoad (PNG_ALPHABET, "space.png", &imgspace);
+	PreLoad (PNG_ALPHABET, "unknown.png", &imgunknown);
+
+	CreateAtlases();
+	if (iDebug == 1)
+		{ printf ("[ INFO ] Preloaded images: %i\n", iPreLoaded); }
+	SDL_SetCursor (curArrow);
+
+	/*** Defaults. ***/
+	iCurLevel = iStartLevel;
+	iCurRoom = stEdit.stRom.arLevel[iCurLevel].arStartLocation[1];
+	iDownAt = 0;
+	iSelected = 1; /*** Start with the upper left selected. ***/
+	iScreen = 1;
+	iChangeEvent = 1;
+	iFlameFrame = 1;
+	oldticks = 0;
+
+	iTTP1 = TTPD_1;
+	iTTPO = TTPD_O;
+	iDX = DD_X;
+	iDY = DD_Y;
+	iHor[0] = (iDX * -1) + OFFSETD_X;
+	iHor[1] = (iDX * 0) + OFFSETD_X;
+	iHor[2] = (iDX * 1) + OFFSETD_X;
+	iHor[3] = (iDX * 2) + OFFSETD_X;
+	iHor[4] = (iDX * 3) + OFFSETD_X;
+	iHor[5] = (iDX * 4) + OFFSETD_X;
+	iHor[6] = (iDX * 5) + OFFSETD_X;
+	iHor[7] = (iDX * 6) + OFFSETD_X;
+	iHor[8] = (iDX * 7) + OFFSETD_X;
+	iHor[9] = (iDX * 8) + OFFSETD_X;
+	iHor[10] = (iDX * 9) + OFFSETD_X;
+	iVer0 = OFFSETD_Y - iTTP1 - (iDY * 1);
+	iVer1 = OFFSETD_Y - iTTP1 + (iDY * 0);
+	iVer2 = OFFSETD_Y - iTTP1 + (iDY * 1);
+	iVer3 = OFFSETD_Y - iTTP1 + (iDY * 2);
+	iVer4 = OFFSETD_Y - iTTP1 + (iDY * 3);
+
+	if ((strcmp (sScreenshot, "") != 0) || (strcmp (sScreenshots, "") != 0))
+		{ Screenshots(); }
+
+	InputStart();
+	ShowScreen();
+	InitPopUp();
+	while (1)
+	{
+		if (iNoAnim == 0)
+		{
+			/* This is for the animation; 20 fps (1000/50). The GBC runs at
+			 * about 60 fps, but changes the torch flames every 3 frames.
+			 */
+			newticks = Ticks();
+			if (newticks > oldticks + FLAME_MS)
+			{
+				iFlameFrame++;
+				if (iFlameFrame == 5) { iFlameFrame = 1; }
+				ShowFlames();
+				oldticks = newticks;
+			}
+		}
+
+		while (PollEvent (&event))
+		{
+			/*** Prev() and Next() change the current level. ***/
+			stLevel = &stEdit.stRom.arLevel[iCurLevel];
+			UndoEnd();
+
+			switch (event.type)
+			{
+				case SDL_CONTROLLERBUTTONDOWN:
+					/*** Nothing for now. ***/
+					break;
+				case SDL_CONTROLLERBUTTONUP:
+					switch (event.cbutton.button)
+					{
+						case SDL_CONTROLLER_BUTTON_A:
+							InitScreenAction ("enter");
+							break;
+						case SDL_CONTROLLER_BUTTON_B:
+							switch (iScreen)
+							{
+								case 1:
+									Quit(); break;
+								case 2:
+									arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
+									iScreen = 1; break;
+								case 3:
+									iScreen = 1; break;
+							}
+							break;
+						case SDL_CONTROLLER_BUTTON_X:
+							if (iScreen != 2)
+							{
+								iScreen = 2;
+								iMovingRoom = 0;
+								iMovingNewBusy = 0;
+								iChangingBrokenRoom = iCurRoom;
+								iChangingBrokenSide = 1;
+								PlaySound ("wav/screen2or3.wav");
+							} else if (arBrokenRoomLinks[iCurLevel] == 0) {
+								arBrokenRoomLinks[iCurLevel] = 1;
+								PlaySound ("wav/screen2or3.wav");
+							}
+							break;
+						case SDL_CONTROLLER_BUTTON_Y:
+							if (iScreen == 2)
+							{
+								arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
+							}
+							if (iScreen != 3)
+							{
+								iScreen = 3;
+								if (iChangeEvent > stLevel->iNrEvents)
+									{ iChangeEvent = stLevel->iNrEvents; }
+								PlaySound ("wav/screen2or3.wav");
+							} else {
+								switch (stLevel->arEventsOpenClose[iChangeEvent])
+								{
+									case 0x00:
+										stLevel->arEventsOpenClose[iChangeEvent] = 0x01;
+										break;
+									case 0x01:
+										stLevel->arEventsOpenClose[iChangeEvent] = 0x00;
+										break;
+								}
+								PlaySound ("wav/check_box.wav");
+								stEdit.arLevelDirty[iCurLevel] = 1;
+								iChanged++;
+							}
+							break;
+						case SDL_CONTROLLER_BUTTON_BACK:
+							if ((iScreen == 2) && (arBrokenRoomLinks[iCurLevel] == 1))
+							{
+								LinkMinus();
+							}
+							if (iScreen == 3)
+							{
+								iEventRoom = stLevel->arEventsFromRoom[iChangeEvent];
+								if ((iEventRoom >= 1) && (iEventRoom <= 23))
+								{
+									EventRoom (iEventRoom + 1, 0);
+								} else {
+									EventRoom (1, 0);
+								}
+							}
+							break;
+						case SDL_CONTROLLER_BUTTON_GUIDE:
+							if (iChanged != 0) { CallSave(); } break;
+						case SDL_CONTROLLER_BUTTON_START:
+							RunLevel (iCurLevel);
+							break;
+						case SDL_CONTROLLER_BUTTON_LEFTSHOULDER:
+							if (iCurLevel != 1)
+							{
+								if (iChanged != 0) { InitPopUpSave(); }
+								Prev();
+							}
+							break;
+						case SDL_CONTROLLER_BUTTON_RIGHTSHOULDER:
+							if (iCurLevel != LEVELS)
+							{
+								if (iChanged != 0) { InitPopUpSave(); }
+								Next();
+							}
+							break;
+						case SDL_CONTROLLER_BUTTON_DPAD_LEFT:
+							InitScreenAction ("left"); break;
+						case SDL_CONTROLLER_BUTTON_DPAD_RIGHT:
+							InitScreenAction ("right"); break;
+						case SDL_CONTROLLER_BUTTON_DPAD_UP:
+							InitScreenAction ("up"); break;
+						case SDL_CONTROLLER_BUTTON_DPAD_DOWN:
+							InitScreenAction ("down"); break;
+					}
+					ShowScreen();
+					break;
+				case SDL_CONTROLLERAXISMOTION: /*** triggers and analog sticks ***/
+					iXJoy1 = SDL_JoystickGetAxis (joystick, 0);
+					iYJoy1 = SDL_JoystickGetAxis (joystick, 1);
+					iXJoy2 = SDL_JoystickGetAxis (joystick, 3);
+					iYJoy2 = SDL_JoystickGetAxis (joystick, 4);
+					if ((iXJoy1 < -30000) || (iXJoy2 < -30000)) /*** left ***/
+					{
+						if ((Ticks() - joyleft) > 300)
+						{
+							if (iScreen == 1)
+							{
+								if (stLevel->arRoomLinks[iCurRoom][1] != 0)
+								{
+									iCurRoom = stLevel->arRoomLinks[iCurRoom][1];
+									PlaySound ("wav/scroll.wav");
+								}
+							}
+							if (iScreen == 3)
+							{
+								InitScreenAction ("left from");
+							}
+							joyleft = Ticks();
+						}
+					}
+					if ((iXJoy1 > 30000) || (iXJoy2 > 30000)) /*** right ***/
+					{
+						if ((Ticks() - joyright) > 300)
+						{
+							if (iScreen == 1)
+							{
+								if (stLevel->arRoomLinks[iCurRoom][2] != 0)
+								{
+									iCurRoom = stLevel->arRoomLinks[iCurRoom][2];
+									PlaySound ("wav/scroll.wav");
+								}
+							}
+							if (iScreen == 3)
+							{
+								InitScreenAction ("right from");
+							}
+							joyright = Ticks();
+						}
+					}
+					if ((iYJoy1 < -30000) || (iYJoy2 < -30000)) /*** up ***/
+					{
+						if ((Ticks() - joyup) > 300)
+						{
+							if (iScreen == 1)
+							{
+								if (stLevel->arRoomLinks[iCurRoom][3] != 0)
+								{
+									iCurRoom = stLevel->arRoomLinks[iCurRoom][3];
+									PlaySound ("wav/scroll.wav");
+								}
+							}
+							if (iScreen == 3)
+							{
+								InitScreenAction ("up from");
+							}
+							joyup = Ticks();
+						}
+					}
+					if ((iYJoy1 > 30000) || (iYJoy2 > 30000)) /*** down ***/
+					{
+						if ((Ticks() - joydown) > 300)
+						{
+							if (iScreen == 1)
+							{
+								if (stLevel->arRoomLinks[iCurRoom][4] != 0)
+								{
+									iCurRoom = stLevel->arRoomLinks[iCurRoom][4];
+									PlaySound ("wav/scroll.wav");
+								}
+							}
+							if (iScreen == 3)
+							{
+								InitScreenAction ("down from");
+							}
+							joydown = Ticks();
+						}
+					}
+					if (event.caxis.axis == SDL_CONTROLLER_AXIS_TRIGGERLEFT)
+					{
+						if ((Ticks() - trigleft) > 300)
+						{
+							if (iScreen == 2)
+							{
+								if (arBrokenRoomLinks[iCurLevel] == 0)
+								{
+									iMovingNewBusy = 0;
+									switch (iMovingRoom)
+									{
+										case 0: iMovingRoom = ROOMS; break; /*** If disabled. ***/
+										case 1: iMovingRoom = ROOMS; break;
+										default: iMovingRoom--; break;
+									}
+								}
+							}
+							if (iScreen == 3)
+							{
+								if (stLevel->iNrEvents < 20) /*** Randomly picked max. ***/
+								{
+									TotalEvents (1);
+								} else {
+									stLevel->iNrEvents = 0;
+									stEdit.arLevelDirty[iCurLevel] = 1;
+									PlaySound ("wav/plus_minus.wav");
+									iChanged++;
+								}
+							}
+							trigleft = Ticks();
+						}
+					}
+					if (event.caxis.axis == SDL_CONTROLLER_AXIS_TRIGGERRIGHT)
+					{
+						if ((Ticks() - trigright) > 300)
+						{
+							if (iScreen == 2)
+							{
+								if (arBrokenRoomLinks[iCurLevel] == 0)
+								{
+									iMovingNewBusy = 0;
+									switch (iMovingRoom)
+									{
+										case 0: iMovingRoom = 1; break; /*** If disabled. ***/
+										case 24: iMovingRoom = 1; break;
+										default: iMovingRoom++; break;
+									}
+								}
+							}
+							if (iScreen == 3)
+							{
+								if (iChangeEvent < stLevel->iNrEvents)
+								{
+									ChangeEvent (1, 0);
+								} else {
+									iChangeEvent = 1;
+									PlaySound ("wav/plus_minus.wav");
+								}
+							}
+							trigright = Ticks();
+						}
+					}
+					ShowScreen();
+					break;
+				case SDL_KEYDOWN: /*** https://wiki.libsdl.org/SDL2/SDL_Keycode ***/
+					switch (event.key.keysym.sym)
+					{
+						case SDLK_F1:
+							if (iScreen == 1)
+							{
+								Help(); SDL_SetCursor (curArrow);
+							}
+							break;
+						case SDLK_F2:
+							if (iScreen == 1)
+							{
+								EXE();
+								SDL_SetCursor (curArrow);
+								SDL_StopTextInput();
+							}
+							break;
+						case SDLK_F3:
+							iProfileHUD = 1 - iProfileHUD;
+							if (iProfileHUD == 1) { ProfileText(); }
+							ShowScreen(); break;
+						case SDLK_LEFTBRACKET:
+							if (event.key.keysym.mod & KMOD_SHIFT)
+							{
+								InitScreenAction ("left brace"); /*** { ***/
+							} else {
+								InitScreenAction ("left bracket"); /*** [ ***/
+							}
+							break;
+						case SDLK_RIGHTBRACKET:
+							if (event.key.keysym.mod & KMOD_SHIFT)
+							{
+								InitScreenAction ("right brace"); /*** } ***/
+							} else {
+								InitScreenAction ("right bracket"); /*** ] ***/
+							}
+							break;
+						case SDLK_d:
+							RunLevel (iCurLevel);
+							break;
+						case SDLK_SLASH:
+							if (iScreen == 1) { ClearRoom(); }
+							break;
+						case SDLK_BACKSLASH:
+							if (iScreen == 1)
+							{
+								/*** Randomize the entire level. ***/
+								for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+								{
+									for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+									{
+										UseTile (-1, iTileLoop, iRoomLoop);
+									}
+								}
+								iChanged++;
+								PlaySound ("wav/ok_close.wav");
+							}
+							break;
+						case SDLK_KP_ENTER:
+						case SDLK_RETURN:
+						case SDLK_SPACE:
+							if (((event.key.keysym.mod & KMOD_LALT) ||
+								(event.key.keysym.mod & KMOD_RALT)) && (iScreen == 1))
+							{
+								Zoom (1);
+								iExtras = 0;
+								PlaySound ("wav/extras.wav");
+							} else {
+								InitScreenAction ("enter");
+							}
+							break;
+						case SDLK_BACKSPACE:
+							if ((iScreen == 2) && (arBrokenRoomLinks[iCurLevel] == 1))
+							{
+								LinkMinus();
+							}
+							break;
+						case SDLK_ESCAPE:
+						case SDLK_q:
+							switch (iScreen)
+							{
+								case 1:
+									Quit(); break;
+								case 2:
+									arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
+									iScreen = 1; break;
+								case 3:
+									iScreen = 1; break;
+							}
+							break;
+						case SDLK_LEFT:
+							if ((event.key.keysym.mod & KMOD_LSHIFT) ||
+								(event.key.keysym.mod & KMOD_RSHIFT))
+							{
+								switch (iScreen)
+								{
+									case 1:
+										if (stLevel->arRoomLinks[iCurRoom][1] != 0)
+										{
+											iCurRoom = stLevel->arRoomLinks[iCurRoom][1];
+											PlaySound ("wav/scroll.wav");
+										}
+										break;
+									case 3:
+										ChangeEvent (-1, 0);
+										break;
+								}
+							} else if ((event.key.keysym.mod & KMOD_LCTRL) ||
+								(event.key.keysym.mod & KMOD_RCTRL))
+							{
+								if (iScreen == 3)
+								{
+									ChangeEvent (-10, 0);
+								}
+							} else {
+								InitScreenAction ("left");
+							}
+							break;
+						case SDLK_RIGHT:
+							if ((event.key.keysym.mod & KMOD_LSHIFT) ||
+								(event.key.keysym.mod & KMOD_RSHIFT))
+							{
+								switch (iScreen)
+								{
+									case 1:
+										if (stLevel->arRoomLinks[iCurRoom][2] != 0)
+										{
+											iCurRoom = stLevel->arRoomLinks[iCurRoom][2];
+											PlaySound ("wav/scroll.wav");
+										}
+										break;
+									case 3:
+										ChangeEvent (1, 0);
+										break;
+								}
+							} else if ((event.key.keysym.mod & KMOD_LCTRL) ||
+								(event.key.keysym.mod & KMOD_RCTRL))
+							{
+								if (iScreen == 3)
+								{
+									ChangeEvent (10, 0);
+								}
+							} else {
+								InitScreenAction ("right");
+							}
+							break;
+						case SDLK_UP:
+							if ((event.key.keysym.mod & KMOD_LSHIFT) ||
+								(event.key.keysym.mod & KMOD_RSHIFT))
+							{
+								if (iScreen == 1)
+								{
+									if (stLevel->arRoomLinks[iCurRoom][3] != 0)
+									{
+										iCurRoom = stLevel->arRoomLinks[iCurRoom][3];
+										PlaySound ("wav/scroll.wav");
+									}
+								}
+							} else {
+								InitScreenAction ("up");
+							}
+							break;
+						case SDLK_DOWN:
+							if ((event.key.keysym.mod & KMOD_LSHIFT) ||
+								(event.key.keysym.mod & KMOD_RSHIFT))
+							{
+								if (iScreen == 1)
+								{
+									if (stLevel->arRoomLinks[iCurRoom][4] != 0)
+									{
+										iCurRoom = stLevel->arRoomLinks[iCurRoom][4];
+										PlaySound ("wav/scroll.wav");
+									}
+								}
+							} else {
+								InitScreenAction ("down");
+							}
+							break;
+						case SDLK_t:
+							/*** Will change the environment. ***/
+							break;
+						case SDLK_MINUS:
+						case SDLK_KP_MINUS:
+							if (iCurLevel != 1)
+							{
+								if (iChanged != 0) { InitPopUpSave(); }
+								Prev();
+							}
+							break;
+						case SDLK_KP_PLUS:
+						case SDLK_EQUALS:
+							if (iCurLevel != LEVELS)
+							{
+								if (iChanged != 0) { InitPopUpSave(); }
+								Next();
+							}
+							break;
+						case SDLK_r:
+							if (iScreen != 2)
+							{
+								iScreen = 2;
+								iMovingRoom = 0;
+								iMovingNewBusy = 0;
+								iChangingBrokenRoom = iCurRoom;
+								iChangingBrokenSide = 1;
+								PlaySound ("wav/screen2or3.wav");
+							} else if (arBrokenRoomLinks[iCurLevel] == 0) {
+								arBrokenRoomLinks[iCurLevel] = 1;
+								PlaySound ("wav/screen2or3.wav");
+							}
+							break;
+						case SDLK_e:
+							if (iScreen == 2)
+							{
+								arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
+							}
+							if (iScreen != 3)
+							{
+								iScreen = 3;
+								if (iChangeEvent > stLevel->iNrEvents)
+									{ iChangeEvent = stLevel->iNrEvents; }
+								PlaySound ("wav/screen2or3.wav");
+							}
+							break;
+						case SDLK_s:
+							if (iChanged != 0) { CallSave(); } break;
+						case SDLK_p:
+							if ((iChanged == 0) || (CallSave() == 1)) { ExportPatches(); }
+							break;
+						case SDLK_z:
+							if ((iScreen == 1) && (event.key.keysym.mod & KMOD_CTRL))
+							{
+								if (event.key.keysym.mod & KMOD_SHIFT)
+									{ Undo (1); } else { Undo (0); }
+							} else if (iScreen == 1) {
+								Zoom (0);
+								iExtras = 0;
+								PlaySound ("wav/extras.wav");
+							}
+							break;
+						case SDLK_y:
+							if ((iScreen == 1) && (event.key.keysym.mod & KMOD_CTRL))
+								{ Undo (1); }
+							break;
+						case SDLK_f:
+							if (iScreen == 1)
+							{
+								Zoom (1);
+								iExtras = 0;
+								PlaySound ("wav/extras.wav");
+							}
+							break;
+						case SDLK_QUOTE:
+							if (iScreen == 1)
+							{
+								if ((event.key.keysym.mod & KMOD_LSHIFT) ||
+									(event.key.keysym.mod & KMOD_RSHIFT))
+								{
+									Sprinkle();
+									PlaySound ("wav/extras.wav");
+									iChanged++;
+								} else {
+									SetLocation (iCurRoom, iSelected, iLastTile);
+									PlaySound ("wav/ok_close.wav");
+									iChanged++;
+								}
+							}
+							break;
+						case SDLK_h:
+							if (iScreen == 1)
+							{
+								FlipRoom (1);
+								PlaySound ("wav/extras.wav");
+								iChanged++;
+							}
+							if (iScreen == 3)
+							{
+								if (event.key.keysym.mod & KMOD_LCTRL)
+								{
+									TotalEvents (-10);
+								} else if (event.key.keysym.mod & KMOD_SHIFT) {
+									TotalEvents (-1);
+								} else {
+									InitScreenAction ("left from");
+								}
+							}
+							break;
+						case SDLK_j:
+							if (iScreen == 3)
+							{
+								if (event.key.keysym.mod & KMOD_LCTRL)
+								{
+									TotalEvents (10);
+								} else if (event.key.keysym.mod & KMOD_SHIFT) {
+									TotalEvents (1);
+								} else {
+									InitScreenAction ("right from");
+								}
+							}
+							break;
+						case SDLK_u:
+							if (iScreen == 3)
+							{
+								InitScreenAction ("up from");
+							}
+							break;
+						case SDLK_n:
+							if (iScreen == 3)
+							{
+								InitScreenAction ("down from");
+							}
+							break;
+						case SDLK_v:
+							if (iScreen == 1)
+							{
+								if ((event.key.keysym.mod & KMOD_LCTRL) ||
+									(event.key.keysym.mod & KMOD_RCTRL))
+								{
+									CopyPaste (2);
+									PlaySound ("wav/extras.wav");
+									iChanged++;
+								} else {
+									FlipRoom (2);
+									PlaySound ("wav/extras.wav");
+									iChanged++;
+								}
+							}
+							break;
+						case SDLK_c:
+							if (iScreen == 1)
+							{
+								if ((event.key.keysym.mod & KMOD_LCTRL) ||
+									(event.key.keysym.mod & KMOD_RCTRL))
+								{
+									CopyPaste (1);
+									PlaySound ("wav/extras.wav");
+								}
+							}
+							if (iScreen == 3)
+							{
+								if (stLevel->arEventsOpenClose[iChangeEvent] != 0x00)
+								{
+									stLevel->arEventsOpenClose[iChangeEvent] = 0x00;
+									PlaySound ("wav/check_box.wav");
+									stEdit.arLevelDirty[iCurLevel] = 1;
+									iChanged++;
+								}
+							}
+							break;
+						case SDLK_o:
+							if (iScreen == 3)
+							{
+								if (stLevel->arEventsOpenClose[iChangeEvent] != 0x01)
+								{
+									stLevel->arEventsOpenClose[iChangeEvent] = 0x01;
+									PlaySound ("wav/check_box.wav");
+									stEdit.arLevelDirty[iCurLevel] = 1;
+									iChanged++;
+								}
+							}
+							break;
+						case SDLK_i:
+							if (iScreen == 1)
+							{
+								if (iInfo == 0) { iInfo = 1; } else { iInfo = 0; }
+							}
+							break;
+						case SDLK_0: /*** empty ***/
+						case SDLK_KP_0:
+							if (iScreen == 1)
+							{
+								SetLocation (iCurRoom, iSelected, 0x00);
+								PlaySound ("wav/ok_close.wav"); iChanged++;
+							}
+							break;
+						case SDLK_1: /*** floor ***/
+						case SDLK_KP_1:
+							if (iScreen == 1)
+							{
+								SetLocation (iCurRoom, iSelected, 0x01);
+								PlaySound ("wav/ok_close.wav"); iChanged++;
+							}
+							break;
+						case SDLK_2: /*** loose tile ***/
+						case SDLK_KP_2:
+							if (iScreen == 1)
+							{
+								SetLocation (iCurRoom, iSelected, 0x0B);
+								PlaySound ("wav/ok_close.wav"); iChanged++;
+							}
+							break;
+						case SDLK_3: /*** closed gate ***/
+						case SDLK_KP_3:
+							if (iScreen == 1)
+							{
+								SetLocation (iCurRoom, iSelected, 0x44);
+								PlaySound ("wav/ok_close.wav"); iChanged++;
+							}
+							break;
+						case SDLK_4: /*** open gate ***/
+						case SDLK_KP_4:
+							if (iScreen == 1)
+							{
+								SetLocation (iCurRoom, iSelected, 0x24);
+								PlaySound ("wav/ok_close.wav"); iChanged++;
+							}
+							break;
+						case SDLK_5: /*** torch ***/
+						case SDLK_KP_5:
+							if (iScreen == 1)
+							{
+								SetLocation (iCurRoom, iSelected, 0x13);
+								PlaySound ("wav/ok_close.wav"); iChanged++;
+							}
+							break;
+						case SDLK_6: /*** spikes ***/
+						case SDLK_KP_6:
+							if (iScreen == 1)
+							{
+								SetLocation (iCurRoom, iSelected, 0x02);
+								PlaySound ("wav/ok_close.wav"); iChanged++;
+							}
+							break;
+						case SDLK_7: /*** small pillar ***/
+						case SDLK_KP_7:
+							if (iScreen == 1)
+							{
+								SetLocation (iCurRoom, iSelected, 0x03);
+								PlaySound ("wav/ok_close.wav"); iChanged++;
+							}
+							break;
+						case SDLK_8: /*** chomper ***/
+						case SDLK_KP_8:
+							if (iScreen == 1)
+							{
+								SetLocation (iCurRoom, iSelected, 0x12);
+								PlaySound ("wav/ok_close.wav"); iChanged++;
+							}
+							break;
+						case SDLK_9: /*** wall ***/
+						case SDLK_KP_9:
+							if (iScreen == 1)
+							{
+								SetLocation (iCurRoom, iSelected, 0x14);
+								PlaySound ("wav/ok_close.wav"); iChanged++;
+							}
+							break;
+						default: break;
+					}
+					ShowScreen();
+					break;
+				case SDL_MOUSEMOTION:
+					iOldXPos = iXPos;
+					iOldYPos = iYPos;
+					iXPos = event.motion.x;
+					iYPos = event.motion.y;
+					if ((iOldXPos == iXPos) && (iOldYPos == iYPos)) { break; }
+
+					/*** Mednafen information. ***/
+					if (OnLevelBar() == 1)
+					{
+						if (iMednafen != 1) { iMednafen = 1; ShowScreen(); }
+					} else {
+						if (iMednafen != 0) { iMednafen = 0; ShowScreen(); }
+					}
+
+					if (iScreen == 2)
+					{
+						if (iMovingRoom != 0) { ShowScreen(); }
+					}
+
+					if (iScreen == 1)
+					{
+						/*** User hovers over tiles in the upper row. ***/
+						if ((InArea (iHor[1], iVer1 + iTTP1, iHor[2], iVer2 + iTTPO)
+							== 1) && (iSelected != 1))
+							{ iSelected = 1; ShowScreen(); }
+						else if ((InArea (iHor[2], iVer1 + iTTP1, iHor[3], iVer2 + iTTPO)
+							== 1) && (iSelected != 2))
+							{ iSelected = 2; ShowScreen(); }
+						else if ((InArea (iHor[3], iVer1 + iTTP1, iHor[4], iVer2 + iTTPO)
+							== 1) && (iSelected != 3))
+							{ iSelected = 3; ShowScreen(); }
+						else if ((InArea (iHor[4], iVer1 + iTTP1, iHor[5], iVer2 + iTTPO)
+							== 1) && (iSelected != 4))
+							{ iSelected = 4; ShowScreen(); }
+						else if ((InArea (iHor[5], iVer1 + iTTP1, iHor[6], iVer2 + iTTPO)
+							== 1) && (iSelected != 5))
+							{ iSelected = 5; ShowScreen(); }
+						else if ((InArea (iHor[6], iVer1 + iTTP1, iHor[7], iVer2 + iTTPO)
+							== 1) && (iSelected != 6))
+							{ iSelected = 6; ShowScreen(); }
+						else if ((InArea (iHor[7], iVer1 + iTTP1, iHor[8], iVer2 + iTTPO)
+							== 1) && (iSelected != 7))
+							{ iSelected = 7; ShowScreen(); }
+						else if ((InArea (iHor[8], iVer1 + iTTP1, iHor[9], iVer2 + iTTPO)
+							== 1) && (iSelected != 8))
+							{ iSelected = 8; ShowScreen(); }
+						else if ((InArea (iHor[9], iVer1 + iTTP1, iHor[10], iVer2 + iTTPO)
+							== 1) && (iSelected != 9))
+							{ iSelected = 9; ShowScreen(); }
+						else if ((InArea (iHor[10], iVer1 + iTTP1, iHor[10] + iDX,
+							iVer2 + iTTPO) == 1) && (iSelected != 10))
+						{ iSelected = 10; ShowScreen(); }
+
+						/*** User hovers over tiles in the middle row. ***/
+						else if ((InArea (iHor[1], iVer2 + iTTPO, iHor[2], iVer3 + iTTPO)
+							== 1) && (iSelected != 11))
+							{ iSelected = 11; ShowScreen(); }
+						else if ((InArea (iHor[2], iVer2 + iTTPO, iHor[3], iVer3 + iTTPO)
+							== 1) && (iSelected != 12))
+							{ iSelected = 12; ShowScreen(); }
+						else if ((InArea (iHor[3], iVer2 + iTTPO, iHor[4], iVer3 + iTTPO)
+							== 1) && (iSelected != 13))
+							{ iSelected = 13; ShowScreen(); }
+						else if ((InArea (iHor[4], iVer2 + iTTPO, iHor[5], iVer3 + iTTPO)
+							== 1) && (iSelected != 14))
+							{ iSelected = 14; ShowScreen(); }
+						else if ((InArea (iHor[5], iVer2 + iTTPO, iHor[6], iVer3 + iTTPO)
+							== 1) && (iSelected != 15))
+							{ iSelected = 15; ShowScreen(); }
+						else if ((InArea (iHor[6], iVer2 + iTTPO, iHor[7], iVer3 + iTTPO)
+							== 1) && (iSelected != 16))
+							{ iSelected = 16; ShowScreen(); }
+						else if ((InArea (iHor[7], iVer2 + iTTPO, iHor[8], iVer3 + iTTPO)
+							== 1) && (iSelected != 17))
+							{ iSelected = 17; ShowScreen(); }
+						else if ((InArea (iHor[8], iVer2 + iTTPO, iHor[9], iVer3 + iTTPO)
+							== 1) && (iSelected != 18))
+							{ iSelected = 18; ShowScreen(); }
+						else if ((InArea (iHor[9], iVer2 + iTTPO, iHor[10], iVer3 + iTTPO)
+							== 1) && (iSelected != 19))
+							{ iSelected = 19; ShowScreen(); }
+						else if ((InArea (iHor[10], iVer2 + iTTPO, iHor[10] + iDX,
+							iVer3 + iTTPO) == 1) && (iSelected != 20))
+						{ iSelected = 20; ShowScreen(); }
+
+						/*** User hovers over tiles in the bottom row. ***/
+						else if ((InArea (iHor[1], iVer3 + iTTPO, iHor[2],
+							iVer3 + iDY + iTTPO) == 1) && (iSelected != 21))
+							{ iSelected = 21; ShowScreen(); }
+						else if ((InArea (iHor[2], iVer3 + iTTPO, iHor[3],
+							iVer3 + iDY + iTTPO) == 1) && (iSelected != 22))
+							{ iSelected = 22; ShowScreen(); }
+						else if ((InArea (iHor[3], iVer3 + iTTPO, iHor[4],
+							iVer3 + iDY + iTTPO) == 1) && (iSelected != 23))
+							{ iSelected = 23; ShowScreen(); }
+						else if ((InArea (iHor[4], iVer3 + iTTPO, iHor[5],
+							iVer3 + iDY + iTTPO) == 1) && (iSelected != 24))
+							{ iSelected = 24; ShowScreen(); }
+						else if ((InArea (iHor[5], iVer3 + iTTPO, iHor[6],
+							iVer3 + iDY + iTTPO) == 1) && (iSelected != 25))
+							{ iSelected = 25; ShowScreen(); }
+						else if ((InArea (iHor[6], iVer3 + iTTPO, iHor[7],
+							iVer3 + iDY + iTTPO) == 1) && (iSelected != 26))
+							{ iSelected = 26; ShowScreen(); }
+						else if ((InArea (iHor[7], iVer3 + iTTPO, iHor[8],
+							iVer3 + iDY + iTTPO) == 1) && (iSelected != 27))
+							{ iSelected = 27; ShowScreen(); }
+						else if ((InArea (iHor[8], iVer3 + iTTPO, iHor[9],
+							iVer3 + iDY + iTTPO) == 1) && (iSelected != 28))
+							{ iSelected = 28; ShowScreen(); }
+						else if ((InArea (iHor[9], iVer3 + iTTPO, iHor[10],
+							iVer3 + iDY + iTTPO) == 1) && (iSelected != 29))
+							{ iSelected = 29; ShowScreen(); }
+						else if ((InArea (iHor[10], iVer3 + iTTPO, iHor[10] + iDX,
+							iVer3 + iDY + iTTPO) == 1) && (iSelected != 30))
+						{ iSelected = 30; ShowScreen(); }
+
+						/*** extras ***/
+						if ((InArea (610, 3, 619, 12) == 1) && (iExtras != 1))
+							{ iExtras = 1; ShowScreen(); }
+						else if ((InArea (620, 3, 629, 12) == 1) && (iExtras != 2))
+							{ iExtras = 2; ShowScreen(); }
+						else if ((InArea (630, 3, 639, 12) == 1) && (iExtras != 3))
+							{ iExtras = 3; ShowScreen(); }
+						else if ((InArea (640, 3, 649, 12) == 1) && (iExtras != 4))
+							{ iExtras = 4; ShowScreen(); }
+						else if ((InArea (650, 3, 659, 12) == 1) && (iExtras != 5))
+							{ iExtras = 5; ShowScreen(); }
+						else if ((InArea (610, 13, 619, 22) == 1) && (iExtras != 6))
+							{ iExtras = 6; ShowScreen(); }
+						else if ((InArea (620, 13, 629, 22) == 1) && (iExtras != 7))
+							{ iExtras = 7; ShowScreen(); }
+						else if ((InArea (630, 13, 639, 22) == 1) && (iExtras != 8))
+							{ iExtras = 8; ShowScreen(); }
+						else if ((InArea (640, 13, 649, 22) == 1) && (iExtras != 9))
+							{ iExtras = 9; ShowScreen(); }
+						else if ((InArea (650, 13, 659, 22) == 1) && (iExtras != 10))
+							{ iExtras = 10; ShowScreen(); }
+						else if ((InArea (610, 3, 659, 22) == 0) && (iExtras != 0))
+							{ iExtras = 0; ShowScreen(); }
+					}
+
+					break;
+				case SDL_MOUSEBUTTONDOWN:
+					if (event.button.button == 1)
+					{
+						if (InArea (0, 50, 25, 548) == 1) /*** left arrow ***/
+						{
+							if (stLevel->arRoomLinks[iCurRoom][1] != 0) { iDownAt = 1; }
+						}
+						if (InArea (667, 50, 692, 548) == 1) /*** right arrow ***/
+						{
+							if (stLevel->arRoomLinks[iCurRoom][2] != 0) { iDownAt = 2; }
+						}
+						if (InArea (25, 25, 667, 50) == 1) /*** up arrow ***/
+						{
+							if (stLevel->arRoomLinks[iCurRoom][3] != 0) { iDownAt = 3; }
+						}
+						if (InArea (25, 548, 667, 573) == 1) /*** down arrow ***/
+						{
+							if (stLevel->arRoomLinks[iCurRoom][4] != 0) { iDownAt = 4; }
+						}
+						if (InArea (0, 25, 25, 50) == 1) /*** rooms ***/
+						{
+							if (arBrokenRoomLinks[iCurLevel] == 0)
+							{
+								iDownAt = 5;
+							} else {
+								iDownAt = 11;
+							}
+						}
+						if (InArea (667, 25, 692, 50) == 1) /*** events ***/
+						{
+							iDownAt = 6;
+						}
+						if (InArea (0, 548, 25, 573) == 1) /*** save ***/
+						{
+							iDownAt = 7;
+						}
+						if (InArea (667, 548, 692, 573) == 1) /*** quit ***/
+						{
+							iDownAt = 8;
+						}
+						if (InArea (0, 0, 25, 25) == 1) /*** previous ***/
+						{
+							iDownAt = 9;
+						}
+						if (InArea (667, 0, 692, 25) == 1) /*** next ***/
+						{
+							iDownAt = 10;
+						}
+
+						if (iScreen == 2)
+						{
+							if (arBrokenRoomLinks[iCurLevel] == 0)
+							{
+								for (iRoomLoop = 0; iRoomLoop < ROOMS; iRoomLoop++) /*** x ***/
+								{
+									/*** y ***/
+									for (iRoomLoop2 = 0; iRoomLoop2 < ROOMS; iRoomLoop2++)
+									{
+										if (InArea (297 + (iRoomLoop * 15), 61 + (iRoomLoop2 * 15),
+											310 + (iRoomLoop * 15), 74 + (iRoomLoop2 * 15)) == 1)
+										{
+											if (arMovingRooms[iRoomLoop + 1][iRoomLoop2 + 1] != 0)
+											{
+												iMovingNewBusy = 0;
+												iMovingRoom =
+													arMovingRooms[iRoomLoop + 1][iRoomLoop2 + 1];
+											}
+										}
+									}
+								}
+								/*** y ***/
+								for (iRoomLoop2 = 0; iRoomLoop2 < ROOMS; iRoomLoop2++)
+								{
+									if (InArea (272, 61 + (iRoomLoop2 * 15),
+										272 + 14, 61 + 14 + (iRoomLoop2 * 15)) == 1)
+									{
+										if (arMovingRooms[25][iRoomLoop2 + 1] != 0)
+										{
+											iMovingNewBusy = 0;
+											iMovingRoom = arMovingRooms[25][iRoomLoop2 + 1];
+										}
+									}
+								}
+
+								/*** rooms broken ***/
+								if (InArea (629, 63, 654, 88) == 1)
+								{
+									iDownAt = 11;
+								}
+							} else {
+								MouseSelectAdj();
+							}
+						}
+					}
+					ShowScreen();
+					break;
+				case SDL_MOUSEBUTTONUP:
+					iDownAt = 0;
+					if (event.button.button == 1) /*** left mouse button, change ***/
+					{
+						if (InArea (0, 50, 25, 548) == 1) /*** left arrow ***/
+						{
+							if (stLevel->arRoomLinks[iCurRoom][1] != 0)
+							{
+								iCurRoom = stLevel->arRoomLinks[iCurRoom][1];
+								PlaySound ("wav/scroll.wav");
+							}
+						}
+						if (InArea (667, 50, 692, 548) == 1) /*** right arrow ***/
+						{
+							if (stLevel->arRoomLinks[iCurRoom][2] != 0)
+							{
+								iCurRoom = stLevel->arRoomLinks[iCurRoom][2];
+								PlaySound ("wav/scroll.wav");
+							}
+						}
+						if (InArea (25, 25, 667, 50) == 1) /*** up arrow ***/
+						{
+							if (stLevel->arRoomLinks[iCurRoom][3] != 0)
+							{
+								iCurRoom = stLevel->arRoomLinks[iCurRoom][3];
+								PlaySound ("wav/scroll.wav");
+							}
+						}
+						if (InArea (25, 548, 667, 573) == 1) /*** down arrow ***/
+						{
+							if (stLevel->arRoomLinks[iCurRoom][4] != 0)
+							{
+								iCurRoom = stLevel->arRoomLinks[iCurRoom][4];
+								PlaySound ("wav/scroll.wav");
+							}
+						}
+						if (InArea (0, 25, 25, 50) == 1) /*** rooms ***/
+						{
+							if (iScreen != 2)
+							{
+								iScreen = 2; iMovingRoom = 0; iMovingNewBusy = 0;
+								iChangingBrokenRoom = iCurRoom;
+								iChangingBrokenSide = 1;
+								PlaySound ("wav/screen2or3.wav");
+							}
+						}
+						if (InArea (667, 25, 692, 50) == 1) /*** events ***/
+						{
+							if (iScreen == 2)
+							{
+								arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
+							}
+							if (iScreen != 3)
+							{
+								iScreen = 3;
+								if (iChangeEvent > stLevel->iNrEvents)
+									{ iChangeEvent = stLevel->iNrEvents; }
+								PlaySound ("wav/screen2or3.wav");
+							}
+						}
+						if (InArea (0, 548, 25, 573) == 1) /*** save ***/
+						{
+							if (iChanged != 0) { CallSave(); }
+						}
+						if (InArea (667, 548, 692, 573) == 1) /*** quit ***/
+						{
+							switch (iScreen)
+							{
+								case 1:
+									Quit(); break;
+								case 2:
+									arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
+									iScreen = 1; break;
+								case 3:
+									iScreen = 1; break;
+							}
+						}
+						if (InArea (0, 0, 25, 25) == 1) /*** previous ***/
+						{
+							if (iChanged != 0) { InitPopUpSave(); }
+							Prev();
+							ShowScreen(); break;
+						}
+						if (InArea (667, 0, 692, 25) == 1) /*** next ***/
+						{
+							if (iChanged != 0) { InitPopUpSave(); }
+							Next();
+							ShowScreen(); break;
+						}
+						if (OnLevelBar() == 1) /*** level bar ***/
+						{
+							RunLevel (iCurLevel);
+						}
+
+						if (iScreen == 1)
+						{
+							if (InArea (iHor[1], iVer1 + iTTP1, iHor[10] + iDX,
+								iVer3 + iDY + iTTPO) == 1) /*** middle field ***/
 							{
-								Help(); SDL_SetCursor (curArrow);
+								if (ShiftHeld() == 1)
+								{
+									SetLocation (iCurRoom, iSelected, iLastTile);
+									PlaySound ("wav/ok_close.wav"); iChanged++;
+								} else {
+									ChangePos();
+									ShowScreen(); break; /*** ? ***/
+								}
 							}
-							break;
-						case SDLK_F2:
-							if (iScreen == 1)
+
+							/*** 1 ***/
+							if (InArea (610, 3, 619, 12) == 1)
 							{
-								EXE();
-								SDL_SetCursor (curArrow);
-								SDL_StopTextInput();
+								Zoom (0);
+								iExtras = 0;
+								PlaySound ("wav/extras.wav");
 							}
-							break;
-						case SDLK_LEFTBRACKET:
-							if (event.key.keysym.mod & KMOD_SHIFT)
+
+							/*** 4 ***/
+							if (InArea (640, 3, 649, 12) == 1)
 							{
-								InitScreenAction ("left brace"); /*** { ***/
-							} else {
-								InitScreenAction ("left bracket"); /*** [ ***/
+								InitScreenAction ("env");
 							}
-							break;
-						case SDLK_RIGHTBRACKET:
-							if (event.key.keysym.mod & KMOD_SHIFT)
+
+							/*** 6 ***/
+							if (InArea (610, 13, 619, 22) == 1)
 							{
-								InitScreenAction ("right brace"); /*** } ***/
-							} else {
-								InitScreenAction ("right bracket"); /*** ] ***/
+								Sprinkle();
+								PlaySound ("wav/extras.wav");
+								iChanged++;
 							}
-							break;
-						case SDLK_d:
-							RunLevel (iCurLevel);
-							break;
-						case SDLK_SLASH:
-							if (iScreen == 1) { ClearRoom(); }
-							break;
-						case SDLK_BACKSLASH:
-							if (iScreen == 1)
+
+							/*** 8 ***/
+							if (InArea (630, 13, 639, 22) == 1)
 							{
-								/*** Randomize the entire level. ***/
-								for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-								{
-									for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-									{
-										UseTile (-1, iTileLoop, iRoomLoop);
-									}
-								}
+								FlipRoom (1);
+								PlaySound ("wav/extras.wav");
 								iChanged++;
-								PlaySound ("wav/ok_close.wav");
 							}
-							break;
-						case SDLK_KP_ENTER:
-						case SDLK_RETURN:
-						case SDLK_SPACE:
-							if (((event.key.keysym.mod & KMOD_LALT) ||
-								(event.key.keysym.mod & KMOD_RALT)) && (iScreen == 1))
+
+							/*** 3 ***/
+							if (InArea (630, 3, 639, 12) == 1)
 							{
-								Zoom (1);
-								iExtras = 0;
+								FlipRoom (2);
 								PlaySound ("wav/extras.wav");
-							} else {
-								InitScreenAction ("enter");
+								iChanged++;
 							}
-							break;
-						case SDLK_BACKSPACE:
-							if ((iScreen == 2) && (arBrokenRoomLinks[iCurLevel] == 1))
+
+							/*** 2 ***/
+							if (InArea (620, 3, 629, 12) == 1)
 							{
-								LinkMinus();
+								CopyPaste (1);
+								PlaySound ("wav/extras.wav");
 							}
-							break;
-						case SDLK_ESCAPE:
-						case SDLK_q:
-							switch (iScreen)
+
+							/*** 7 ***/
+							if (InArea (620, 13, 629, 22) == 1)
 							{
-								case 1:
-									Quit(); break;
-								case 2:
-									arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
-									iScreen = 1; break;
-								case 3:
-									iScreen = 1; break;
+								CopyPaste (2);
+								PlaySound ("wav/extras.wav");
+								iChanged++;
 							}
-							break;
-						case SDLK_LEFT:
-							if ((event.key.keysym.mod & KMOD_LSHIFT) ||
-								(event.key.keysym.mod & KMOD_RSHIFT))
+
+							/*** 5 ***/
+							if (InArea (650, 3, 659, 12) == 1)
 							{
-								switch (iScreen)
+								Help(); SDL_SetCursor (curArrow);
+							}
+
+							/*** 10 ***/
+							if (InArea (650, 13, 659, 22) == 1)
+							{
+								EXE();
+								SDL_SetCursor (curArrow);
+								SDL_StopTextInput();
+							}
+						}
+
+						if (iScreen == 2) /*** room links screen ***/
+						{
+							if (arBrokenRoomLinks[iCurLevel] == 0)
+							{
+								for (iRoomLoop = 0; iRoomLoop < ROOMS; iRoomLoop++) /*** x ***/
 								{
-									case 1:
-										if (arRoomLinks[iCurLevel][iCurRoom][1] != 0)
+									/*** y ***/
+									for (iRoomLoop2 = 0; iRoomLoop2 < ROOMS; iRoomLoop2++)
+									{
+										if (InArea (297 + (iRoomLoop * 15), 61 + (iRoomLoop2 * 15),
+											310 + (iRoomLoop * 15), 74 + (iRoomLoop2 * 15)) == 1)
 										{
-											iCurRoom = arRoomLinks[iCurLevel][iCurRoom][1];
-											PlaySound ("wav/scroll.wav");
+											if (iMovingRoom != 0)
+											{
+												if (arMovingRooms[iRoomLoop + 1][iRoomLoop2 + 1] == 0)
+												{
+													RemoveOldRoom();
+													AddNewRoom (iRoomLoop + 1,
+														iRoomLoop2 + 1, iMovingRoom);
+													iChanged++;
+												}
+												iMovingRoom = 0; iMovingNewBusy = 0;
+											}
 										}
-										break;
-									case 3:
-										ChangeEvent (-1, 0);
-										break;
-								}
-							} else if ((event.key.keysym.mod & KMOD_LCTRL) ||
-								(event.key.keysym.mod & KMOD_RCTRL))
-							{
-								if (iScreen == 3)
-								{
-									ChangeEvent (-10, 0);
+									}
 								}
-							} else {
-								InitScreenAction ("left");
-							}
-							break;
-						case SDLK_RIGHT:
-							if ((event.key.keysym.mod & KMOD_LSHIFT) ||
-								(event.key.keysym.mod & KMOD_RSHIFT))
-							{
-								switch (iScreen)
+								/*** y ***/
+								for (iRoomLoop2 = 0; iRoomLoop2 < ROOMS; iRoomLoop2++)
 								{
-									case 1:
-										if (arRoomLinks[iCurLevel][iCurRoom][2] != 0)
+									if (InArea (272, 61 + (iRoomLoop2 * 15),
+										272 + 14, 61 + 14 + (iRoomLoop2 * 15)) == 1)
+									{
+										if (iMovingRoom != 0)
 										{
-											iCurRoom = arRoomLinks[iCurLevel][iCurRoom][2];
-											PlaySound ("wav/scroll.wav");
+											if (arMovingRooms[25][iRoomLoop2 + 1] == 0)
+											{
+												RemoveOldRoom();
+												AddNewRoom (25, iRoomLoop2 + 1, iMovingRoom);
+												iChanged++;
+											}
+											iMovingRoom = 0; iMovingNewBusy = 0;
 										}
-										break;
-									case 3:
-										ChangeEvent (1, 0);
-										break;
+									}
 								}
-							} else if ((event.key.keysym.mod & KMOD_LCTRL) ||
-								(event.key.keysym.mod & KMOD_RCTRL))
-							{
-								if (iScreen == 3)
+
+								/*** rooms broken ***/
+								if (InArea (629, 63, 654, 88) == 1)
 								{
-									ChangeEvent (10, 0);
+									arBrokenRoomLinks[iCurLevel] = 1;
+									PlaySound ("wav/screen2or3.wav");
+								}
+
+								/*** Horizontal level. ***/
+								if (InArea (275, 434, 275 + 49, 434 + 49) == 1)
+								{
+									for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+									{
+										/*** Clear. ***/
+										stLevel->arRoomLinks[iRoomLoop][1] = 0;
+										stLevel->arRoomLinks[iRoomLoop][2] = 0;
+										stLevel->arRoomLinks[iRoomLoop][3] = 0;
+										stLevel->arRoomLinks[iRoomLoop][4] = 0;
+
+										if (iRoomLoop != 1)
+											{ stLevel->arRoomLinks[iRoomLoop][1] = iRoomLoop - 1; }
+										if (iRoomLoop != 24)
+											{ stLevel->arRoomLinks[iRoomLoop][2] = iRoomLoop + 1; }
+									}
+									PlaySound ("wav/move_room.wav");
+									stEdit.arLevelDirty[iCurLevel] = 1;
+									iChanged++;
+								}
+
+								/*** Vertical level. ***/
+								if (InArea (275, 486, 275 + 49, 486 + 49) == 1)
+								{
+									for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+									{
+										/*** Clear. ***/
+										stLevel->arRoomLinks[iRoomLoop][1] = 0;
+										stLevel->arRoomLinks[iRoomLoop][2] = 0;
+										stLevel->arRoomLinks[iRoomLoop][3] = 0;
+										stLevel->arRoomLinks[iRoomLoop][4] = 0;
+
+										if (iRoomLoop != 1)
+											{ stLevel->arRoomLinks[iRoomLoop][3] = iRoomLoop - 1; }
+										if (iRoomLoop != 24)
+											{ stLevel->arRoomLinks[iRoomLoop][4] = iRoomLoop + 1; }
+									}
+									PlaySound ("wav/move_room.wav");
+									stEdit.arLevelDirty[iCurLevel] = 1;
+									iChanged++;
 								}
-							} else {
-								InitScreenAction ("right");
-							}
-							break;
-						case SDLK_UP:
-							if ((event.key.keysym.mod & KMOD_LSHIFT) ||
-								(event.key.keysym.mod & KMOD_RSHIFT))
-							{
-								if (iScreen == 1)
+
+								/*** Horizontal rectangle level. ***/
+								if (InArea (327, 434, 327 + 49, 434 + 49) == 1)
 								{
-									if (arRoomLinks[iCurLevel][iCurRoom][3] != 0)
+									for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
 									{
-										iCurRoom = arRoomLinks[iCurLevel][iCurRoom][3];
-										PlaySound ("wav/scroll.wav");
+										/*** Clear. ***/
+										stLevel->arRoomLinks[iRoomLoop][1] = 0;
+										stLevel->arRoomLinks[iRoomLoop][2] = 0;
+										stLevel->arRoomLinks[iRoomLoop][3] = 0;
+										stLevel->arRoomLinks[iRoomLoop][4] = 0;
 									}
+									stLevel->arRoomLinks[1][2] = 2;
+									stLevel->arRoomLinks[1][4] = 7;
+									stLevel->arRoomLinks[2][1] = 1;
+									stLevel->arRoomLinks[2][2] = 3;
+									stLevel->arRoomLinks[2][4] = 8;
+									stLevel->arRoomLinks[3][1] = 2;
+									stLevel->arRoomLinks[3][2] = 4;
+									stLevel->arRoomLinks[3][4] = 9;
+									stLevel->arRoomLinks[4][1] = 3;
+									stLevel->arRoomLinks[4][2] = 5;
+									stLevel->arRoomLinks[4][4] = 10;
+									stLevel->arRoomLinks[5][1] = 4;
+									stLevel->arRoomLinks[5][2] = 6;
+									stLevel->arRoomLinks[5][4] = 11;
+									stLevel->arRoomLinks[6][1] = 5;
+									stLevel->arRoomLinks[6][4] = 12;
+									stLevel->arRoomLinks[7][2] = 8;
+									stLevel->arRoomLinks[7][3] = 1;
+									stLevel->arRoomLinks[7][4] = 13;
+									stLevel->arRoomLinks[8][1] = 7;
+									stLevel->arRoomLinks[8][2] = 9;
+									stLevel->arRoomLinks[8][3] = 2;
+									stLevel->arRoomLinks[8][4] = 14;
+									stLevel->arRoomLinks[9][1] = 8;
+									stLevel->arRoomLinks[9][2] = 10;
+									stLevel->arRoomLinks[9][3] = 3;
+									stLevel->arRoomLinks[9][4] = 15;
+									stLevel->arRoomLinks[10][1] = 9;
+									stLevel->arRoomLinks[10][2] = 11;
+									stLevel->arRoomLinks[10][3] = 4;
+									stLevel->arRoomLinks[10][4] = 16;
+									stLevel->arRoomLinks[11][1] = 10;
+									stLevel->arRoomLinks[11][2] = 12;
+									stLevel->arRoomLinks[11][3] = 5;
+									stLevel->arRoomLinks[11][4] = 17;
+									stLevel->arRoomLinks[12][1] = 11;
+									stLevel->arRoomLinks[12][3] = 6;
+									stLevel->arRoomLinks[12][4] = 18;
+									stLevel->arRoomLinks[13][2] = 14;
+									stLevel->arRoomLinks[13][3] = 7;
+									stLevel->arRoomLinks[13][4] = 19;
+									stLevel->arRoomLinks[14][1] = 13;
+									stLevel->arRoomLinks[14][2] = 15;
+									stLevel->arRoomLinks[14][3] = 8;
+									stLevel->arRoomLinks[14][4] = 20;
+									stLevel->arRoomLinks[15][1] = 14;
+									stLevel->arRoomLinks[15][2] = 16;
+									stLevel->arRoomLinks[15][3] = 9;
+									stLevel->arRoomLinks[15][4] = 21;
+									stLevel->arRoomLinks[16][1] = 15;
+									stLevel->arRoomLinks[16][2] = 17;
+									stLevel->arRoomLinks[16][3] = 10;
+									stLevel->arRoomLinks[16][4] = 22;
+									stLevel->arRoomLinks[17][1] = 16;
+									stLevel->arRoomLinks[17][2] = 18;
+									stLevel->arRoomLinks[17][3] = 11;
+									stLevel->arRoomLinks[17][4] = 23;
+									stLevel->arRoomLinks[18][1] = 17;
+									stLevel->arRoomLinks[18][3] = 12;
+									stLevel->arRoomLinks[18][4] = 24;
+									stLevel->arRoomLinks[19][2] = 20;
+									stLevel->arRoomLinks[19][3] = 13;
+									stLevel->arRoomLinks[20][1] = 19;
+									stLevel->arRoomLinks[20][2] = 21;
+									stLevel->arRoomLinks[20][3] = 14;
+									stLevel->arRoomLinks[21][1] = 20;
+									stLevel->arRoomLinks[21][2] = 22;
+									stLevel->arRoomLinks[21][3] = 15;
+									stLevel->arRoomLinks[22][1] = 21;
+									stLevel->arRoomLinks[22][2] = 23;
+									stLevel->arRoomLinks[22][3] = 16;
+									stLevel->arRoomLinks[23][1] = 22;
+									stLevel->arRoomLinks[23][2] = 24;
+									stLevel->arRoomLinks[23][3] = 17;
+									stLevel->arRoomLinks[24][1] = 23;
+									stLevel->arRoomLinks[24][3] = 18;
+									PlaySound ("wav/move_room.wav");
+									stEdit.arLevelDirty[iCurLevel] = 1;
+									iChanged++;
 								}
-							} else {
-								InitScreenAction ("up");
-							}
-							break;
-						case SDLK_DOWN:
-							if ((event.key.keysym.mod & KMOD_LSHIFT) ||
-								(event.key.keysym.mod & KMOD_RSHIFT))
-							{
-								if (iScreen == 1)
+
+								/*** Vertical rectangle level. ***/
+								if (InArea (327, 486, 327 + 49, 486 + 49) == 1)
 								{
-									if (arRoomLinks[iCurLevel][iCurRoom][4] != 0)
+									for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
 									{
-										iCurRoom = arRoomLinks[iCurLevel][iCurRoom][4];
-										PlaySound ("wav/scroll.wav");
+										/*** Clear. ***/
+										stLevel->arRoomLinks[iRoomLoop][1] = 0;
+										stLevel->arRoomLinks[iRoomLoop][2] = 0;
+										stLevel->arRoomLinks[iRoomLoop][3] = 0;
+										stLevel->arRoomLinks[iRoomLoop][4] = 0;
 									}
+									stLevel->arRoomLinks[1][2] = 2;
+									stLevel->arRoomLinks[1][4] = 5;
+									stLevel->arRoomLinks[2][1] = 1;
+									stLevel->arRoomLinks[2][2] = 3;
+									stLevel->arRoomLinks[2][4] = 6;
+									stLevel->arRoomLinks[3][1] = 2;
+									stLevel->arRoomLinks[3][2] = 4;
+									stLevel->arRoomLinks[3][4] = 7;
+									stLevel->arRoomLinks[4][1] = 3;
+									stLevel->arRoomLinks[4][4] = 8;
+									stLevel->arRoomLinks[5][2] = 6;
+									stLevel->arRoomLinks[5][3] = 1;
+									stLevel->arRoomLinks[5][4] = 9;
+									stLevel->arRoomLinks[6][1] = 5;
+									stLevel->arRoomLinks[6][2] = 7;
+									stLevel->arRoomLinks[6][3] = 2;
+									stLevel->arRoomLinks[6][4] = 10;
+									stLevel->arRoomLinks[7][1] = 6;
+									stLevel->arRoomLinks[7][2] = 8;
+									stLevel->arRoomLinks[7][3] = 3;
+									stLevel->arRoomLinks[7][4] = 11;
+									stLevel->arRoomLinks[8][1] = 7;
+									stLevel->arRoomLinks[8][3] = 4;
+									stLevel->arRoomLinks[8][4] = 12;
+									stLevel->arRoomLinks[9][2] = 10;
+									stLevel->arRoomLinks[9][3] = 5;
+									stLevel->arRoomLinks[9][4] = 13;
+									stLevel->arRoomLinks[10][1] = 9;
+									stLevel->arRoomLinks[10][2] = 11;
+									stLevel->arRoomLinks[10][3] = 6;
+									stLevel->arRoomLinks[10][4] = 14;
+									stLevel->arRoomLinks[11][1] = 10;
+									stLevel->arRoomLinks[11][2] = 12;
+									stLevel->arRoomLinks[11][3] = 7;
+									stLevel->arRoomLinks[11][4] = 15;
+									stLevel->arRoomLinks[12][1] = 11;
+									stLevel->arRoomLinks[12][3] = 8;
+									stLevel->arRoomLinks[12][4] = 16;
+									stLevel->arRoomLinks[13][2] = 14;
+									stLevel->arRoomLinks[13][3] = 9;
+									stLevel->arRoomLinks[13][4] = 17;
+									stLevel->arRoomLinks[14][1] = 13;
+									stLevel->arRoomLinks[14][2] = 15;
+									stLevel->arRoomLinks[14][3] = 10;
+									stLevel->arRoomLinks[14][4] = 18;
+									stLevel->arRoomLinks[15][1] = 14;
+									stLevel->arRoomLinks[15][2] = 16;
+									stLevel->arRoomLinks[15][3] = 11;
+									stLevel->arRoomLinks[15][4] = 19;
+									stLevel->arRoomLinks[16][1] = 15;
+									stLevel->arRoomLinks[16][3] = 12;
+									stLevel->arRoomLinks[16][4] = 20;
+									stLevel->arRoomLinks[17][2] = 18;
+									stLevel->arRoomLinks[17][3] = 13;
+									stLevel->arRoomLinks[17][4] = 21;
+									stLevel->arRoomLinks[18][1] = 17;
+									stLevel->arRoomLinks[18][2] = 19;
+									stLevel->arRoomLinks[18][3] = 14;
+									stLevel->arRoomLinks[18][4] = 22;
+									stLevel->arRoomLinks[19][1] = 18;
+									stLevel->arRoomLinks[19][2] = 20;
+									stLevel->arRoomLinks[19][3] = 15;
+									stLevel->arRoomLinks[19][4] = 23;
+									stLevel->arRoomLinks[20][1] = 19;
+									stLevel->arRoomLinks[20][3] = 16;
+									stLevel->arRoomLinks[20][4] = 24;
+									stLevel->arRoomLinks[21][2] = 22;
+									stLevel->arRoomLinks[21][3] = 17;
+									stLevel->arRoomLinks[22][1] = 21;
+									stLevel->arRoomLinks[22][2] = 23;
+									stLevel->arRoomLinks[22][3] = 18;
+									stLevel->arRoomLinks[23][1] = 22;
+									stLevel->arRoomLinks[23][2] = 24;
+									stLevel->arRoomLinks[23][3] = 19;
+									stLevel->arRoomLinks[24][1] = 23;
+									stLevel->arRoomLinks[24][3] = 20;
+									PlaySound ("wav/move_room.wav");
+									stEdit.arLevelDirty[iCurLevel] = 1;
+									iChanged++;
 								}
 							} else {
-								InitScreenAction ("down");
-							}
-							break;
-						case SDLK_t:
-							/*** Will change the environment. ***/
-							break;
-						case SDLK_MINUS:
-						case SDLK_KP_MINUS:
-							if (iCurLevel != 1)
-							{
-								if (iChanged != 0) { InitPopUpSave(); }
-								Prev();
-							}
-							break;
-						case SDLK_KP_PLUS:
-						case SDLK_EQUALS:
-							if (iCurLevel != LEVELS)
-							{
-								if (iChanged != 0) { InitPopUpSave(); }
-								Next();
-							}
-							break;
-						case SDLK_r:
-							if (iScreen != 2)
-							{
-								iScreen = 2;
-								iMovingRoom = 0;
-								iMovingNewBusy = 0;
-								iChangingBrokenRoom = iCurRoom;
-								iChangingBrokenSide = 1;
-								PlaySound ("wav/screen2or3.wav");
-							} else if (arBrokenRoomLinks[iCurLevel] == 0) {
-								arBrokenRoomLinks[iCurLevel] = 1;
-								PlaySound ("wav/screen2or3.wav");
-							}
-							break;
-						case SDLK_e:
-							if (iScreen == 2)
-							{
-								arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
-							}
-							if (iScreen != 3)
-							{
-								iScreen = 3;
-								if (iChangeEvent > arNrEvents[iCurLevel])
-									{ iChangeEvent = arNrEvents[iCurLevel]; }
-								PlaySound ("wav/screen2or3.wav");
-							}
-							break;
-						case SDLK_s:
-							if (iChanged != 0) { CallSave(); } break;
-						case SDLK_z:
-							if (iScreen == 1)
-							{
-								Zoom (0);
-								iExtras = 0;
-								PlaySound ("wav/extras.wav");
-							}
-							break;
-						case SDLK_f:
-							if (iScreen == 1)
-							{
-								Zoom (1);
-								iExtras = 0;
-								PlaySound ("wav/extras.wav");
+								if (MouseSelectAdj() == 1)
+								{
+									LinkPlus();
+								}
 							}
-							break;
-						case SDLK_QUOTE:
-							if (iScreen == 1)
+						}
+
+						if (iScreen == 3) /*** events screen ***/
+						{
+							/*** total no. of events ***/
+							if (InArea (150, 59, 150 + 13, 59 + 20) == 1)
+								{ TotalEvents (-10); }
+							if (InArea (165, 59, 165 + 13, 59 + 20) == 1)
+								{ TotalEvents (-1); }
+							if (InArea (235, 59, 235 + 13, 59 + 20) == 1)
+								{ TotalEvents (1); }
+							if (InArea (250, 59, 250 + 13, 59 + 20) == 1)
+								{ TotalEvents (10); }
+
+							/*** edit this event ***/
+							if (InArea (472, 59, 472 + 13, 59 + 20) == 1)
+								{ ChangeEvent (-10, 0); }
+							if (InArea (487, 59, 487 + 13, 59 + 20) == 1)
+								{ ChangeEvent (-1, 0); }
+							if (InArea (557, 59, 557 + 13, 59 + 20) == 1)
+								{ ChangeEvent (1, 0); }
+							if (InArea (572, 59, 572 + 13, 59 + 20) == 1)
+								{ ChangeEvent (10, 0); }
+
+							/*** Opens ***/
+							if (InArea (282, 306, 282 + 14, 306 + 14) == 1)
 							{
-								if ((event.key.keysym.mod & KMOD_LSHIFT) ||
-									(event.key.keysym.mod & KMOD_RSHIFT))
+								if (stLevel->arEventsOpenClose[iChangeEvent] != 0x01)
 								{
-									Sprinkle();
-									PlaySound ("wav/extras.wav");
-									iChanged++;
-								} else {
-									SetLocation (iCurRoom, iSelected, iLastTile);
-									PlaySound ("wav/ok_close.wav");
+									stLevel->arEventsOpenClose[iChangeEvent] = 0x01;
+									PlaySound ("wav/check_box.wav");
+									stEdit.arLevelDirty[iCurLevel] = 1;
 									iChanged++;
 								}
 							}
-							break;
-						case SDLK_h:
-							if (iScreen == 1)
-							{
-								FlipRoom (1);
-								PlaySound ("wav/extras.wav");
-								iChanged++;
-							}
-							if (iScreen == 3)
+
+							/*** Closes ***/
+							if (InArea (387, 306, 387 + 14, 306 + 14) == 1)
 							{
-								if (event.key.keysym.mod & KMOD_LCTRL)
+								if (stLevel->arEventsOpenClose[iChangeEvent] != 0x00)
 								{
-									TotalEvents (-10);
-								} else if (event.key.keysym.mod & KMOD_SHIFT) {
-									TotalEvents (-1);
-								} else {
-									InitScreenAction ("left from");
+									stLevel->arEventsOpenClose[iChangeEvent] = 0x00;
+									PlaySound ("wav/check_box.wav");
+									stEdit.arLevelDirty[iCurLevel] = 1;
+									iChanged++;
 								}
 							}
-							break;
-						case SDLK_j:
-							if (iScreen == 3)
+
+							/*** from room ***/
+							if ((iYPos >= 136 * iScale) &&
+								(iYPos <= (136 + 14) * iScale))
 							{
-								if (event.key.keysym.mod & KMOD_LCTRL)
+								for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
 								{
-									TotalEvents (10);
-								} else if (event.key.keysym.mod & KMOD_SHIFT) {
-									TotalEvents (1);
-								} else {
-									InitScreenAction ("right from");
+									if ((iXPos >= (282 + ((iRoomLoop - 1) * 15)) * iScale)
+										&& (iXPos <= ((282 + 14) +
+										((iRoomLoop - 1) * 15)) * iScale))
+									{
+										EventRoom (iRoomLoop, 0);
+									}
 								}
 							}
-							break;
-						case SDLK_u:
-							if (iScreen == 3)
+
+							/*** from tile ***/
+							for (iColLoop = 1; iColLoop <= 3; iColLoop++)
 							{
-								InitScreenAction ("up from");
+								for (iRowLoop = 1; iRowLoop <= 10; iRowLoop++)
+								{
+									if ((iXPos >= (282 + ((iRowLoop - 1) * 15)) * iScale)
+										&& (iXPos <= ((282 + 14) +
+										((iRowLoop - 1) * 15)) * iScale))
+									{
+										if ((iYPos >= (238 + ((iColLoop - 1) * 15)) * iScale)
+											&& (iYPos <= ((238 + 14) +
+											((iColLoop - 1) * 15)) * iScale))
+										{
+											EventTile (iRowLoop, iColLoop, 0);
+										}
+									}
+								}
 							}
-							break;
-						case SDLK_n:
-							if (iScreen == 3)
+
+							/*** to room ***/
+							if ((iYPos >= 377 * iScale) &&
+								(iYPos <= (377 + 14) * iScale))
 							{
-								InitScreenAction ("down from");
+								for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+								{
+									if ((iXPos >= (282 + ((iRoomLoop - 1) * 15)) * iScale)
+										&& (iXPos <= ((282 + 14) +
+										((iRoomLoop - 1) * 15)) * iScale))
+									{
+										EventRoom (iRoomLoop, 1);
+									}
+								}
 							}
-							break;
-						case SDLK_v:
-							if (iScreen == 1)
+
+							/*** to tile ***/
+							for (iColLoop = 1; iColLoop <= 3; iColLoop++)
 							{
-								if ((event.key.keysym.mod & KMOD_LCTRL) ||
-									(event.key.keysym.mod & KMOD_RCTRL))
+								for (iRowLoop = 1; iRowLoop <= 10; iRowLoop++)
 								{
-									CopyPaste (2);
-									PlaySound ("wav/extras.wav");
-									iChanged++;
-								} else {
-									FlipRoom (2);
-									PlaySound ("wav/extras.wav");
-									iChanged++;
+									if ((iXPos >= (282 + ((iRowLoop - 1) * 15)) * iScale)
+										&& (iXPos <= ((282 + 14) +
+										((iRowLoop - 1) * 15)) * iScale))
+									{
+										if ((iYPos >= (479 + ((iColLoop - 1) * 15)) * iScale)
+											&& (iYPos <= ((479 + 14) +
+											((iColLoop - 1) * 15)) * iScale))
+										{
+											EventTile (iRowLoop, iColLoop, 1);
+										}
+									}
 								}
 							}
-							break;
-						case SDLK_c:
-							if (iScreen == 1)
+						}
+					}
+					if (event.button.button == 2) /*** middle mouse button, clear ***/
+					{
+						if (iScreen == 1) { ClearRoom(); }
+					}
+					if (event.button.button == 3) /*** right mouse button, randomize ***/
+					{
+						if (iScreen == 1)
+						{
+							for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
 							{
-								if ((event.key.keysym.mod & KMOD_LCTRL) ||
-									(event.key.keysym.mod & KMOD_RCTRL))
+								for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
 								{
-									CopyPaste (1);
-									PlaySound ("wav/extras.wav");
+									UseTile (-1, iTileLoop, iRoomLoop);
 								}
 							}
-							if (iScreen == 3)
+							PlaySound ("wav/ok_close.wav");
+							iChanged++;
+						}
+						if (iScreen == 2)
+						{
+							if (arBrokenRoomLinks[iCurLevel] == 1)
 							{
-								if (arEventsOpenClose[iCurLevel][iChangeEvent] != 0x00)
+								if (MouseSelectAdj() == 1)
 								{
-									arEventsOpenClose[iCurLevel][iChangeEvent] = 0x00;
-									PlaySound ("wav/check_box.wav");
-									iChanged++;
+									LinkMinus();
 								}
 							}
-							break;
-						case SDLK_o:
-							if (iScreen == 3)
-							{
-								if (arEventsOpenClose[iCurLevel][iChangeEvent] != 0x01)
+						}
+					}
+					ShowScreen();
+					break;
+				case SDL_MOUSEWHEEL:
+					if (event.wheel.y > 0) /*** scroll wheel up ***/
+					{
+						if (InArea (iHor[1], iVer1 + iTTP1, iHor[10] + iDX,
+							iVer3 + iDY + iTTPO) == 1) /*** middle field ***/
+						{
+							if (ShiftHeld() == 1)
+							{ /*** right ***/
+								if (stLevel->arRoomLinks[iCurRoom][2] != 0)
 								{
-									arEventsOpenClose[iCurLevel][iChangeEvent] = 0x01;
-									PlaySound ("wav/check_box.wav");
-									iChanged++;
+									iCurRoom = stLevel->arRoomLinks[iCurRoom][2];
+									PlaySound ("wav/scroll.wav");
+								}
+							} else { /*** up ***/
+								if (stLevel->arRoomLinks[iCurRoom][3] != 0)
+								{
+									iCurRoom = stLevel->arRoomLinks[iCurRoom][3];
+									PlaySound ("wav/scroll.wav");
 								}
 							}
-							break;
-						case SDLK_i:
-							if (iScreen == 1)
-							{
-								if (iInfo == 0) { iInfo = 1; } else { iInfo = 0; }
-							}
-							break;
-						case SDLK_0: /*** empty ***/
-						case SDLK_KP_0:
-							if (iScreen == 1)
-							{
-								SetLocation (iCurRoom, iSelected, 0x00);
-								PlaySound ("wav/ok_close.wav"); iChanged++;
-							}
-							break;
-						case SDLK_1: /*** floor ***/
-						case SDLK_KP_1:
-							if (iScreen == 1)
-							{
-								SetLocation (iCurRoom, iSelected, 0x01);
-								PlaySound ("wav/ok_close.wav"); iChanged++;
-							}
-							break;
-						case SDLK_2: /*** loose tile ***/
-						case SDLK_KP_2:
-							if (iScreen == 1)
-							{
-								SetLocation (iCurRoom, iSelected, 0x0B);
-								PlaySound ("wav/ok_close.wav"); iChanged++;
-							}
-							break;
-						case SDLK_3: /*** closed gate ***/
-						case SDLK_KP_3:
-							if (iScreen == 1)
-							{
-								SetLocation (iCurRoom, iSelected, 0x44);
-								PlaySound ("wav/ok_close.wav"); iChanged++;
-							}
-							break;
-						case SDLK_4: /*** open gate ***/
-						case SDLK_KP_4:
-							if (iScreen == 1)
-							{
-								SetLocation (iCurRoom, iSelected, 0x24);
-								PlaySound ("wav/ok_close.wav"); iChanged++;
-							}
-							break;
-						case SDLK_5: /*** torch ***/
-						case SDLK_KP_5:
-							if (iScreen == 1)
-							{
-								SetLocation (iCurRoom, iSelected, 0x13);
-								PlaySound ("wav/ok_close.wav"); iChanged++;
-							}
-							break;
-						case SDLK_6: /*** spikes ***/
-						case SDLK_KP_6:
-							if (iScreen == 1)
-							{
-								SetLocation (iCurRoom, iSelected, 0x02);
-								PlaySound ("wav/ok_close.wav"); iChanged++;
-							}
-							break;
-						case SDLK_7: /*** small pillar ***/
-						case SDLK_KP_7:
-							if (iScreen == 1)
-							{
-								SetLocation (iCurRoom, iSelected, 0x03);
-								PlaySound ("wav/ok_close.wav"); iChanged++;
-							}
-							break;
-						case SDLK_8: /*** chomper ***/
-						case SDLK_KP_8:
-							if (iScreen == 1)
-							{
-								SetLocation (iCurRoom, iSelected, 0x12);
-								PlaySound ("wav/ok_close.wav"); iChanged++;
-							}
-							break;
-						case SDLK_9: /*** wall ***/
-						case SDLK_KP_9:
-							if (iScreen == 1)
-							{
-								SetLocation (iCurRoom, iSelected, 0x14);
-								PlaySound ("wav/ok_close.wav"); iChanged++;
+						}
+					}
+					if (event.wheel.y < 0) /*** scroll wheel down ***/
+					{
+						if (InArea (iHor[1], iVer1 + iTTP1, iHor[10] + iDX,
+							iVer3 + iDY + iTTPO) == 1) /*** middle field ***/
+						{
+							if (ShiftHeld() == 1)
+							{ /*** left ***/
+								if (stLevel->arRoomLinks[iCurRoom][1] != 0)
+								{
+									iCurRoom = stLevel->arRoomLinks[iCurRoom][1];
+									PlaySound ("wav/scroll.wav");
+								}
+							} else { /*** down ***/
+								if (stLevel->arRoomLinks[iCurRoom][4] != 0)
+								{
+									iCurRoom = stLevel->arRoomLinks[iCurRoom][4];
+									PlaySound ("wav/scroll.wav");
+								}
 							}
-							break;
+						}
+					}
+					ShowScreen();
+					break;
+				case SDL_WINDOWEVENT:
+					if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
+						{ ShowScreen(); } break;
+				case SDL_RENDER_TARGETS_RESET:
+					DropRoomLayers (0);
+					ShowScreen(); break; /*** The textures were lost. ***/
+				case SDL_QUIT:
+					Quit(); break;
+				default: break;
+			}
+		}
+
+		/*** Sleep until there is input, or until the flames change. ***/
+		if ((iNoAnim == 0) && (iFlames != 0))
+		{
+			iWait = (int)(oldticks + FLAME_MS + 1 - Ticks());
+			if (iWait < 1) { iWait = 1; }
+			WaitEvent (iWait);
+		} else {
+			WaitEvent (-1);
+		}
+	}
+}
+/*****************************************************************************/
+void InitPopUpSave (void)
+/*****************************************************************************/
+{
+	int iPopUp;
+	SDL_Event event;
+
+	iPopUp = 1;
+
+	PlaySound ("wav/popup_yn.wav");
+	ShowPopUpSave();
+	while (iPopUp == 1)
+	{
+		while (PollEvent (&event))
+		{
+			UndoEnd();
+			switch (event.type)
+			{
+				case SDL_CONTROLLERBUTTONDOWN:
+					/*** Nothing for now. ***/
+					break;
+				case SDL_CONTROLLERBUTTONUP:
+					switch (event.cbutton.button)
+					{
+						case SDL_CONTROLLER_BUTTON_A:
+							if (CallSave() == 1) { iPopUp = 0; } break;
+						case SDL_CONTROLLER_BUTTON_B:
+							iPopUp = 0; break;
+					}
+					break;
+				case SDL_KEYDOWN:
+					switch (event.key.keysym.sym)
+					{
+						case SDLK_ESCAPE:
+						case SDLK_n:
+							iPopUp = 0; break;
+						case SDLK_y:
+							if (CallSave() == 1) { iPopUp = 0; } break;
 						default: break;
 					}
-					ShowScreen();
-					break;
-				case SDL_MOUSEMOTION:
-					iOldXPos = iXPos;
-					iOldYPos = iYPos;
-					iXPos = event.motion.x;
-					iYPos = event.motion.y;
-					if ((iOldXPos == iXPos) && (iOldYPos == iYPos)) { break; }
+					break;
+				case SDL_MOUSEMOTION:
+					iXPos = event.motion.x;
+					iYPos = event.motion.y;
+					break;
+				case SDL_MOUSEBUTTONDOWN:
+					if (event.button.button == 1)
+					{
+						if (InArea (440, 376, 440 + 85, 376 + 32) == 1) /*** Yes ***/
+						{
+							iYesOn = 1;
+							ShowPopUpSave();
+						}
+						if (InArea (167, 376, 167 + 85, 376 + 32) == 1) /*** No ***/
+						{
+							iNoOn = 1;
+							ShowPopUpSave();
+						}
+					}
+					break;
+				case SDL_MOUSEBUTTONUP:
+					iYesOn = 0;
+					iNoOn = 0;
+					if (event.button.button == 1)
+					{
+						if (InArea (440, 376, 440 + 85, 376 + 32) == 1) /*** Yes ***/
+						{
+							if (CallSave() == 1) { iPopUp = 0; }
+						}
+						if (InArea (167, 376, 167 + 85, 376 + 32) == 1) /*** No ***/
+						{
+							iPopUp = 0;
+						}
+					}
+					ShowPopUpSave(); break;
+				case SDL_WINDOWEVENT:
+					if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
+						{ ShowScreen(); ShowPopUpSave(); } break;
+				case SDL_QUIT:
+					Quit(); break;
+			}
+		}
+
+		/*** Sleep until there is input. ***/
+		WaitEvent (-1);
+	}
+	PlaySound ("wav/popup_close.wav");
+	ShowScreen();
+}
+/*****************************************************************************/
+void ShowPopUpSave (void)
+/*****************************************************************************/
+{
+	char arText[9 + 2][MAX_TEXT + 2];
+
+	ProfilePhase (PHASE_OTHER);
+
+	/*** faded background ***/
+	ShowImage (imgfadedl, 0, 0, "imgfadedl");
+
+	/*** popup ***/
+	ShowImage (imgpopup_yn, 150, 148, "imgpopup_yn");
+
+	/*** Yes ***/
+	switch (iYesOn)
+	{
+		case 0: ShowImage (imgyes[1], 440, 376, "imgyes[1]"); break; /*** off ***/
+		case 1: ShowImage (imgyes[2], 440, 376, "imgyes[2]"); break; /*** on ***/
+	}
+
+	/*** No ***/
+	switch (iNoOn)
+	{
+		case 0: ShowImage (imgno[1], 167, 376, "imgno[1]"); break; /*** off ***/
+		case 1: ShowImage (imgno[2], 167, 376, "imgno[2]"); break; /*** on ***/
+	}
+
+	if (iChanged == 1)
+	{
+		snprintf (arText[0], MAX_TEXT, "%s", "You made an unsaved change.");
+		snprintf (arText[1], MAX_TEXT, "%s", "Do you want to save it?");
+	} else {
+		snprintf (arText[0], MAX_TEXT, "%s", "There are unsaved changes.");
+		snprintf (arText[1], MAX_TEXT, "%s", "Do you wish to save these?");
+	}
+
+	DisplayText (180, 177, FONT_SIZE_15, arText, 2, font1);
+
+	/*** refresh screen ***/
+	Present();
+}
+/*****************************************************************************/
+void LoadFonts (void)
+/*****************************************************************************/
+{
+	font1 = TTF_OpenFont ("ttf/Bitstream-Vera-Sans-Bold.ttf",
+		FONT_SIZE_15 * iScale);
+	if (font1 == NULL) { printf ("[FAILED] Font gone!\n"); exit (EXIT_ERROR); }
+	font2 = TTF_OpenFont ("ttf/Bitstream-Vera-Sans-Bold.ttf",
+		FONT_SIZE_11 * iScale);
+	if (font2 == NULL) { printf ("[FAILED] Font gone!\n"); exit (EXIT_ERROR); }
+	font3 = TTF_OpenFont ("ttf/Bitstream-Vera-Sans-Bold.ttf",
+		FONT_SIZE_20 * iScale);
+	if (font3 == NULL) { printf ("[FAILED] Font gone!\n"); exit (EXIT_ERROR); }
+}
+/*****************************************************************************/
+void MixAudio (void *unused, Uint8 *stream, int iLen)
+/*****************************************************************************/
+{
+	int iTemp;
+	int iAmount;
+
+	if (unused != NULL) { } /*** To prevent warnings. ***/
+
+	SDL_memset (stream, 0, iLen); /*** SDL2 ***/
+	for (iTemp = 0; iTemp < NUM_SOUNDS; iTemp++)
+	{
+		iAmount = (sounds[iTemp].dlen-sounds[iTemp].dpos);
+		if (iAmount > iLen)
+		{
+			iAmount = iLen;
+		}
+		SDL_MixAudio (stream, &sounds[iTemp].data[sounds[iTemp].dpos], iAmount,
+			SDL_MIX_MAXVOLUME);
+		sounds[iTemp].dpos += iAmount;
+	}
+}
+/*****************************************************************************/
+void PlaySound (char *sFile)
+/*****************************************************************************/
+{
+	int iIndex;
+	SDL_AudioSpec wave;
+	Uint8 *data;
+	Uint32 dlen;
+	SDL_AudioCVT cvt;
+
+	if (iNoAudio == 1) { return; }
+	for (iIndex = 0; iIndex < NUM_SOUNDS; iIndex++)
+	{
+		if (sounds[iIndex].dpos == sounds[iIndex].dlen)
+		{
+			break;
+		}
+	}
+	if (iIndex == NUM_SOUNDS) { return; }
+
+	if (SDL_LoadWAV (sFile, &wave, &data, &dlen) == NULL)
+	{
+		printf ("[FAILED] Could not load %s: %s!\n", sFile, SDL_GetError());
+		exit (EXIT_ERROR);
+	}
+	SDL_BuildAudioCVT (&cvt, wave.format, wave.channels, wave.freq, AUDIO_S16, 2,
+		44100);
+	/*** The "+ 1" is a workaround for SDL bug #2274. ***/
+	cvt.buf = (Uint8 *)malloc (dlen * (cvt.len_mult + 1));
+	memcpy (cvt.buf, data, dlen);
+	cvt.len = dlen;
+	SDL_ConvertAudio (&cvt);
+	SDL_FreeWAV (data);
+
+	if (sounds[iIndex].data)
+	{
+		free (sounds[iIndex].data);
+	}
+	SDL_LockAudio();
+	sounds[iIndex].data = cvt.buf;
+	sounds[iIndex].dlen = cvt.len_cvt;
+	sounds[iIndex].dpos = 0;
+	SDL_UnlockAudio();
+}
+/*****************************************************************************/
+void PreLoadSet (char cTypeP, int iTile)
+/*****************************************************************************/
+{
+	char sDir[MAX_PATHFILE + 2];
+	char sImage[MAX_IMG + 2];
+
+	switch (cTypeP)
+	{
+		case 'd':
+			snprintf (sDir, MAX_PATHFILE, "png%sdungeon%s", SLASH, SLASH);
+			snprintf (sImage, MAX_IMG, "%s0x%02x.png", sDir, iTile);
+			imgd[iTile][1] = LoadImage (sImage); /*** regular ***/
+			snprintf (sDir, MAX_PATHFILE, "png%ssdungeon%s", SLASH, SLASH);
+			snprintf (sImage, MAX_IMG, "%s0x%02x.png", sDir, iTile);
+			imgd[iTile][2] = LoadImage (sImage);
+			break;
+		case 'p':
+			snprintf (sDir, MAX_PATHFILE, "png%spalace%s", SLASH, SLASH);
+			snprintf (sImage, MAX_IMG, "%s0x%02x.png", sDir, iTile);
+			imgp[iTile][1] = LoadImage (sImage); /*** regular ***/
+			snprintf (sDir, MAX_PATHFILE, "png%sspalace%s", SLASH, SLASH);
+			snprintf (sImage, MAX_IMG, "%s0x%02x.png", sDir, iTile);
+			imgp[iTile][2] = LoadImage (sImage);
+			break;
+	}
+
+	iPreLoaded+=2;
+}
+/*****************************************************************************/
+void PreLoad (char *sPath, char *sPNG, struct img **imgImage)
+/*****************************************************************************/
+{
+	char sImage[MAX_IMG + 2];
+
+	if (snprintf (sImage, MAX_IMG, "png%s%s%s%s", SLASH, sPath, SLASH,
+		sPNG) >= MAX_IMG)
+	{
+		printf ("[FAILED] The path of image \"%s\" is too long!\n", sPNG);
+		exit (EXIT_ERROR);
+	}
+	*imgImage = LoadImage (sImage);
+
+	iPreLoaded++;
+}
+/*****************************************************************************/
+struct img *LoadImage (char *sImage)
+/*****************************************************************************/
+{
+	SDL_Surface *imgloaded;
+	SDL_Surface *imgconv;
+	struct img *stImg;
+
+	imgloaded = IMG_Load (sImage);
+	if (imgloaded == NULL)
+	{
+		printf ("[FAILED] IMG_Load: %s!\n", IMG_GetError());
+		exit (EXIT_ERROR);
+	}
+	if (iImgs == MAX_IMGS)
+	{
+		printf ("[FAILED] Too many images; increase MAX_IMGS!\n");
+		exit (EXIT_ERROR);
+	}
+	iImgs++;
+	stImg = &arImgs[iImgs];
+	stImg->tex = NULL;
+	stImg->src.x = 0;
+	stImg->src.y = 0;
+	stImg->src.w = imgloaded->w;
+	stImg->src.h = imgloaded->h;
+	stImg->iAtlas = 0;
+
+	/*** Shelf packing: left to right, then a new shelf below. ***/
+	if ((iNoAtlas == 0) && (imgloaded->w * imgloaded->h <= ATLAS_MAX_AREA) &&
+		(imgloaded->w <= ATLAS_SIZE) && (imgloaded->h <= ATLAS_SIZE))
+	{
+		if (iShelfX + imgloaded->w > ATLAS_SIZE)
+		{
+			iShelfX = 0;
+			iShelfY+=iShelfH + 1;
+			iShelfH = 0;
+		}
+		if (((iAtlases == 0) || (iShelfY + imgloaded->h > ATLAS_SIZE)) &&
+			(iAtlases < MAX_ATLASES))
+		{
+			arAtlasSurfaces[iAtlases + 1] = SDL_CreateRGBSurfaceWithFormat (0,
+				ATLAS_SIZE, ATLAS_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+			if (arAtlasSurfaces[iAtlases + 1] == NULL)
+			{
+				printf ("[FAILED] Could not create an atlas: %s!\n",
+					SDL_GetError());
+				exit (EXIT_ERROR);
+			}
+			iAtlases++;
+			iShelfX = 0;
+			iShelfY = 0;
+			iShelfH = 0;
+		}
+		if ((iAtlases != 0) && (iShelfY + imgloaded->h <= ATLAS_SIZE))
+		{
+			imgconv = SDL_ConvertSurfaceFormat (imgloaded,
+				SDL_PIXELFORMAT_ARGB8888, 0);
+			if (imgconv == NULL)
+			{
+				printf ("[FAILED] SDL_ConvertSurfaceFormat: %s!\n", SDL_GetError());
+				exit (EXIT_ERROR);
+			}
+			stImg->iAtlas = iAtlases;
+			stImg->src.x = iShelfX;
+			stImg->src.y = iShelfY;
+			SDL_SetSurfaceBlendMode (imgconv, SDL_BLENDMODE_NONE);
+			SDL_BlitSurface (imgconv, NULL, arAtlasSurfaces[iAtlases],
+				&stImg->src);
+			SDL_FreeSurface (imgconv);
+			SDL_FreeSurface (imgloaded);
+			iShelfX+=stImg->src.w + 1; /*** 1 pixel apart ***/
+			if (stImg->src.h > iShelfH) { iShelfH = stImg->src.h; }
+			return (stImg);
+		}
+	}
+
+	/*** Large images, such as backgrounds, get their own texture. ***/
+	stImg->tex = SDL_CreateTextureFromSurface (ascreen, imgloaded);
+	stFrame.iCreates++;
+	if (stImg->tex == NULL)
+	{
+		printf ("[FAILED] SDL_CreateTextureFromSurface: %s!\n", SDL_GetError());
+		exit (EXIT_ERROR);
+	}
+	SDL_FreeSurface (imgloaded);
+
+	return (stImg);
+}
+/*****************************************************************************/
+void CreateAtlases (void)
+/*****************************************************************************/
+{
+	int iPacked;
+
+	/*** Used for looping. ***/
+	int iAtlasLoop;
+	int iImgLoop;
+
+	for (iAtlasLoop = 1; iAtlasLoop <= iAtlases; iAtlasLoop++)
+	{
+		arAtlases[iAtlasLoop] = SDL_CreateTextureFromSurface (ascreen,
+			arAtlasSurfaces[iAtlasLoop]);
+		stFrame.iCreates++;
+		if (arAtlases[iAtlasLoop] == NULL)
+		{
+			printf ("[FAILED] SDL_CreateTextureFromSurface: %s!\n",
+				SDL_GetError());
+			exit (EXIT_ERROR);
+		}
+		SDL_SetTextureBlendMode (arAtlases[iAtlasLoop], SDL_BLENDMODE_BLEND);
+		SDL_FreeSurface (arAtlasSurfaces[iAtlasLoop]);
+		arAtlasSurfaces[iAtlasLoop] = NULL;
+	}
+	iPacked = 0;
+	for (iImgLoop = 1; iImgLoop <= iImgs; iImgLoop++)
+	{
+		if (arImgs[iImgLoop].iAtlas == 0) { continue; }
+		arImgs[iImgLoop].tex = arAtlases[arImgs[iImgLoop].iAtlas];
+		iPacked++;
+	}
+
+	if (iDebug == 1)
+	{
+		printf ("[ INFO ] Packed %i images into %i atlases.\n",
+			iPacked, iAtlases);
+	}
+}
+/*****************************************************************************/
+void ShowScreen (void)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	int iTile;
+	char sLevelBar[MAX_TEXT + 2];
+	char sLevelBarF[MAX_TEXT + 2];
+	char sSize[MAX_TEXT + 2];
+	int iFree;
+	int iUnusedRooms;
+	int iX, iY;
+	int iEventUnused;
+	int iTileValue;
+	int iToRoom;
+
+	/*** Used for looping. ***/
+	int iRoomLoop;
+	int iSideLoop;
+
+	ProfilePhase (PHASE_SCREEN);
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+	if (iDrawMode == DRAW_ALL) { iFlames = 0; }
+	FlushDraws();
+	SDL_SetRenderTarget (ascreen, imgscene);
+
+	switch (iCurLevel)
+	{
+		case 1: cCurType = 'd'; break;
+		case 2: cCurType = 'd'; break;
+		case 3: cCurType = 'd'; break;
+		case 4: cCurType = 'p'; break;
+		case 5: cCurType = 'p'; break;
+		case 6: cCurType = 'p'; break;
+		case 7: cCurType = 'd'; break;
+		case 8: cCurType = 'd'; break;
+		case 9: cCurType = 'd'; break;
+		case 10: cCurType = 'p'; break;
+		case 11: cCurType = 'p'; break;
+		case 12: cCurType = 'd'; break;
+		case 13: cCurType = 'd'; break;
+		case 14: cCurType = 'p'; break;
+		case 15: cCurType = 'd'; break; /*** Also palace. ***/
+		case 16: cCurType = 'd'; break;
+		case 17: cCurType = 'd'; break;
+		default:
+			printf ("[FAILED] Invalid level number: %i!\n", iCurLevel);
+			exit (EXIT_ERROR);
+			break;
+	}
+
+	if ((iScreen == 1) && (iDrawMode == DRAW_ALL) && (RoomLayer() == 1))
+	{
+		/*** The room came from a layer; redraw what is on top of it. ***/
+		memcpy (arClip, arFlames, sizeof (arFlames));
+		iClips = iFlames;
+		iDrawMode = DRAW_RECORD;
+		ShowTiles();
+		iDrawMode = DRAW_CLIP;
+		ShowImage (imgblack, 0, 0, "imgblack");
+		ShowTiles();
+		iDrawMode = DRAW_ALL;
+	} else {
+		/*** black background ***/
+		ShowImage (imgblack, 0, 0, "imgblack");
+
+		if (iScreen == 1) { ShowTiles(); }
+	}
+	if (iScreen == 2) /*** R ***/
+	{
+		if (arBrokenRoomLinks[iCurLevel] == 0)
+		{
+			InitRooms();
+			/*** room links ***/
+			ShowImage (imgrl, 25, 50, "imgrl");
+			/*** rooms broken on ***/
+			if (iDownAt == 11)
+			{
+				ShowImage (imgbroomson_1, 629, 63, "imgbroomson_1"); /*** down ***/
+			} else {
+				ShowImage (imgbroomson_0, 629, 63, "imgbroomson_0"); /*** up ***/
+			}
+			WhereToStart();
+			for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+			{
+				arDone[iRoomLoop] = 0;
+			}
+			ShowRooms (stLevel->arStartLocation[1], iStartRoomsX, iStartRoomsY, 1);
+			iUnusedRooms = 0;
+			for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+			{
+				if (arDone[iRoomLoop] != 1)
+				{
+					iUnusedRooms++;
+					ShowRooms (iRoomLoop, 25, iUnusedRooms, 0);
+
+					/* Give unused rooms 0xFF as tile 1. This may not be the best
+					 * location in the code to do this, but it works.
+					 */
+					if ((iCurLevel != 15) &&
+						(stLevel->arRoomTiles[iRoomLoop][1] != 0xFF))
+					{
+						stLevel->arRoomTiles[iRoomLoop][1] = 0xFF;
+						stEdit.arLevelDirty[iCurLevel] = 1;
+					}
+				}
+			}
+			if (iMovingRoom != 0)
+			{
+				iX = (iXPos + 10) / iScale;
+				iY = (iYPos + 10) / iScale;
+				ShowImage (imgroom[iMovingRoom], iX, iY, "imgroom[...]");
+				if (iCurRoom == iMovingRoom)
+				{
+					ShowImage (imgsrc, iX, iY, "imgsrc"); /*** green stripes ***/
+				}
+				if (stLevel->arStartLocation[1] == iMovingRoom)
+				{
+					ShowImage (imgsrs, iX, iY, "imgsrs"); /*** blue border ***/
+				}
+				ShowImage (imgsrm, iX, iY, "imgsrm"); /*** red stripes ***/
+				ShowRooms (-1, iMovingNewX, iMovingNewY, 0);
+			}
+		} else {
+			/*** broken room links ***/
+			ShowImage (imgbrl, 25, 50, "imgbrl");
+			for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+			{
+				/*** green stripes ***/
+				if (iCurRoom == iRoomLoop)
+				{
+					BrokenRoomChange (iRoomLoop, 0, &iX, &iY);
+					ShowImage (imgsrc, iX, iY, "imgsrc");
+				}
+
+				/*** blue border ***/
+				if (stLevel->arStartLocation[1] == iRoomLoop)
+				{
+					BrokenRoomChange (iRoomLoop, 0, &iX, &iY);
+					ShowImage (imgsrs, iX, iY, "imgsrs");
+				}
+
+				for (iSideLoop = 1; iSideLoop <= 4; iSideLoop++)
+				{
+					if (stLevel->arRoomLinks[iRoomLoop][iSideLoop] != 0)
+					{
+						BrokenRoomChange (iRoomLoop, iSideLoop, &iX, &iY);
+						iToRoom = stLevel->arRoomLinks[iRoomLoop][iSideLoop];
+						if ((iToRoom < 1) || (iToRoom > ROOMS)) { iToRoom = 25; }
+						ShowImage (imgroom[iToRoom], iX, iY, "imgroom[...]");
+
+						/*** blue square ***/
+						if (arRoomConnectionsBroken[iCurLevel][iRoomLoop][iSideLoop] == 1)
+						{
+							BrokenRoomChange (iRoomLoop, iSideLoop, &iX, &iY);
+							ShowImage (imgsrb, iX, iY, "imgsrb");
+						}
+					}
+
+					/*** red stripes ***/
+					if ((iChangingBrokenRoom == iRoomLoop) &&
+						(iChangingBrokenSide == iSideLoop))
+					{
+						BrokenRoomChange (iRoomLoop, iSideLoop, &iX, &iY);
+						ShowImage (imgsrm, iX, iY, "imgsrm");
+					}
+				}
+			}
+		}
+	}
+	if (iScreen == 3) /*** E ***/
+	{
+		iEventUnused = 0;
+
+		/*** background ***/
+		ShowImage (imgevents, 25, 50, "imgevents");
+
+		/*** total no. of events ***/
+		CenterNumber (stLevel->iNrEvents, 178, 59, color_wh, 0);
+
+		/*** edit this event ***/
+		CenterNumber (iChangeEvent, 500, 59, color_wh, 0);
+
+		/*** from room ***/
+		if ((stLevel->arEventsFromRoom[iChangeEvent] >= 1) &&
+			(stLevel->arEventsFromRoom[iChangeEvent] <= 24))
+		{
+			iX = 267 + (stLevel->arEventsFromRoom[iChangeEvent] * 15);
+			iY = 136;
+			ShowImage (imgsele, iX, iY, "imgsele");
+		} else { iEventUnused = 1; }
+
+		/*** from tile ***/
+		if ((stLevel->arEventsFromTile[iChangeEvent] >= 1) &&
+			(stLevel->arEventsFromTile[iChangeEvent] <= 30))
+		{
+			iTile = stLevel->arEventsFromTile[iChangeEvent];
+			if ((iTile >= 1) && (iTile <= 10))
+			{
+				iX = 267 + (iTile * 15);
+				iY = 238;
+			}
+			if ((iTile >= 11) && (iTile <= 20))
+			{
+				iX = 267 + ((iTile - 10) * 15);
+				iY = 253;
+			}
+			if ((iTile >= 21) && (iTile <= 30))
+			{
+				iX = 267 + ((iTile - 20) * 15);
+				iY = 268;
+			}
+			ShowImage (imgsele, iX, iY, "imgsele");
+		} else { iEventUnused = 1; }
+
+		/*** from image ***/
+		if (iEventUnused == 0)
+		{
+			iTileValue = stLevel->arRoomTiles
+				[stLevel->arEventsFromRoom[iChangeEvent]]
+				[stLevel->arEventsFromTile[iChangeEvent]];
+			switch (cCurType)
+			{
+				case 'd': ShowTile (imgd[iTileValue][1], 128, 112,
+					iTileValue, TILE_NORMAL); break;
+				case 'p': ShowTile (imgp[iTileValue][1], 128, 112,
+					iTileValue, TILE_NORMAL); break;
+			}
+		} else {
+			ShowImage (imgeventu, 128, 112, "imgeventu");
+		}
+
+		/*** open or close ***/
+		switch (stLevel->arEventsOpenClose[iChangeEvent])
+		{
+			case 0x00: /*** close ***/
+				ShowImage (imgsell, 387, 306, "imgsell"); break;
+			case 0x01: /*** open ***/
+				ShowImage (imgsell, 282, 306, "imgsell"); break;
+		}
+
+		iEventUnused = 0;
+
+		/*** to room ***/
+		if ((stLevel->arEventsToRoom[iChangeEvent] >= 1) &&
+			(stLevel->arEventsToRoom[iChangeEvent] <= 24))
+		{
+			iX = 267 + (stLevel->arEventsToRoom[iChangeEvent] * 15);
+			iY = 377;
+			ShowImage (imgsele, iX, iY, "imgsele");
+		} else { iEventUnused = 1; }
+
+		/*** to tile ***/
+		if ((stLevel->arEventsToTile[iChangeEvent] >= 1) &&
+			(stLevel->arEventsToTile[iChangeEvent] <= 30))
+		{
+			iTile = stLevel->arEventsToTile[iChangeEvent];
+			if ((iTile >= 1) && (iTile <= 10))
+			{
+				iX = 267 + (iTile * 15);
+				iY = 479;
+			}
+			if ((iTile >= 11) && (iTile <= 20))
+			{
+				iX = 267 + ((iTile - 10) * 15);
+				iY = 494;
+			}
+			if ((iTile >= 21) && (iTile <= 30))
+			{
+				iX = 267 + ((iTile - 20) * 15);
+				iY = 509;
+			}
+			ShowImage (imgsele, iX, iY, "imgsele");
+		} else { iEventUnused = 1; }
+
+		/*** to image ***/
+		if (iEventUnused == 0)
+		{
+			iTileValue = stLevel->arRoomTiles
+				[stLevel->arEventsToRoom[iChangeEvent]]
+				[stLevel->arEventsToTile[iChangeEvent]];
+			switch (cCurType)
+			{
+				case 'd': ShowTile (imgd[iTileValue][1], 128, 353,
+					iTileValue, TILE_NORMAL); break;
+				case 'p': ShowTile (imgp[iTileValue][1], 128, 353,
+					iTileValue, TILE_NORMAL); break;
+			}
+		} else {
+			ShowImage (imgeventu, 128, 353, "imgeventu");
+		}
+	}
+
+	/*** left ***/
+	if (stLevel->arRoomLinks[iCurRoom][1] != 0)
+	{
+		/*** yes ***/
+		if (iDownAt == 1)
+		{
+			ShowImage (imgleft_1, 0, 50, "imgleft_1"); /*** down ***/
+		} else {
+			ShowImage (imgleft_0, 0, 50, "imgleft_0"); /*** up ***/
+		}
+		if (stLevel->arRoomLinks[iCurRoom][1] > 24)
+			{ ShowImage (imglinkwarnlr, 0, 50, "imglinkwarnlr"); } /*** glow ***/
+	} else {
+		/*** no ***/
+		ShowImage (imglrno, 0, 50, "imglrno");
+	}
+
+	/*** right ***/
+	if (stLevel->arRoomLinks[iCurRoom][2] != 0)
+	{
+		/*** yes ***/
+		if (iDownAt == 2)
+		{
+			ShowImage (imgright_1, 667, 50, "imgright_1"); /*** down ***/
+		} else {
+			ShowImage (imgright_0, 667, 50, "imgright_0"); /*** up ***/
+		}
+		if (stLevel->arRoomLinks[iCurRoom][2] > 24)
+			{ ShowImage (imglinkwarnlr, 667, 50, "imglinkwarnlr"); } /*** glow ***/
+	} else {
+		/*** no ***/
+		ShowImage (imglrno, 667, 50, "imglrno");
+	}
+
+	/*** up ***/
+	if (stLevel->arRoomLinks[iCurRoom][3] != 0)
+	{
+		/*** yes ***/
+		if (iDownAt == 3)
+		{
+			ShowImage (imgup_1, 25, 25, "imgup_1"); /*** down ***/
+		} else {
+			ShowImage (imgup_0, 25, 25, "imgup_0"); /*** up ***/
+		}
+		if (stLevel->arRoomLinks[iCurRoom][3] > 24)
+			{ ShowImage (imglinkwarnud, 25, 25, "imglinkwarnud"); } /*** glow ***/
+	} else {
+		/*** no ***/
+		if (iScreen != 1)
+		{
+			ShowImage (imgudno, 25, 25, "imgudno"); /*** without info ***/
+		} else {
+			ShowImage (imgudnonfo, 25, 25, "imgudnonfo"); /*** with info ***/
+		}
+	}
+
+	/*** down ***/
+	if (stLevel->arRoomLinks[iCurRoom][4] != 0)
+	{
+		/*** yes ***/
+		if (iDownAt == 4)
+		{
+			ShowImage (imgdown_1, 25, 548, "imgdown_1"); /*** down ***/
+		} else {
+			ShowImage (imgdown_0, 25, 548, "imgdown_0"); /*** up ***/
+		}
+		if (stLevel->arRoomLinks[iCurRoom][4] > 24)
+			{ ShowImage (imglinkwarnud, 25, 548, "imglinkwarnud"); } /*** glow ***/
+	} else {
+		/*** no ***/
+		ShowImage (imgudno, 25, 548, "imgudno");
+	}
+
+	switch (iScreen)
+	{
+		case 1:
+			if (arBrokenRoomLinks[iCurLevel] == 1)
+			{
+				/*** rooms broken on ***/
+				if (iDownAt == 11)
+				{
+					ShowImage (imgbroomson_1, 0, 25, "imgbroomson_1"); /*** down ***/
+				} else {
+					ShowImage (imgbroomson_0, 0, 25, "imgbroomson_0"); /*** up ***/
+				}
+			} else {
+				/*** rooms on ***/
+				if (iDownAt == 5)
+				{
+					ShowImage (imgroomson_1, 0, 25, "imgroomson_1"); /*** down ***/
+				} else {
+					ShowImage (imgroomson_0, 0, 25, "imgroomson_0"); /*** up ***/
+				}
+			}
+			/*** events on ***/
+			if (iDownAt == 6)
+			{
+				ShowImage (imgeventson_1, 667, 25, "imgeventson_1"); /*** down ***/
+			} else {
+				ShowImage (imgeventson_0, 667, 25, "imgeventson_0"); /*** up ***/
+			}
+			break;
+		case 2:
+			/*** rooms off ***/
+			if (arBrokenRoomLinks[iCurLevel] == 1)
+			{
+				ShowImage (imgbroomsoff, 0, 25, "imgbroomsoff"); /*** broken ***/
+			} else {
+				ShowImage (imgroomsoff, 0, 25, "imgroomsoff");
+			}
 
-					/*** Mednafen information. ***/
-					if (OnLevelBar() == 1)
-					{
-						if (iMednafen != 1) { iMednafen = 1; ShowScreen(); }
-					} else {
-						if (iMednafen != 0) { iMednafen = 0; ShowScreen(); }
-					}
+			/*** events on ***/
+			if (iDownAt == 6)
+			{
+				ShowImage (imgeventson_1, 667, 25, "imgeventson_1"); /*** down ***/
+			} else {
+				ShowImage (imgeventson_0, 667, 25, "imgeventson_0"); /*** up ***/
+			}
+			break;
+		case 3:
+			if (arBrokenRoomLinks[iCurLevel] == 1)
+			{
+				/*** rooms broken on ***/
+				if (iDownAt == 11)
+				{
+					ShowImage (imgbroomson_1, 0, 25, "imgbroomson_1"); /*** down ***/
+				} else {
+					ShowImage (imgbroomson_0, 0, 25, "imgbroomson_0"); /*** up ***/
+				}
+			} else {
+				/*** rooms on ***/
+				if (iDownAt == 5)
+				{
+					ShowImage (imgroomson_1, 0, 25, "imgroomson_1"); /*** down ***/
+				} else {
+					ShowImage (imgroomson_0, 0, 25, "imgroomson_0"); /*** up ***/
+				}
+			}
+			/*** events off ***/
+			ShowImage (imgeventsoff, 667, 25, "imgeventsoff");
+			break;
+	}
 
-					if (iScreen == 2)
-					{
-						if (iMovingRoom != 0) { ShowScreen(); }
-					}
+	/*** save ***/
+	if (iChanged != 0)
+	{
+		/*** on ***/
+		if (iDownAt == 7)
+		{
+			ShowImage (imgsaveon_1, 0, 548, "imgsaveon_1"); /*** down ***/
+		} else {
+			ShowImage (imgsaveon_0, 0, 548, "imgsaveon_0"); /*** up ***/
+		}
+	} else {
+		/*** off ***/
+		ShowImage (imgsaveoff, 0, 548, "imgsaveoff");
+	}
 
-					if (iScreen == 1)
-					{
-						/*** User hovers over tiles in the upper row. ***/
-						if ((InArea (iHor[1], iVer1 + iTTP1, iHor[2], iVer2 + iTTPO)
-							== 1) && (iSelected != 1))
-							{ iSelected = 1; ShowScreen(); }
-						else if ((InArea (iHor[2], iVer1 + iTTP1, iHor[3], iVer2 + iTTPO)
-							== 1) && (iSelected != 2))
-							{ iSelected = 2; ShowScreen(); }
-						else if ((InArea (iHor[3], iVer1 + iTTP1, iHor[4], iVer2 + iTTPO)
-							== 1) && (iSelected != 3))
-							{ iSelected = 3; ShowScreen(); }
-						else if ((InArea (iHor[4], iVer1 + iTTP1, iHor[5], iVer2 + iTTPO)
-							== 1) && (iSelected != 4))
-							{ iSelected = 4; ShowScreen(); }
-						else if ((InArea (iHor[5], iVer1 + iTTP1, iHor[6], iVer2 + iTTPO)
-							== 1) && (iSelected != 5))
-							{ iSelected = 5; ShowScreen(); }
-						else if ((InArea (iHor[6], iVer1 + iTTP1, iHor[7], iVer2 + iTTPO)
-							== 1) && (iSelected != 6))
-							{ iSelected = 6; ShowScreen(); }
-						else if ((InArea (iHor[7], iVer1 + iTTP1, iHor[8], iVer2 + iTTPO)
-							== 1) && (iSelected != 7))
-							{ iSelected = 7; ShowScreen(); }
-						else if ((InArea (iHor[8], iVer1 + iTTP1, iHor[9], iVer2 + iTTPO)
-							== 1) && (iSelected != 8))
-							{ iSelected = 8; ShowScreen(); }
-						else if ((InArea (iHor[9], iVer1 + iTTP1, iHor[10], iVer2 + iTTPO)
-							== 1) && (iSelected != 9))
-							{ iSelected = 9; ShowScreen(); }
-						else if ((InArea (iHor[10], iVer1 + iTTP1, iHor[10] + iDX,
-							iVer2 + iTTPO) == 1) && (iSelected != 10))
-						{ iSelected = 10; ShowScreen(); }
+	/*** quit ***/
+	if (iDownAt == 8)
+	{
+		ShowImage (imgquit_1, 667, 548, "imgquit_1"); /*** down ***/
+	} else {
+		ShowImage (imgquit_0, 667, 548, "imgquit_0"); /*** up ***/
+	}
 
-						/*** User hovers over tiles in the middle row. ***/
-						else if ((InArea (iHor[1], iVer2 + iTTPO, iHor[2], iVer3 + iTTPO)
-							== 1) && (iSelected != 11))
-							{ iSelected = 11; ShowScreen(); }
-						else if ((InArea (iHor[2], iVer2 + iTTPO, iHor[3], iVer3 + iTTPO)
-							== 1) && (iSelected != 12))
-							{ iSelected = 12; ShowScreen(); }
-						else if ((InArea (iHor[3], iVer2 + iTTPO, iHor[4], iVer3 + iTTPO)
-							== 1) && (iSelected != 13))
-							{ iSelected = 13; ShowScreen(); }
-						else if ((InArea (iHor[4], iVer2 + iTTPO, iHor[5], iVer3 + iTTPO)
-							== 1) && (iSelected != 14))
-							{ iSelected = 14; ShowScreen(); }
-						else if ((InArea (iHor[5], iVer2 + iTTPO, iHor[6], iVer3 + iTTPO)
-							== 1) && (iSelected != 15))
-							{ iSelected = 15; ShowScreen(); }
-						else if ((InArea (iHor[6], iVer2 + iTTPO, iHor[7], iVer3 + iTTPO)
-							== 1) && (iSelected != 16))
-							{ iSelected = 16; ShowScreen(); }
-						else if ((InArea (iHor[7], iVer2 + iTTPO, iHor[8], iVer3 + iTTPO)
-							== 1) && (iSelected != 17))
-							{ iSelected = 17; ShowScreen(); }
-						else if ((InArea (iHor[8], iVer2 + iTTPO, iHor[9], iVer3 + iTTPO)
-							== 1) && (iSelected != 18))
-							{ iSelected = 18; ShowScreen(); }
-						else if ((InArea (iHor[9], iVer2 + iTTPO, iHor[10], iVer3 + iTTPO)
-							== 1) && (iSelected != 19))
-							{ iSelected = 19; ShowScreen(); }
-						else if ((InArea (iHor[10], iVer2 + iTTPO, iHor[10] + iDX,
-							iVer3 + iTTPO) == 1) && (iSelected != 20))
-						{ iSelected = 20; ShowScreen(); }
+	/*** previous ***/
+	if (iCurLevel != 1)
+	{
+		/*** on ***/
+		if (iDownAt == 9)
+		{
+			ShowImage (imgprevon_1, 0, 0, "imgprevon_1"); /*** down ***/
+		} else {
+			ShowImage (imgprevon_0, 0, 0, "imgprevon_0"); /*** up ***/
+		}
+	} else {
+		/*** off ***/
+		ShowImage (imgprevoff, 0, 0, "imgprevoff");
+	}
 
-						/*** User hovers over tiles in the bottom row. ***/
-						else if ((InArea (iHor[1], iVer3 + iTTPO, iHor[2],
-							iVer3 + iDY + iTTPO) == 1) && (iSelected != 21))
-							{ iSelected = 21; ShowScreen(); }
-						else if ((InArea (iHor[2], iVer3 + iTTPO, iHor[3],
-							iVer3 + iDY + iTTPO) == 1) && (iSelected != 22))
-							{ iSelected = 22; ShowScreen(); }
-						else if ((InArea (iHor[3], iVer3 + iTTPO, iHor[4],
-							iVer3 + iDY + iTTPO) == 1) && (iSelected != 23))
-							{ iSelected = 23; ShowScreen(); }
-						else if ((InArea (iHor[4], iVer3 + iTTPO, iHor[5],
-							iVer3 + iDY + iTTPO) == 1) && (iSelected != 24))
-							{ iSelected = 24; ShowScreen(); }
-						else if ((InArea (iHor[5], iVer3 + iTTPO, iHor[6],
-							iVer3 + iDY + iTTPO) == 1) && (iSelected != 25))
-							{ iSelected = 25; ShowScreen(); }
-						else if ((InArea (iHor[6], iVer3 + iTTPO, iHor[7],
-							iVer3 + iDY + iTTPO) == 1) && (iSelected != 26))
-							{ iSelected = 26; ShowScreen(); }
-						else if ((InArea (iHor[7], iVer3 + iTTPO, iHor[8],
-							iVer3 + iDY + iTTPO) == 1) && (iSelected != 27))
-							{ iSelected = 27; ShowScreen(); }
-						else if ((InArea (iHor[8], iVer3 + iTTPO, iHor[9],
-							iVer3 + iDY + iTTPO) == 1) && (iSelected != 28))
-							{ iSelected = 28; ShowScreen(); }
-						else if ((InArea (iHor[9], iVer3 + iTTPO, iHor[10],
-							iVer3 + iDY + iTTPO) == 1) && (iSelected != 29))
-							{ iSelected = 29; ShowScreen(); }
-						else if ((InArea (iHor[10], iVer3 + iTTPO, iHor[10] + iDX,
-							iVer3 + iDY + iTTPO) == 1) && (iSelected != 30))
-						{ iSelected = 30; ShowScreen(); }
+	/*** next ***/
+	if (iCurLevel != LEVELS)
+	{
+		/*** on ***/
+		if (iDownAt == 10)
+		{
+			ShowImage (imgnexton_1, 667, 0, "imgnexton_1"); /*** down ***/
+		} else {
+			ShowImage (imgnexton_0, 667, 0, "imgnexton_0"); /*** up ***/
+		}
+	} else {
+		/*** off ***/
+		ShowImage (imgnextoff, 667, 0, "imgnextoff");
+	}
 
-						/*** extras ***/
-						if ((InArea (610, 3, 619, 12) == 1) && (iExtras != 1))
-							{ iExtras = 1; ShowScreen(); }
-						else if ((InArea (620, 3, 629, 12) == 1) && (iExtras != 2))
-							{ iExtras = 2; ShowScreen(); }
-						else if ((InArea (630, 3, 639, 12) == 1) && (iExtras != 3))
-							{ iExtras = 3; ShowScreen(); }
-						else if ((InArea (640, 3, 649, 12) == 1) && (iExtras != 4))
-							{ iExtras = 4; ShowScreen(); }
-						else if ((InArea (650, 3, 659, 12) == 1) && (iExtras != 5))
-							{ iExtras = 5; ShowScreen(); }
-						else if ((InArea (610, 13, 619, 22) == 1) && (iExtras != 6))
-							{ iExtras = 6; ShowScreen(); }
-						else if ((InArea (620, 13, 629, 22) == 1) && (iExtras != 7))
-							{ iExtras = 7; ShowScreen(); }
-						else if ((InArea (630, 13, 639, 22) == 1) && (iExtras != 8))
-							{ iExtras = 8; ShowScreen(); }
-						else if ((InArea (640, 13, 649, 22) == 1) && (iExtras != 9))
-							{ iExtras = 9; ShowScreen(); }
-						else if ((InArea (650, 13, 659, 22) == 1) && (iExtras != 10))
-							{ iExtras = 10; ShowScreen(); }
-						else if ((InArea (610, 3, 659, 22) == 0) && (iExtras != 0))
-							{ iExtras = 0; ShowScreen(); }
-					}
+	/*** level bar ***/
+	ShowImage (imgbar, 25, 0, "imgbar");
+
+	/*** Assemble level bar text. ***/
+	switch (iCurLevel)
+	{
+		case 1: snprintf (sLevelBar, MAX_TEXT, "level 1 (prison),"); break;
+		case 2: snprintf (sLevelBar, MAX_TEXT, "level 2 (guards),"); break;
+		case 3: snprintf (sLevelBar, MAX_TEXT, "level 3 (skeleton),"); break;
+		case 4: snprintf (sLevelBar, MAX_TEXT, "level 4 (mirror),"); break;
+		case 5: snprintf (sLevelBar, MAX_TEXT, "level 5 (thief),"); break;
+		case 6: snprintf (sLevelBar, MAX_TEXT, "level 6 (plunge),"); break;
+		case 7: snprintf (sLevelBar, MAX_TEXT, "level 7 (weightless),"); break;
+		case 8: snprintf (sLevelBar, MAX_TEXT, "level 8 (mouse),"); break;
+		case 9: snprintf (sLevelBar, MAX_TEXT, "level 9 (twisty),"); break;
+		case 10: snprintf (sLevelBar, MAX_TEXT, "level 10 (quad),"); break;
+		case 11: snprintf (sLevelBar, MAX_TEXT, "level 11 (fragile),"); break;
+		case 12: snprintf (sLevelBar, MAX_TEXT, "level 12a (tower),"); break;
+		case 13: snprintf (sLevelBar, MAX_TEXT, "level 12b (jaffar),"); break;
+		case 14: snprintf (sLevelBar, MAX_TEXT, "level 12c (rescue),"); break;
+		case 15: snprintf (sLevelBar, MAX_TEXT, "various d/p,"); break;
+		case 16: snprintf (sLevelBar, MAX_TEXT, "training,"); break;
+		case 17: snprintf (sLevelBar, MAX_TEXT, "training (cont.),"); break;
+	}
+	switch (iScreen)
+	{
+		case 1:
+			snprintf (sLevelBarF, MAX_TEXT, "%s room %i", sLevelBar, iCurRoom);
+			ShowImage (imgextras[iExtras], 610, 3, "imgextras[...]");
+			break;
+		case 2:
+			snprintf (sLevelBarF, MAX_TEXT, "%s room links", sLevelBar); break;
+		case 3:
+			snprintf (sLevelBarF, MAX_TEXT, "%s events", sLevelBar); break;
+	}
 
-					break;
-				case SDL_MOUSEBUTTONDOWN:
-					if (event.button.button == 1)
-					{
-						if (InArea (0, 50, 25, 548) == 1) /*** left arrow ***/
-						{
-							if (arRoomLinks[iCurLevel][iCurRoom][1] != 0) { iDownAt = 1; }
-						}
-						if (InArea (667, 50, 692, 548) == 1) /*** right arrow ***/
-						{
-							if (arRoomLinks[iCurLevel][iCurRoom][2] != 0) { iDownAt = 2; }
-						}
-						if (InArea (25, 25, 667, 50) == 1) /*** up arrow ***/
-						{
-							if (arRoomLinks[iCurLevel][iCurRoom][3] != 0) { iDownAt = 3; }
-						}
-						if (InArea (25, 548, 667, 573) == 1) /*** down arrow ***/
-						{
-							if (arRoomLinks[iCurLevel][iCurRoom][4] != 0) { iDownAt = 4; }
-						}
-						if (InArea (0, 25, 25, 50) == 1) /*** rooms ***/
-						{
-							if (arBrokenRoomLinks[iCurLevel] == 0)
-							{
-								iDownAt = 5;
-							} else {
-								iDownAt = 11;
-							}
-						}
-						if (InArea (667, 25, 692, 50) == 1) /*** events ***/
-						{
-							iDownAt = 6;
-						}
-						if (InArea (0, 548, 25, 573) == 1) /*** save ***/
-						{
-							iDownAt = 7;
-						}
-						if (InArea (667, 548, 692, 573) == 1) /*** quit ***/
-						{
-							iDownAt = 8;
-						}
-						if (InArea (0, 0, 25, 25) == 1) /*** previous ***/
-						{
-							iDownAt = 9;
-						}
-						if (InArea (667, 0, 692, 25) == 1) /*** next ***/
-						{
-							iDownAt = 10;
-						}
+	/*** Mednafen information. ***/
+	if (iMednafen == 1) { ShowImage (imgmednafen, 25, 50, "imgmednafen"); }
 
-						if (iScreen == 2)
-						{
-							if (arBrokenRoomLinks[iCurLevel] == 0)
-							{
-								for (iRoomLoop = 0; iRoomLoop < ROOMS; iRoomLoop++) /*** x ***/
-								{
-									/*** y ***/
-									for (iRoomLoop2 = 0; iRoomLoop2 < ROOMS; iRoomLoop2++)
-									{
-										if (InArea (297 + (iRoomLoop * 15), 61 + (iRoomLoop2 * 15),
-											310 + (iRoomLoop * 15), 74 + (iRoomLoop2 * 15)) == 1)
-										{
-											if (arMovingRooms[iRoomLoop + 1][iRoomLoop2 + 1] != 0)
-											{
-												iMovingNewBusy = 0;
-												iMovingRoom =
-													arMovingRooms[iRoomLoop + 1][iRoomLoop2 + 1];
-											}
-										}
-									}
-								}
-								/*** y ***/
-								for (iRoomLoop2 = 0; iRoomLoop2 < ROOMS; iRoomLoop2++)
-								{
-									if (InArea (272, 61 + (iRoomLoop2 * 15),
-										272 + 14, 61 + 14 + (iRoomLoop2 * 15)) == 1)
-									{
-										if (arMovingRooms[25][iRoomLoop2 + 1] != 0)
-										{
-											iMovingNewBusy = 0;
-											iMovingRoom = arMovingRooms[25][iRoomLoop2 + 1];
-										}
-									}
-								}
+	/*** Display level bar text. ***/
+	if (ClipArea (28, 3, 602 - 28, 22 - 3) == 1)
+	{
+		messaget = TextTexture (font1, sLevelBarF, color_bl, color_wh, 0,
+			&offset.w, &offset.h);
+		offset.x = 31;
+		offset.y = 5;
+		CustomRenderCopy (messaget, NULL, &offset, "message");
+
+		/*** Display the (compressed) level size and the free bytes. ***/
+		iFree = FreeBytes();
+		snprintf (sSize, MAX_TEXT, "%i B, %i free", LevelSize (iCurLevel), iFree);
+		offset.x = offset.x + (offset.w / iScale) + 8;
+		if (iFree <= WARN_BYTES_FREE)
+		{
+			messaget = TextTexture (font2, sSize, color_red, color_wh, 0,
+				&offset.w, &offset.h);
+		} else {
+			messaget = TextTexture (font2, sSize, color_bl, color_wh, 0,
+				&offset.w, &offset.h);
+		}
+		offset.y = 8;
+		CustomRenderCopy (messaget, NULL, &offset, "message");
+	}
 
-								/*** rooms broken ***/
-								if (InArea (629, 63, 654, 88) == 1)
-								{
-									iDownAt = 11;
-								}
-							} else {
-								MouseSelectAdj();
-							}
-						}
-					}
-					ShowScreen();
+	/*** refresh screen ***/
+	if (imgscene != NULL)
+	{
+		FlushDraws();
+		SDL_SetRenderTarget (ascreen, NULL);
+		ProfileCopy (imgscene);
+		SDL_RenderCopy (ascreen, imgscene, NULL, NULL);
+	}
+	Present();
+}
+/*****************************************************************************/
+void ShowTiles (void)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	int iTile;
+	int iLoc;
+	int iHorL, iVerL;
+	struct img *imgskeleton[2 + 2];
+	struct img *imgshadow[2 + 2];
+	struct img *imgjaffar[2 + 2];
+	struct img *imgguard[2 + 2];
+	int iUnknown;
+
+	/*** Used for looping. ***/
+	int iTileLoop;
+
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	/*** above this room ***/
+	if (stLevel->arRoomLinks[iCurRoom][3] != 0)
+	{
+		for (iTileLoop = 1; iTileLoop <= (TILES / 3); iTileLoop++)
+		{
+			iTile = stLevel->arRoomTiles
+				[stLevel->arRoomLinks[iCurRoom][3]][iTileLoop + 20];
+			switch (cCurType)
+			{
+				case 'd':
+					ShowTile (imgd[iTile][1], iHor[iTileLoop], iVer0,
+						iTile, TILE_NORMAL);
 					break;
-				case SDL_MOUSEBUTTONUP:
-					iDownAt = 0;
-					if (event.button.button == 1) /*** left mouse button, change ***/
-					{
-						if (InArea (0, 50, 25, 548) == 1) /*** left arrow ***/
-						{
-							if (arRoomLinks[iCurLevel][iCurRoom][1] != 0)
-							{
-								iCurRoom = arRoomLinks[iCurLevel][iCurRoom][1];
-								PlaySound ("wav/scroll.wav");
-							}
-						}
-						if (InArea (667, 50, 692, 548) == 1) /*** right arrow ***/
-						{
-							if (arRoomLinks[iCurLevel][iCurRoom][2] != 0)
-							{
-								iCurRoom = arRoomLinks[iCurLevel][iCurRoom][2];
-								PlaySound ("wav/scroll.wav");
-							}
-						}
-						if (InArea (25, 25, 667, 50) == 1) /*** up arrow ***/
-						{
-							if (arRoomLinks[iCurLevel][iCurRoom][3] != 0)
-							{
-								iCurRoom = arRoomLinks[iCurLevel][iCurRoom][3];
-								PlaySound ("wav/scroll.wav");
-							}
-						}
-						if (InArea (25, 548, 667, 573) == 1) /*** down arrow ***/
-						{
-							if (arRoomLinks[iCurLevel][iCurRoom][4] != 0)
-							{
-								iCurRoom = arRoomLinks[iCurLevel][iCurRoom][4];
-								PlaySound ("wav/scroll.wav");
-							}
-						}
-						if (InArea (0, 25, 25, 50) == 1) /*** rooms ***/
-						{
-							if (iScreen != 2)
-							{
-								iScreen = 2; iMovingRoom = 0; iMovingNewBusy = 0;
-								iChangingBrokenRoom = iCurRoom;
-								iChangingBrokenSide = 1;
-								PlaySound ("wav/screen2or3.wav");
-							}
-						}
-						if (InArea (667, 25, 692, 50) == 1) /*** events ***/
-						{
-							if (iScreen == 2)
-							{
-								arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
-							}
-							if (iScreen != 3)
-							{
-								iScreen = 3;
-								if (iChangeEvent > arNrEvents[iCurLevel])
-									{ iChangeEvent = arNrEvents[iCurLevel]; }
-								PlaySound ("wav/screen2or3.wav");
-							}
-						}
-						if (InArea (0, 548, 25, 573) == 1) /*** save ***/
-						{
-							if (iChanged != 0) { CallSave(); }
-						}
-						if (InArea (667, 548, 692, 573) == 1) /*** quit ***/
-						{
-							switch (iScreen)
-							{
-								case 1:
-									Quit(); break;
-								case 2:
-									arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
-									iScreen = 1; break;
-								case 3:
-									iScreen = 1; break;
-							}
-						}
-						if (InArea (0, 0, 25, 25) == 1) /*** previous ***/
-						{
-							if (iChanged != 0) { InitPopUpSave(); }
-							Prev();
-							ShowScreen(); break;
-						}
-						if (InArea (667, 0, 692, 25) == 1) /*** next ***/
-						{
-							if (iChanged != 0) { InitPopUpSave(); }
-							Next();
-							ShowScreen(); break;
-						}
-						if (OnLevelBar() == 1) /*** level bar ***/
-						{
-							RunLevel (iCurLevel);
-						}
+				case 'p':
+					ShowTile (imgp[iTile][1], iHor[iTileLoop], iVer0,
+						iTile, TILE_NORMAL);
+					break;
+			}
+		}
+	} else {
+		for (iTileLoop = 1; iTileLoop <= (TILES / 3); iTileLoop++)
+		{
+			iTile = 0x01;
+			switch (cCurType)
+			{
+				case 'd':
+					ShowTile (imgd[iTile][1], iHor[iTileLoop], iVer0,
+						iTile, TILE_NORMAL);
+					break;
+				case 'p':
+					ShowTile (imgp[iTile][1], iHor[iTileLoop], iVer0,
+						iTile, TILE_NORMAL);
+					break;
+			}
+		}
+	}
 
-						if (iScreen == 1)
-						{
-							if (InArea (iHor[1], iVer1 + iTTP1, iHor[10] + iDX,
-								iVer3 + iDY + iTTPO) == 1) /*** middle field ***/
-							{
-								keystate = SDL_GetKeyboardState (NULL);
-								if ((keystate[SDL_SCANCODE_LSHIFT]) ||
-									(keystate[SDL_SCANCODE_RSHIFT]))
-								{
-									SetLocation (iCurRoom, iSelected, iLastTile);
-									PlaySound ("wav/ok_close.wav"); iChanged++;
-								} else {
-									ChangePos();
-									ShowScreen(); break; /*** ? ***/
-								}
-							}
+	/*** under this room ***/
+	if (stLevel->arRoomLinks[iCurRoom][4] != 0)
+	{
+		for (iTileLoop = 1; iTileLoop <= (TILES / 3); iTileLoop++)
+		{
+			iTile = stLevel->arRoomTiles
+				[stLevel->arRoomLinks[iCurRoom][4]][iTileLoop];
+			switch (cCurType)
+			{
+				case 'd':
+					ShowTile (imgd[iTile][1], iHor[iTileLoop], iVer4,
+						iTile, TILE_NORMAL);
+					break;
+				case 'p':
+					ShowTile (imgp[iTile][1], iHor[iTileLoop], iVer4,
+						iTile, TILE_NORMAL);
+					break;
+			}
+		}
+	}
 
-							/*** 1 ***/
-							if (InArea (610, 3, 619, 12) == 1)
-							{
-								Zoom (0);
-								iExtras = 0;
-								PlaySound ("wav/extras.wav");
-							}
+	/*** One tile: top row, room left. ***/
+	if (stLevel->arRoomLinks[iCurRoom][1] != 0)
+	{
+		iTile = stLevel->arRoomTiles
+			[stLevel->arRoomLinks[iCurRoom][1]][10];
+	} else {
+		iTile = 0x14;
+	}
+	switch (cCurType)
+	{
+		case 'd':
+			ShowTile (imgd[iTile][1], iHor[0], iVer1, iTile, TILE_NORMAL);
+			break;
+		case 'p':
+			ShowTile (imgp[iTile][1], iHor[0], iVer1, iTile, TILE_NORMAL);
+			break;
+	}
+	ShowImage (imgfadeds, iHor[0], iVer1, "imgfadeds");
 
-							/*** 4 ***/
-							if (InArea (640, 3, 649, 12) == 1)
-							{
-								InitScreenAction ("env");
-							}
+	/*** One tile: middle row, room left. ***/
+	if (stLevel->arRoomLinks[iCurRoom][1] != 0)
+	{
+		iTile = stLevel->arRoomTiles
+			[stLevel->arRoomLinks[iCurRoom][1]][20];
+	} else {
+		iTile = 0x14;
+	}
+	switch (cCurType)
+	{
+		case 'd':
+			ShowTile (imgd[iTile][1], iHor[0], iVer2, iTile, TILE_NORMAL);
+			break;
+		case 'p':
+			ShowTile (imgp[iTile][1], iHor[0], iVer2, iTile, TILE_NORMAL);
+			break;
+	}
+	ShowImage (imgfadeds, iHor[0], iVer2, "imgfadeds");
 
-							/*** 6 ***/
-							if (InArea (610, 13, 619, 22) == 1)
-							{
-								Sprinkle();
-								PlaySound ("wav/extras.wav");
-								iChanged++;
-							}
+	/*** One tile: 'top' row, room left down. ***/
+	if (stLevel->arRoomLinks[iCurRoom][1] != 0) /*** left ***/
+	{
+		if (stLevel->arRoomLinks
+			[stLevel->arRoomLinks[iCurRoom][1]][4] != 0) /*** down ***/
+		{
+			iTile = stLevel->arRoomTiles
+				[stLevel->arRoomLinks[stLevel->arRoomLinks[iCurRoom][1]][4]]
+				[10];
+		} else {
+			iTile = 0x14;
+		}
+	}
+	switch (cCurType)
+	{
+		case 'd':
+			ShowTile (imgd[iTile][1], iHor[0], iVer4, iTile, TILE_NORMAL);
+			break;
+		case 'p':
+			ShowTile (imgp[iTile][1], iHor[0], iVer4, iTile, TILE_NORMAL);
+			break;
+	}
+	ShowImage (imgfadeds, iHor[0], iVer4, "imgfadeds");
 
-							/*** 8 ***/
-							if (InArea (630, 13, 639, 22) == 1)
-							{
-								FlipRoom (1);
-								PlaySound ("wav/extras.wav");
-								iChanged++;
-							}
+	/*** One tile: bottom row, room left. ***/
+	if (stLevel->arRoomLinks[iCurRoom][1] != 0)
+	{
+		iTile = stLevel->arRoomTiles
+			[stLevel->arRoomLinks[iCurRoom][1]][30];
+	} else {
+		iTile = 0x14;
+	}
+	switch (cCurType)
+	{
+		case 'd':
+			ShowTile (imgd[iTile][1], iHor[0], iVer3, iTile, TILE_NORMAL);
+			break;
+		case 'p':
+			ShowTile (imgp[iTile][1], iHor[0], iVer3, iTile, TILE_NORMAL);
+			break;
+	}
+	ShowImage (imgfadeds, iHor[0], iVer3, "imgfadeds");
 
-							/*** 3 ***/
-							if (InArea (630, 3, 639, 12) == 1)
-							{
-								FlipRoom (2);
-								PlaySound ("wav/extras.wav");
-								iChanged++;
-							}
+	/*** Tiles. ***/
+	for (iTileLoop = 1; iTileLoop <= 30; iTileLoop++)
+	{
+		iLoc = 0;
+		iHorL = iHor[0]; /*** To prevent warnings. ***/
+		iVerL = iVer0; /*** To prevent warnings. ***/
+		if ((iTileLoop >= 1) && (iTileLoop <= 10))
+		{
+			iLoc = 20 + iTileLoop;
+			iHorL = iHor[iTileLoop];
+			iVerL = iVer3;
+		}
+		if ((iTileLoop >= 11) && (iTileLoop <= 20))
+		{
+			iLoc = iTileLoop;
+			iHorL = iHor[iTileLoop - 10];
+			iVerL = iVer2;
+		}
+		if ((iTileLoop >= 21) && (iTileLoop <= 30))
+		{
+			iLoc = -20 + iTileLoop;
+			iHorL = iHor[iTileLoop - 20];
+			iVerL = iVer1;
+		}
+		iTile = stLevel->arRoomTiles[iCurRoom][iLoc];
+		if (imgd[iTile][1] == NULL) { iUnknown = 1; } else { iUnknown = 0; }
+		if (iUnknown == 1)
+		{
+			ShowTile (imgunk[1], iHorL, iVerL, iTile, TILE_NORMAL);
+		} else {
+			switch (cCurType)
+			{
+				case 'd':
+					ShowTile (imgd[iTile][1], iHorL, iVerL, iTile, TILE_NORMAL);
+					break;
+				case 'p':
+					ShowTile (imgp[iTile][1], iHorL, iVerL, iTile, TILE_NORMAL);
+					break;
+			}
+		}
 
-							/*** 2 ***/
-							if (InArea (620, 3, 629, 12) == 1)
-							{
-								CopyPaste (1);
-								PlaySound ("wav/extras.wav");
-							}
+		/*** The highlight, prince and guard are not part of a room layer. ***/
+		iSprite = 1;
+		if (iLoc == iSelected)
+		{
+			if (iUnknown == 1)
+			{
+				ShowTile (imgunk[2], iHorL, iVerL, iTile, TILE_HIGH);
+			} else {
+				switch (cCurType)
+				{
+					case 'd':
+						ShowTile (imgd[iTile][2], iHorL, iVerL,
+							iTile, TILE_HIGH);
+						break;
+					case 'p':
+						ShowTile (imgp[iTile][2], iHorL, iVerL,
+							iTile, TILE_HIGH);
+						break;
+				}
+			}
+		}
 
-							/*** 7 ***/
-							if (InArea (620, 13, 629, 22) == 1)
-							{
-								CopyPaste (2);
-								PlaySound ("wav/extras.wav");
-								iChanged++;
-							}
+		/*** prince ***/
+		if ((iCurRoom == stLevel->arStartLocation[1]) &&
+			(iLoc == stLevel->arStartLocation[2]))
+		{
+			switch (stLevel->arStartLocation[3])
+			{
+				case 0x00: /*** looks right ***/
+					ShowImage (imgprincer[1], iHorL + 20, iVerL + 20, "imgprincer[1]");
+					if (iSelected == iLoc)
+						{ ShowImage (imgprincer[2], iHorL + 20,
+						iVerL + 20, "imgprincer[2]"); }
+					break;
+				case 0xFF: /*** looks left ***/
+					ShowImage (imgprincel[1], iHorL + 24, iVerL + 20, "imgprincel[1]");
+					if (iSelected == iLoc)
+						{ ShowImage (imgprincel[2], iHorL + 24,
+						iVerL + 20, "imgprincel[2]"); }
+					break;
+				default:
+					printf ("[ WARN ] Strange prince direction: 0x%02x!\n",
+						stLevel->arStartLocation[3]);
+			}
+		}
 
-							/*** 5 ***/
-							if (InArea (650, 3, 659, 12) == 1)
-							{
-								Help(); SDL_SetCursor (curArrow);
-							}
+		/*** guard ***/
+		if (stLevel->arGuardTile[iCurRoom] == iLoc)
+		{
+			switch (stLevel->arGuardDir[iCurRoom])
+			{
+				case 0xFF: /*** l ***/
+					imgskeleton[1] = imgskeletonl[1];
+					imgshadow[1] = imgshadowl[1];
+					imgjaffar[1] = imgjaffarl[1];
+					imgguard[1] = imgguardl[1];
+					imgskeleton[2] = imgskeletonl[2];
+					imgshadow[2] = imgshadowl[2];
+					imgjaffar[2] = imgjaffarl[2];
+					imgguard[2] = imgguardl[2];
+					break;
+				case 0x00: /*** r ***/
+					imgskeleton[1] = imgskeletonr[1];
+					imgshadow[1] = imgshadowr[1];
+					imgjaffar[1] = imgjaffarr[1];
+					imgguard[1] = imgguardr[1];
+					imgskeleton[2] = imgskeletonr[2];
+					imgshadow[2] = imgshadowr[2];
+					imgjaffar[2] = imgjaffarr[2];
+					imgguard[2] = imgguardr[2];
+					break;
+				default:
+					printf ("[FAILED] Incorrect guard direction: 0x%02x!\n",
+						stLevel->arGuardDir[iCurRoom]);
+					exit (EXIT_ERROR);
+			}
+			switch (iCurLevel)
+			{
+				case 3:
+					ShowImage (imgskeleton[1], iHorL, iVerL + 24, "imgskeleton[1]");
+					if (iLoc == iSelected)
+						{ ShowImage (imgskeleton[2], iHorL,
+						iVerL + 24, "imgskeleton[2]"); }
+					break;
+				case 12:
+					ShowImage (imgshadow[1], iHorL, iVerL + 16, "imgshadow[1]");
+					if (iLoc == iSelected)
+						{ ShowImage (imgshadow[2], iHorL, iVerL + 16, "imgshadow[2]"); }
+					break;
+				case 13:
+					ShowImage (imgjaffar[1], iHorL, iVerL + 12, "imgjaffar[1]");
+					if (iLoc == iSelected)
+						{ ShowImage (imgjaffar[2], iHorL, iVerL + 12, "imgjaffar[2]"); }
+					break;
+				default:
+					ShowImage (imgguard[1], iHorL, iVerL + 16, "imgguard[1]");
+					if (iLoc == iSelected)
+						{ ShowImage (imgguard[2], iHorL, iVerL + 16, "imgguard[2]"); }
+					break;
+			}
+		}
+		iSprite = 0;
+	}
 
-							/*** 10 ***/
-							if (InArea (650, 13, 659, 22) == 1)
-							{
-								EXE();
-								SDL_SetCursor (curArrow);
-								SDL_StopTextInput();
-							}
-						}
+	if (iCurLevel == 15)
+	{
+		ShowImage (imgvwarning, 40, 472, "imgvwarning");
+	}
+}
+/*****************************************************************************/
+void ShowFlames (void)
+/*****************************************************************************/
+{
+	/* Only the torches change between flame frames. Everything that is drawn
+	 * over them is drawn again, clipped to the torches, on top of imgscene.
+	 */
+	if (imgscene == NULL) { ShowScreen(); return; }
+	memcpy (arClip, arFlames, sizeof (arFlames));
+	iClips = iFlames;
+	iDrawMode = DRAW_CLIP;
+	ShowScreen();
+	iDrawMode = DRAW_ALL;
+}
+/*****************************************************************************/
+int RoomLayer (void)
+/*****************************************************************************/
+{
+	unsigned long long llHash;
+	struct roomlayer *stLayer;
 
-						if (iScreen == 2) /*** room links screen ***/
-						{
-							if (arBrokenRoomLinks[iCurLevel] == 0)
-							{
-								for (iRoomLoop = 0; iRoomLoop < ROOMS; iRoomLoop++) /*** x ***/
-								{
-									/*** y ***/
-									for (iRoomLoop2 = 0; iRoomLoop2 < ROOMS; iRoomLoop2++)
-									{
-										if (InArea (297 + (iRoomLoop * 15), 61 + (iRoomLoop2 * 15),
-											310 + (iRoomLoop * 15), 74 + (iRoomLoop2 * 15)) == 1)
-										{
-											if (iMovingRoom != 0)
-											{
-												if (arMovingRooms[iRoomLoop + 1][iRoomLoop2 + 1] == 0)
-												{
-													RemoveOldRoom();
-													AddNewRoom (iRoomLoop + 1,
-														iRoomLoop2 + 1, iMovingRoom);
-													iChanged++;
-												}
-												iMovingRoom = 0; iMovingNewBusy = 0;
-											}
-										}
-									}
-								}
-								/*** y ***/
-								for (iRoomLoop2 = 0; iRoomLoop2 < ROOMS; iRoomLoop2++)
-								{
-									if (InArea (272, 61 + (iRoomLoop2 * 15),
-										272 + 14, 61 + 14 + (iRoomLoop2 * 15)) == 1)
-									{
-										if (iMovingRoom != 0)
-										{
-											if (arMovingRooms[25][iRoomLoop2 + 1] == 0)
-											{
-												RemoveOldRoom();
-												AddNewRoom (25, iRoomLoop2 + 1, iMovingRoom);
-												iChanged++;
-											}
-											iMovingRoom = 0; iMovingNewBusy = 0;
-										}
-									}
-								}
+	/*** Used for looping. ***/
+	int iLayerLoop;
 
-								/*** rooms broken ***/
-								if (InArea (629, 63, 654, 88) == 1)
-								{
-									arBrokenRoomLinks[iCurLevel] = 1;
-									PlaySound ("wav/screen2or3.wav");
-								}
+	if (imgscene == NULL) { return (0); }
 
-								/*** Horizontal level. ***/
-								if (InArea (275, 434, 275 + 49, 434 + 49) == 1)
-								{
-									for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-									{
-										/*** Clear. ***/
-										arRoomLinks[iCurLevel][iRoomLoop][1] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][2] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][3] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][4] = 0;
+	/*** A layer shows tiles of adjacent rooms too, so hash the whole level. ***/
+	llHash = HashBytes ((unsigned char *)&stEdit.stRom.arLevel[iCurLevel],
+		sizeof (struct level));
+	stLayer = NULL;
+	for (iLayerLoop = 1; iLayerLoop <= ROOM_LAYERS; iLayerLoop++)
+	{
+		if ((arLayers[iLayerLoop].iLevel == iCurLevel) &&
+			(arLayers[iLayerLoop].iRoom == iCurRoom) &&
+			(arLayers[iLayerLoop].iInfo == iInfo) &&
+			(arLayers[iLayerLoop].llHash == llHash))
+			{ stLayer = &arLayers[iLayerLoop]; }
+	}
 
-										if (iRoomLoop != 1)
-											{ arRoomLinks[iCurLevel][iRoomLoop][1] = iRoomLoop - 1; }
-										if (iRoomLoop != 24)
-											{ arRoomLinks[iCurLevel][iRoomLoop][2] = iRoomLoop + 1; }
-									}
-									PlaySound ("wav/move_room.wav");
-									iChanged++;
-								}
+	if (stLayer == NULL)
+	{
+		/*** Replace the least recently used layer. ***/
+		stLayer = &arLayers[1];
+		for (iLayerLoop = 2; iLayerLoop <= ROOM_LAYERS; iLayerLoop++)
+		{
+			if (arLayers[iLayerLoop].iUsed < stLayer->iUsed)
+				{ stLayer = &arLayers[iLayerLoop]; }
+		}
+		if (stLayer->img == NULL)
+		{
+			stLayer->img = SDL_CreateTexture (ascreen, SDL_PIXELFORMAT_ARGB8888,
+				SDL_TEXTUREACCESS_TARGET, (WINDOW_WIDTH) * iScale,
+				(WINDOW_HEIGHT) * iScale);
+			stFrame.iCreates++;
+			if (stLayer->img == NULL)
+			{
+				printf ("[ WARN ] Could not create a room layer: %s!\n",
+					SDL_GetError());
+				return (0);
+			}
+			SDL_SetTextureBlendMode (stLayer->img, SDL_BLENDMODE_NONE);
+		}
+		FlushDraws();
+		SDL_SetRenderTarget (ascreen, stLayer->img);
+		iFlames = 0;
+		iDrawMode = DRAW_LAYER;
+		ShowImage (imgblack, 0, 0, "imgblack");
+		ShowTiles();
+		iDrawMode = DRAW_ALL;
+		FlushDraws();
+		SDL_SetRenderTarget (ascreen, imgscene);
+		stLayer->iLevel = iCurLevel;
+		stLayer->iRoom = iCurRoom;
+		stLayer->iInfo = iInfo;
+		stLayer->llHash = llHash;
+		memcpy (stLayer->arFlames, arFlames, sizeof (arFlames));
+		stLayer->iFlames = iFlames;
+		if (iDebug == 1)
+		{
+			printf ("[ INFO ] Drew the layer of room %i (level %i).\n",
+				iCurRoom, iCurLevel);
+		}
+	}
 
-								/*** Vertical level. ***/
-								if (InArea (275, 486, 275 + 49, 486 + 49) == 1)
-								{
-									for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-									{
-										/*** Clear. ***/
-										arRoomLinks[iCurLevel][iRoomLoop][1] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][2] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][3] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][4] = 0;
+	iLayerClock++;
+	stLayer->iUsed = iLayerClock;
+	memcpy (arFlames, stLayer->arFlames, sizeof (arFlames));
+	iFlames = stLayer->iFlames;
+	FlushDraws();
+	ProfileCopy (stLayer->img);
+	if (SDL_RenderCopy (ascreen, stLayer->img, NULL, NULL) != 0)
+	{
+		printf ("[ WARN ] SDL_RenderCopy (room layer): %s!\n", SDL_GetError());
+	}
 
-										if (iRoomLoop != 1)
-											{ arRoomLinks[iCurLevel][iRoomLoop][3] = iRoomLoop - 1; }
-										if (iRoomLoop != 24)
-											{ arRoomLinks[iCurLevel][iRoomLoop][4] = iRoomLoop + 1; }
-									}
-									PlaySound ("wav/move_room.wav");
-									iChanged++;
-								}
+	return (1);
+}
+/*****************************************************************************/
+void DropRoomLayers (int iLevel)
+/*****************************************************************************/
+{
+	/*** Used for looping. ***/
+	int iLayerLoop;
+
+	for (iLayerLoop = 1; iLayerLoop <= ROOM_LAYERS; iLayerLoop++)
+	{
+		if ((iLevel == 0) || (arLayers[iLayerLoop].iLevel == iLevel))
+		{
+			arLayers[iLayerLoop].iLevel = 0;
+			arLayers[iLayerLoop].iUsed = 0;
+		}
+	}
+}
+/*****************************************************************************/
+void InitPopUp (void)
+/*****************************************************************************/
+{
+	int iPopUp;
+	SDL_Event event;
 
-								/*** Horizontal rectangle level. ***/
-								if (InArea (327, 434, 327 + 49, 434 + 49) == 1)
-								{
-									for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-									{
-										/*** Clear. ***/
-										arRoomLinks[iCurLevel][iRoomLoop][1] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][2] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][3] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][4] = 0;
-									}
-									arRoomLinks[iCurLevel][1][2] = 2;
-									arRoomLinks[iCurLevel][1][4] = 7;
-									arRoomLinks[iCurLevel][2][1] = 1;
-									arRoomLinks[iCurLevel][2][2] = 3;
-									arRoomLinks[iCurLevel][2][4] = 8;
-									arRoomLinks[iCurLevel][3][1] = 2;
-									arRoomLinks[iCurLevel][3][2] = 4;
-									arRoomLinks[iCurLevel][3][4] = 9;
-									arRoomLinks[iCurLevel][4][1] = 3;
-									arRoomLinks[iCurLevel][4][2] = 5;
-									arRoomLinks[iCurLevel][4][4] = 10;
-									arRoomLinks[iCurLevel][5][1] = 4;
-									arRoomLinks[iCurLevel][5][2] = 6;
-									arRoomLinks[iCurLevel][5][4] = 11;
-									arRoomLinks[iCurLevel][6][1] = 5;
-									arRoomLinks[iCurLevel][6][4] = 12;
-									arRoomLinks[iCurLevel][7][2] = 8;
-									arRoomLinks[iCurLevel][7][3] = 1;
-									arRoomLinks[iCurLevel][7][4] = 13;
-									arRoomLinks[iCurLevel][8][1] = 7;
-									arRoomLinks[iCurLevel][8][2] = 9;
-									arRoomLinks[iCurLevel][8][3] = 2;
-									arRoomLinks[iCurLevel][8][4] = 14;
-									arRoomLinks[iCurLevel][9][1] = 8;
-									arRoomLinks[iCurLevel][9][2] = 10;
-									arRoomLinks[iCurLevel][9][3] = 3;
-									arRoomLinks[iCurLevel][9][4] = 15;
-									arRoomLinks[iCurLevel][10][1] = 9;
-									arRoomLinks[iCurLevel][10][2] = 11;
-									arRoomLinks[iCurLevel][10][3] = 4;
-									arRoomLinks[iCurLevel][10][4] = 16;
-									arRoomLinks[iCurLevel][11][1] = 10;
-									arRoomLinks[iCurLevel][11][2] = 12;
-									arRoomLinks[iCurLevel][11][3] = 5;
-									arRoomLinks[iCurLevel][11][4] = 17;
-									arRoomLinks[iCurLevel][12][1] = 11;
-									arRoomLinks[iCurLevel][12][3] = 6;
-									arRoomLinks[iCurLevel][12][4] = 18;
-									arRoomLinks[iCurLevel][13][2] = 14;
-									arRoomLinks[iCurLevel][13][3] = 7;
-									arRoomLinks[iCurLevel][13][4] = 19;
-									arRoomLinks[iCurLevel][14][1] = 13;
-									arRoomLinks[iCurLevel][14][2] = 15;
-									arRoomLinks[iCurLevel][14][3] = 8;
-									arRoomLinks[iCurLevel][14][4] = 20;
-									arRoomLinks[iCurLevel][15][1] = 14;
-									arRoomLinks[iCurLevel][15][2] = 16;
-									arRoomLinks[iCurLevel][15][3] = 9;
-									arRoomLinks[iCurLevel][15][4] = 21;
-									arRoomLinks[iCurLevel][16][1] = 15;
-									arRoomLinks[iCurLevel][16][2] = 17;
-									arRoomLinks[iCurLevel][16][3] = 10;
-									arRoomLinks[iCurLevel][16][4] = 22;
-									arRoomLinks[iCurLevel][17][1] = 16;
-									arRoomLinks[iCurLevel][17][2] = 18;
-									arRoomLinks[iCurLevel][17][3] = 11;
-									arRoomLinks[iCurLevel][17][4] = 23;
-									arRoomLinks[iCurLevel][18][1] = 17;
-									arRoomLinks[iCurLevel][18][3] = 12;
-									arRoomLinks[iCurLevel][18][4] = 24;
-									arRoomLinks[iCurLevel][19][2] = 20;
-									arRoomLinks[iCurLevel][19][3] = 13;
-									arRoomLinks[iCurLevel][20][1] = 19;
-									arRoomLinks[iCurLevel][20][2] = 21;
-									arRoomLinks[iCurLevel][20][3] = 14;
-									arRoomLinks[iCurLevel][21][1] = 20;
-									arRoomLinks[iCurLevel][21][2] = 22;
-									arRoomLinks[iCurLevel][21][3] = 15;
-									arRoomLinks[iCurLevel][22][1] = 21;
-									arRoomLinks[iCurLevel][22][2] = 23;
-									arRoomLinks[iCurLevel][22][3] = 16;
-									arRoomLinks[iCurLevel][23][1] = 22;
-									arRoomLinks[iCurLevel][23][2] = 24;
-									arRoomLinks[iCurLevel][23][3] = 17;
-									arRoomLinks[iCurLevel][24][1] = 23;
-									arRoomLinks[iCurLevel][24][3] = 18;
-									PlaySound ("wav/move_room.wav");
-									iChanged++;
-								}
+	iPopUp = 1;
 
-								/*** Vertical rectangle level. ***/
-								if (InArea (327, 486, 327 + 49, 486 + 49) == 1)
-								{
-									for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-									{
-										/*** Clear. ***/
-										arRoomLinks[iCurLevel][iRoomLoop][1] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][2] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][3] = 0;
-										arRoomLinks[iCurLevel][iRoomLoop][4] = 0;
-									}
-									arRoomLinks[iCurLevel][1][2] = 2;
-									arRoomLinks[iCurLevel][1][4] = 5;
-									arRoomLinks[iCurLevel][2][1] = 1;
-									arRoomLinks[iCurLevel][2][2] = 3;
-									arRoomLinks[iCurLevel][2][4] = 6;
-									arRoomLinks[iCurLevel][3][1] = 2;
-									arRoomLinks[iCurLevel][3][2] = 4;
-									arRoomLinks[iCurLevel][3][4] = 7;
-									arRoomLinks[iCurLevel][4][1] = 3;
-									arRoomLinks[iCurLevel][4][4] = 8;
-									arRoomLinks[iCurLevel][5][2] = 6;
-									arRoomLinks[iCurLevel][5][3] = 1;
-									arRoomLinks[iCurLevel][5][4] = 9;
-									arRoomLinks[iCurLevel][6][1] = 5;
-									arRoomLinks[iCurLevel][6][2] = 7;
-									arRoomLinks[iCurLevel][6][3] = 2;
-									arRoomLinks[iCurLevel][6][4] = 10;
-									arRoomLinks[iCurLevel][7][1] = 6;
-									arRoomLinks[iCurLevel][7][2] = 8;
-									arRoomLinks[iCurLevel][7][3] = 3;
-									arRoomLinks[iCurLevel][7][4] = 11;
-									arRoomLinks[iCurLevel][8][1] = 7;
-									arRoomLinks[iCurLevel][8][3] = 4;
-									arRoomLinks[iCurLevel][8][4] = 12;
-									arRoomLinks[iCurLevel][9][2] = 10;
-									arRoomLinks[iCurLevel][9][3] = 5;
-									arRoomLinks[iCurLevel][9][4] = 13;
-									arRoomLinks[iCurLevel][10][1] = 9;
-									arRoomLinks[iCurLevel][10][2] = 11;
-									arRoomLinks[iCurLevel][10][3] = 6;
-									arRoomLinks[iCurLevel][10][4] = 14;
-									arRoomLinks[iCurLevel][11][1] = 10;
-									arRoomLinks[iCurLevel][11][2] = 12;
-									arRoomLinks[iCurLevel][11][3] = 7;
-									arRoomLinks[iCurLevel][11][4] = 15;
-									arRoomLinks[iCurLevel][12][1] = 11;
-									arRoomLinks[iCurLevel][12][3] = 8;
-									arRoomLinks[iCurLevel][12][4] = 16;
-									arRoomLinks[iCurLevel][13][2] = 14;
-									arRoomLinks[iCurLevel][13][3] = 9;
-									arRoomLinks[iCurLevel][13][4] = 17;
-									arRoomLinks[iCurLevel][14][1] = 13;
-									arRoomLinks[iCurLevel][14][2] = 15;
-									arRoomLinks[iCurLevel][14][3] = 10;
-									arRoomLinks[iCurLevel][14][4] = 18;
-									arRoomLinks[iCurLevel][15][1] = 14;
-									arRoomLinks[iCurLevel][15][2] = 16;
-									arRoomLinks[iCurLevel][15][3] = 11;
-									arRoomLinks[iCurLevel][15][4] = 19;
-									arRoomLinks[iCurLevel][16][1] = 15;
-									arRoomLinks[iCurLevel][16][3] = 12;
-									arRoomLinks[iCurLevel][16][4] = 20;
-									arRoomLinks[iCurLevel][17][2] = 18;
-									arRoomLinks[iCurLevel][17][3] = 13;
-									arRoomLinks[iCurLevel][17][4] = 21;
-									arRoomLinks[iCurLevel][18][1] = 17;
-									arRoomLinks[iCurLevel][18][2] = 19;
-									arRoomLinks[iCurLevel][18][3] = 14;
-									arRoomLinks[iCurLevel][18][4] = 22;
-									arRoomLinks[iCurLevel][19][1] = 18;
-									arRoomLinks[iCurLevel][19][2] = 20;
-									arRoomLinks[iCurLevel][19][3] = 15;
-									arRoomLinks[iCurLevel][19][4] = 23;
-									arRoomLinks[iCurLevel][20][1] = 19;
-									arRoomLinks[iCurLevel][20][3] = 16;
-									arRoomLinks[iCurLevel][20][4] = 24;
-									arRoomLinks[iCurLevel][21][2] = 22;
-									arRoomLinks[iCurLevel][21][3] = 17;
-									arRoomLinks[iCurLevel][22][1] = 21;
-									arRoomLinks[iCurLevel][22][2] = 23;
-									arRoomLinks[iCurLevel][22][3] = 18;
-									arRoomLinks[iCurLevel][23][1] = 22;
-									arRoomLinks[iCurLevel][23][2] = 24;
-									arRoomLinks[iCurLevel][23][3] = 19;
-									arRoomLinks[iCurLevel][24][1] = 23;
-									arRoomLinks[iCurLevel][24][3] = 20;
-									PlaySound ("wav/move_room.wav");
-									iChanged++;
-								}
-							} else {
-								if (MouseSelectAdj() == 1)
-								{
-									LinkPlus();
-								}
-							}
+	PlaySound ("wav/popup.wav");
+	ShowPopUp();
+	while (iPopUp == 1)
+	{
+		while (PollEvent (&event))
+		{
+			UndoEnd();
+			switch (event.type)
+			{
+				case SDL_CONTROLLERBUTTONDOWN:
+					/*** Nothing for now. ***/
+					break;
+				case SDL_CONTROLLERBUTTONUP:
+					switch (event.cbutton.button)
+					{
+						case SDL_CONTROLLER_BUTTON_A:
+							iPopUp = 0; break;
+					}
+					break;
+				case SDL_KEYDOWN:
+					switch (event.key.keysym.sym)
+					{
+						case SDLK_ESCAPE:
+						case SDLK_KP_ENTER:
+						case SDLK_RETURN:
+						case SDLK_SPACE:
+						case SDLK_o:
+							iPopUp = 0;
+						default: break;
+					}
+					break;
+				case SDL_MOUSEMOTION:
+					iXPos = event.motion.x;
+					iYPos = event.motion.y;
+					break;
+				case SDL_MOUSEBUTTONDOWN:
+					if (event.button.button == 1)
+					{
+						if (InArea (440, 376, 440 + 85, 376 + 32) == 1) /*** OK ***/
+						{
+							iOKOn = 1;
+							ShowPopUp();
 						}
-
-						if (iScreen == 3) /*** events screen ***/
+					}
+					break;
+				case SDL_MOUSEBUTTONUP:
+					iOKOn = 0;
+					if (event.button.button == 1)
+					{
+						if (InArea (440, 376, 440 + 85, 376 + 32) == 1) /*** OK ***/
 						{
-							/*** total no. of events ***/
-							if (InArea (150, 59, 150 + 13, 59 + 20) == 1)
-								{ TotalEvents (-10); }
-							if (InArea (165, 59, 165 + 13, 59 + 20) == 1)
-								{ TotalEvents (-1); }
-							if (InArea (235, 59, 235 + 13, 59 + 20) == 1)
-								{ TotalEvents (1); }
-							if (InArea (250, 59, 250 + 13, 59 + 20) == 1)
-								{ TotalEvents (10); }
+							iPopUp = 0;
+						}
+					}
+					ShowPopUp(); break;
+				case SDL_WINDOWEVENT:
+					if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
+						{ ShowScreen(); ShowPopUp(); } break;
+				case SDL_QUIT:
+					Quit(); break;
+			}
+		}
 
-							/*** edit this event ***/
-							if (InArea (472, 59, 472 + 13, 59 + 20) == 1)
-								{ ChangeEvent (-10, 0); }
-							if (InArea (487, 59, 487 + 13, 59 + 20) == 1)
-								{ ChangeEvent (-1, 0); }
-							if (InArea (557, 59, 557 + 13, 59 + 20) == 1)
-								{ ChangeEvent (1, 0); }
-							if (InArea (572, 59, 572 + 13, 59 + 20) == 1)
-								{ ChangeEvent (10, 0); }
+		/*** Sleep until there is input. ***/
+		WaitEvent (-1);
+	}
+	PlaySound ("wav/popup_close.wav");
+	ShowScreen();
+}
+/*****************************************************************************/
+void ShowPopUp (void)
+/*****************************************************************************/
+{
+	char arText[9 + 2][MAX_TEXT + 2];
 
-							/*** Opens ***/
-							if (InArea (282, 306, 282 + 14, 306 + 14) == 1)
-							{
-								if (arEventsOpenClose[iCurLevel][iChangeEvent] != 0x01)
-								{
-									arEventsOpenClose[iCurLevel][iChangeEvent] = 0x01;
-									PlaySound ("wav/check_box.wav");
-									iChanged++;
-								}
-							}
+	ProfilePhase (PHASE_OTHER);
 
-							/*** Closes ***/
-							if (InArea (387, 306, 387 + 14, 306 + 14) == 1)
-							{
-								if (arEventsOpenClose[iCurLevel][iChangeEvent] != 0x00)
-								{
-									arEventsOpenClose[iCurLevel][iChangeEvent] = 0x00;
-									PlaySound ("wav/check_box.wav");
-									iChanged++;
-								}
-							}
+	/*** faded background ***/
+	ShowImage (imgfadedl, 0, 0, "imgfadedl");
 
-							/*** from room ***/
-							if ((iYPos >= 136 * iScale) &&
-								(iYPos <= (136 + 14) * iScale))
-							{
-								for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-								{
-									if ((iXPos >= (282 + ((iRoomLoop - 1) * 15)) * iScale)
-										&& (iXPos <= ((282 + 14) +
-										((iRoomLoop - 1) * 15)) * iScale))
-									{
-										EventRoom (iRoomLoop, 0);
-									}
-								}
-							}
+	/*** popup ***/
+	ShowImage (imgpopup, 52, 64, "imgpopup");
 
-							/*** from tile ***/
-							for (iColLoop = 1; iColLoop <= 3; iColLoop++)
-							{
-								for (iRowLoop = 1; iRowLoop <= 10; iRowLoop++)
-								{
-									if ((iXPos >= (282 + ((iRowLoop - 1) * 15)) * iScale)
-										&& (iXPos <= ((282 + 14) +
-										((iRowLoop - 1) * 15)) * iScale))
-									{
-										if ((iYPos >= (238 + ((iColLoop - 1) * 15)) * iScale)
-											&& (iYPos <= ((238 + 14) +
-											((iColLoop - 1) * 15)) * iScale))
-										{
-											EventTile (iRowLoop, iColLoop, 0);
-										}
-									}
-								}
-							}
+	/*** OK ***/
+	switch (iOKOn)
+	{
+		case 0: ShowImage (imgok[1], 440, 376, "imgok[1]"); break; /*** off ***/
+		case 1: ShowImage (imgok[2], 440, 376, "imgok[2]"); break; /*** on ***/
+	}
 
-							/*** to room ***/
-							if ((iYPos >= 377 * iScale) &&
-								(iYPos <= (377 + 14) * iScale))
-							{
-								for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-								{
-									if ((iXPos >= (282 + ((iRoomLoop - 1) * 15)) * iScale)
-										&& (iXPos <= ((282 + 14) +
-										((iRoomLoop - 1) * 15)) * iScale))
-									{
-										EventRoom (iRoomLoop, 1);
-									}
-								}
-							}
+	snprintf (arText[0], MAX_TEXT, "%s %s", EDITOR_NAME, EDITOR_VERSION);
+	snprintf (arText[1], MAX_TEXT, "%s", COPYRIGHT);
+	snprintf (arText[2], MAX_TEXT, "%s", "");
+	if (iController != 1)
+	{
+		snprintf (arText[3], MAX_TEXT, "%s", "single tile (change or select)");
+		snprintf (arText[4], MAX_TEXT, "%s", "entire room (clear or fill)");
+		snprintf (arText[5], MAX_TEXT, "%s", "entire level (randomize or fill)");
+	} else {
+		snprintf (arText[3], MAX_TEXT, "%s", "The detected game controller:");
+		snprintf (arText[4], MAX_TEXT, "%s", sControllerName);
+		snprintf (arText[5], MAX_TEXT, "%s", "Have fun using it!");
+	}
+	snprintf (arText[6], MAX_TEXT, "%s", "");
+	snprintf (arText[7], MAX_TEXT, "%s", "You may use one guard per room.");
+	snprintf (arText[8], MAX_TEXT, "%s", "The tile behavior may differ per"
+		" level.");
 
-							/*** to tile ***/
-							for (iColLoop = 1; iColLoop <= 3; iColLoop++)
-							{
-								for (iRowLoop = 1; iRowLoop <= 10; iRowLoop++)
-								{
-									if ((iXPos >= (282 + ((iRowLoop - 1) * 15)) * iScale)
-										&& (iXPos <= ((282 + 14) +
-										((iRowLoop - 1) * 15)) * iScale))
-									{
-										if ((iYPos >= (479 + ((iColLoop - 1) * 15)) * iScale)
-											&& (iYPos <= ((479 + 14) +
-											((iColLoop - 1) * 15)) * iScale))
-										{
-											EventTile (iRowLoop, iColLoop, 1);
-										}
-									}
-								}
-							}
-						}
+	DisplayText (180, 177, FONT_SIZE_15, arText, 9, font1);
+
+	/*** refresh screen ***/
+	Present();
+}
+/*****************************************************************************/
+void Help (void)
+/*****************************************************************************/
+{
+	int iHelp;
+	SDL_Event event;
+
+	iHelp = 1;
+
+	PlaySound ("wav/popup.wav");
+	ShowHelp();
+	while (iHelp == 1)
+	{
+		while (PollEvent (&event))
+		{
+			UndoEnd();
+			switch (event.type)
+			{
+				case SDL_CONTROLLERBUTTONDOWN:
+					/*** Nothing for now. ***/
+					break;
+				case SDL_CONTROLLERBUTTONUP:
+					switch (event.cbutton.button)
+					{
+						case SDL_CONTROLLER_BUTTON_A:
+							iHelp = 0; break;
 					}
-					if (event.button.button == 2) /*** middle mouse button, clear ***/
+					break;
+				case SDL_KEYDOWN:
+					switch (event.key.keysym.sym)
 					{
-						if (iScreen == 1) { ClearRoom(); }
+						case SDLK_ESCAPE:
+						case SDLK_KP_ENTER:
+						case SDLK_RETURN:
+						case SDLK_SPACE:
+						case SDLK_o:
+							iHelp = 0;
+						default: break;
 					}
-					if (event.button.button == 3) /*** right mouse button, randomize ***/
+					break;
+				case SDL_MOUSEMOTION:
+					iXPos = event.motion.x;
+					iYPos = event.motion.y;
+					if (InArea (87, 413, 87 + 517, 413 + 20) == 1)
 					{
-						if (iScreen == 1)
-						{
-							for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-							{
-								for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-								{
-									UseTile (-1, iTileLoop, iRoomLoop);
-								}
-							}
-							PlaySound ("wav/ok_close.wav");
-							iChanged++;
-						}
-						if (iScreen == 2)
-						{
-							if (arBrokenRoomLinks[iCurLevel] == 1)
-							{
-								if (MouseSelectAdj() == 1)
-								{
-									LinkMinus();
-								}
-							}
-						}
+						SDL_SetCursor (curHand);
+					} else {
+						SDL_SetCursor (curArrow);
 					}
-					ShowScreen();
 					break;
-				case SDL_MOUSEWHEEL:
-					if (event.wheel.y > 0) /*** scroll wheel up ***/
+				case SDL_MOUSEBUTTONDOWN:
+					if (event.button.button == 1)
 					{
-						if (InArea (iHor[1], iVer1 + iTTP1, iHor[10] + iDX,
-							iVer3 + iDY + iTTPO) == 1) /*** middle field ***/
+						if (InArea (590, 523, 674, 554) == 1) /*** OK ***/
 						{
-							keystate = SDL_GetKeyboardState (NULL);
-							if ((keystate[SDL_SCANCODE_LSHIFT]) ||
-								(keystate[SDL_SCANCODE_RSHIFT]))
-							{ /*** right ***/
-								if (arRoomLinks[iCurLevel][iCurRoom][2] != 0)
-								{
-									iCurRoom = arRoomLinks[iCurLevel][iCurRoom][2];
-									PlaySound ("wav/scroll.wav");
-								}
-							} else { /*** up ***/
-								if (arRoomLinks[iCurLevel][iCurRoom][3] != 0)
-								{
-									iCurRoom = arRoomLinks[iCurLevel][iCurRoom][3];
-									PlaySound ("wav/scroll.wav");
-								}
-							}
+							iHelpOK = 1;
+							ShowHelp();
 						}
 					}
-					if (event.wheel.y < 0) /*** scroll wheel down ***/
+					break;
+				case SDL_MOUSEBUTTONUP:
+					iHelpOK = 0;
+					if (event.button.button == 1) /*** left mouse button ***/
 					{
-						if (InArea (iHor[1], iVer1 + iTTP1, iHor[10] + iDX,
-							iVer3 + iDY + iTTPO) == 1) /*** middle field ***/
-						{
-							keystate = SDL_GetKeyboardState (NULL);
-							if ((keystate[SDL_SCANCODE_LSHIFT]) ||
-								(keystate[SDL_SCANCODE_RSHIFT]))
-							{ /*** left ***/
-								if (arRoomLinks[iCurLevel][iCurRoom][1] != 0)
-								{
-									iCurRoom = arRoomLinks[iCurLevel][iCurRoom][1];
-									PlaySound ("wav/scroll.wav");
-								}
-							} else { /*** down ***/
-								if (arRoomLinks[iCurLevel][iCurRoom][4] != 0)
-								{
-									iCurRoom = arRoomLinks[iCurLevel][iCurRoom][4];
-									PlaySound ("wav/scroll.wav");
-								}
-							}
-						}
+						if (InArea (590, 523, 674, 554) == 1)
+							{ iHelp = 0; }
+						if (InArea (87, 413, 87 + 517, 413 + 20) == 1)
+							{ OpenURL ("https://github.com/EndeavourAccuracy/legbop"); }
 					}
-					ShowScreen();
-					break;
+					ShowHelp(); break;
 				case SDL_WINDOWEVENT:
 					if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
-						{ ShowScreen(); } break;
+						{ ShowHelp(); } break;
 				case SDL_QUIT:
 					Quit(); break;
-				default: break;
 			}
 		}
 
-		/*** prevent CPU eating ***/
-		gamespeed = REFRESH;
-		while ((SDL_GetTicks() - looptime) < gamespeed)
-		{
-			SDL_Delay (10);
-		}
-		looptime = SDL_GetTicks();
+		/*** Sleep until there is input. ***/
+		WaitEvent (-1);
 	}
+	PlaySound ("wav/popup_close.wav");
+	ShowScreen();
 }
 /*****************************************************************************/
-void InitPopUpSave (void)
+void ShowHelp (void)
 /*****************************************************************************/
 {
-	int iPopUp;
+	ProfilePhase (PHASE_OTHER);
+
+	/*** background ***/
+	ShowImage (imghelp, 0, 0, "imghelp");
+
+	/*** OK ***/
+	switch (iHelpOK)
+	{
+		case 0: ShowImage (imgok[1], 590, 523, "imgok[1]"); break; /*** off ***/
+		case 1: ShowImage (imgok[2], 590, 523, "imgok[2]"); break; /*** on ***/
+	}
+
+	/*** refresh screen ***/
+	Present();
+}
+/*****************************************************************************/
+void EXE (void)
+/*****************************************************************************/
+{
+	int iEXE;
 	SDL_Event event;
+	int iValue, iRGBLoop, iY;
+	int iOldXPos, iOldYPos;
+	char sLineTemp[SLIDES_LINES_CHARS + 2];
+	char cAddChar;
 
-	iPopUp = 1;
+	iEXE = 1;
+	iN = 0;
 
-	PlaySound ("wav/popup_yn.wav");
-	ShowPopUpSave();
-	while (iPopUp == 1)
+	EXELoad();
+
+	PlaySound ("wav/popup.wav");
+	ShowEXE();
+	while (iEXE == 1)
 	{
-		while (SDL_PollEvent (&event))
+		while (PollEvent (&event))
 		{
+			UndoEnd();
 			switch (event.type)
 			{
 				case SDL_CONTROLLERBUTTONDOWN:
@@ -3659,3511 +7594,4267 @@ void InitPopUpSave (void)
 					switch (event.cbutton.button)
 					{
 						case SDL_CONTROLLER_BUTTON_A:
-							CallSave(); iPopUp = 0; break;
-						case SDL_CONTROLLER_BUTTON_B:
-							iPopUp = 0; break;
+							if (EXESave() == 1) { iEXE = 0; } break;
 					}
 					break;
 				case SDL_KEYDOWN:
 					switch (event.key.keysym.sym)
 					{
 						case SDLK_ESCAPE:
-						case SDLK_n:
-							iPopUp = 0; break;
-						case SDLK_y:
-							CallSave(); iPopUp = 0; break;
+							iEXE = 0; break;
+						case SDLK_KP_ENTER:
+						case SDLK_RETURN:
+						/*** Not including SDLK_SPACE here. ***/
+						case SDLK_s:
+							if ((iS == 0) && (EXESave() == 1)) { iEXE = 0; }
+							break;
+						case SDLK_BACKSPACE:
+							if (iS != 0)
+							{
+								if (strlen (arIntroSlides[iS][iL]) > 0)
+								{
+									arIntroSlides[iS][iL]
+										[strlen (arIntroSlides[iS][iL]) - 1] = '\0';
+									IntroSlides();
+									PlaySound ("wav/hum_adj.wav");
+								}
+							}
+							break;
 						default: break;
 					}
+					ShowEXE();
 					break;
 				case SDL_MOUSEMOTION:
+					iOldXPos = iXPos;
+					iOldYPos = iYPos;
 					iXPos = event.motion.x;
 					iYPos = event.motion.y;
+					if ((iOldXPos == iXPos) && (iOldYPos == iYPos)) { break; }
+
+					/*** Intro slides. ***/
+					iS = 0;
+					iL = 0;
+					/*** 1 ***/
+					if (InArea (34, 209, 34 + 222, 209 + 12) == 1) { iS = 1; iL = 1; }
+					if (InArea (34, 225, 34 + 222, 225 + 12) == 1) { iS = 1; iL = 2; }
+					if (InArea (34, 241, 34 + 222, 241 + 12) == 1) { iS = 1; iL = 3; }
+					if (InArea (34, 257, 34 + 222, 257 + 12) == 1) { iS = 1; iL = 4; }
+					/*** 2 ***/
+					if (InArea (34, 313, 34 + 222, 313 + 12) == 1) { iS = 2; iL = 1; }
+					if (InArea (34, 329, 34 + 222, 329 + 12) == 1) { iS = 2; iL = 2; }
+					if (InArea (34, 345, 34 + 222, 345 + 12) == 1) { iS = 2; iL = 3; }
+					if (InArea (34, 361, 34 + 222, 361 + 12) == 1) { iS = 2; iL = 4; }
+					/*** 3 ***/
+					if (InArea (266, 313, 266 + 222, 313 + 12) == 1) { iS = 3; iL = 1; }
+					if (InArea (266, 329, 266 + 222, 329 + 12) == 1) { iS = 3; iL = 2; }
+					if (InArea (266, 345, 266 + 222, 345 + 12) == 1) { iS = 3; iL = 3; }
+					if (InArea (266, 361, 266 + 222, 361 + 12) == 1) { iS = 3; iL = 4; }
+					/*** 4 ***/
+					if (InArea (34, 417, 34 + 222, 417 + 12) == 1) { iS = 4; iL = 1; }
+					if (InArea (34, 433, 34 + 222, 433 + 12) == 1) { iS = 4; iL = 2; }
+					if (InArea (34, 449, 34 + 222, 449 + 12) == 1) { iS = 4; iL = 3; }
+					if (InArea (34, 465, 34 + 222, 465 + 12) == 1) { iS = 4; iL = 4; }
+					/*** 5 ***/
+					if (InArea (266, 417, 266 + 222, 417 + 12) == 1) { iS = 5; iL = 1; }
+					if (InArea (266, 433, 266 + 222, 433 + 12) == 1) { iS = 5; iL = 2; }
+					if (InArea (266, 449, 266 + 222, 449 + 12) == 1) { iS = 5; iL = 3; }
+					if (InArea (266, 465, 266 + 222, 465 + 12) == 1) { iS = 5; iL = 4; }
+					/*** stop/start input ***/
+					if (iS == 0)
+					{
+						if (iN == 1) { IntroSlides(); iN = 0; }
+						SDL_SetCursor (curArrow);
+						SDL_StopTextInput();
+					} else {
+						SDL_SetCursor (curText);
+						SDL_StartTextInput();
+					}
+
+					ShowEXE();
 					break;
 				case SDL_MOUSEBUTTONDOWN:
 					if (event.button.button == 1)
 					{
-						if (InArea (440, 376, 440 + 85, 376 + 32) == 1) /*** Yes ***/
-						{
-							iYesOn = 1;
-							ShowPopUpSave();
-						}
-						if (InArea (167, 376, 167 + 85, 376 + 32) == 1) /*** No ***/
+						if (InArea (590, 523, 674, 554) == 1) /*** Save ***/
 						{
-							iNoOn = 1;
-							ShowPopUpSave();
+							iEXESave = 1;
+							ShowEXE();
 						}
 					}
 					break;
 				case SDL_MOUSEBUTTONUP:
-					iYesOn = 0;
-					iNoOn = 0;
-					if (event.button.button == 1)
+					iEXESave = 0;
+					if (event.button.button == 1) /*** left mouse button ***/
 					{
-						if (InArea (440, 376, 440 + 85, 376 + 32) == 1) /*** Yes ***/
+						if (InArea (590, 523, 674, 554) == 1) /*** Save ***/
 						{
-							CallSave(); iPopUp = 0;
+							if (EXESave() == 1) { iEXE = 0; }
 						}
-						if (InArea (167, 376, 167 + 85, 376 + 32) == 1) /*** No ***/
+
+						/*** Starting minutes left. ***/
+						PlusMinus (&iEXEMinutesLeft, 219, 34, 0, 255, -10, 0);
+						PlusMinus (&iEXEMinutesLeft, 234, 34, 0, 255, -1, 0);
+						PlusMinus (&iEXEMinutesLeft, 304, 34, 0, 255, +1, 0);
+						PlusMinus (&iEXEMinutesLeft, 319, 34, 0, 255, +10, 0);
+
+						/*** Starting hit points. ***/
+						PlusMinus (&iEXEHitPoints, 219, 58, 0, 255, -10, 0);
+						PlusMinus (&iEXEHitPoints, 234, 58, 0, 255, -1, 0);
+						PlusMinus (&iEXEHitPoints, 304, 58, 0, 255, +1, 0);
+						PlusMinus (&iEXEHitPoints, 319, 58, 0, 255, +10, 0);
+
+						/*** Prince colors. ***/
+						for (iRGBLoop = 1; iRGBLoop <= 9; iRGBLoop++)
 						{
-							iPopUp = 0;
+							switch (iRGBLoop)
+							{
+								case 1: iValue = iEXEHairR; iY = 34; break;
+								case 2: iValue = iEXEHairG; iY = 58; break;
+								case 3: iValue = iEXEHairB; iY = 82; break;
+								case 4: iValue = iEXESkinR; iY = 116; break;
+								case 5: iValue = iEXESkinG; iY = 140; break;
+								case 6: iValue = iEXESkinB; iY = 164; break;
+								case 7: iValue = iEXESuitR; iY = 198; break;
+								case 8: iValue = iEXESuitG; iY = 222; break;
+								case 9: iValue = iEXESuitB; iY = 246; break;
+							}
+							PlusMinus (&iValue, 469, iY, 0, 31, -10, 0);
+							PlusMinus (&iValue, 484, iY, 0, 31, -1, 0);
+							PlusMinus (&iValue, 554, iY, 0, 31, +1, 0);
+							PlusMinus (&iValue, 569, iY, 0, 31, +10, 0);
+							switch (iRGBLoop)
+							{
+								case 1: iEXEHairR = iValue; break;
+								case 2: iEXEHairG = iValue; break;
+								case 3: iEXEHairB = iValue; break;
+								case 4: iEXESkinR = iValue; break;
+								case 5: iEXESkinG = iValue; break;
+								case 6: iEXESkinB = iValue; break;
+								case 7: iEXESuitR = iValue; break;
+								case 8: iEXESuitG = iValue; break;
+								case 9: iEXESuitB = iValue; break;
+							}
 						}
 					}
-					ShowPopUpSave(); break;
+					ShowEXE();
+					break;
 				case SDL_WINDOWEVENT:
 					if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
-						{ ShowScreen(); ShowPopUpSave(); } break;
+						{ ShowEXE(); } break;
 				case SDL_QUIT:
 					Quit(); break;
+				case SDL_TEXTINPUT:
+					if (strlen (arIntroSlides[iS][iL]) < SLIDES_LINES_CHARS - 1)
+					{
+						cAddChar = toupper (event.text.text[0]);
+						if (((cAddChar >= 'A') && (cAddChar <= 'Z')) || (cAddChar == ' '))
+						{
+							snprintf (sLineTemp, SLIDES_LINES_CHARS, "%s",
+								arIntroSlides[iS][iL]);
+							/*** Added "+1" for \0. ***/
+							snprintf (arIntroSlides[iS][iL], SLIDES_LINES_CHARS,
+								"%s%c", sLineTemp, cAddChar);
+							IntroSlides();
+							PlaySound ("wav/hum_adj.wav");
+						}
+					}
+					ShowEXE();
+					break;
 			}
 		}
 
-		/*** prevent CPU eating ***/
-		gamespeed = REFRESH;
-		while ((SDL_GetTicks() - looptime) < gamespeed)
-		{
-			SDL_Delay (10);
-		}
-		looptime = SDL_GetTicks();
+		/*** Sleep until there is input. ***/
+		WaitEvent (-1);
 	}
 	PlaySound ("wav/popup_close.wav");
 	ShowScreen();
 }
 /*****************************************************************************/
-void ShowPopUpSave (void)
-/*****************************************************************************/
-{
-	char arText[9 + 2][MAX_TEXT + 2];
-
-	/*** faded background ***/
-	ShowImage (imgfadedl, 0, 0, "imgfadedl");
-
-	/*** popup ***/
-	ShowImage (imgpopup_yn, 150, 148, "imgpopup_yn");
-
-	/*** Yes ***/
-	switch (iYesOn)
-	{
-		case 0: ShowImage (imgyes[1], 440, 376, "imgyes[1]"); break; /*** off ***/
-		case 1: ShowImage (imgyes[2], 440, 376, "imgyes[2]"); break; /*** on ***/
-	}
-
-	/*** No ***/
-	switch (iNoOn)
-	{
-		case 0: ShowImage (imgno[1], 167, 376, "imgno[1]"); break; /*** off ***/
-		case 1: ShowImage (imgno[2], 167, 376, "imgno[2]"); break; /*** on ***/
-	}
-
-	if (iChanged == 1)
-	{
-		snprintf (arText[0], MAX_TEXT, "%s", "You made an unsaved change.");
-		snprintf (arText[1], MAX_TEXT, "%s", "Do you want to save it?");
-	} else {
-		snprintf (arText[0], MAX_TEXT, "%s", "There are unsaved changes.");
-		snprintf (arText[1], MAX_TEXT, "%s", "Do you wish to save these?");
-	}
-
-	DisplayText (180, 177, FONT_SIZE_15, arText, 2, font1);
-
-	/*** refresh screen ***/
-	SDL_RenderPresent (ascreen);
-}
-/*****************************************************************************/
-void LoadFonts (void)
-/*****************************************************************************/
-{
-	font1 = TTF_OpenFont ("ttf/Bitstream-Vera-Sans-Bold.ttf",
-		FONT_SIZE_15 * iScale);
-	if (font1 == NULL) { printf ("[FAILED] Font gone!\n"); exit (EXIT_ERROR); }
-	font2 = TTF_OpenFont ("ttf/Bitstream-Vera-Sans-Bold.ttf",
-		FONT_SIZE_11 * iScale);
-	if (font2 == NULL) { printf ("[FAILED] Font gone!\n"); exit (EXIT_ERROR); }
-	font3 = TTF_OpenFont ("ttf/Bitstream-Vera-Sans-Bold.ttf",
-		FONT_SIZE_20 * iScale);
-	if (font3 == NULL) { printf ("[FAILED] Font gone!\n"); exit (EXIT_ERROR); }
-}
-/*****************************************************************************/
-void MixAudio (void *unused, Uint8 *stream, int iLen)
-/*****************************************************************************/
-{
-	int iTemp;
-	int iAmount;
-
-	if (unused != NULL) { } /*** To prevent warnings. ***/
-
-	SDL_memset (stream, 0, iLen); /*** SDL2 ***/
-	for (iTemp = 0; iTemp < NUM_SOUNDS; iTemp++)
-	{
-		iAmount = (sounds[iTemp].dlen-sounds[iTemp].dpos);
-		if (iAmount > iLen)
-		{
-			iAmount = iLen;
-		}
-		SDL_MixAudio (stream, &sounds[iTemp].data[sounds[iTemp].dpos], iAmount,
-			SDL_MIX_MAXVOLUME);
-		sounds[iTemp].dpos += iAmount;
-	}
-}
-/*****************************************************************************/
-void PlaySound (char *sFile)
-/*****************************************************************************/
-{
-	int iIndex;
-	SDL_AudioSpec wave;
-	Uint8 *data;
-	Uint32 dlen;
-	SDL_AudioCVT cvt;
-
-	if (iNoAudio == 1) { return; }
-	for (iIndex = 0; iIndex < NUM_SOUNDS; iIndex++)
-	{
-		if (sounds[iIndex].dpos == sounds[iIndex].dlen)
-		{
-			break;
-		}
-	}
-	if (iIndex == NUM_SOUNDS) { return; }
-
-	if (SDL_LoadWAV (sFile, &wave, &data, &dlen) == NULL)
-	{
-		printf ("[FAILED] Could not load %s: %s!\n", sFile, SDL_GetError());
-		exit (EXIT_ERROR);
-	}
-	SDL_BuildAudioCVT (&cvt, wave.format, wave.channels, wave.freq, AUDIO_S16, 2,
-		44100);
-	/*** The "+ 1" is a workaround for SDL bug #2274. ***/
-	cvt.buf = (Uint8 *)malloc (dlen * (cvt.len_mult + 1));
-	memcpy (cvt.buf, data, dlen);
-	cvt.len = dlen;
-	SDL_ConvertAudio (&cvt);
-	SDL_FreeWAV (data);
-
-	if (sounds[iIndex].data)
-	{
-		free (sounds[iIndex].data);
-	}
-	SDL_LockAudio();
-	sounds[iIndex].data = cvt.buf;
-	sounds[iIndex].dlen = cvt.len_cvt;
-	sounds[iIndex].dpos = 0;
-	SDL_UnlockAudio();
-}
-/*****************************************************************************/
-void PreLoadSet (char cTypeP, int iTile)
-/*****************************************************************************/
-{
-	char sDir[MAX_PATHFILE + 2];
-	char sImage[MAX_IMG + 2];
-
-	switch (cTypeP)
-	{
-		case 'd':
-			snprintf (sDir, MAX_PATHFILE, "png%sdungeon%s", SLASH, SLASH);
-			snprintf (sImage, MAX_IMG, "%s0x%02x.png", sDir, iTile);
-			imgd[iTile][1] = IMG_LoadTexture (ascreen, sImage); /*** regular ***/
-			snprintf (sDir, MAX_PATHFILE, "png%ssdungeon%s", SLASH, SLASH);
-			snprintf (sImage, MAX_IMG, "%s0x%02x.png", sDir, iTile);
-			imgd[iTile][2] = IMG_LoadTexture (ascreen, sImage);
-			if ((!imgd[iTile][1]) || (!imgd[iTile][2]))
-			{
-				printf ("[FAILED] IMG_LoadTexture: %s!\n", IMG_GetError());
-				exit (EXIT_ERROR);
-			}
-			break;
-		case 'p':
-			snprintf (sDir, MAX_PATHFILE, "png%spalace%s", SLASH, SLASH);
-			snprintf (sImage, MAX_IMG, "%s0x%02x.png", sDir, iTile);
-			imgp[iTile][1] = IMG_LoadTexture (ascreen, sImage); /*** regular ***/
-			snprintf (sDir, MAX_PATHFILE, "png%sspalace%s", SLASH, SLASH);
-			snprintf (sImage, MAX_IMG, "%s0x%02x.png", sDir, iTile);
-			imgp[iTile][2] = IMG_LoadTexture (ascreen, sImage);
-			if ((!imgp[iTile][1]) || (!imgp[iTile][2]))
-			{
-				printf ("[FAILED] IMG_LoadTexture: %s!\n", IMG_GetError());
-				exit (EXIT_ERROR);
-			}
-			break;
-	}
-
-	iPreLoaded+=2;
-}
-/*****************************************************************************/
-void PreLoad (char *sPath, char *sPNG, SDL_Texture **imgImage)
-/*****************************************************************************/
-{
-	char sImage[MAX_IMG + 2];
-
-	snprintf (sImage, MAX_IMG, "png%s%s%s%s", SLASH, sPath, SLASH, sPNG);
-	*imgImage = IMG_LoadTexture (ascreen, sImage);
-	if (!*imgImage)
-	{
-		printf ("[FAILED] IMG_LoadTexture: %s!\n", IMG_GetError());
-		exit (EXIT_ERROR);
-	}
-
-	iPreLoaded++;
-}
-/*****************************************************************************/
-void ShowScreen (void)
+void ShowEXE (void)
 /*****************************************************************************/
 {
-	int iTile;
-	int iLoc;
-	int iHorL, iVerL;
-	char sLevelBar[MAX_TEXT + 2];
-	char sLevelBarF[MAX_TEXT + 2];
-	int iUnusedRooms;
-	int iX, iY;
-	SDL_Texture *imgskeleton[2 + 2];
-	SDL_Texture *imgshadow[2 + 2];
-	SDL_Texture *imgjaffar[2 + 2];
-	SDL_Texture *imgguard[2 + 2];
-	int iEventUnused;
-	int iTileValue;
-	int iToRoom;
-	int iUnknown;
-
-	/*** Used for looping. ***/
-	int iTileLoop;
-	int iRoomLoop;
-	int iSideLoop;
-
-	switch (iCurLevel)
-	{
-		case 1: cCurType = 'd'; break;
-		case 2: cCurType = 'd'; break;
-		case 3: cCurType = 'd'; break;
-		case 4: cCurType = 'p'; break;
-		case 5: cCurType = 'p'; break;
-		case 6: cCurType = 'p'; break;
-		case 7: cCurType = 'd'; break;
-		case 8: cCurType = 'd'; break;
-		case 9: cCurType = 'd'; break;
-		case 10: cCurType = 'p'; break;
-		case 11: cCurType = 'p'; break;
-		case 12: cCurType = 'd'; break;
-		case 13: cCurType = 'd'; break;
-		case 14: cCurType = 'p'; break;
-		case 15: cCurType = 'd'; break; /*** Also palace. ***/
-		case 16: cCurType = 'd'; break;
-		case 17: cCurType = 'd'; break;
-		default:
-			printf ("[FAILED] Invalid level number: %i!\n", iCurLevel);
-			exit (EXIT_ERROR);
-			break;
-	}
-
-	/*** black background ***/
-	ShowImage (imgblack, 0, 0, "imgblack");
-
-	if (iScreen == 1)
-	{
-		/*** above this room ***/
-		if (arRoomLinks[iCurLevel][iCurRoom][3] != 0)
-		{
-			for (iTileLoop = 1; iTileLoop <= (TILES / 3); iTileLoop++)
-			{
-				iTile = arRoomTiles[iCurLevel]
-					[arRoomLinks[iCurLevel][iCurRoom][3]][iTileLoop + 20];
-				switch (cCurType)
-				{
-					case 'd':
-						snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-						ShowImage (imgd[iTile][1], iHor[iTileLoop], iVer0, sInfo);
-						break;
-					case 'p':
-						snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-						ShowImage (imgp[iTile][1], iHor[iTileLoop], iVer0, sInfo);
-						break;
-				}
-			}
-		} else {
-			for (iTileLoop = 1; iTileLoop <= (TILES / 3); iTileLoop++)
-			{
-				iTile = 0x01;
-				switch (cCurType)
-				{
-					case 'd':
-						snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-						ShowImage (imgd[iTile][1], iHor[iTileLoop], iVer0, sInfo);
-						break;
-					case 'p':
-						snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-						ShowImage (imgp[iTile][1], iHor[iTileLoop], iVer0, sInfo);
-						break;
-				}
-			}
-		}
+	SDL_Color clr;
+	int iR, iG, iB;
+	int iX, iY, iBaseX, iBaseY;
+	int iLetter;
 
-		/*** under this room ***/
-		if (arRoomLinks[iCurLevel][iCurRoom][4] != 0)
-		{
-			for (iTileLoop = 1; iTileLoop <= (TILES / 3); iTileLoop++)
-			{
-				iTile = arRoomTiles[iCurLevel]
-					[arRoomLinks[iCurLevel][iCurRoom][4]][iTileLoop];
-				switch (cCurType)
-				{
-					case 'd':
-						snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-						ShowImage (imgd[iTile][1], iHor[iTileLoop], iVer4, sInfo);
-						break;
-					case 'p':
-						snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-						ShowImage (imgp[iTile][1], iHor[iTileLoop], iVer4, sInfo);
-						break;
-				}
-			}
-		}
+	/*** Used for looping. ***/
+	int iSlideLoop;
+	int iLineLoop;
+	int iCharLoop;
 
-		/*** One tile: top row, room left. ***/
-		if (arRoomLinks[iCurLevel][iCurRoom][1] != 0)
-		{
-			iTile = arRoomTiles[iCurLevel]
-				[arRoomLinks[iCurLevel][iCurRoom][1]][10];
-		} else {
-			iTile = 0x14;
-		}
-		switch (cCurType)
-		{
-			case 'd':
-				snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-				ShowImage (imgd[iTile][1], iHor[0], iVer1, sInfo);
-				break;
-			case 'p':
-				snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-				ShowImage (imgp[iTile][1], iHor[0], iVer1, sInfo);
-				break;
-		}
-		ShowImage (imgfadeds, iHor[0], iVer1, "imgfadeds");
+	ProfilePhase (PHASE_EXE);
 
-		/*** One tile: middle row, room left. ***/
-		if (arRoomLinks[iCurLevel][iCurRoom][1] != 0)
-		{
-			iTile = arRoomTiles[iCurLevel]
-				[arRoomLinks[iCurLevel][iCurRoom][1]][20];
-		} else {
-			iTile = 0x14;
-		}
-		switch (cCurType)
-		{
-			case 'd':
-				snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-				ShowImage (imgd[iTile][1], iHor[0], iVer2, sInfo);
-				break;
-			case 'p':
-				snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-				ShowImage (imgp[iTile][1], iHor[0], iVer2, sInfo);
-				break;
-		}
-		ShowImage (imgfadeds, iHor[0], iVer2, "imgfadeds");
+	/*** background ***/
+	ShowImage (imgexe, 0, 0, "imgexe");
 
-		/*** One tile: 'top' row, room left down. ***/
-		if (arRoomLinks[iCurLevel][iCurRoom][1] != 0) /*** left ***/
-		{
-			if (arRoomLinks[iCurLevel]
-				[arRoomLinks[iCurLevel][iCurRoom][1]][4] != 0) /*** down ***/
-			{
-				iTile = arRoomTiles[iCurLevel]
-					[arRoomLinks[iCurLevel][arRoomLinks[iCurLevel][iCurRoom][1]][4]]
-					[10];
-			} else {
-				iTile = 0x14;
-			}
-		}
-		switch (cCurType)
-		{
-			case 'd':
-				snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-				ShowImage (imgd[iTile][1], iHor[0], iVer4, sInfo);
-				break;
-			case 'p':
-				snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-				ShowImage (imgp[iTile][1], iHor[0], iVer4, sInfo);
-				break;
-		}
-		ShowImage (imgfadeds, iHor[0], iVer4, "imgfadeds");
+	/*** save button ***/
+	switch (iEXESave)
+	{
+		case 0: /*** off ***/
+			ShowImage (imgsave[1], 590, 523, "imgsave[1]"); break;
+		case 1: /*** on ***/
+			ShowImage (imgsave[2], 590, 523, "imgsave[2]"); break;
+	}
 
-		/*** One tile: bottom row, room left. ***/
-		if (arRoomLinks[iCurLevel][iCurRoom][1] != 0)
-		{
-			iTile = arRoomTiles[iCurLevel]
-				[arRoomLinks[iCurLevel][iCurRoom][1]][30];
-		} else {
-			iTile = 0x14;
-		}
-		switch (cCurType)
-		{
-			case 'd':
-				snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-				ShowImage (imgd[iTile][1], iHor[0], iVer3, sInfo);
-				break;
-			case 'p':
-				snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-				ShowImage (imgp[iTile][1], iHor[0], iVer3, sInfo);
-				break;
-		}
-		ShowImage (imgfadeds, iHor[0], iVer3, "imgfadeds");
+	/*** Starting minutes left. ***/
+	if (iEXEMinutesLeft == 60) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXEMinutesLeft, 247, 34, clr, 0);
 
-		/*** Tiles. ***/
-		for (iTileLoop = 1; iTileLoop <= 30; iTileLoop++)
-		{
-			iLoc = 0;
-			iHorL = iHor[0]; /*** To prevent warnings. ***/
-			iVerL = iVer0; /*** To prevent warnings. ***/
-			if ((iTileLoop >= 1) && (iTileLoop <= 10))
-			{
-				iLoc = 20 + iTileLoop;
-				iHorL = iHor[iTileLoop];
-				iVerL = iVer3;
-			}
-			if ((iTileLoop >= 11) && (iTileLoop <= 20))
-			{
-				iLoc = iTileLoop;
-				iHorL = iHor[iTileLoop - 10];
-				iVerL = iVer2;
-			}
-			if ((iTileLoop >= 21) && (iTileLoop <= 30))
-			{
-				iLoc = -20 + iTileLoop;
-				iHorL = iHor[iTileLoop - 20];
-				iVerL = iVer1;
-			}
-			iTile = arRoomTiles[iCurLevel][iCurRoom][iLoc];
-			if (imgd[iTile][1] == NULL) { iUnknown = 1; } else { iUnknown = 0; }
-			if (iUnknown == 1)
-			{
-				snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-				ShowImage (imgunk[1], iHorL, iVerL, sInfo);
-			} else {
-				switch (cCurType)
-				{
-					case 'd':
-						snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-						ShowImage (imgd[iTile][1], iHorL, iVerL, sInfo);
-						break;
-					case 'p':
-						snprintf (sInfo, MAX_INFO, "tile=%i", iTile);
-						ShowImage (imgp[iTile][1], iHorL, iVerL, sInfo);
-						break;
-				}
-			}
-			if (iLoc == iSelected)
-			{
-				if (iUnknown == 1)
-				{
-					snprintf (sInfo, MAX_INFO, "high=%i", iTile);
-					ShowImage (imgunk[2], iHorL, iVerL, sInfo);
-				} else {
-					switch (cCurType)
-					{
-						case 'd':
-							snprintf (sInfo, MAX_INFO, "high=%i", iTile);
-							ShowImage (imgd[iTile][2], iHorL, iVerL, sInfo);
-							break;
-						case 'p':
-							snprintf (sInfo, MAX_INFO, "high=%i", iTile);
-							ShowImage (imgp[iTile][2], iHorL, iVerL, sInfo);
-							break;
-					}
-				}
-			}
+	/*** Starting hit points. ***/
+	if (iEXEHitPoints == 3) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXEHitPoints, 247, 58, clr, 0);
 
-			/*** prince ***/
-			if ((iCurRoom == arStartLocation[iCurLevel][1]) &&
-				(iLoc == arStartLocation[iCurLevel][2]))
-			{
-				switch (arStartLocation[iCurLevel][3])
-				{
-					case 0x00: /*** looks right ***/
-						ShowImage (imgprincer[1], iHorL + 20, iVerL + 20, "imgprincer[1]");
-						if (iSelected == iLoc)
-							{ ShowImage (imgprincer[2], iHorL + 20,
-							iVerL + 20, "imgprincer[2]"); }
-						break;
-					case 0xFF: /*** looks left ***/
-						ShowImage (imgprincel[1], iHorL + 24, iVerL + 20, "imgprincel[1]");
-						if (iSelected == iLoc)
-							{ ShowImage (imgprincel[2], iHorL + 24,
-							iVerL + 20, "imgprincel[2]"); }
-						break;
-					default:
-						printf ("[ WARN ] Strange prince direction: 0x%02x!\n",
-							arStartLocation[iCurLevel][3]);
-				}
-			}
+	/*** Hair. ***/
+	if (iEXEHairR == 24) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXEHairR, 497, 34, clr, 0);
+	if (iEXEHairG == 21) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXEHairG, 497, 58, clr, 0);
+	if (iEXEHairB == 0) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXEHairB, 497, 82, clr, 0);
 
-			/*** guard ***/
-			if (arGuardTile[iCurLevel][iCurRoom] == iLoc)
-			{
-				switch (arGuardDir[iCurLevel][iCurRoom])
-				{
-					case 0xFF: /*** l ***/
-						imgskeleton[1] = imgskeletonl[1];
-						imgshadow[1] = imgshadowl[1];
-						imgjaffar[1] = imgjaffarl[1];
-						imgguard[1] = imgguardl[1];
-						imgskeleton[2] = imgskeletonl[2];
-						imgshadow[2] = imgshadowl[2];
-						imgjaffar[2] = imgjaffarl[2];
-						imgguard[2] = imgguardl[2];
-						break;
-					case 0x00: /*** r ***/
-						imgskeleton[1] = imgskeletonr[1];
-						imgshadow[1] = imgshadowr[1];
-						imgjaffar[1] = imgjaffarr[1];
-						imgguard[1] = imgguardr[1];
-						imgskeleton[2] = imgskeletonr[2];
-						imgshadow[2] = imgshadowr[2];
-						imgjaffar[2] = imgjaffarr[2];
-						imgguard[2] = imgguardr[2];
-						break;
-					default:
-						printf ("[FAILED] Incorrect guard direction: 0x%02x!\n",
-							arGuardDir[iCurLevel][iCurRoom]);
-						exit (EXIT_ERROR);
-				}
-				switch (iCurLevel)
-				{
-					case 3:
-						ShowImage (imgskeleton[1], iHorL, iVerL + 24, "imgskeleton[1]");
-						if (iLoc == iSelected)
-							{ ShowImage (imgskeleton[2], iHorL,
-							iVerL + 24, "imgskeleton[2]"); }
-						break;
-					case 12:
-						ShowImage (imgshadow[1], iHorL, iVerL + 16, "imgshadow[1]");
-						if (iLoc == iSelected)
-							{ ShowImage (imgshadow[2], iHorL, iVerL + 16, "imgshadow[2]"); }
-						break;
-					case 13:
-						ShowImage (imgjaffar[1], iHorL, iVerL + 12, "imgjaffar[1]");
-						if (iLoc == iSelected)
-							{ ShowImage (imgjaffar[2], iHorL, iVerL + 12, "imgjaffar[2]"); }
-						break;
-					default:
-						ShowImage (imgguard[1], iHorL, iVerL + 16, "imgguard[1]");
-						if (iLoc == iSelected)
-							{ ShowImage (imgguard[2], iHorL, iVerL + 16, "imgguard[2]"); }
-						break;
-				}
-			}
-		}
+	/*** Skin. ***/
+	if (iEXESkinR == 20) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXESkinR, 497, 116, clr, 0);
+	if (iEXESkinG == 13) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXESkinG, 497, 140, clr, 0);
+	if (iEXESkinB == 11) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXESkinB, 497, 164, clr, 0);
+
+	/*** Suit. ***/
+	if (iEXESuitR == 31) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXESuitR, 497, 198, clr, 0);
+	if (iEXESuitG == 31) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXESuitG, 497, 222, clr, 0);
+	if (iEXESuitB == 31) { clr = color_bl; } else { clr = color_blue; }
+	CenterNumber (iEXESuitB, 497, 246, clr, 0);
+
+	/*** Fill the prince with approximate(!) colors. ***/
+	/*** Hair. ***/
+	iR = (iEXEHairR * 255) / 31;
+	iG = (iEXEHairG * 255) / 31;
+	iB = (iEXEHairB * 255) / 31;
+	ColorRect (614, 49, 12, 8, iR, iG, iB);
+	ColorRect (610, 53, 8, 16, iR, iG, iB);
+	/*** Skin. ***/
+	iR = (iEXESkinR * 255) / 31;
+	iG = (iEXESkinG * 255) / 31;
+	iB = (iEXESkinB * 255) / 31;
+	ColorRect (618, 57, 8, 12, iR, iG, iB);
+	ColorRect (614, 69, 8, 4, iR, iG, iB);
+	ColorRect (610, 77, 8, 20, iR, iG, iB);
+	ColorRect (614, 97, 8, 4, iR, iG, iB);
+	ColorRect (618, 101, 8, 4, iR, iG, iB);
+	ColorRect (622, 105, 4, 4, iR, iG, iB);
+	ColorRect (614, 157, 12, 8, iR, iG, iB);
+	ColorRect (626, 161, 4, 4, iR, iG, iB);
+	/*** Suit. ***/
+	iR = (iEXESuitR * 255) / 31;
+	iG = (iEXESuitG * 255) / 31;
+	iB = (iEXESuitB * 255) / 31;
+	ColorRect (610, 73, 12, 4, iR, iG, iB);
+	ColorRect (618, 77, 8, 20, iR, iG, iB);
+	ColorRect (622, 97, 4, 4, iR, iG, iB);
+	ColorRect (610, 97, 4, 24, iR, iG, iB);
+	ColorRect (614, 101, 4, 56, iR, iG, iB);
+	ColorRect (618, 105, 4, 52, iR, iG, iB);
+	ColorRect (622, 109, 4, 44, iR, iG, iB);
+	ColorRect (626, 117, 4, 24, iR, iG, iB);
 
-		if (iCurLevel == 15)
+	/*** Intro slides. ***/
+	for (iSlideLoop = 1; iSlideLoop <= SLIDES; iSlideLoop++)
+	{
+		switch (iSlideLoop)
 		{
-			ShowImage (imgvwarning, 40, 472, "imgvwarning");
+			case 1: iBaseX = 34; iBaseY = 191; break;
+			case 2: iBaseX = 34; iBaseY = 295; break;
+			case 3: iBaseX = 266; iBaseY = 295; break;
+			case 4: iBaseX = 34; iBaseY = 399; break;
+			case 5: iBaseX = 266; iBaseY = 399; break;
 		}
-	}
-	if (iScreen == 2) /*** R ***/
-	{
-		if (arBrokenRoomLinks[iCurLevel] == 0)
+		iBaseX+=14;
+		iBaseY+=18;
+		iY = iBaseY;
+		for (iLineLoop = 1; iLineLoop <= SLIDES_LINES; iLineLoop++)
 		{
-			InitRooms();
-			/*** room links ***/
-			ShowImage (imgrl, 25, 50, "imgrl");
-			/*** rooms broken on ***/
-			if (iDownAt == 11)
-			{
-				ShowImage (imgbroomson_1, 629, 63, "imgbroomson_1"); /*** down ***/
-			} else {
-				ShowImage (imgbroomson_0, 629, 63, "imgbroomson_0"); /*** up ***/
-			}
-			WhereToStart();
-			for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-			{
-				arDone[iRoomLoop] = 0;
-			}
-			ShowRooms (arStartLocation[iCurLevel][1], iStartRoomsX, iStartRoomsY, 1);
-			iUnusedRooms = 0;
-			for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-			{
-				if (arDone[iRoomLoop] != 1)
-				{
-					iUnusedRooms++;
-					ShowRooms (iRoomLoop, 25, iUnusedRooms, 0);
-
-					/* Give unused rooms 0xFF as tile 1. This may not be the best
-					 * location in the code to do this, but it works.
-					 */
-					if (iCurLevel != 15)
-					{
-						arRoomTiles[iCurLevel][iRoomLoop][1] = 0xFF;
-					}
-				}
-			}
-			if (iMovingRoom != 0)
-			{
-				iX = (iXPos + 10) / iScale;
-				iY = (iYPos + 10) / iScale;
-				ShowImage (imgroom[iMovingRoom], iX, iY, "imgroom[...]");
-				if (iCurRoom == iMovingRoom)
-				{
-					ShowImage (imgsrc, iX, iY, "imgsrc"); /*** green stripes ***/
-				}
-				if (arStartLocation[iCurLevel][1] == iMovingRoom)
-				{
-					ShowImage (imgsrs, iX, iY, "imgsrs"); /*** blue border ***/
-				}
-				ShowImage (imgsrm, iX, iY, "imgsrm"); /*** red stripes ***/
-				ShowRooms (-1, iMovingNewX, iMovingNewY, 0);
-			}
-		} else {
-			/*** broken room links ***/
-			ShowImage (imgbrl, 25, 50, "imgbrl");
-			for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-			{
-				/*** green stripes ***/
-				if (iCurRoom == iRoomLoop)
-				{
-					BrokenRoomChange (iRoomLoop, 0, &iX, &iY);
-					ShowImage (imgsrc, iX, iY, "imgsrc");
-				}
-
-				/*** blue border ***/
-				if (arStartLocation[iCurLevel][1] == iRoomLoop)
-				{
-					BrokenRoomChange (iRoomLoop, 0, &iX, &iY);
-					ShowImage (imgsrs, iX, iY, "imgsrs");
-				}
-
-				for (iSideLoop = 1; iSideLoop <= 4; iSideLoop++)
+			iX = iBaseX;
+			for (iCharLoop = 0; iCharLoop <
+				(int)strlen ((char *)arIntroSlides[iSlideLoop]
+				[iLineLoop]); iCharLoop++)
+			{
+				iLetter = arIntroSlides[iSlideLoop][iLineLoop][iCharLoop] - 0x40;
+				if (iLetter == -32)
 				{
-					if (arRoomLinks[iCurLevel][iRoomLoop][iSideLoop] != 0)
-					{
-						BrokenRoomChange (iRoomLoop, iSideLoop, &iX, &iY);
-						iToRoom = arRoomLinks[iCurLevel][iRoomLoop][iSideLoop];
-						if ((iToRoom < 1) || (iToRoom > ROOMS)) { iToRoom = 25; }
-						ShowImage (imgroom[iToRoom], iX, iY, "imgroom[...]");
-
-						/*** blue square ***/
-						if (arRoomConnectionsBroken[iCurLevel][iRoomLoop][iSideLoop] == 1)
-						{
-							BrokenRoomChange (iRoomLoop, iSideLoop, &iX, &iY);
-							ShowImage (imgsrb, iX, iY, "imgsrb");
-						}
-					}
-
-					/*** red stripes ***/
-					if ((iChangingBrokenRoom == iRoomLoop) &&
-						(iChangingBrokenSide == iSideLoop))
-					{
-						BrokenRoomChange (iRoomLoop, iSideLoop, &iX, &iY);
-						ShowImage (imgsrm, iX, iY, "imgsrm");
-					}
+					ShowImage (imgspace, iX, iY, "imgspace");
+				} else if ((iLetter >= 1) && (iLetter <= 26)) {
+					ShowImage (imgalphabet[iLetter], iX, iY, "imgalphabet[...]");
+				} else {
+					ShowImage (imgunknown, iX, iY, "imgunknown");
 				}
+				iX+=16;
 			}
+			iY+=16;
 		}
 	}
-	if (iScreen == 3) /*** E ***/
-	{
-		iEventUnused = 0;
-
-		/*** background ***/
-		ShowImage (imgevents, 25, 50, "imgevents");
-
-		/*** total no. of events ***/
-		CenterNumber (arNrEvents[iCurLevel], 178, 59, color_wh, 0);
-
-		/*** edit this event ***/
-		CenterNumber (iChangeEvent, 500, 59, color_wh, 0);
-
-		/*** from room ***/
-		if ((arEventsFromRoom[iCurLevel][iChangeEvent] >= 1) &&
-			(arEventsFromRoom[iCurLevel][iChangeEvent] <= 24))
-		{
-			iX = 267 + (arEventsFromRoom[iCurLevel][iChangeEvent] * 15);
-			iY = 136;
-			ShowImage (imgsele, iX, iY, "imgsele");
-		} else { iEventUnused = 1; }
 
-		/*** from tile ***/
-		if ((arEventsFromTile[iCurLevel][iChangeEvent] >= 1) &&
-			(arEventsFromTile[iCurLevel][iChangeEvent] <= 30))
-		{
-			iTile = arEventsFromTile[iCurLevel][iChangeEvent];
-			if ((iTile >= 1) && (iTile <= 10))
-			{
-				iX = 267 + (iTile * 15);
-				iY = 238;
-			}
-			if ((iTile >= 11) && (iTile <= 20))
-			{
-				iX = 267 + ((iTile - 10) * 15);
-				iY = 253;
-			}
-			if ((iTile >= 21) && (iTile <= 30))
+	/*** Selected intro slide text line. ***/
+	switch (iS)
+	{
+		case 1:
+			switch (iL)
 			{
-				iX = 267 + ((iTile - 20) * 15);
-				iY = 268;
+				case 1: iX = 34; iY = 209; break;
+				case 2: iX = 34; iY = 225; break;
+				case 3: iX = 34; iY = 241; break;
+				case 4: iX = 34; iY = 257; break;
 			}
-			ShowImage (imgsele, iX, iY, "imgsele");
-		} else { iEventUnused = 1; }
-
-		/*** from image ***/
-		if (iEventUnused == 0)
-		{
-			iTileValue = arRoomTiles[iCurLevel]
-				[arEventsFromRoom[iCurLevel][iChangeEvent]]
-				[arEventsFromTile[iCurLevel][iChangeEvent]];
-			snprintf (sInfo, MAX_INFO, "tile=%i", iTileValue);
-			switch (cCurType)
+			break;
+		case 2:
+			switch (iL)
 			{
-				case 'd': ShowImage (imgd[iTileValue][1], 128, 112, sInfo); break;
-				case 'p': ShowImage (imgp[iTileValue][1], 128, 112, sInfo); break;
+				case 1: iX = 34; iY = 313; break;
+				case 2: iX = 34; iY = 329; break;
+				case 3: iX = 34; iY = 345; break;
+				case 4: iX = 34; iY = 361; break;
 			}
-		} else {
-			ShowImage (imgeventu, 128, 112, "imgeventu");
-		}
-
-		/*** open or close ***/
-		switch (arEventsOpenClose[iCurLevel][iChangeEvent])
-		{
-			case 0x00: /*** close ***/
-				ShowImage (imgsell, 387, 306, "imgsell"); break;
-			case 0x01: /*** open ***/
-				ShowImage (imgsell, 282, 306, "imgsell"); break;
-		}
-
-		iEventUnused = 0;
-
-		/*** to room ***/
-		if ((arEventsToRoom[iCurLevel][iChangeEvent] >= 1) &&
-			(arEventsToRoom[iCurLevel][iChangeEvent] <= 24))
-		{
-			iX = 267 + (arEventsToRoom[iCurLevel][iChangeEvent] * 15);
-			iY = 377;
-			ShowImage (imgsele, iX, iY, "imgsele");
-		} else { iEventUnused = 1; }
-
-		/*** to tile ***/
-		if ((arEventsToTile[iCurLevel][iChangeEvent] >= 1) &&
-			(arEventsToTile[iCurLevel][iChangeEvent] <= 30))
-		{
-			iTile = arEventsToTile[iCurLevel][iChangeEvent];
-			if ((iTile >= 1) && (iTile <= 10))
+			break;
+		case 3:
+			switch (iL)
 			{
-				iX = 267 + (iTile * 15);
-				iY = 479;
+				case 1: iX = 266; iY = 313; break;
+				case 2: iX = 266; iY = 329; break;
+				case 3: iX = 266; iY = 345; break;
+				case 4: iX = 266; iY = 361; break;
 			}
-			if ((iTile >= 11) && (iTile <= 20))
+			break;
+		case 4:
+			switch (iL)
 			{
-				iX = 267 + ((iTile - 10) * 15);
-				iY = 494;
+				case 1: iX = 34; iY = 417; break;
+				case 2: iX = 34; iY = 433; break;
+				case 3: iX = 34; iY = 449; break;
+				case 4: iX = 34; iY = 465; break;
 			}
-			if ((iTile >= 21) && (iTile <= 30))
+			break;
+		case 5:
+			switch (iL)
 			{
-				iX = 267 + ((iTile - 20) * 15);
-				iY = 509;
+				case 1: iX = 266; iY = 417; break;
+				case 2: iX = 266; iY = 433; break;
+				case 3: iX = 266; iY = 449; break;
+				case 4: iX = 266; iY = 465; break;
 			}
-			ShowImage (imgsele, iX, iY, "imgsele");
-		} else { iEventUnused = 1; }
+			break;
+	}
+	if (iS != 0) { ShowImage (imgseltextline, iX, iY, "imgseltextline"); }
 
-		/*** to image ***/
-		if (iEventUnused == 0)
-		{
-			iTileValue = arRoomTiles[iCurLevel]
-				[arEventsToRoom[iCurLevel][iChangeEvent]]
-				[arEventsToTile[iCurLevel][iChangeEvent]];
-			snprintf (sInfo, MAX_INFO, "tile=%i", iTileValue);
-			switch (cCurType)
-			{
-				case 'd': ShowImage (imgd[iTileValue][1], 128, 353, sInfo); break;
-				case 'p': ShowImage (imgp[iTileValue][1], 128, 353, sInfo); break;
-			}
-		} else {
-			ShowImage (imgeventu, 128, 353, "imgeventu");
-		}
+	/*** Show the number of free bytes. ***/
+	if (iBytesLeft < 0)
+	{
+		clr = color_red;
+		ShowImage (imgexewarning, 265 - 9, 249, "imgexewarning");
+	} else {
+		clr = color_bl;
 	}
+	CenterNumber (iBytesLeft, 265, 249, clr, 0);
 
-	/*** left ***/
-	if (arRoomLinks[iCurLevel][iCurRoom][1] != 0)
+	/*** If necessary, show warnings about slide sizes. ***/
+	if (arSlideSizes[1] != 29)
 	{
-		/*** yes ***/
-		if (iDownAt == 1)
+		ShowImage (imgexewarning, 116 - 9, 265, "imgexewarning");
+		CenterNumber (29 - arSlideSizes[1], 116, 265, color_red, 0);
+	}
+	if (arSlideSizes[2] != 24)
+	{
+		ShowImage (imgexewarning, 116 - 9, 369, "imgexewarning");
+		CenterNumber (24 - arSlideSizes[2], 116, 369, color_red, 0);
+	}
+	if (arSlideSizes[3] != 37)
+	{
+		ShowImage (imgexewarning, 348 - 9, 369, "imgexewarning");
+		CenterNumber (37 - arSlideSizes[3], 348, 369, color_red, 0);
+	}
+	if (arSlideSizes[4] != 31)
+	{
+		ShowImage (imgexewarning, 116 - 9, 473, "imgexewarning");
+		CenterNumber (31 - arSlideSizes[4], 116, 473, color_red, 0);
+	}
+	if (arSlideSizes[5] != 29)
+	{
+		ShowImage (imgexewarning, 348 - 9, 473, "imgexewarning");
+		CenterNumber (29 - arSlideSizes[5], 348, 473, color_red, 0);
+	}
+
+	/*** refresh screen ***/
+	Present();
+}
+/*****************************************************************************/
+void InitScreenAction (char *sAction)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	int iEventRoom;
+	int iToTile;
+	int iFromTile;
+
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	if (strcmp (sAction, "left") == 0)
+	{
+		switch (iScreen)
 		{
-			ShowImage (imgleft_1, 0, 50, "imgleft_1"); /*** down ***/
-		} else {
-			ShowImage (imgleft_0, 0, 50, "imgleft_0"); /*** up ***/
+			case 1:
+				iSelected--;
+				switch (iSelected)
+				{
+					case 0: iSelected = 10; break;
+					case 10: iSelected = 20; break;
+					case 20: iSelected = 30; break;
+				}
+				break;
+			case 2:
+				if (arBrokenRoomLinks[iCurLevel] == 0)
+				{
+					if (iMovingRoom != 0)
+					{
+						if (iMovingNewX != 1) { iMovingNewX--; }
+							else { iMovingNewX = 25; }
+						PlaySound ("wav/cross.wav");
+					}
+				} else {
+					if (iChangingBrokenSide != 1)
+					{
+						iChangingBrokenSide = 1;
+					} else {
+						switch (iChangingBrokenRoom)
+						{
+							case 1: iChangingBrokenRoom = 4; break;
+							case 5: iChangingBrokenRoom = 8; break;
+							case 9: iChangingBrokenRoom = 12; break;
+							case 13: iChangingBrokenRoom = 16; break;
+							case 17: iChangingBrokenRoom = 20; break;
+							case 21: iChangingBrokenRoom = 24; break;
+							default: iChangingBrokenRoom--; break;
+						}
+					}
+				}
+				break;
+			case 3:
+				iToTile = stLevel->arEventsToTile[iChangeEvent];
+				switch (iToTile)
+				{
+					case 1: iToTile = 10; break;
+					case 11: iToTile = 20; break;
+					case 21: iToTile = 30; break;
+					default: iToTile--; break;
+				}
+				if (iToTile > 20) { EventTile (iToTile - 20, 3, 1); }
+					else if (iToTile > 10)
+						{ EventTile (iToTile - 10, 2, 1); }
+					else { EventTile (iToTile, 1, 1); }
+				break;
 		}
-		if (arRoomLinks[iCurLevel][iCurRoom][1] > 24)
-			{ ShowImage (imglinkwarnlr, 0, 50, "imglinkwarnlr"); } /*** glow ***/
-	} else {
-		/*** no ***/
-		ShowImage (imglrno, 0, 50, "imglrno");
 	}
 
-	/*** right ***/
-	if (arRoomLinks[iCurLevel][iCurRoom][2] != 0)
+	if (strcmp (sAction, "right") == 0)
 	{
-		/*** yes ***/
-		if (iDownAt == 2)
+		switch (iScreen)
 		{
-			ShowImage (imgright_1, 667, 50, "imgright_1"); /*** down ***/
-		} else {
-			ShowImage (imgright_0, 667, 50, "imgright_0"); /*** up ***/
+			case 1:
+				iSelected++;
+				switch (iSelected)
+				{
+					case 11: iSelected = 1; break;
+					case 21: iSelected = 11; break;
+					case 31: iSelected = 21; break;
+				}
+				break;
+			case 2:
+				if (arBrokenRoomLinks[iCurLevel] == 0)
+				{
+					if (iMovingRoom != 0)
+					{
+						if (iMovingNewX != 25) { iMovingNewX++; }
+							else { iMovingNewX = 1; }
+						PlaySound ("wav/cross.wav");
+					}
+				} else {
+					if (iChangingBrokenSide != 2)
+					{
+						iChangingBrokenSide = 2;
+					} else {
+						switch (iChangingBrokenRoom)
+						{
+							case 4: iChangingBrokenRoom = 1; break;
+							case 8: iChangingBrokenRoom = 5; break;
+							case 12: iChangingBrokenRoom = 9; break;
+							case 16: iChangingBrokenRoom = 13; break;
+							case 20: iChangingBrokenRoom = 17; break;
+							case 24: iChangingBrokenRoom = 21; break;
+							default: iChangingBrokenRoom++; break;
+						}
+					}
+				}
+				break;
+			case 3:
+				iToTile = stLevel->arEventsToTile[iChangeEvent];
+				switch (iToTile)
+				{
+					case 10: iToTile = 1; break;
+					case 20: iToTile = 11; break;
+					case 30: iToTile = 21; break;
+					default: iToTile++; break;
+				}
+				if (iToTile > 20) { EventTile (iToTile - 20, 3, 1); }
+					else if (iToTile > 10)
+						{ EventTile (iToTile - 10, 2, 1); }
+					else { EventTile (iToTile, 1, 1); }
+				break;
 		}
-		if (arRoomLinks[iCurLevel][iCurRoom][2] > 24)
-			{ ShowImage (imglinkwarnlr, 667, 50, "imglinkwarnlr"); } /*** glow ***/
-	} else {
-		/*** no ***/
-		ShowImage (imglrno, 667, 50, "imglrno");
 	}
 
-	/*** up ***/
-	if (arRoomLinks[iCurLevel][iCurRoom][3] != 0)
+	if (strcmp (sAction, "up") == 0)
 	{
-		/*** yes ***/
-		if (iDownAt == 3)
+		switch (iScreen)
 		{
-			ShowImage (imgup_1, 25, 25, "imgup_1"); /*** down ***/
-		} else {
-			ShowImage (imgup_0, 25, 25, "imgup_0"); /*** up ***/
+			case 1:
+				if (iSelected > 10) { iSelected-=10; }
+					else { iSelected+=20; }
+				break;
+			case 2:
+				if (arBrokenRoomLinks[iCurLevel] == 0)
+				{
+					if (iMovingRoom != 0)
+					{
+						if (iMovingNewY != 1) { iMovingNewY--; }
+							else { iMovingNewY = 24; }
+						PlaySound ("wav/cross.wav");
+					}
+				} else {
+					if (iChangingBrokenSide != 3)
+					{
+						iChangingBrokenSide = 3;
+					} else {
+						switch (iChangingBrokenRoom)
+						{
+							case 1: iChangingBrokenRoom = 21; break;
+							case 2: iChangingBrokenRoom = 22; break;
+							case 3: iChangingBrokenRoom = 23; break;
+							case 4: iChangingBrokenRoom = 24; break;
+							default: iChangingBrokenRoom -= 4; break;
+						}
+					}
+				}
+				break;
+			case 3:
+				iToTile = stLevel->arEventsToTile[iChangeEvent];
+				if (iToTile > 10) { iToTile-=10; }
+					else { iToTile+=20; }
+				if (iToTile > 20) { EventTile (iToTile - 20, 3, 1); }
+					else if (iToTile > 10)
+						{ EventTile (iToTile - 10, 2, 1); }
+					else { EventTile (iToTile, 1, 1); }
+				break;
 		}
-		if (arRoomLinks[iCurLevel][iCurRoom][3] > 24)
-			{ ShowImage (imglinkwarnud, 25, 25, "imglinkwarnud"); } /*** glow ***/
-	} else {
-		/*** no ***/
-		if (iScreen != 1)
+	}
+
+	if (strcmp (sAction, "down") == 0)
+	{
+		switch (iScreen)
 		{
-			ShowImage (imgudno, 25, 25, "imgudno"); /*** without info ***/
-		} else {
-			ShowImage (imgudnonfo, 25, 25, "imgudnonfo"); /*** with info ***/
+			case 1:
+				if (iSelected <= 20) { iSelected+=10; }
+					else { iSelected-=20; }
+				break;
+			case 2:
+				if (arBrokenRoomLinks[iCurLevel] == 0)
+				{
+					if (iMovingRoom != 0)
+					{
+						if (iMovingNewY != 24) { iMovingNewY++; }
+							else { iMovingNewY = 1; }
+						PlaySound ("wav/cross.wav");
+					}
+				} else {
+					if (iChangingBrokenSide != 4)
+					{
+						iChangingBrokenSide = 4;
+					} else {
+						switch (iChangingBrokenRoom)
+						{
+							case 21: iChangingBrokenRoom = 1; break;
+							case 22: iChangingBrokenRoom = 2; break;
+							case 23: iChangingBrokenRoom = 3; break;
+							case 24: iChangingBrokenRoom = 4; break;
+							default: iChangingBrokenRoom += 4; break;
+						}
+					}
+				}
+				break;
+			case 3:
+				iToTile = stLevel->arEventsToTile[iChangeEvent];
+				if (iToTile <= 20) { iToTile+=10; }
+					else { iToTile-=20; }
+				if (iToTile > 20) { EventTile (iToTile - 20, 3, 1); }
+					else if (iToTile > 10)
+						{ EventTile (iToTile - 10, 2, 1); }
+					else { EventTile (iToTile, 1, 1); }
+				break;
 		}
 	}
 
-	/*** down ***/
-	if (arRoomLinks[iCurLevel][iCurRoom][4] != 0)
+	if (strcmp (sAction, "left bracket") == 0)
 	{
-		/*** yes ***/
-		if (iDownAt == 4)
+		switch (iScreen)
 		{
-			ShowImage (imgdown_1, 25, 548, "imgdown_1"); /*** down ***/
-		} else {
-			ShowImage (imgdown_0, 25, 548, "imgdown_0"); /*** up ***/
+			case 2:
+				if (arBrokenRoomLinks[iCurLevel] == 0)
+				{
+					iMovingNewBusy = 0;
+					switch (iMovingRoom)
+					{
+						case 0: iMovingRoom = ROOMS; break; /*** If disabled. ***/
+						case 1: iMovingRoom = ROOMS; break;
+						default: iMovingRoom--; break;
+					}
+				}
+				break;
+			case 3:
+				iEventRoom = stLevel->arEventsToRoom[iChangeEvent];
+				if ((iEventRoom >= 2) && (iEventRoom <= 24))
+				{
+					EventRoom (iEventRoom - 1, 1);
+				} else {
+					EventRoom (24, 1);
+				}
+				break;
 		}
-		if (arRoomLinks[iCurLevel][iCurRoom][4] > 24)
-			{ ShowImage (imglinkwarnud, 25, 548, "imglinkwarnud"); } /*** glow ***/
-	} else {
-		/*** no ***/
-		ShowImage (imgudno, 25, 548, "imgudno");
 	}
 
-	switch (iScreen)
+	if (strcmp (sAction, "right bracket") == 0)
 	{
-		case 1:
-			if (arBrokenRoomLinks[iCurLevel] == 1)
-			{
-				/*** rooms broken on ***/
-				if (iDownAt == 11)
+		switch (iScreen)
+		{
+			case 2:
+				if (arBrokenRoomLinks[iCurLevel] == 0)
 				{
-					ShowImage (imgbroomson_1, 0, 25, "imgbroomson_1"); /*** down ***/
-				} else {
-					ShowImage (imgbroomson_0, 0, 25, "imgbroomson_0"); /*** up ***/
+					iMovingNewBusy = 0;
+					switch (iMovingRoom)
+					{
+						case 0: iMovingRoom = 1; break; /*** If disabled. ***/
+						case 24: iMovingRoom = 1; break;
+						default: iMovingRoom++; break;
+					}
 				}
-			} else {
-				/*** rooms on ***/
-				if (iDownAt == 5)
+				break;
+			case 3:
+				iEventRoom = stLevel->arEventsToRoom[iChangeEvent];
+				if ((iEventRoom >= 1) && (iEventRoom <= 23))
 				{
-					ShowImage (imgroomson_1, 0, 25, "imgroomson_1"); /*** down ***/
+					EventRoom (iEventRoom + 1, 1);
 				} else {
-					ShowImage (imgroomson_0, 0, 25, "imgroomson_0"); /*** up ***/
+					EventRoom (1, 1);
 				}
-			}
-			/*** events on ***/
-			if (iDownAt == 6)
-			{
-				ShowImage (imgeventson_1, 667, 25, "imgeventson_1"); /*** down ***/
-			} else {
-				ShowImage (imgeventson_0, 667, 25, "imgeventson_0"); /*** up ***/
-			}
-			break;
-		case 2:
-			/*** rooms off ***/
-			if (arBrokenRoomLinks[iCurLevel] == 1)
+				break;
+		}
+	}
+
+	if (strcmp (sAction, "left brace") == 0)
+	{
+		if (iScreen == 3)
+		{
+			iEventRoom = stLevel->arEventsFromRoom[iChangeEvent];
+			if ((iEventRoom >= 2) && (iEventRoom <= 24))
 			{
-				ShowImage (imgbroomsoff, 0, 25, "imgbroomsoff"); /*** broken ***/
+				EventRoom (iEventRoom - 1, 0);
 			} else {
-				ShowImage (imgroomsoff, 0, 25, "imgroomsoff");
+				EventRoom (24, 0);
 			}
+		}
+	}
 
-			/*** events on ***/
-			if (iDownAt == 6)
+	if (strcmp (sAction, "right brace") == 0)
+	{
+		if (iScreen == 3)
+		{
+			iEventRoom = stLevel->arEventsFromRoom[iChangeEvent];
+			if ((iEventRoom >= 1) && (iEventRoom <= 23))
 			{
-				ShowImage (imgeventson_1, 667, 25, "imgeventson_1"); /*** down ***/
+				EventRoom (iEventRoom + 1, 0);
 			} else {
-				ShowImage (imgeventson_0, 667, 25, "imgeventson_0"); /*** up ***/
+				EventRoom (1, 0);
 			}
-			break;
-		case 3:
-			if (arBrokenRoomLinks[iCurLevel] == 1)
-			{
-				/*** rooms broken on ***/
-				if (iDownAt == 11)
+		}
+	}
+
+	if (strcmp (sAction, "enter") == 0)
+	{
+		switch (iScreen)
+		{
+			case 1:
+				ChangePos();
+				break;
+			case 2:
+				if (arBrokenRoomLinks[iCurLevel] == 0)
 				{
-					ShowImage (imgbroomson_1, 0, 25, "imgbroomson_1"); /*** down ***/
+					if (iMovingRoom != 0)
+					{
+						if (arMovingRooms[iMovingNewX][iMovingNewY] == 0)
+						{
+							RemoveOldRoom();
+							AddNewRoom (iMovingNewX, iMovingNewY, iMovingRoom);
+							iChanged++;
+						}
+						iMovingRoom = 0; iMovingNewBusy = 0;
+					}
 				} else {
-					ShowImage (imgbroomson_0, 0, 25, "imgbroomson_0"); /*** up ***/
+					LinkPlus();
 				}
-			} else {
-				/*** rooms on ***/
-				if (iDownAt == 5)
+				break;
+			case 3:
+				if (iController == 1) /*** Else it uses brackets. ***/
 				{
-					ShowImage (imgroomson_1, 0, 25, "imgroomson_1"); /*** down ***/
-				} else {
-					ShowImage (imgroomson_0, 0, 25, "imgroomson_0"); /*** up ***/
+					iEventRoom = stLevel->arEventsToRoom[iChangeEvent];
+					if ((iEventRoom >= 1) && (iEventRoom <= 23))
+					{
+						EventRoom (iEventRoom + 1, 1);
+					} else {
+						EventRoom (1, 1);
+					}
 				}
-			}
-			/*** events off ***/
-			ShowImage (imgeventsoff, 667, 25, "imgeventsoff");
-			break;
-	}
-
-	/*** save ***/
-	if (iChanged != 0)
-	{
-		/*** on ***/
-		if (iDownAt == 7)
-		{
-			ShowImage (imgsaveon_1, 0, 548, "imgsaveon_1"); /*** down ***/
-		} else {
-			ShowImage (imgsaveon_0, 0, 548, "imgsaveon_0"); /*** up ***/
+				break;
 		}
-	} else {
-		/*** off ***/
-		ShowImage (imgsaveoff, 0, 548, "imgsaveoff");
 	}
 
-	/*** quit ***/
-	if (iDownAt == 8)
+	if (strcmp (sAction, "env") == 0)
 	{
-		ShowImage (imgquit_1, 667, 548, "imgquit_1"); /*** down ***/
-	} else {
-		ShowImage (imgquit_0, 667, 548, "imgquit_0"); /*** up ***/
+/***
+	switch (cCurType)
+	{
+		case 'd': cCurType = 'p'; break;
+		case 'p': cCurType = 'd'; break;
+	}
+	PlaySound ("wav/extras.wav");
+***/
 	}
 
-	/*** previous ***/
-	if (iCurLevel != 1)
+	if (strcmp (sAction, "left from") == 0)
 	{
-		/*** on ***/
-		if (iDownAt == 9)
+		if (iScreen == 3)
 		{
-			ShowImage (imgprevon_1, 0, 0, "imgprevon_1"); /*** down ***/
-		} else {
-			ShowImage (imgprevon_0, 0, 0, "imgprevon_0"); /*** up ***/
+			iFromTile = stLevel->arEventsFromTile[iChangeEvent];
+			switch (iFromTile)
+			{
+				case 1: iFromTile = 10; break;
+				case 11: iFromTile = 20; break;
+				case 21: iFromTile = 30; break;
+				default: iFromTile--; break;
+			}
+			if (iFromTile > 20) { EventTile (iFromTile - 20, 3, 0); }
+				else if (iFromTile > 10)
+					{ EventTile (iFromTile - 10, 2, 0); }
+				else { EventTile (iFromTile, 1, 0); }
 		}
-	} else {
-		/*** off ***/
-		ShowImage (imgprevoff, 0, 0, "imgprevoff");
 	}
 
-	/*** next ***/
-	if (iCurLevel != LEVELS)
+	if (strcmp (sAction, "right from") == 0)
 	{
-		/*** on ***/
-		if (iDownAt == 10)
+		if (iScreen == 3)
 		{
-			ShowImage (imgnexton_1, 667, 0, "imgnexton_1"); /*** down ***/
-		} else {
-			ShowImage (imgnexton_0, 667, 0, "imgnexton_0"); /*** up ***/
+			iFromTile = stLevel->arEventsFromTile[iChangeEvent];
+			switch (iFromTile)
+			{
+				case 10: iFromTile = 1; break;
+				case 20: iFromTile = 11; break;
+				case 30: iFromTile = 21; break;
+				default: iFromTile++; break;
+			}
+			if (iFromTile > 20) { EventTile (iFromTile - 20, 3, 0); }
+				else if (iFromTile > 10)
+					{ EventTile (iFromTile - 10, 2, 0); }
+				else { EventTile (iFromTile, 1, 0); }
 		}
-	} else {
-		/*** off ***/
-		ShowImage (imgnextoff, 667, 0, "imgnextoff");
 	}
 
-	/*** level bar ***/
-	ShowImage (imgbar, 25, 0, "imgbar");
-
-	/*** Assemble level bar text. ***/
-	switch (iCurLevel)
+	if (strcmp (sAction, "up from") == 0)
 	{
-		case 1: snprintf (sLevelBar, MAX_TEXT, "level 1 (prison),"); break;
-		case 2: snprintf (sLevelBar, MAX_TEXT, "level 2 (guards),"); break;
-		case 3: snprintf (sLevelBar, MAX_TEXT, "level 3 (skeleton),"); break;
-		case 4: snprintf (sLevelBar, MAX_TEXT, "level 4 (mirror),"); break;
-		case 5: snprintf (sLevelBar, MAX_TEXT, "level 5 (thief),"); break;
-		case 6: snprintf (sLevelBar, MAX_TEXT, "level 6 (plunge),"); break;
-		case 7: snprintf (sLevelBar, MAX_TEXT, "level 7 (weightless),"); break;
-		case 8: snprintf (sLevelBar, MAX_TEXT, "level 8 (mouse),"); break;
-		case 9: snprintf (sLevelBar, MAX_TEXT, "level 9 (twisty),"); break;
-		case 10: snprintf (sLevelBar, MAX_TEXT, "level 10 (quad),"); break;
-		case 11: snprintf (sLevelBar, MAX_TEXT, "level 11 (fragile),"); break;
-		case 12: snprintf (sLevelBar, MAX_TEXT, "level 12a (tower),"); break;
-		case 13: snprintf (sLevelBar, MAX_TEXT, "level 12b (jaffar),"); break;
-		case 14: snprintf (sLevelBar, MAX_TEXT, "level 12c (rescue),"); break;
-		case 15: snprintf (sLevelBar, MAX_TEXT, "various d/p,"); break;
-		case 16: snprintf (sLevelBar, MAX_TEXT, "training,"); break;
-		case 17: snprintf (sLevelBar, MAX_TEXT, "training (cont.),"); break;
+		if (iScreen == 3)
+		{
+			iFromTile = stLevel->arEventsFromTile[iChangeEvent];
+			if (iFromTile > 10) { iFromTile-=10; }
+				else { iFromTile+=20; }
+			if (iFromTile > 20) { EventTile (iFromTile - 20, 3, 0); }
+				else if (iFromTile > 10)
+					{ EventTile (iFromTile - 10, 2, 0); }
+				else { EventTile (iFromTile, 1, 0); }
+		}
 	}
-	switch (iScreen)
+
+	if (strcmp (sAction, "down from") == 0)
 	{
-		case 1:
-			snprintf (sLevelBarF, MAX_TEXT, "%s room %i", sLevelBar, iCurRoom);
-			ShowImage (imgextras[iExtras], 610, 3, "imgextras[...]");
-			break;
-		case 2:
-			snprintf (sLevelBarF, MAX_TEXT, "%s room links", sLevelBar); break;
-		case 3:
-			snprintf (sLevelBarF, MAX_TEXT, "%s events", sLevelBar); break;
+		if (iScreen == 3)
+		{
+			iFromTile = stLevel->arEventsFromTile[iChangeEvent];
+			if (iFromTile <= 20) { iFromTile+=10; }
+				else { iFromTile-=20; }
+			if (iFromTile > 20) { EventTile (iFromTile - 20, 3, 0); }
+				else if (iFromTile > 10)
+					{ EventTile (iFromTile - 10, 2, 0); }
+				else { EventTile (iFromTile, 1, 0); }
+		}
 	}
-
-	/*** Mednafen information. ***/
-	if (iMednafen == 1) { ShowImage (imgmednafen, 25, 50, "imgmednafen"); }
-
-	/*** Display level bar text. ***/
-	message = TTF_RenderText_Shaded (font1, sLevelBarF, color_bl, color_wh);
-	messaget = SDL_CreateTextureFromSurface (ascreen, message);
-	offset.x = 31;
-	offset.y = 5;
-	offset.w = message->w; offset.h = message->h;
-	CustomRenderCopy (messaget, NULL, &offset, "message");
-	SDL_DestroyTexture (messaget); SDL_FreeSurface (message);
-
-	/*** refresh screen ***/
-	SDL_RenderPresent (ascreen);
 }
 /*****************************************************************************/
-void InitPopUp (void)
+void RunLevel (int iLevel)
 /*****************************************************************************/
 {
-	int iPopUp;
-	SDL_Event event;
+	SDL_Thread *princethread;
 
-	iPopUp = 1;
+	if (iReplay != 0) { return; } /*** A replay leaves the ROM alone. ***/
 
-	PlaySound ("wav/popup.wav");
-	ShowPopUp();
-	while (iPopUp == 1)
+	if (iDebug == 1)
 	{
-		while (SDL_PollEvent (&event))
-		{
-			switch (event.type)
-			{
-				case SDL_CONTROLLERBUTTONDOWN:
-					/*** Nothing for now. ***/
-					break;
-				case SDL_CONTROLLERBUTTONUP:
-					switch (event.cbutton.button)
-					{
-						case SDL_CONTROLLER_BUTTON_A:
-							iPopUp = 0; break;
-					}
-					break;
-				case SDL_KEYDOWN:
-					switch (event.key.keysym.sym)
-					{
-						case SDLK_ESCAPE:
-						case SDLK_KP_ENTER:
-						case SDLK_RETURN:
-						case SDLK_SPACE:
-						case SDLK_o:
-							iPopUp = 0;
-						default: break;
-					}
-					break;
-				case SDL_MOUSEMOTION:
-					iXPos = event.motion.x;
-					iYPos = event.motion.y;
-					break;
-				case SDL_MOUSEBUTTONDOWN:
-					if (event.button.button == 1)
-					{
-						if (InArea (440, 376, 440 + 85, 376 + 32) == 1) /*** OK ***/
-						{
-							iOKOn = 1;
-							ShowPopUp();
-						}
-					}
-					break;
-				case SDL_MOUSEBUTTONUP:
-					iOKOn = 0;
-					if (event.button.button == 1)
-					{
-						if (InArea (440, 376, 440 + 85, 376 + 32) == 1) /*** OK ***/
-						{
-							iPopUp = 0;
-						}
-					}
-					ShowPopUp(); break;
-				case SDL_WINDOWEVENT:
-					if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
-						{ ShowScreen(); ShowPopUp(); } break;
-				case SDL_QUIT:
-					Quit(); break;
-			}
-		}
+		printf ("[  OK  ] Starting the game in level %i.\n", iLevel);
+	}
 
-		/*** prevent CPU eating ***/
-		gamespeed = REFRESH;
-		while ((SDL_GetTicks() - looptime) < gamespeed)
-		{
-			SDL_Delay (10);
-		}
-		looptime = SDL_GetTicks();
+	if (ModifyForMednafen (iLevel) == 0) { return; }
+
+	princethread = SDL_CreateThread (StartGame, "StartGame", NULL);
+	if (princethread == NULL)
+	{
+		printf ("[FAILED] Could not create thread!\n");
+		exit (EXIT_ERROR);
 	}
-	PlaySound ("wav/popup_close.wav");
-	ShowScreen();
 }
 /*****************************************************************************/
-void ShowPopUp (void)
+int StartGame (void *unused)
 /*****************************************************************************/
 {
-	char arText[9 + 2][MAX_TEXT + 2];
+	char sSystem[200 + 2];
+	char sSound[200 + 2];
+	SDL_Event event;
 
-	/*** faded background ***/
-	ShowImage (imgfadedl, 0, 0, "imgfadedl");
+	if (unused != NULL) { } /*** To prevent warnings. ***/
 
-	/*** popup ***/
-	ShowImage (imgpopup, 52, 64, "imgpopup");
+	PlaySound ("wav/mednafen.wav");
 
-	/*** OK ***/
-	switch (iOKOn)
+	switch (iNoAudio)
 	{
-		case 0: ShowImage (imgok[1], 440, 376, "imgok[1]"); break; /*** off ***/
-		case 1: ShowImage (imgok[2], 440, 376, "imgok[2]"); break; /*** on ***/
+#if defined WIN32 || _WIN32 || WIN64 || _WIN64
+		case 0: snprintf (sSound, 200, "%s", " -sound 1"); break;
+#else
+		case 0: snprintf (sSound, 200, "%s", " -sound 1 -sounddriver sdl"); break;
+#endif
+		case 1: snprintf (sSound, 200, "%s", " -sound 0"); break;
 	}
 
-	snprintf (arText[0], MAX_TEXT, "%s %s", EDITOR_NAME, EDITOR_VERSION);
-	snprintf (arText[1], MAX_TEXT, "%s", COPYRIGHT);
-	snprintf (arText[2], MAX_TEXT, "%s", "");
-	if (iController != 1)
+	snprintf (sSystem, 200, "mednafen %s %s > %s",
+		sSound, stEdit.sPathFile, DEVNULL);
+	if (system (sSystem) == -1)
 	{
-		snprintf (arText[3], MAX_TEXT, "%s", "single tile (change or select)");
-		snprintf (arText[4], MAX_TEXT, "%s", "entire room (clear or fill)");
-		snprintf (arText[5], MAX_TEXT, "%s", "entire level (randomize or fill)");
-	} else {
-		snprintf (arText[3], MAX_TEXT, "%s", "The detected game controller:");
-		snprintf (arText[4], MAX_TEXT, "%s", sControllerName);
-		snprintf (arText[5], MAX_TEXT, "%s", "Have fun using it!");
+		printf ("[ WARN ] Could not execute mednafen!\n");
 	}
-	snprintf (arText[6], MAX_TEXT, "%s", "");
-	snprintf (arText[7], MAX_TEXT, "%s", "You may use one guard per room.");
-	snprintf (arText[8], MAX_TEXT, "%s", "The tile behavior may differ per"
-		" level.");
 
-	DisplayText (180, 177, FONT_SIZE_15, arText, 9, font1);
+	/* The ROM image belongs to the main thread; PollEvent() undoes the
+	 * changes for Mednafen once this event arrives.
+	 */
+	memset (&event, 0, sizeof (event));
+	event.type = SDL_USEREVENT;
+	event.user.code = EVENT_GAME_DONE;
+	SDL_PushEvent (&event);
 
-	/*** refresh screen ***/
-	SDL_RenderPresent (ascreen);
+	return (EXIT_NORMAL);
 }
 /*****************************************************************************/
-void Help (void)
+void ClearRoom (void)
 /*****************************************************************************/
 {
-	int iHelp;
-	SDL_Event event;
+	int iTileLoop;
 
-	iHelp = 1;
+	/*** Remove tiles. ***/
+	for (iTileLoop = 1; iTileLoop <= 30; iTileLoop++)
+	{
+		SetLocation (iCurRoom, iTileLoop, 0x00);
+	}
 
-	PlaySound ("wav/popup.wav");
-	ShowHelp();
-	while (iHelp == 1)
+	/*** Remove guard. ***/
+	stEdit.stRom.arLevel[iCurLevel].arGuardTile[iCurRoom] = TILES + 1;
+	stEdit.arLevelDirty[iCurLevel] = 1;
+
+	PlaySound ("wav/ok_close.wav");
+	iChanged++;
+}
+/*****************************************************************************/
+void UseTile (int iTile, int iLocation, int iRoom)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	/*** Do not use iSelected in this function. ***/
+
+	/*** Random tile. ***/
+	if (iTile == -1)
 	{
-		while (SDL_PollEvent (&event))
-		{
-			switch (event.type)
+		do {
+			iTile = 1 + (int) (60.0 * rand() / (RAND_MAX + 1.0));
+		} while (Unused (iTile) == 1);
+	}
+
+	/*** Custom tile. ***/
+	if (iTile == -2)
+	{
+		SetLocation (iRoom, iLocation, iCustomTile);
+	}
+
+	/*** Make sure the disabled living can't be used. ***/
+	if ((iCurLevel != 3) && ((iTile == 65) || (iTile == 66))) { return; }
+	if ((iCurLevel != 12) && ((iTile == 67) || (iTile == 68))) { return; }
+	if ((iCurLevel != 13) && ((iTile == 69) || (iTile == 70))) { return; }
+	if (((iCurLevel == 3) || (iCurLevel == 12) || (iCurLevel == 13)) &&
+		((iTile == 63) || (iTile == 64))) { return; }
+
+	switch (iTile)
+	{
+		/*** Row 1. ***/
+		case 1: SetLocation (iRoom, iLocation, 0x00); break;
+		case 2: SetLocation (iRoom, iLocation, 0xE0); break;
+		case 3: SetLocation (iRoom, iLocation, 0x20); break;
+		case 4: SetLocation (iRoom, iLocation, 0x40); break;
+		case 5: SetLocation (iRoom, iLocation, 0x60); break;
+		case 6: SetLocation (iRoom, iLocation, 0x01); break;
+		case 7: SetLocation (iRoom, iLocation, 0xE1); break;
+		case 8: SetLocation (iRoom, iLocation, 0x21); break;
+		case 9: SetLocation (iRoom, iLocation, 0x1F); break;
+		case 10: SetLocation (iRoom, iLocation, 0x0E); break;
+
+		/*** Row 2. ***/
+		case 11: SetLocation (iRoom, iLocation, 0x02); break;
+		case 12: SetLocation (iRoom, iLocation, 0x12); break;
+		/***/
+		case 17: SetLocation (iRoom, iLocation, 0x17); break;
+		case 18: SetLocation (iRoom, iLocation, 0x0D); break;
+		case 19: SetLocation (iRoom, iLocation, 0x05); break;
+		/***/
+
+		/*** Row 3. ***/
+		case 21: SetLocation (iRoom, iLocation, 0x14); break;
+		case 22: SetLocation (iRoom, iLocation, 0x34); break;
+		case 23: SetLocation (iRoom, iLocation, 0x03); break;
+		case 24: SetLocation (iRoom, iLocation, 0x08); break;
+		case 25: SetLocation (iRoom, iLocation, 0x09); break;
+		case 26: SetLocation (iRoom, iLocation, 0x10); break;
+		case 27: SetLocation (iRoom, iLocation, 0x50); break;
+		case 28: SetLocation (iRoom, iLocation, 0x11); break;
+		/***/
+		case 30: SetLocation (iRoom, iLocation, 0x13); break;
+
+		/*** Row 4. ***/
+		case 31: SetLocation (iRoom, iLocation, 0x2A); break;
+		case 32: SetLocation (iRoom, iLocation, 0x4A); break;
+		case 33: SetLocation (iRoom, iLocation, 0x6A); break;
+		case 34: SetLocation (iRoom, iLocation, 0x8A); break;
+		case 35: SetLocation (iRoom, iLocation, 0xAA); break;
+		case 36: SetLocation (iRoom, iLocation, 0x0A); break;
+		/***/
+		/***/
+		case 39: SetLocation (iRoom, iLocation, 0x0B); break;
+		case 40: SetLocation (iRoom, iLocation, 0x2B); break;
+
+		/*** Row 5. ***/
+		case 41: SetLocation (iRoom, iLocation, 0x16); break;
+		/***/
+		case 43: SetLocation (iRoom, iLocation, 0x44); break;
+		case 44: SetLocation (iRoom, iLocation, 0x24); break;
+		case 45: SetLocation (iRoom, iLocation, 0x0C); break;
+		case 46: SetLocation (iRoom, iLocation, 0x2C); break;
+		case 47: SetLocation (iRoom, iLocation, 0x4C); break;
+		case 48: SetLocation (iRoom, iLocation, 0x27); break;
+		case 49: SetLocation (iRoom, iLocation, 0x47); break;
+		case 50: SetLocation (iRoom, iLocation, 0x07); break;
+
+		/*** Row 6. ***/
+		case 51: SetLocation (iRoom, iLocation, 0x19); break;
+		case 52: SetLocation (iRoom, iLocation, 0x1A); break;
+		case 53: SetLocation (iRoom, iLocation, 0x1B); break;
+		case 54: SetLocation (iRoom, iLocation, 0x1C); break;
+		case 55: SetLocation (iRoom, iLocation, 0x1D); break;
+		case 56: SetLocation (iRoom, iLocation, 0x18); break;
+		case 57: SetLocation (iRoom, iLocation, 0x41); break;
+		case 58: SetLocation (iRoom, iLocation, 0x15); break;
+		case 59: SetLocation (iRoom, iLocation,
+			RaiseDropEvent (0x0F, iChangeEvent, 1)); break;
+		case 60: SetLocation (iRoom, iLocation,
+			RaiseDropEvent (0x06, iChangeEvent, 1)); break;
+		case 61: /*** prince, turned right ***/
+			if ((stLevel->arStartLocation[1] != iCurRoom) ||
+				(stLevel->arStartLocation[2] != iLocation) ||
+				(stLevel->arStartLocation[3] != 0x00))
 			{
-				case SDL_CONTROLLERBUTTONDOWN:
-					/*** Nothing for now. ***/
-					break;
-				case SDL_CONTROLLERBUTTONUP:
-					switch (event.cbutton.button)
-					{
-						case SDL_CONTROLLER_BUTTON_A:
-							iHelp = 0; break;
-					}
-					break;
-				case SDL_KEYDOWN:
-					switch (event.key.keysym.sym)
-					{
-						case SDLK_ESCAPE:
-						case SDLK_KP_ENTER:
-						case SDLK_RETURN:
-						case SDLK_SPACE:
-						case SDLK_o:
-							iHelp = 0;
-						default: break;
-					}
-					break;
-				case SDL_MOUSEMOTION:
-					iXPos = event.motion.x;
-					iYPos = event.motion.y;
-					if (InArea (87, 413, 87 + 517, 413 + 20) == 1)
-					{
-						SDL_SetCursor (curHand);
-					} else {
-						SDL_SetCursor (curArrow);
-					}
-					break;
-				case SDL_MOUSEBUTTONDOWN:
-					if (event.button.button == 1)
-					{
-						if (InArea (590, 523, 674, 554) == 1) /*** OK ***/
-						{
-							iHelpOK = 1;
-							ShowHelp();
-						}
-					}
-					break;
-				case SDL_MOUSEBUTTONUP:
-					iHelpOK = 0;
-					if (event.button.button == 1) /*** left mouse button ***/
-					{
-						if (InArea (590, 523, 674, 554) == 1)
-							{ iHelp = 0; }
-						if (InArea (87, 413, 87 + 517, 413 + 20) == 1)
-							{ OpenURL ("https://github.com/EndeavourAccuracy/legbop"); }
-					}
-					ShowHelp(); break;
-				case SDL_WINDOWEVENT:
-					if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
-						{ ShowHelp(); } break;
-				case SDL_QUIT:
-					Quit(); break;
+				UndoRoom (iCurRoom);
+				stLevel->arStartLocation[1] = iCurRoom;
+				stLevel->arStartLocation[2] = iLocation;
+				stLevel->arStartLocation[3] = 0x00;
+				stEdit.arLevelDirty[iCurLevel] = 1;
+				PlaySound ("wav/hum_adj.wav");
 			}
-		}
+			break;
+		case 62: /*** prince, turned left ***/
+			if ((stLevel->arStartLocation[1] != iCurRoom) ||
+				(stLevel->arStartLocation[2] != iLocation) ||
+				(stLevel->arStartLocation[3] != 0xFF))
+			{
+				UndoRoom (iCurRoom);
+				stLevel->arStartLocation[1] = iCurRoom;
+				stLevel->arStartLocation[2] = iLocation;
+				stLevel->arStartLocation[3] = 0xFF;
+				stEdit.arLevelDirty[iCurLevel] = 1;
+				PlaySound ("wav/hum_adj.wav");
+			}
+			break;
+		case 63: case 65: case 67: case 69: /*** living, turned right ***/
+			UndoRoom (iCurRoom);
+			if ((stLevel->arGuardTile[iCurRoom] == iLocation) &&
+				(stLevel->arGuardDir[iCurRoom] == 0x00))
+			{
+				stLevel->arGuardTile[iCurRoom] = TILES + 1;
+			} else {
+				stLevel->arGuardTile[iCurRoom] = iLocation;
+				stLevel->arGuardDir[iCurRoom] = 0x00;
+				PlaySound ("wav/hum_adj.wav");
+			}
+			stEdit.arLevelDirty[iCurLevel] = 1;
+			break;
+		case 64: case 66: case 68: case 70: /*** living, turned left ***/
+			UndoRoom (iCurRoom);
+			if ((stLevel->arGuardTile[iCurRoom] == iLocation) &&
+				(stLevel->arGuardDir[iCurRoom] == 0xFF))
+			{
+				stLevel->arGuardTile[iCurRoom] = TILES + 1;
+			} else {
+				stLevel->arGuardTile[iCurRoom] = iLocation;
+				stLevel->arGuardDir[iCurRoom] = 0xFF;
+				PlaySound ("wav/hum_adj.wav");
+			}
+			stEdit.arLevelDirty[iCurLevel] = 1;
+			break;
+	}
+}
+/*****************************************************************************/
+void Zoom (int iToggleFull)
+/*****************************************************************************/
+{
+	/*** The offscreen surface, and all textures, keep their size. ***/
+	if (iOffscreen == 1) { return; }
 
-		/*** prevent CPU eating ***/
-		gamespeed = REFRESH;
-		while ((SDL_GetTicks() - looptime) < gamespeed)
+	if (iToggleFull == 1)
+	{
+		if (iFullscreen == 0)
+		{ iFullscreen = SDL_WINDOW_FULLSCREEN_DESKTOP; }
+			else { iFullscreen = 0; }
+	} else {
+		if (iFullscreen == SDL_WINDOW_FULLSCREEN_DESKTOP)
 		{
-			SDL_Delay (10);
+			iFullscreen = 0;
+			iScale = 1;
+		} else if (iScale == 1) {
+			iScale = 2;
+		} else if (iScale == 2) {
+			iFullscreen = SDL_WINDOW_FULLSCREEN_DESKTOP;
+		} else {
+			printf ("[ WARN ] Unknown window state!\n");
 		}
-		looptime = SDL_GetTicks();
 	}
-	PlaySound ("wav/popup_close.wav");
-	ShowScreen();
+
+	SDL_SetWindowFullscreen (window, iFullscreen);
+	SDL_SetWindowSize (window, (WINDOW_WIDTH) * iScale,
+		(WINDOW_HEIGHT) * iScale);
+	SDL_RenderSetLogicalSize (ascreen, (WINDOW_WIDTH) * iScale,
+		(WINDOW_HEIGHT) * iScale);
+	SDL_SetWindowPosition (window, SDL_WINDOWPOS_CENTERED,
+		SDL_WINDOWPOS_CENTERED);
+	TTF_CloseFont (font1);
+	TTF_CloseFont (font2);
+	TTF_CloseFont (font3);
+	LoadFonts();
+	DropTexts(); /*** These used the old fonts. ***/
+	SceneTexture();
 }
 /*****************************************************************************/
-void ShowHelp (void)
+void SceneTexture (void)
 /*****************************************************************************/
 {
-	/*** background ***/
-	ShowImage (imghelp, 0, 0, "imghelp");
+	/*** Used for looping. ***/
+	int iLayerLoop;
 
-	/*** OK ***/
-	switch (iHelpOK)
+	for (iLayerLoop = 1; iLayerLoop <= ROOM_LAYERS; iLayerLoop++)
 	{
-		case 0: ShowImage (imgok[1], 590, 523, "imgok[1]"); break; /*** off ***/
-		case 1: ShowImage (imgok[2], 590, 523, "imgok[2]"); break; /*** on ***/
+		if (arLayers[iLayerLoop].img != NULL)
+		{
+			SDL_DestroyTexture (arLayers[iLayerLoop].img);
+			arLayers[iLayerLoop].img = NULL;
+		}
 	}
+	DropRoomLayers (0);
+	if (imgscene != NULL) { SDL_DestroyTexture (imgscene); imgscene = NULL; }
+	if (SDL_RenderTargetSupported (ascreen) == SDL_FALSE) { return; }
 
-	/*** refresh screen ***/
-	SDL_RenderPresent (ascreen);
+	imgscene = SDL_CreateTexture (ascreen, SDL_PIXELFORMAT_ARGB8888,
+		SDL_TEXTUREACCESS_TARGET, (WINDOW_WIDTH) * iScale,
+		(WINDOW_HEIGHT) * iScale);
+	stFrame.iCreates++;
+	if (imgscene == NULL)
+	{
+		printf ("[ WARN ] Could not create the screen texture: %s!\n",
+			SDL_GetError());
+		return;
+	}
+	SDL_SetTextureBlendMode (imgscene, SDL_BLENDMODE_NONE);
 }
 /*****************************************************************************/
-void EXE (void)
+void LinkMinus (void)
 /*****************************************************************************/
 {
-	int iEXE;
-	SDL_Event event;
-	int iValue, iRGBLoop, iY;
-	int iOldXPos, iOldYPos;
-	char sLineTemp[SLIDES_LINES_CHARS + 2];
-	char cAddChar;
+	struct level *stLevel;
+	int iCurrent, iNew;
 
-	iEXE = 1;
-	iN = 0;
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
 
-	EXELoad();
+	iCurrent = stLevel->arRoomLinks[iChangingBrokenRoom][iChangingBrokenSide];
+	if (iCurrent > ROOMS) /*** "?"; high links ***/
+	{
+		iNew = 0;
+	} else if (iCurrent == 0) {
+		iNew = ROOMS;
+	} else {
+		iNew = iCurrent - 1;
+	}
+	stLevel->arRoomLinks[iChangingBrokenRoom][iChangingBrokenSide] = iNew;
+	stEdit.arLevelDirty[iCurLevel] = 1;
+	iChanged++;
+	arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
+	PlaySound ("wav/hum_adj.wav");
+}
+/*****************************************************************************/
+int BrokenRoomLinks (int iPrint)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	int iBroken;
+	int iRoomLoop;
 
-	PlaySound ("wav/popup.wav");
-	ShowEXE();
-	while (iEXE == 1)
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+	{
+		arDone[iRoomLoop] = 0;
+		arRoomConnectionsBroken[iCurLevel][iRoomLoop][1] = 0;
+		arRoomConnectionsBroken[iCurLevel][iRoomLoop][2] = 0;
+		arRoomConnectionsBroken[iCurLevel][iRoomLoop][3] = 0;
+		arRoomConnectionsBroken[iCurLevel][iRoomLoop][4] = 0;
+	}
+	CheckSides (stLevel->arStartLocation[1], 0, 0);
+	iBroken = 0;
+
+	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
 	{
-		while (SDL_PollEvent (&event))
+		/*** If the room is in use... ***/
+		if (arDone[iRoomLoop] == 1)
 		{
-			switch (event.type)
+			/*** check left ***/
+			if (stLevel->arRoomLinks[iRoomLoop][1] != 0)
 			{
-				case SDL_CONTROLLERBUTTONDOWN:
-					/*** Nothing for now. ***/
-					break;
-				case SDL_CONTROLLERBUTTONUP:
-					switch (event.cbutton.button)
-					{
-						case SDL_CONTROLLER_BUTTON_A:
-							EXESave(); iEXE = 0; break;
-					}
-					break;
-				case SDL_KEYDOWN:
-					switch (event.key.keysym.sym)
-					{
-						case SDLK_ESCAPE:
-							iEXE = 0; break;
-						case SDLK_KP_ENTER:
-						case SDLK_RETURN:
-						/*** Not including SDLK_SPACE here. ***/
-						case SDLK_s:
-							if (iS == 0) { EXESave(); iEXE = 0; }
-							break;
-						case SDLK_BACKSPACE:
-							if (iS != 0)
-							{
-								if (strlen (arIntroSlides[iS][iL]) > 0)
-								{
-									arIntroSlides[iS][iL]
-										[strlen (arIntroSlides[iS][iL]) - 1] = '\0';
-									IntroSlides();
-									PlaySound ("wav/hum_adj.wav");
-								}
-							}
-							break;
-						default: break;
-					}
-					ShowEXE();
-					break;
-				case SDL_MOUSEMOTION:
-					iOldXPos = iXPos;
-					iOldYPos = iYPos;
-					iXPos = event.motion.x;
-					iYPos = event.motion.y;
-					if ((iOldXPos == iXPos) && (iOldYPos == iYPos)) { break; }
-
-					/*** Intro slides. ***/
-					iS = 0;
-					iL = 0;
-					/*** 1 ***/
-					if (InArea (34, 209, 34 + 222, 209 + 12) == 1) { iS = 1; iL = 1; }
-					if (InArea (34, 225, 34 + 222, 225 + 12) == 1) { iS = 1; iL = 2; }
-					if (InArea (34, 241, 34 + 222, 241 + 12) == 1) { iS = 1; iL = 3; }
-					if (InArea (34, 257, 34 + 222, 257 + 12) == 1) { iS = 1; iL = 4; }
-					/*** 2 ***/
-					if (InArea (34, 313, 34 + 222, 313 + 12) == 1) { iS = 2; iL = 1; }
-					if (InArea (34, 329, 34 + 222, 329 + 12) == 1) { iS = 2; iL = 2; }
-					if (InArea (34, 345, 34 + 222, 345 + 12) == 1) { iS = 2; iL = 3; }
-					if (InArea (34, 361, 34 + 222, 361 + 12) == 1) { iS = 2; iL = 4; }
-					/*** 3 ***/
-					if (InArea (266, 313, 266 + 222, 313 + 12) == 1) { iS = 3; iL = 1; }
-					if (InArea (266, 329, 266 + 222, 329 + 12) == 1) { iS = 3; iL = 2; }
-					if (InArea (266, 345, 266 + 222, 345 + 12) == 1) { iS = 3; iL = 3; }
-					if (InArea (266, 361, 266 + 222, 361 + 12) == 1) { iS = 3; iL = 4; }
-					/*** 4 ***/
-					if (InArea (34, 417, 34 + 222, 417 + 12) == 1) { iS = 4; iL = 1; }
-					if (InArea (34, 433, 34 + 222, 433 + 12) == 1) { iS = 4; iL = 2; }
-					if (InArea (34, 449, 34 + 222, 449 + 12) == 1) { iS = 4; iL = 3; }
-					if (InArea (34, 465, 34 + 222, 465 + 12) == 1) { iS = 4; iL = 4; }
-					/*** 5 ***/
-					if (InArea (266, 417, 266 + 222, 417 + 12) == 1) { iS = 5; iL = 1; }
-					if (InArea (266, 433, 266 + 222, 433 + 12) == 1) { iS = 5; iL = 2; }
-					if (InArea (266, 449, 266 + 222, 449 + 12) == 1) { iS = 5; iL = 3; }
-					if (InArea (266, 465, 266 + 222, 465 + 12) == 1) { iS = 5; iL = 4; }
-					/*** stop/start input ***/
-					if (iS == 0)
-					{
-						if (iN == 1) { IntroSlides(); iN = 0; }
-						SDL_SetCursor (curArrow);
-						SDL_StopTextInput();
-					} else {
-						SDL_SetCursor (curText);
-						SDL_StartTextInput();
-					}
-
-					ShowEXE();
-					break;
-				case SDL_MOUSEBUTTONDOWN:
-					if (event.button.button == 1)
+				if ((stLevel->arRoomLinks[iRoomLoop][1] == iRoomLoop) ||
+					(stLevel->arRoomLinks[stLevel->arRoomLinks[iRoomLoop][1]][2]
+					!= iRoomLoop) ||
+					(stLevel->arRoomLinks[iRoomLoop][1] > ROOMS))
+				{
+					arRoomConnectionsBroken[iCurLevel][iRoomLoop][1] = 1;
+					iBroken = 1;
+					if ((iDebug == 1) && (iPrint == 1))
 					{
-						if (InArea (590, 523, 674, 554) == 1) /*** Save ***/
-						{
-							iEXESave = 1;
-							ShowEXE();
-						}
+						printf ("[ INFO ] The left of room %i has a broken link.\n",
+							iRoomLoop);
 					}
-					break;
-				case SDL_MOUSEBUTTONUP:
-					iEXESave = 0;
-					if (event.button.button == 1) /*** left mouse button ***/
-					{
-						if (InArea (590, 523, 674, 554) == 1) /*** Save ***/
-						{
-							EXESave(); iEXE = 0;
-						}
-
-						/*** Starting minutes left. ***/
-						PlusMinus (&iEXEMinutesLeft, 219, 34, 0, 255, -10, 0);
-						PlusMinus (&iEXEMinutesLeft, 234, 34, 0, 255, -1, 0);
-						PlusMinus (&iEXEMinutesLeft, 304, 34, 0, 255, +1, 0);
-						PlusMinus (&iEXEMinutesLeft, 319, 34, 0, 255, +10, 0);
-
-						/*** Starting hit points. ***/
-						PlusMinus (&iEXEHitPoints, 219, 58, 0, 255, -10, 0);
-						PlusMinus (&iEXEHitPoints, 234, 58, 0, 255, -1, 0);
-						PlusMinus (&iEXEHitPoints, 304, 58, 0, 255, +1, 0);
-						PlusMinus (&iEXEHitPoints, 319, 58, 0, 255, +10, 0);
-
-						/*** Prince colors. ***/
-						for (iRGBLoop = 1; iRGBLoop <= 9; iRGBLoop++)
-						{
-							switch (iRGBLoop)
-							{
-								case 1: iValue = iEXEHairR; iY = 34; break;
-								case 2: iValue = iEXEHairG; iY = 58; break;
-								case 3: iValue = iEXEHairB; iY = 82; break;
-								case 4: iValue = iEXESkinR; iY = 116; break;
-								case 5: iValue = iEXESkinG; iY = 140; break;
-								case 6: iValue = iEXESkinB; iY = 164; break;
-								case 7: iValue = iEXESuitR; iY = 198; break;
-								case 8: iValue = iEXESuitG; iY = 222; break;
-								case 9: iValue = iEXESuitB; iY = 246; break;
-							}
-							PlusMinus (&iValue, 469, iY, 0, 31, -10, 0);
-							PlusMinus (&iValue, 484, iY, 0, 31, -1, 0);
-							PlusMinus (&iValue, 554, iY, 0, 31, +1, 0);
-							PlusMinus (&iValue, 569, iY, 0, 31, +10, 0);
-							switch (iRGBLoop)
-							{
-								case 1: iEXEHairR = iValue; break;
-								case 2: iEXEHairG = iValue; break;
-								case 3: iEXEHairB = iValue; break;
-								case 4: iEXESkinR = iValue; break;
-								case 5: iEXESkinG = iValue; break;
-								case 6: iEXESkinB = iValue; break;
-								case 7: iEXESuitR = iValue; break;
-								case 8: iEXESuitG = iValue; break;
-								case 9: iEXESuitB = iValue; break;
-							}
-						}
+				}
+			}
+			/*** check right ***/
+			if (stLevel->arRoomLinks[iRoomLoop][2] != 0)
+			{
+				if ((stLevel->arRoomLinks[iRoomLoop][2] == iRoomLoop) ||
+					(stLevel->arRoomLinks[stLevel->arRoomLinks[iRoomLoop][2]][1]
+					!= iRoomLoop) ||
+					(stLevel->arRoomLinks[iRoomLoop][2] > ROOMS))
+				{
+					arRoomConnectionsBroken[iCurLevel][iRoomLoop][2] = 1;
+					iBroken = 1;
+					if ((iDebug == 1) && (iPrint == 1))
+					{
+						printf ("[ INFO ] The right of room %i has a broken link.\n",
+							iRoomLoop);
 					}
-					ShowEXE();
-					break;
-				case SDL_WINDOWEVENT:
-					if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
-						{ ShowEXE(); } break;
-				case SDL_QUIT:
-					Quit(); break;
-				case SDL_TEXTINPUT:
-					if (strlen (arIntroSlides[iS][iL]) < SLIDES_LINES_CHARS - 1)
+				}
+			}
+			/*** check up ***/
+			if (stLevel->arRoomLinks[iRoomLoop][3] != 0)
+			{
+				if ((stLevel->arRoomLinks[iRoomLoop][3] == iRoomLoop) ||
+					(stLevel->arRoomLinks[stLevel->arRoomLinks[iRoomLoop][3]][4]
+					!= iRoomLoop) ||
+					(stLevel->arRoomLinks[iRoomLoop][3] > ROOMS))
+				{
+					arRoomConnectionsBroken[iCurLevel][iRoomLoop][3] = 1;
+					iBroken = 1;
+					if ((iDebug == 1) && (iPrint == 1))
 					{
-						cAddChar = toupper (event.text.text[0]);
-						if (((cAddChar >= 'A') && (cAddChar <= 'Z')) || (cAddChar == ' '))
-						{
-							snprintf (sLineTemp, SLIDES_LINES_CHARS, "%s",
-								arIntroSlides[iS][iL]);
-							/*** Added "+1" for \0. ***/
-							snprintf (arIntroSlides[iS][iL], SLIDES_LINES_CHARS,
-								"%s%c", sLineTemp, cAddChar);
-							IntroSlides();
-							PlaySound ("wav/hum_adj.wav");
-						}
+						printf ("[ INFO ] The top of room %i has a broken link.\n",
+							iRoomLoop);
 					}
-					ShowEXE();
-					break;
+				}
+			}
+			/*** check down ***/
+			if (stLevel->arRoomLinks[iRoomLoop][4] != 0)
+			{
+				if ((stLevel->arRoomLinks[iRoomLoop][4] == iRoomLoop) ||
+					(stLevel->arRoomLinks[stLevel->arRoomLinks[iRoomLoop][4]][3]
+					!= iRoomLoop) ||
+					(stLevel->arRoomLinks[iRoomLoop][4] > ROOMS))
+				{
+					arRoomConnectionsBroken[iCurLevel][iRoomLoop][4] = 1;
+					iBroken = 1;
+					if ((iDebug == 1) && (iPrint == 1))
+					{
+						printf ("[ INFO ] The bottom of room %i has a broken link.\n",
+							iRoomLoop);
+					}
+				}
 			}
 		}
+	}
+
+	return (iBroken);
+}
+/*****************************************************************************/
+void ChangeEvent (int iAmount, int iChangePos)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	int iTile;
+	int iHighNibble, iLowNibble;
+
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
 
-		/*** prevent CPU eating ***/
-		gamespeed = REFRESH;
-		while ((SDL_GetTicks() - looptime) < gamespeed)
+	if (((iAmount > 0) && (iChangeEvent != stLevel->iNrEvents)) ||
+		((iAmount < 0) && (iChangeEvent > 1)))
+	{
+		/*** Modify the event number. ***/
+		iChangeEvent+=iAmount;
+		if (iChangeEvent < 1) { iChangeEvent = 1; }
+		if (iChangeEvent > stLevel->iNrEvents)
+			{ iChangeEvent = stLevel->iNrEvents; }
+
+		/*** Apply the event number to the selected tile. ***/
+		if (iChangePos == 1)
 		{
-			SDL_Delay (10);
+			iTile = stLevel->arRoomTiles[iCurRoom][iSelected];
+			iHighNibble = iTile >> 4;
+			iLowNibble = iTile & 0x0F; /*** 0F = 00001111 ***/
+			if ((iLowNibble == 0x0F) && (IsEven (iHighNibble))) /*** Raise. ***/
+			{
+				stLevel->arRoomTiles[iCurRoom][iSelected] =
+					RaiseDropEvent (0x0F, iChangeEvent, iAmount);
+				stEdit.arLevelDirty[iCurLevel] = 1;
+				iChanged++;
+			}
+			if ((iLowNibble == 0x06) && (IsEven (iHighNibble))) /*** Drop. ***/
+			{
+				stLevel->arRoomTiles[iCurRoom][iSelected] =
+					RaiseDropEvent (0x06, iChangeEvent, iAmount);
+				stEdit.arLevelDirty[iCurLevel] = 1;
+				iChanged++;
+			}
 		}
-		looptime = SDL_GetTicks();
+
+		PlaySound ("wav/plus_minus.wav");
 	}
-	PlaySound ("wav/popup_close.wav");
-	ShowScreen();
 }
 /*****************************************************************************/
-void ShowEXE (void)
+void ChangeCustom (int iAmount)
 /*****************************************************************************/
 {
-	SDL_Color clr;
-	int iR, iG, iB;
-	int iX, iY, iBaseX, iBaseY;
-	int iLetter;
+	if (((iAmount > 0) && (iCustomTile < 0xFF)) ||
+		((iAmount < 0) && (iCustomTile > 0x00)))
+	{
+		/*** Modify the custom tile. ***/
+		iCustomTile+=iAmount;
+		if (iCustomTile < 0x00) { iCustomTile = 0x00; }
+		if (iCustomTile > 0xFF) { iCustomTile = 0xFF; }
+
+		PlaySound ("wav/plus_minus.wav");
+	}
+}
+/*****************************************************************************/
+void Prev (void)
+/*****************************************************************************/
+{
+	if (iCurLevel != 1)
+	{
+		iCurLevel--;
+		LoadEditorLevels(); iChanged = 0; /*** Both are to discard changes. ***/
+		UndoClear();
+		iCurRoom = stEdit.stRom.arLevel[iCurLevel].arStartLocation[1];
+		iChangeEvent = 1;
+		PlaySound ("wav/level_change.wav");
+	}
+}
+/*****************************************************************************/
+void Next (void)
+/*****************************************************************************/
+{
+	if (iCurLevel != LEVELS)
+	{
+		iCurLevel++;
+		LoadEditorLevels(); iChanged = 0; /*** Both are to discard changes. ***/
+		UndoClear();
+		iCurRoom = stEdit.stRom.arLevel[iCurLevel].arStartLocation[1];
+		iChangeEvent = 1;
+		PlaySound ("wav/level_change.wav");
+	}
+}
+/*****************************************************************************/
+int CallSave (void)
+/*****************************************************************************/
+{
+	if (iReplay != 0) { return (1); } /*** A replay leaves the ROM alone. ***/
+
+	/*** Never save the changes for Mednafen. ***/
+	if (iModified == 1) { ModifyBack(); }
+
+	CreateBAK();
+	return (SaveLevels());
+}
+/*****************************************************************************/
+void Sprinkle (void)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	int iRandom;
 
 	/*** Used for looping. ***/
-	int iSlideLoop;
-	int iLineLoop;
-	int iCharLoop;
+	int iRoomLoop;
+	int iTileLoop;
 
-	/*** background ***/
-	ShowImage (imgexe, 0, 0, "imgexe");
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
 
-	/*** save button ***/
-	switch (iEXESave)
+	stEdit.arLevelDirty[iCurLevel] = 1;
+	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
 	{
-		case 0: /*** off ***/
-			ShowImage (imgsave[1], 590, 523, "imgsave[1]"); break;
-		case 1: /*** on ***/
-			ShowImage (imgsave[2], 590, 523, "imgsave[2]"); break;
-	}
-
-	/*** Starting minutes left. ***/
-	if (iEXEMinutesLeft == 60) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXEMinutesLeft, 247, 34, clr, 0);
+		UndoRoom (iRoomLoop);
+		for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+		{
+			/*** space? add wall shadow ***/
+			if ((stLevel->arRoomTiles[iRoomLoop][iTileLoop] == 0x00) ||
+				(stLevel->arRoomTiles[iRoomLoop][iTileLoop] == 0xE0))
+			{
+				/*** 1-4 ***/
+				iRandom = 1 + (int) (4.0 * rand() / (RAND_MAX + 1.0));
+				switch (iRandom)
+				{
+					case 1: stLevel->arRoomTiles[iRoomLoop][iTileLoop] = 0x20; break;
+					case 2: stLevel->arRoomTiles[iRoomLoop][iTileLoop] = 0x40; break;
+				}
+			}
 
-	/*** Starting hit points. ***/
-	if (iEXEHitPoints == 3) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXEHitPoints, 247, 58, clr, 0);
+			/*** empty floor? add wall shadow, rubble, torch, skeleton ***/
+			if ((stLevel->arRoomTiles[iRoomLoop][iTileLoop] == 0x01) ||
+				(stLevel->arRoomTiles[iRoomLoop][iTileLoop] == 0xE1))
+			{
+				/*** 1-8 ***/
+				iRandom = 1 + (int) (8.0 * rand() / (RAND_MAX + 1.0));
+				switch (iRandom)
+				{
+					case 1: stLevel->arRoomTiles[iRoomLoop][iTileLoop] = 0x21; break;
+					case 2: stLevel->arRoomTiles[iRoomLoop][iTileLoop] = 0x0E; break;
+					case 3: stLevel->arRoomTiles[iRoomLoop][iTileLoop] = 0x13; break;
+					case 4: stLevel->arRoomTiles[iRoomLoop][iTileLoop] = 0x15; break;
+				}
+			}
+		}
+	}
+}
+/*****************************************************************************/
+void SetLocation (int iRoom, int iLocation, int iTile)
+/*****************************************************************************/
+{
+	UndoRoom (iRoom);
+	DropRoomLayers (iCurLevel);
+	stEdit.stRom.arLevel[iCurLevel].arRoomTiles[iRoom][iLocation] = iTile;
+	iLastTile = iTile;
+	stEdit.arLevelDirty[iCurLevel] = 1;
+}
+/*****************************************************************************/
+void FlipRoom (int iAxis)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	unsigned char arRoomTilesTemp[TILES + 2];
+	int iTileUse;
+	int iTile;
 
-	/*** Hair. ***/
-	if (iEXEHairR == 24) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXEHairR, 497, 34, clr, 0);
-	if (iEXEHairG == 21) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXEHairG, 497, 58, clr, 0);
-	if (iEXEHairB == 0) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXEHairB, 497, 82, clr, 0);
+	/*** Used for looping. ***/
+	int iTileLoop;
 
-	/*** Skin. ***/
-	if (iEXESkinR == 20) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXESkinR, 497, 116, clr, 0);
-	if (iEXESkinG == 13) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXESkinG, 497, 140, clr, 0);
-	if (iEXESkinB == 11) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXESkinB, 497, 164, clr, 0);
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
 
-	/*** Suit. ***/
-	if (iEXESuitR == 31) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXESuitR, 497, 198, clr, 0);
-	if (iEXESuitG == 31) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXESuitG, 497, 222, clr, 0);
-	if (iEXESuitB == 31) { clr = color_bl; } else { clr = color_blue; }
-	CenterNumber (iEXESuitB, 497, 246, clr, 0);
+	UndoRoom (iCurRoom);
+	stEdit.arLevelDirty[iCurLevel] = 1;
 
-	/*** Fill the prince with approximate(!) colors. ***/
-	/*** Hair. ***/
-	iR = (iEXEHairR * 255) / 31;
-	iG = (iEXEHairG * 255) / 31;
-	iB = (iEXEHairB * 255) / 31;
-	ColorRect (614, 49, 12, 8, iR, iG, iB);
-	ColorRect (610, 53, 8, 16, iR, iG, iB);
-	/*** Skin. ***/
-	iR = (iEXESkinR * 255) / 31;
-	iG = (iEXESkinG * 255) / 31;
-	iB = (iEXESkinB * 255) / 31;
-	ColorRect (618, 57, 8, 12, iR, iG, iB);
-	ColorRect (614, 69, 8, 4, iR, iG, iB);
-	ColorRect (610, 77, 8, 20, iR, iG, iB);
-	ColorRect (614, 97, 8, 4, iR, iG, iB);
-	ColorRect (618, 101, 8, 4, iR, iG, iB);
-	ColorRect (622, 105, 4, 4, iR, iG, iB);
-	ColorRect (614, 157, 12, 8, iR, iG, iB);
-	ColorRect (626, 161, 4, 4, iR, iG, iB);
-	/*** Suit. ***/
-	iR = (iEXESuitR * 255) / 31;
-	iG = (iEXESuitG * 255) / 31;
-	iB = (iEXESuitB * 255) / 31;
-	ColorRect (610, 73, 12, 4, iR, iG, iB);
-	ColorRect (618, 77, 8, 20, iR, iG, iB);
-	ColorRect (622, 97, 4, 4, iR, iG, iB);
-	ColorRect (610, 97, 4, 24, iR, iG, iB);
-	ColorRect (614, 101, 4, 56, iR, iG, iB);
-	ColorRect (618, 105, 4, 52, iR, iG, iB);
-	ColorRect (622, 109, 4, 44, iR, iG, iB);
-	ColorRect (626, 117, 4, 24, iR, iG, iB);
+	/*** Storing tiles for later use. ***/
+	for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+	{
+		arRoomTilesTemp[iTileLoop] = stLevel->arRoomTiles[iCurRoom][iTileLoop];
+	}
 
-	/*** Intro slides. ***/
-	for (iSlideLoop = 1; iSlideLoop <= SLIDES; iSlideLoop++)
+	if (iAxis == 1) /*** horizontal ***/
 	{
-		switch (iSlideLoop)
+		/*** tiles ***/
+		for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
 		{
-			case 1: iBaseX = 34; iBaseY = 191; break;
-			case 2: iBaseX = 34; iBaseY = 295; break;
-			case 3: iBaseX = 266; iBaseY = 295; break;
-			case 4: iBaseX = 34; iBaseY = 399; break;
-			case 5: iBaseX = 266; iBaseY = 399; break;
+			iTileUse = 0; /*** To prevent warnings. ***/
+			if ((iTileLoop >= 1) && (iTileLoop <= 10))
+				{ iTileUse = 11 - iTileLoop; }
+			if ((iTileLoop >= 11) && (iTileLoop <= 20))
+				{ iTileUse = 31 - iTileLoop; }
+			if ((iTileLoop >= 21) && (iTileLoop <= 30))
+				{ iTileUse = 51 - iTileLoop; }
+			stLevel->arRoomTiles[iCurRoom][iTileLoop] = arRoomTilesTemp[iTileUse];
 		}
-		iBaseX+=14;
-		iBaseY+=18;
-		iY = iBaseY;
-		for (iLineLoop = 1; iLineLoop <= SLIDES_LINES; iLineLoop++)
+
+		/*** prince ***/
+		if (stLevel->arStartLocation[1] == iCurRoom)
 		{
-			iX = iBaseX;
-			for (iCharLoop = 0; iCharLoop <
-				(int)strlen ((char *)arIntroSlides[iSlideLoop]
-				[iLineLoop]); iCharLoop++)
-			{
-				iLetter = arIntroSlides[iSlideLoop][iLineLoop][iCharLoop] - 0x40;
-				if (iLetter == -32)
-				{
-					ShowImage (imgspace, iX, iY, "imgspace");
-				} else if ((iLetter >= 1) && (iLetter <= 26)) {
-					ShowImage (imgalphabet[iLetter], iX, iY, "imgalphabet[...]");
-				} else {
-					ShowImage (imgunknown, iX, iY, "imgunknown");
-				}
-				iX+=16;
-			}
-			iY+=16;
+			/*** direction ***/
+			if (stLevel->arStartLocation[3] == 0x00)
+				{ stLevel->arStartLocation[3] = 0xFF; }
+					else { stLevel->arStartLocation[3] = 0x00; }
+			/*** tile ***/
+			iTile = stLevel->arStartLocation[2];
+			if ((iTile >= 1) && (iTile <= 10))
+				{ stLevel->arStartLocation[2] = 11 - iTile; }
+			if ((iTile >= 11) && (iTile <= 20))
+				{ stLevel->arStartLocation[2] = 31 - iTile; }
+			if ((iTile >= 21) && (iTile <= 30))
+				{ stLevel->arStartLocation[2] = 51 - iTile; }
+		}
+
+		/*** guard ***/
+		if (stLevel->arGuardTile[iCurRoom] <= TILES + 1)
+		{
+			/*** direction ***/
+			if (stLevel->arGuardDir[iCurRoom] == 0x00)
+				{ stLevel->arGuardDir[iCurRoom] = 0xFF; }
+					else { stLevel->arGuardDir[iCurRoom] = 0x00; }
+			/*** tile ***/
+			iTile = stLevel->arGuardTile[iCurRoom];
+			if ((iTile >= 1) && (iTile <= 10))
+				{ stLevel->arGuardTile[iCurRoom] = 11 - iTile; }
+			if ((iTile >= 11) && (iTile <= 20))
+				{ stLevel->arGuardTile[iCurRoom] = 31 - iTile; }
+			if ((iTile >= 21) && (iTile <= 30))
+				{ stLevel->arGuardTile[iCurRoom] = 51 - iTile; }
+		}
+	} else { /*** vertical ***/
+		/*** tiles ***/
+		for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+		{
+			iTileUse = 0; /*** To prevent warnings. ***/
+			if ((iTileLoop >= 1) && (iTileLoop <= 10))
+				{ iTileUse = iTileLoop + 20; }
+			if ((iTileLoop >= 11) && (iTileLoop <= 20))
+				{ iTileUse = iTileLoop; }
+			if ((iTileLoop >= 21) && (iTileLoop <= 30))
+				{ iTileUse = iTileLoop - 20; }
+			stLevel->arRoomTiles[iCurRoom][iTileLoop] =
+				arRoomTilesTemp[iTileUse];
+		}
+
+		/*** prince ***/
+		if (stLevel->arStartLocation[1] == iCurRoom)
+		{
+			/*** tile ***/
+			iTile = stLevel->arStartLocation[2];
+			if ((iTile >= 1) && (iTile <= 10))
+				{ stLevel->arStartLocation[2] = iTile + 20; }
+			if ((iTile >= 21) && (iTile <= 30))
+				{ stLevel->arStartLocation[2] = iTile - 20; }
+		}
+
+		/*** guard ***/
+		if (stLevel->arGuardTile[iCurRoom] <= TILES + 1)
+		{
+			/*** tile ***/
+			iTile = stLevel->arGuardTile[iCurRoom];
+			if ((iTile >= 1) && (iTile <= 10))
+				{ stLevel->arGuardTile[iCurRoom] = iTile + 20; }
+			if ((iTile >= 21) && (iTile <= 30))
+				{ stLevel->arGuardTile[iCurRoom] = iTile - 20; }
 		}
 	}
+}
+/*****************************************************************************/
+void CopyPaste (int iAction)
+/*****************************************************************************/
+{
+	struct level *stLevel;
 
-	/*** Selected intro slide text line. ***/
-	switch (iS)
+	/*** Used for looping. ***/
+	int iTileLoop;
+
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	if (iAction == 1) /*** copy ***/
 	{
-		case 1:
-			switch (iL)
-			{
-				case 1: iX = 34; iY = 209; break;
-				case 2: iX = 34; iY = 225; break;
-				case 3: iX = 34; iY = 241; break;
-				case 4: iX = 34; iY = 257; break;
-			}
-			break;
-		case 2:
-			switch (iL)
-			{
-				case 1: iX = 34; iY = 313; break;
-				case 2: iX = 34; iY = 329; break;
-				case 3: iX = 34; iY = 345; break;
-				case 4: iX = 34; iY = 361; break;
-			}
-			break;
-		case 3:
-			switch (iL)
-			{
-				case 1: iX = 266; iY = 313; break;
-				case 2: iX = 266; iY = 329; break;
-				case 3: iX = 266; iY = 345; break;
-				case 4: iX = 266; iY = 361; break;
-			}
-			break;
-		case 4:
-			switch (iL)
+		for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+		{
+			arCopyPasteTile[iTileLoop] = stLevel->arRoomTiles[iCurRoom][iTileLoop];
+		}
+		cCopyPasteGuardTile = stLevel->arGuardTile[iCurRoom];
+		cCopyPasteGuardDir = stLevel->arGuardDir[iCurRoom];
+		iCopied = 1;
+	} else { /*** paste ***/
+		UndoRoom (iCurRoom);
+		stEdit.arLevelDirty[iCurLevel] = 1;
+		if (iCopied == 1)
+		{
+			for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
 			{
-				case 1: iX = 34; iY = 417; break;
-				case 2: iX = 34; iY = 433; break;
-				case 3: iX = 34; iY = 449; break;
-				case 4: iX = 34; iY = 465; break;
+				stLevel->arRoomTiles[iCurRoom][iTileLoop] =
+					arCopyPasteTile[iTileLoop];
 			}
-			break;
-		case 5:
-			switch (iL)
+			stLevel->arGuardTile[iCurRoom] = cCopyPasteGuardTile;
+			stLevel->arGuardDir[iCurRoom] = cCopyPasteGuardDir;
+		} else {
+			for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
 			{
-				case 1: iX = 266; iY = 417; break;
-				case 2: iX = 266; iY = 433; break;
-				case 3: iX = 266; iY = 449; break;
-				case 4: iX = 266; iY = 465; break;
+				stLevel->arRoomTiles[iCurRoom][iTileLoop] = 0x00;
 			}
-			break;
+			stLevel->arGuardTile[iCurRoom] = TILES + 1;
+		}
 	}
-	if (iS != 0) { ShowImage (imgseltextline, iX, iY, "imgseltextline"); }
+}
+/*****************************************************************************/
+void UndoRoom (int iRoom)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	struct undostep *stStep;
+	struct undoroom *arRooms;
+	int iInStep;
 
-	/*** Show the number of free bytes. ***/
-	if (iBytesLeft < 0)
+	/*** Used for looping. ***/
+	int iRoomLoop;
+
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	/*** Call this before a room changes; only its first change is kept. ***/
+	stStep = stUndoCur;
+	iInStep = 0;
+	if ((stStep != NULL) && (stStep->stNext == NULL) &&
+		(stStep->iLevel == iCurLevel))
 	{
-		clr = color_red;
-		ShowImage (imgexewarning, 265 - 9, 249, "imgexewarning");
+		for (iRoomLoop = 0; iRoomLoop < stStep->iRooms; iRoomLoop++)
+		{
+			if (stStep->arRooms[iRoomLoop].iRoom == iRoom) { iInStep = 1; }
+		}
 	} else {
-		clr = color_bl;
+		stStep = NULL;
 	}
-	CenterNumber (iBytesLeft, 265, 249, clr, 0);
 
-	/*** If necessary, show warnings about slide sizes. ***/
-	if (arSlideSizes[1] != 29)
-	{
-		ShowImage (imgexewarning, 116 - 9, 265, "imgexewarning");
-		CenterNumber (29 - arSlideSizes[1], 116, 265, color_red, 0);
+	/* A change in a room that the previous step already has, made shortly
+	 * after it, joins that step. This way, placing tiles in quick succession
+	 * is undone at once.
+	 */
+	if ((stStep != NULL) && (iUndoOpen == 0) && ((iInStep == 0) ||
+		(Ticks() - stStep->iTicks >= UNDO_COALESCE))) { stStep = NULL; }
+
+	if (stStep == NULL)
+	{
+		UndoDrop (stUndoCur == NULL ? stUndoOldest : stUndoCur->stNext);
+		stStep = malloc (sizeof (struct undostep));
+		if (stStep == NULL)
+		{
+			printf ("[ WARN ] Could not allocate an undo step!\n");
+			return;
+		}
+		stStep->iLevel = iCurLevel;
+		stStep->iRooms = 0;
+		stStep->arRooms = NULL;
+		memcpy (stStep->arStartLocation, stLevel->arStartLocation,
+			sizeof (stStep->arStartLocation));
+		stStep->stPrev = stUndoCur;
+		stStep->stNext = NULL;
+		if (stUndoCur == NULL) { stUndoOldest = stStep; }
+			else { stUndoCur->stNext = stStep; }
+		stUndoCur = stStep;
+		iUndoBytes+=sizeof (struct undostep);
+		iUndoOpen = 1;
+		iInStep = 0;
+	}
+	stStep->iTicks = Ticks();
+	if (iInStep == 1) { return; }
+
+	/*** Copy-on-write; other rooms stay shared with the level itself. ***/
+	arRooms = realloc (stStep->arRooms,
+		(stStep->iRooms + 1) * sizeof (struct undoroom));
+	if (arRooms == NULL)
+	{
+		printf ("[ WARN ] Could not allocate an undo room!\n");
+		return;
+	}
+	stStep->arRooms = arRooms;
+	arRooms[stStep->iRooms].iRoom = iRoom;
+	memcpy (arRooms[stStep->iRooms].arTiles, stLevel->arRoomTiles[iRoom],
+		sizeof (arRooms[stStep->iRooms].arTiles));
+	arRooms[stStep->iRooms].cGuardTile = stLevel->arGuardTile[iRoom];
+	arRooms[stStep->iRooms].cGuardDir = stLevel->arGuardDir[iRoom];
+	stStep->iRooms++;
+	iUndoBytes+=sizeof (struct undoroom);
+
+	/*** Forget the oldest steps if the history uses too much memory. ***/
+	while ((iUndoBytes > iUndoBudget * 1024) && (stUndoOldest != stUndoCur))
+	{
+		stStep = stUndoOldest;
+		stUndoOldest = stStep->stNext;
+		stUndoOldest->stPrev = NULL;
+		stStep->stNext = NULL;
+		UndoDrop (stStep);
 	}
-	if (arSlideSizes[2] != 24)
+}
+/*****************************************************************************/
+void UndoEnd (void)
+/*****************************************************************************/
+{
+	/*** The next change starts a new step, unless it is coalesced. ***/
+	iUndoOpen = 0;
+}
+/*****************************************************************************/
+void Undo (int iRedo)
+/*****************************************************************************/
+{
+	struct undostep *stStep;
+	struct level *stLevel;
+	struct undoroom stRoom;
+	unsigned char arStartLocation[3 + 2];
+	int iRoom;
+
+	/*** Used for looping. ***/
+	int iRoomLoop;
+
+	if (iRedo == 0)
 	{
-		ShowImage (imgexewarning, 116 - 9, 369, "imgexewarning");
-		CenterNumber (24 - arSlideSizes[2], 116, 369, color_red, 0);
-	}
-	if (arSlideSizes[3] != 37)
+		stStep = stUndoCur;
+	} else {
+		stStep = (stUndoCur == NULL ? stUndoOldest : stUndoCur->stNext);
+	}
+	if ((stStep == NULL) || (stStep->iLevel != iCurLevel)) { return; }
+	stLevel = &stEdit.stRom.arLevel[stStep->iLevel];
+
+	/*** Swapping makes the step hold what undoing or redoing it restores. ***/
+	for (iRoomLoop = 0; iRoomLoop < stStep->iRooms; iRoomLoop++)
+	{
+		iRoom = stStep->arRooms[iRoomLoop].iRoom;
+		stRoom = stStep->arRooms[iRoomLoop];
+		memcpy (stStep->arRooms[iRoomLoop].arTiles, stLevel->arRoomTiles[iRoom],
+			sizeof (stRoom.arTiles));
+		stStep->arRooms[iRoomLoop].cGuardTile = stLevel->arGuardTile[iRoom];
+		stStep->arRooms[iRoomLoop].cGuardDir = stLevel->arGuardDir[iRoom];
+		memcpy (stLevel->arRoomTiles[iRoom], stRoom.arTiles,
+			sizeof (stRoom.arTiles));
+		stLevel->arGuardTile[iRoom] = stRoom.cGuardTile;
+		stLevel->arGuardDir[iRoom] = stRoom.cGuardDir;
+	}
+	memcpy (arStartLocation, stLevel->arStartLocation,
+		sizeof (arStartLocation));
+	memcpy (stLevel->arStartLocation, stStep->arStartLocation,
+		sizeof (arStartLocation));
+	memcpy (stStep->arStartLocation, arStartLocation,
+		sizeof (arStartLocation));
+
+	if (iRedo == 0) { stUndoCur = stStep->stPrev; } else { stUndoCur = stStep; }
+	iUndoOpen = 0;
+	stEdit.arLevelDirty[stStep->iLevel] = 1;
+	iChanged++;
+	PlaySound ("wav/extras.wav");
+}
+/*****************************************************************************/
+void UndoDrop (struct undostep *stStep)
+/*****************************************************************************/
+{
+	struct undostep *stNext;
+
+	/*** Frees stStep and all steps after it. ***/
+	if (stStep == NULL) { return; }
+	if (stStep->stPrev != NULL) { stStep->stPrev->stNext = NULL; }
+	if (stStep == stUndoOldest) { stUndoOldest = NULL; }
+	while (stStep != NULL)
 	{
-		ShowImage (imgexewarning, 348 - 9, 369, "imgexewarning");
-		CenterNumber (37 - arSlideSizes[3], 348, 369, color_red, 0);
+		stNext = stStep->stNext;
+		iUndoBytes-=sizeof (struct undostep) +
+			(stStep->iRooms * sizeof (struct undoroom));
+		free (stStep->arRooms);
+		free (stStep);
+		stStep = stNext;
 	}
-	if (arSlideSizes[4] != 31)
+}
+/*****************************************************************************/
+void UndoClear (void)
+/*****************************************************************************/
+{
+	UndoDrop (stUndoOldest);
+	stUndoCur = NULL;
+	iUndoOpen = 0;
+}
+/*****************************************************************************/
+int InArea (int iUpperLeftX, int iUpperLeftY,
+	int iLowerRightX, int iLowerRightY)
+/*****************************************************************************/
+{
+	if ((iUpperLeftX * iScale <= iXPos) &&
+		(iLowerRightX * iScale >= iXPos) &&
+		(iUpperLeftY * iScale <= iYPos) &&
+		(iLowerRightY * iScale >= iYPos))
 	{
-		ShowImage (imgexewarning, 116 - 9, 473, "imgexewarning");
-		CenterNumber (31 - arSlideSizes[4], 116, 473, color_red, 0);
+		return (1);
+	} else {
+		return (0);
 	}
-	if (arSlideSizes[5] != 29)
+}
+/*****************************************************************************/
+int MouseSelectAdj (void)
+/*****************************************************************************/
+{
+	/* On the broken room links screen, if you click one of the adjacent
+	 * rooms, this function sets iOnAdj to 1, and also sets both
+	 * iChangingBrokenRoom and iChangingBrokenSide.
+	 */
+
+	int iOnAdj;
+	int iRoomLoop;
+	int iAdjBaseX;
+	int iAdjBaseY;
+
+	iOnAdj = 0;
+	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
 	{
-		ShowImage (imgexewarning, 348 - 9, 473, "imgexewarning");
-		CenterNumber (29 - arSlideSizes[5], 348, 473, color_red, 0);
+		switch (iRoomLoop)
+		{
+			case 1: iAdjBaseX = ADJ_BASE_X + (63 * 0);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 0); break;
+			case 2: iAdjBaseX = ADJ_BASE_X + (63 * 1);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 0); break;
+			case 3: iAdjBaseX = ADJ_BASE_X + (63 * 2);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 0); break;
+			case 4: iAdjBaseX = ADJ_BASE_X + (63 * 3);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 0); break;
+			case 5: iAdjBaseX = ADJ_BASE_X + (63 * 0);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 1); break;
+			case 6: iAdjBaseX = ADJ_BASE_X + (63 * 1);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 1); break;
+			case 7: iAdjBaseX = ADJ_BASE_X + (63 * 2);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 1); break;
+			case 8: iAdjBaseX = ADJ_BASE_X + (63 * 3);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 1); break;
+			case 9: iAdjBaseX = ADJ_BASE_X + (63 * 0);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 2); break;
+			case 10: iAdjBaseX = ADJ_BASE_X + (63 * 1);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 2); break;
+			case 11: iAdjBaseX = ADJ_BASE_X + (63 * 2);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 2); break;
+			case 12: iAdjBaseX = ADJ_BASE_X + (63 * 3);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 2); break;
+			case 13: iAdjBaseX = ADJ_BASE_X + (63 * 0);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 3); break;
+			case 14: iAdjBaseX = ADJ_BASE_X + (63 * 1);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 3); break;
+			case 15: iAdjBaseX = ADJ_BASE_X + (63 * 2);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 3); break;
+			case 16: iAdjBaseX = ADJ_BASE_X + (63 * 3);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 3); break;
+			case 17: iAdjBaseX = ADJ_BASE_X + (63 * 0);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 4); break;
+			case 18: iAdjBaseX = ADJ_BASE_X + (63 * 1);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 4); break;
+			case 19: iAdjBaseX = ADJ_BASE_X + (63 * 2);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 4); break;
+			case 20: iAdjBaseX = ADJ_BASE_X + (63 * 3);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 4); break;
+			case 21: iAdjBaseX = ADJ_BASE_X + (63 * 0);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 5); break;
+			case 22: iAdjBaseX = ADJ_BASE_X + (63 * 1);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 5); break;
+			case 23: iAdjBaseX = ADJ_BASE_X + (63 * 2);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 5); break;
+			case 24: iAdjBaseX = ADJ_BASE_X + (63 * 3);
+				iAdjBaseY = ADJ_BASE_Y + (63 * 5); break;
+			default:
+				printf ("[FAILED] iRoomLoop is not in the 1-24 range!\n");
+				exit (EXIT_ERROR);
+		}
+		if (InArea (iAdjBaseX + 1, iAdjBaseY + 16,
+			iAdjBaseX + 15, iAdjBaseY + 30) == 1)
+		{
+			iChangingBrokenRoom = iRoomLoop;
+			iChangingBrokenSide = 1; /*** left ***/
+			iOnAdj = 1;
+		}
+		if (InArea (iAdjBaseX + 31, iAdjBaseY + 16,
+			iAdjBaseX + 45, iAdjBaseY + 30) == 1)
+		{
+			iChangingBrokenRoom = iRoomLoop;
+			iChangingBrokenSide = 2; /*** right ***/
+			iOnAdj = 1;
+		}
+		if (InArea (iAdjBaseX + 16, iAdjBaseY + 1,
+			iAdjBaseX + 30, iAdjBaseY + 14) == 1)
+		{
+			iChangingBrokenRoom = iRoomLoop;
+			iChangingBrokenSide = 3; /*** up ***/
+			iOnAdj = 1;
+		}
+		if (InArea (iAdjBaseX + 16, iAdjBaseY + 31,
+			iAdjBaseX + 30, iAdjBaseY + 45) == 1)
+		{
+			iChangingBrokenRoom = iRoomLoop;
+			iChangingBrokenSide = 4; /*** down ***/
+			iOnAdj = 1;
+		}
 	}
 
-	/*** refresh screen ***/
-	SDL_RenderPresent (ascreen);
+	return (iOnAdj);
 }
 /*****************************************************************************/
-void InitScreenAction (char *sAction)
+int OnLevelBar (void)
 /*****************************************************************************/
 {
-	int iEventRoom;
-	int iToTile;
-	int iFromTile;
+	if (InArea (28, 3, 602, 22) == 1) { return (1); } else { return (0); }
+}
+/*****************************************************************************/
+void ChangePos (void)
+/*****************************************************************************/
+{
+	int iChanging;
+	SDL_Event event;
+	int iOldXPos, iOldYPos;
+	int iUseTile;
+	int iNowOn;
 
-	if (strcmp (sAction, "left") == 0)
+	/*** Used for looping. ***/
+	int iRoomLoop;
+	int iTileLoop;
+
+	iChanging = 1;
+	iEventTooltip = 0;
+	iCustomHover = 0;
+
+	ShowChange();
+	while (iChanging == 1)
 	{
-		switch (iScreen)
+		while (PollEvent (&event))
 		{
-			case 1:
-				iSelected--;
-				switch (iSelected)
-				{
-					case 0: iSelected = 10; break;
-					case 10: iSelected = 20; break;
-					case 20: iSelected = 30; break;
-				}
-				break;
-			case 2:
-				if (arBrokenRoomLinks[iCurLevel] == 0)
-				{
-					if (iMovingRoom != 0)
+			UndoEnd();
+			switch (event.type)
+			{
+				case SDL_CONTROLLERBUTTONDOWN:
+					/*** Nothing for now. ***/
+					break;
+				case SDL_CONTROLLERBUTTONUP:
+					switch (event.cbutton.button)
+					{
+						case SDL_CONTROLLER_BUTTON_A:
+							if (iOnTile != 0)
+							{
+								UseTile (iOnTile, iSelected, iCurRoom);
+								if (iOnTile <= 60) { iChanging = 0; }
+								iChanged++;
+							}
+							break;
+						case SDL_CONTROLLER_BUTTON_B:
+							iChanging = 0; break;
+						case SDL_CONTROLLER_BUTTON_X:
+							UseTile (-2, iSelected, iCurRoom);
+							iChanging = 0;
+							iChanged++;
+							break;
+						case SDL_CONTROLLER_BUTTON_DPAD_LEFT:
+							ChangePosAction ("left"); break;
+						case SDL_CONTROLLER_BUTTON_DPAD_RIGHT:
+							ChangePosAction ("right"); break;
+						case SDL_CONTROLLER_BUTTON_DPAD_UP:
+							ChangePosAction ("up"); break;
+						case SDL_CONTROLLER_BUTTON_DPAD_DOWN:
+							ChangePosAction ("down"); break;
+						case SDL_CONTROLLER_BUTTON_LEFTSHOULDER:
+							ChangeCustom (-1); break;
+						case SDL_CONTROLLER_BUTTON_RIGHTSHOULDER:
+							ChangeCustom (1); break;
+					}
+					ShowChange();
+					break;
+				case SDL_CONTROLLERAXISMOTION: /*** triggers and analog sticks ***/
+					iXJoy1 = SDL_JoystickGetAxis (joystick, 0);
+					iYJoy1 = SDL_JoystickGetAxis (joystick, 1);
+					iXJoy2 = SDL_JoystickGetAxis (joystick, 3);
+					iYJoy2 = SDL_JoystickGetAxis (joystick, 4);
+					if ((iXJoy1 < -30000) || (iXJoy2 < -30000)) /*** left ***/
+					{
+						if ((Ticks() - joyleft) > 300)
+						{
+							ChangeEvent (-1, 1);
+							joyleft = Ticks();
+						}
+					}
+					if ((iXJoy1 > 30000) || (iXJoy2 > 30000)) /*** right ***/
+					{
+						if ((Ticks() - joyright) > 300)
+						{
+							ChangeEvent (1, 1);
+							joyright = Ticks();
+						}
+					}
+					if ((iYJoy1 < -30000) || (iYJoy2 < -30000)) /*** up ***/
+					{
+						if ((Ticks() - joyup) > 300)
+						{
+							ChangeEvent (10, 1);
+							joyup = Ticks();
+						}
+					}
+					if ((iYJoy1 > 30000) || (iYJoy2 > 30000)) /*** down ***/
+					{
+						if ((Ticks() - joydown) > 300)
+						{
+							ChangeEvent (-10, 1);
+							joydown = Ticks();
+						}
+					}
+					ShowChange();
+					break;
+				case SDL_KEYDOWN:
+					switch (event.key.keysym.sym)
+					{
+						case SDLK_KP_ENTER:
+						case SDLK_RETURN:
+						case SDLK_SPACE:
+							if (event.key.keysym.mod & KMOD_CTRL)
+							{
+								if ((iOnTile >= 1) && (iOnTile <= 60))
+								{
+									for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+									{
+										for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+											{ UseTile (iOnTile, iTileLoop, iRoomLoop); }
+									}
+									iChanging = 0;
+									iChanged++;
+								}
+							} else if (event.key.keysym.mod & KMOD_SHIFT) {
+								if ((iOnTile >= 1) && (iOnTile <= 60))
+								{
+									for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+										{ UseTile (iOnTile, iTileLoop, iCurRoom); }
+									iChanging = 0;
+									iChanged++;
+								}
+							} else if (iOnTile != 0) {
+								UseTile (iOnTile, iSelected, iCurRoom);
+								if (iOnTile <= 60) { iChanging = 0; }
+								iChanged++;
+							}
+							break;
+						case SDLK_ESCAPE:
+						case SDLK_q:
+						case SDLK_c:
+							iChanging = 0; break;
+						case SDLK_LEFT:
+							if (event.key.keysym.mod & KMOD_CTRL)
+							{
+								ChangeEvent (-10, 1);
+							} else if (event.key.keysym.mod & KMOD_SHIFT) {
+								ChangeEvent (-1, 1);
+							} else {
+								ChangePosAction ("left");
+							}
+							break;
+						case SDLK_RIGHT:
+							if (event.key.keysym.mod & KMOD_CTRL)
+							{
+								ChangeEvent (10, 1);
+							} else if (event.key.keysym.mod & KMOD_SHIFT) {
+								ChangeEvent (1, 1);
+							} else {
+								ChangePosAction ("right");
+							}
+							break;
+						case SDLK_UP: ChangePosAction ("up"); break;
+						case SDLK_DOWN: ChangePosAction ("down"); break;
+						default: break;
+					}
+					ShowChange();
+					break;
+				case SDL_MOUSEMOTION:
+					iOldXPos = iXPos;
+					iOldYPos = iYPos;
+					iXPos = event.motion.x;
+					iYPos = event.motion.y;
+					if ((iOldXPos == iXPos) && (iOldYPos == iYPos)) { break; }
+
+					/*** event tooltip ***/
+					iEventTooltipOld = iEventTooltip;
+					if (InArea (525, 539, 525 + 126, 539 + 29) == 1)
+						{ iEventTooltip = 1; } else { iEventTooltip = 0; }
+					if (iEventTooltip != iEventTooltipOld) { ShowChange(); }
+
+					/*** custom hover ***/
+					iCustomHoverOld = iCustomHover;
+					if (InArea (395, 491, 395 + 126, 491 + 47) == 1)
+						{ iCustomHover = 1; } else { iCustomHover = 0; }
+					if (iCustomHover != iCustomHoverOld) { ShowChange(); }
+
+					iNowOn = OnTile();
+					if ((iOnTile != iNowOn) && (iNowOn != 0))
 					{
-						if (iMovingNewX != 1) { iMovingNewX--; }
-							else { iMovingNewX = 25; }
-						PlaySound ("wav/cross.wav");
+						if (IsDisabled (iNowOn) == 0)
+						{
+							iOnTile = iNowOn;
+							ShowChange();
+						}
 					}
-				} else {
-					if (iChangingBrokenSide != 1)
+					break;
+				case SDL_MOUSEBUTTONDOWN:
+					if (event.button.button == 1) /*** left mouse button ***/
 					{
-						iChangingBrokenSide = 1;
-					} else {
-						switch (iChangingBrokenRoom)
+						if (InArea (656, 0, 656 + 36, 0 + 573) == 1) /*** close ***/
 						{
-							case 1: iChangingBrokenRoom = 4; break;
-							case 5: iChangingBrokenRoom = 8; break;
-							case 9: iChangingBrokenRoom = 12; break;
-							case 13: iChangingBrokenRoom = 16; break;
-							case 17: iChangingBrokenRoom = 20; break;
-							case 21: iChangingBrokenRoom = 24; break;
-							default: iChangingBrokenRoom--; break;
+							iCloseOn = 1;
+							ShowChange();
 						}
 					}
-				}
-				break;
-			case 3:
-				iToTile = arEventsToTile[iCurLevel][iChangeEvent];
-				switch (iToTile)
-				{
-					case 1: iToTile = 10; break;
-					case 11: iToTile = 20; break;
-					case 21: iToTile = 30; break;
-					default: iToTile--; break;
-				}
-				if (iToTile > 20) { EventTile (iToTile - 20, 3, 1); }
-					else if (iToTile > 10)
-						{ EventTile (iToTile - 10, 2, 1); }
-					else { EventTile (iToTile, 1, 1); }
-				break;
-		}
-	}
+					break;
+				case SDL_MOUSEBUTTONUP:
+					iCloseOn = 0;
 
-	if (strcmp (sAction, "right") == 0)
-	{
-		switch (iScreen)
-		{
-			case 1:
-				iSelected++;
-				switch (iSelected)
-				{
-					case 11: iSelected = 1; break;
-					case 21: iSelected = 11; break;
-					case 31: iSelected = 21; break;
-				}
-				break;
-			case 2:
-				if (arBrokenRoomLinks[iCurLevel] == 0)
-				{
-					if (iMovingRoom != 0)
+					/*** On tile or living. ***/
+					iUseTile = 0;
+					if ((InArea (2, 2, 2 + 652, 2 + 488) == 1) ||
+						(InArea (2, 488, 2 + 327, 488 + 83) == 1)) { iUseTile = 1; }
+
+					/*** On the custom tile area. ***/
+					if (InArea (395, 491, 395 + 126, 491 + 47) == 1)
 					{
-						if (iMovingNewX != 25) { iMovingNewX++; }
-							else { iMovingNewX = 1; }
-						PlaySound ("wav/cross.wav");
+						iOnTile = -2;
+						iUseTile = 1;
 					}
-				} else {
-					if (iChangingBrokenSide != 2)
+
+					if (event.button.button == 1) /*** left mouse button ***/
 					{
-						iChangingBrokenSide = 2;
-					} else {
-						switch (iChangingBrokenRoom)
+						/*** Changing the custom tile. ***/
+						if (InArea (402, 543, 402 + 13, 543 + 20) == 1)
+							{ ChangeCustom (-16); }
+						if (InArea (417, 543, 417 + 13, 543 + 20) == 1)
+							{ ChangeCustom (-1); }
+						if (InArea (487, 543, 487 + 13, 543 + 20) == 1)
+							{ ChangeCustom (1); }
+						if (InArea (502, 543, 502 + 13, 543 + 20) == 1)
+							{ ChangeCustom (16); }
+
+						/*** Changing the event number. ***/
+						if (InArea (532, 543, 532 + 13, 543 + 20) == 1)
+							{ ChangeEvent (-10, 1); }
+						if (InArea (547, 543, 547 + 13, 543 + 20) == 1)
+							{ ChangeEvent (-1, 1); }
+						if (InArea (617, 543, 617 + 13, 543 + 20) == 1)
+							{ ChangeEvent (1, 1); }
+						if (InArea (632, 543, 632 + 13, 543 + 20) == 1)
+							{ ChangeEvent (10, 1); }
+
+						/*** On close. ***/
+						if (InArea (656, 0, 656 + 36, 0 + 573) == 1) { iChanging = 0; }
+
+						if (iUseTile == 1)
 						{
-							case 4: iChangingBrokenRoom = 1; break;
-							case 8: iChangingBrokenRoom = 5; break;
-							case 12: iChangingBrokenRoom = 9; break;
-							case 16: iChangingBrokenRoom = 13; break;
-							case 20: iChangingBrokenRoom = 17; break;
-							case 24: iChangingBrokenRoom = 21; break;
-							default: iChangingBrokenRoom++; break;
+							UseTile (iOnTile, iSelected, iCurRoom);
+							if (iOnTile <= 60) { iChanging = 0; }
+							iChanged++;
 						}
 					}
-				}
-				break;
-			case 3:
-				iToTile = arEventsToTile[iCurLevel][iChangeEvent];
-				switch (iToTile)
-				{
-					case 10: iToTile = 1; break;
-					case 20: iToTile = 11; break;
-					case 30: iToTile = 21; break;
-					default: iToTile++; break;
-				}
-				if (iToTile > 20) { EventTile (iToTile - 20, 3, 1); }
-					else if (iToTile > 10)
-						{ EventTile (iToTile - 10, 2, 1); }
-					else { EventTile (iToTile, 1, 1); }
-				break;
-		}
-	}
 
-	if (strcmp (sAction, "up") == 0)
-	{
-		switch (iScreen)
-		{
-			case 1:
-				if (iSelected > 10) { iSelected-=10; }
-					else { iSelected+=20; }
-				break;
-			case 2:
-				if (arBrokenRoomLinks[iCurLevel] == 0)
-				{
-					if (iMovingRoom != 0)
+					if (event.button.button == 2)
 					{
-						if (iMovingNewY != 1) { iMovingNewY--; }
-							else { iMovingNewY = 24; }
-						PlaySound ("wav/cross.wav");
+						if ((iUseTile == 1) && (iOnTile != 0) && (iOnTile <= 60))
+						{
+							for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+							{
+								UseTile (iOnTile, iTileLoop, iCurRoom);
+							}
+							iChanging = 0;
+							iChanged++;
+						}
 					}
-				} else {
-					if (iChangingBrokenSide != 3)
+
+					if (event.button.button == 3)
 					{
-						iChangingBrokenSide = 3;
-					} else {
-						switch (iChangingBrokenRoom)
+						if ((iUseTile == 1) && (iOnTile != 0) && (iOnTile <= 60))
 						{
-							case 1: iChangingBrokenRoom = 21; break;
-							case 2: iChangingBrokenRoom = 22; break;
-							case 3: iChangingBrokenRoom = 23; break;
-							case 4: iChangingBrokenRoom = 24; break;
-							default: iChangingBrokenRoom -= 4; break;
+							for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+							{
+								for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+								{
+									UseTile (iOnTile, iTileLoop, iRoomLoop);
+								}
+							}
+							iChanging = 0;
+							iChanged++;
 						}
 					}
-				}
-				break;
-			case 3:
-				iToTile = arEventsToTile[iCurLevel][iChangeEvent];
-				if (iToTile > 10) { iToTile-=10; }
-					else { iToTile+=20; }
-				if (iToTile > 20) { EventTile (iToTile - 20, 3, 1); }
-					else if (iToTile > 10)
-						{ EventTile (iToTile - 10, 2, 1); }
-					else { EventTile (iToTile, 1, 1); }
-				break;
+
+					ShowChange();
+					break;
+				case SDL_WINDOWEVENT:
+					if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
+						{ ShowChange(); } break;
+				case SDL_QUIT:
+					Quit(); break;
+			}
 		}
+
+		/*** Sleep until there is input. ***/
+		WaitEvent (-1);
 	}
+	PlaySound ("wav/ok_close.wav");
+}
+/*****************************************************************************/
+void RemoveOldRoom (void)
+/*****************************************************************************/
+{
+	struct level *stLevel;
 
-	if (strcmp (sAction, "down") == 0)
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	arMovingRooms[iMovingOldX][iMovingOldY] = 0;
+	stEdit.arLevelDirty[iCurLevel] = 1;
+
+	/* Change the links of the rooms around
+	 * the removed room.
+	 */
+
+	/*** left of removed ***/
+	if ((iMovingOldX >= 2) && (iMovingOldX <= 24))
 	{
-		switch (iScreen)
-		{
-			case 1:
-				if (iSelected <= 20) { iSelected+=10; }
-					else { iSelected-=20; }
-				break;
-			case 2:
-				if (arBrokenRoomLinks[iCurLevel] == 0)
-				{
-					if (iMovingRoom != 0)
-					{
-						if (iMovingNewY != 24) { iMovingNewY++; }
-							else { iMovingNewY = 1; }
-						PlaySound ("wav/cross.wav");
-					}
-				} else {
-					if (iChangingBrokenSide != 4)
-					{
-						iChangingBrokenSide = 4;
-					} else {
-						switch (iChangingBrokenRoom)
-						{
-							case 21: iChangingBrokenRoom = 1; break;
-							case 22: iChangingBrokenRoom = 2; break;
-							case 23: iChangingBrokenRoom = 3; break;
-							case 24: iChangingBrokenRoom = 4; break;
-							default: iChangingBrokenRoom += 4; break;
-						}
-					}
-				}
-				break;
-			case 3:
-				iToTile = arEventsToTile[iCurLevel][iChangeEvent];
-				if (iToTile <= 20) { iToTile+=10; }
-					else { iToTile-=20; }
-				if (iToTile > 20) { EventTile (iToTile - 20, 3, 1); }
-					else if (iToTile > 10)
-						{ EventTile (iToTile - 10, 2, 1); }
-					else { EventTile (iToTile, 1, 1); }
-				break;
+		if (arMovingRooms[iMovingOldX - 1][iMovingOldY] != 0)
+		{
+			stLevel->arRoomLinks[arMovingRooms[iMovingOldX - 1]
+				[iMovingOldY]][2] = 0; /*** remove right ***/
 		}
 	}
 
-	if (strcmp (sAction, "left bracket") == 0)
+	/*** right of removed ***/
+	if ((iMovingOldX >= 1) && (iMovingOldX <= 23))
 	{
-		switch (iScreen)
+		if (arMovingRooms[iMovingOldX + 1][iMovingOldY] != 0)
 		{
-			case 2:
-				if (arBrokenRoomLinks[iCurLevel] == 0)
-				{
-					iMovingNewBusy = 0;
-					switch (iMovingRoom)
-					{
-						case 0: iMovingRoom = ROOMS; break; /*** If disabled. ***/
-						case 1: iMovingRoom = ROOMS; break;
-						default: iMovingRoom--; break;
-					}
-				}
-				break;
-			case 3:
-				iEventRoom = arEventsToRoom[iCurLevel][iChangeEvent];
-				if ((iEventRoom >= 2) && (iEventRoom <= 24))
-				{
-					EventRoom (iEventRoom - 1, 1);
-				} else {
-					EventRoom (24, 1);
-				}
-				break;
+			stLevel->arRoomLinks[arMovingRooms[iMovingOldX + 1]
+				[iMovingOldY]][1] = 0; /*** remove left ***/
 		}
 	}
 
-	if (strcmp (sAction, "right bracket") == 0)
+	/*** above removed ***/
+	if ((iMovingOldY >= 2) && (iMovingOldY <= 24))
 	{
-		switch (iScreen)
+		if (arMovingRooms[iMovingOldX][iMovingOldY - 1] != 0)
 		{
-			case 2:
-				if (arBrokenRoomLinks[iCurLevel] == 0)
-				{
-					iMovingNewBusy = 0;
-					switch (iMovingRoom)
-					{
-						case 0: iMovingRoom = 1; break; /*** If disabled. ***/
-						case 24: iMovingRoom = 1; break;
-						default: iMovingRoom++; break;
-					}
-				}
-				break;
-			case 3:
-				iEventRoom = arEventsToRoom[iCurLevel][iChangeEvent];
-				if ((iEventRoom >= 1) && (iEventRoom <= 23))
-				{
-					EventRoom (iEventRoom + 1, 1);
-				} else {
-					EventRoom (1, 1);
-				}
-				break;
+			stLevel->arRoomLinks[arMovingRooms[iMovingOldX]
+				[iMovingOldY - 1]][4] = 0; /*** remove below ***/
 		}
 	}
 
-	if (strcmp (sAction, "left brace") == 0)
+	/*** below removed ***/
+	if ((iMovingOldY >= 1) && (iMovingOldY <= 23))
 	{
-		if (iScreen == 3)
+		if (arMovingRooms[iMovingOldX][iMovingOldY + 1] != 0)
 		{
-			iEventRoom = arEventsFromRoom[iCurLevel][iChangeEvent];
-			if ((iEventRoom >= 2) && (iEventRoom <= 24))
-			{
-				EventRoom (iEventRoom - 1, 0);
-			} else {
-				EventRoom (24, 0);
-			}
+			stLevel->arRoomLinks[arMovingRooms[iMovingOldX]
+				[iMovingOldY + 1]][3] = 0; /*** remove above ***/
 		}
 	}
+}
+/*****************************************************************************/
+void AddNewRoom (int iX, int iY, int iRoom)
+/*****************************************************************************/
+{
+	struct level *stLevel;
 
-	if (strcmp (sAction, "right brace") == 0)
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	arMovingRooms[iX][iY] = iRoom;
+	stEdit.arLevelDirty[iCurLevel] = 1;
+
+	/* Change the links of the rooms around
+	 * the new room and the room itself.
+	 */
+
+	stLevel->arRoomLinks[iRoom][1] = 0;
+	stLevel->arRoomLinks[iRoom][2] = 0;
+	stLevel->arRoomLinks[iRoom][3] = 0;
+	stLevel->arRoomLinks[iRoom][4] = 0;
+
+	if ((iX >= 2) && (iX <= 24)) /*** left of added ***/
 	{
-		if (iScreen == 3)
+		if (arMovingRooms[iX - 1][iY] != 0)
 		{
-			iEventRoom = arEventsFromRoom[iCurLevel][iChangeEvent];
-			if ((iEventRoom >= 1) && (iEventRoom <= 23))
-			{
-				EventRoom (iEventRoom + 1, 0);
-			} else {
-				EventRoom (1, 0);
-			}
+			stLevel->arRoomLinks[arMovingRooms[iX - 1]
+				[iY]][2] = iRoom; /*** add room right ***/
+			stLevel->arRoomLinks[iRoom][1] = arMovingRooms[iX - 1][iY];
 		}
 	}
 
-	if (strcmp (sAction, "enter") == 0)
+	if ((iX >= 1) && (iX <= 23)) /*** right of added ***/
 	{
-		switch (iScreen)
+		if (arMovingRooms[iX + 1][iY] != 0)
 		{
-			case 1:
-				ChangePos();
-				break;
-			case 2:
-				if (arBrokenRoomLinks[iCurLevel] == 0)
-				{
-					if (iMovingRoom != 0)
-					{
-						if (arMovingRooms[iMovingNewX][iMovingNewY] == 0)
-						{
-							RemoveOldRoom();
-							AddNewRoom (iMovingNewX, iMovingNewY, iMovingRoom);
-							iChanged++;
-						}
-						iMovingRoom = 0; iMovingNewBusy = 0;
-					}
-				} else {
-					LinkPlus();
-				}
-				break;
-			case 3:
-				if (iController == 1) /*** Else it uses brackets. ***/
-				{
-					iEventRoom = arEventsToRoom[iCurLevel][iChangeEvent];
-					if ((iEventRoom >= 1) && (iEventRoom <= 23))
-					{
-						EventRoom (iEventRoom + 1, 1);
-					} else {
-						EventRoom (1, 1);
-					}
-				}
-				break;
+			stLevel->arRoomLinks[arMovingRooms[iX + 1]
+				[iY]][1] = iRoom; /*** add room left ***/
+			stLevel->arRoomLinks[iRoom][2] = arMovingRooms[iX + 1][iY];
 		}
 	}
 
-	if (strcmp (sAction, "env") == 0)
+	if ((iY >= 2) && (iY <= 24)) /*** above added ***/
 	{
-/***
-	switch (cCurType)
+		if (arMovingRooms[iX][iY - 1] != 0)
+		{
+			stLevel->arRoomLinks[arMovingRooms[iX]
+				[iY - 1]][4] = iRoom; /*** add room below ***/
+			stLevel->arRoomLinks[iRoom][3] = arMovingRooms[iX][iY - 1];
+		}
+	}
+
+	if ((iY >= 1) && (iY <= 23)) /*** below added ***/
 	{
-		case 'd': cCurType = 'p'; break;
-		case 'p': cCurType = 'd'; break;
+		if (arMovingRooms[iX][iY + 1] != 0)
+		{
+			stLevel->arRoomLinks[arMovingRooms[iX]
+				[iY + 1]][3] = iRoom; /*** add room above ***/
+			stLevel->arRoomLinks[iRoom][4] = arMovingRooms[iX][iY + 1];
+		}
 	}
-	PlaySound ("wav/extras.wav");
-***/
+
+	PlaySound ("wav/move_room.wav");
+}
+/*****************************************************************************/
+void LinkPlus (void)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	int iCurrent, iNew;
+
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	iCurrent = stLevel->arRoomLinks[iChangingBrokenRoom][iChangingBrokenSide];
+	if (iCurrent > ROOMS) /*** "?"; high links ***/
+	{
+		iNew = 0;
+	} else if (iCurrent == ROOMS) {
+		iNew = 0;
+	} else {
+		iNew = iCurrent + 1;
 	}
+	stLevel->arRoomLinks[iChangingBrokenRoom][iChangingBrokenSide] = iNew;
+	stEdit.arLevelDirty[iCurLevel] = 1;
+	iChanged++;
+	arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
+	PlaySound ("wav/hum_adj.wav");
+}
+/*****************************************************************************/
+void EventRoom (int iRoom, int iFromTo)
+/*****************************************************************************/
+{
+	struct level *stLevel;
 
-	if (strcmp (sAction, "left from") == 0)
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	switch (iFromTo)
 	{
-		if (iScreen == 3)
+		case 0: stLevel->arEventsFromRoom[iChangeEvent] = iRoom; break;
+		case 1: stLevel->arEventsToRoom[iChangeEvent] = iRoom; break;
+	}
+	PlaySound ("wav/check_box.wav");
+	stEdit.arLevelDirty[iCurLevel] = 1;
+	iChanged++;
+}
+/*****************************************************************************/
+void EventTile (int iX, int iY, int iFromTo)
+/*****************************************************************************/
+{
+	struct level *stLevel;
+	int iTile;
+
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	iTile = ((iY - 1) * 10) + iX;
+	switch (iFromTo)
+	{
+		case 0: stLevel->arEventsFromTile[iChangeEvent] = iTile; break;
+		case 1: stLevel->arEventsToTile[iChangeEvent] = iTile; break;
+	}
+	PlaySound ("wav/check_box.wav");
+	stEdit.arLevelDirty[iCurLevel] = 1;
+	iChanged++;
+}
+/*****************************************************************************/
+void ShowImage (struct img *img, int iX, int iY, char *sImageInfo)
+/*****************************************************************************/
+{
+	DrawImage (img, iX, iY, -1, TILE_NORMAL, sImageInfo);
+}
+/*****************************************************************************/
+void ShowTile (struct img *img, int iX, int iY, int iTile, int iFlags)
+/*****************************************************************************/
+{
+	if ((iFlags & TILE_HIGH) != 0)
+	{
+		DrawImage (img, iX, iY, iTile, iFlags, "high");
+	} else {
+		DrawImage (img, iX, iY, iTile, iFlags, "tile");
+	}
+}
+/*****************************************************************************/
+void DrawImage (struct img *img, int iX, int iY, int iTile, int iFlags,
+	char *sImageInfo)
+/*****************************************************************************/
+{
+	SDL_Rect dest;
+	SDL_Rect loc;
+	int iWidth, iHeight;
+	int iInfoC;
+	char arText[9 + 2][MAX_TEXT + 2];
+	int iHighNibble, iLowNibble;
+	int iTileValue;
+	int iGreen;
+	int iFlame;
+
+	iInfoC = 0;
+
+	/*** iTile is -1 for images that are not tiles. ***/
+	iTileValue = iTile;
+	if ((iFlags & TILE_HIGH) != 0) { iGreen = 2; } else { iGreen = 1; }
+	if ((iNoAnim == 0) && (iTileValue == 0x13) && (iGreen == 1))
+		{ iFlame = 1; } else { iFlame = 0; }
+
+	if (iInfo == 1)
+	{
+		snprintf (arText[0], MAX_TEXT, "0x%02x", iTileValue);
+	}
+
+	/*** Raise and drop buttons. ***/
+	if (iTileValue != -1)
+	{
+		iHighNibble = iTileValue >> 4;
+		iLowNibble = iTileValue & 0x0F; /*** 0F = 00001111 ***/
+
+		if ((iLowNibble == 0x0F) && (IsEven (iHighNibble))) /*** Raise. ***/
 		{
-			iFromTile = arEventsFromTile[iCurLevel][iChangeEvent];
-			switch (iFromTile)
+			switch (cCurType)
 			{
-				case 1: iFromTile = 10; break;
-				case 11: iFromTile = 20; break;
-				case 21: iFromTile = 30; break;
-				default: iFromTile--; break;
+				case 'd': img = imgd[0x0F][iGreen]; break;
+				case 'p': img = imgp[0x0F][iGreen]; break;
 			}
-			if (iFromTile > 20) { EventTile (iFromTile - 20, 3, 0); }
-				else if (iFromTile > 10)
-					{ EventTile (iFromTile - 10, 2, 0); }
-				else { EventTile (iFromTile, 1, 0); }
+			if (iInfo != 1)
+				{ snprintf (arText[0], MAX_TEXT, "N:%i", iHighNibble); }
+			iInfoC = 1;
+		}
+
+		if ((iLowNibble == 0x06) && (IsEven (iHighNibble))) /*** Drop. ***/
+		{
+			switch (cCurType)
+			{
+				case 'd': img = imgd[0x06][iGreen]; break;
+				case 'p': img = imgp[0x06][iGreen]; break;
+			}
+			if (iInfo != 1)
+				{ snprintf (arText[0], MAX_TEXT, "N:%i", iHighNibble); }
+			iInfoC = 1;
 		}
 	}
 
-	if (strcmp (sAction, "right from") == 0)
+	/*** Custom tile. ***/
+	if ((iTileValue != -1) && (iInfoC == 0) && (imgd[iTileValue][1] == NULL))
 	{
-		if (iScreen == 3)
-		{
-			iFromTile = arEventsFromTile[iCurLevel][iChangeEvent];
-			switch (iFromTile)
-			{
-				case 10: iFromTile = 1; break;
-				case 20: iFromTile = 11; break;
-				case 30: iFromTile = 21; break;
-				default: iFromTile++; break;
-			}
-			if (iFromTile > 20) { EventTile (iFromTile - 20, 3, 0); }
-				else if (iFromTile > 10)
-					{ EventTile (iFromTile - 10, 2, 0); }
-				else { EventTile (iFromTile, 1, 0); }
-		}
+		snprintf (arText[0], MAX_TEXT, "0x%02X", iTileValue);
+		iInfoC = 1;
 	}
 
-	if (strcmp (sAction, "up from") == 0)
+	if (iFlame == 1)
 	{
-		if (iScreen == 3)
+		switch (cCurType)
 		{
-			iFromTile = arEventsFromTile[iCurLevel][iChangeEvent];
-			if (iFromTile > 10) { iFromTile-=10; }
-				else { iFromTile+=20; }
-			if (iFromTile > 20) { EventTile (iFromTile - 20, 3, 0); }
-				else if (iFromTile > 10)
-					{ EventTile (iFromTile - 10, 2, 0); }
-				else { EventTile (iFromTile, 1, 0); }
+			case 'd': img = imgspriteflamed; break;
+			case 'p': img = imgspriteflamep; break;
 		}
 	}
-
-	if (strcmp (sAction, "down from") == 0)
+	iWidth = img->src.w;
+	iHeight = img->src.h;
+	loc = img->src;
+	dest.x = iX;
+	dest.y = iY;
+	dest.w = iWidth;
+	dest.h = iHeight;
+	if (iFlame == 1)
 	{
-		if (iScreen == 3)
+		loc.x+=(iFlameFrame - 1) * 130;
+		loc.w = loc.w / 4;
+		dest.w = dest.w / 4;
+		if (((iDrawMode == DRAW_ALL) || (iDrawMode == DRAW_LAYER)) &&
+			(iFlames < MAX_FLAMES))
 		{
-			iFromTile = arEventsFromTile[iCurLevel][iChangeEvent];
-			if (iFromTile <= 20) { iFromTile+=10; }
-				else { iFromTile-=20; }
-			if (iFromTile > 20) { EventTile (iFromTile - 20, 3, 0); }
-				else if (iFromTile > 10)
-					{ EventTile (iFromTile - 10, 2, 0); }
-				else { EventTile (iFromTile, 1, 0); }
+			iFlames++;
+			arFlames[iFlames] = dest;
 		}
 	}
+	switch (iDrawMode)
+	{
+		case DRAW_LAYER:
+			if (iSprite == 1) { return; }
+			break;
+		case DRAW_RECORD:
+			if ((iSprite == 1) && (iClips < MAX_CLIPS))
+			{
+				iClips++;
+				arClip[iClips] = dest;
+			}
+			return;
+		case DRAW_CLIP:
+			if (ClipArea (dest.x, dest.y, dest.w, dest.h) == 0) { return; }
+			break;
+	}
+	CustomRenderCopy (img->tex, &loc, &dest, sImageInfo);
+
+	/*** Info ("i"). ***/
+	if ((iTileValue != -1) && ((iInfo == 1) || (iInfoC == 1)))
+	{
+		DisplayText (dest.x, dest.y + 162 - 12 - FONT_SIZE_11,
+			FONT_SIZE_11, arText, 1, font2);
+	}
 }
 /*****************************************************************************/
-void RunLevel (int iLevel)
+void CustomRenderCopy (SDL_Texture* src, SDL_Rect* srcrect,
+	SDL_Rect *dstrect, char *sImageInfo)
 /*****************************************************************************/
 {
-	SDL_Thread *princethread;
+	SDL_Rect stuff;
+	SDL_Rect clip;
 
-	if (iDebug == 1)
+	/*** Used for looping. ***/
+	int iClipLoop;
+
+	stFrame.iCopies++;
+
+	stuff.x = dstrect->x * iScale;
+	stuff.y = dstrect->y * iScale;
+	if (srcrect != NULL) /*** image ***/
 	{
-		printf ("[  OK  ] Starting the game in level %i.\n", iLevel);
+		stuff.w = dstrect->w * iScale;
+		stuff.h = dstrect->h * iScale;
+	} else { /*** font ***/
+		stuff.w = dstrect->w;
+		stuff.h = dstrect->h;
+	}
+	if (iDrawMode != DRAW_CLIP)
+	{
+		QueueDraw (src, srcrect, &stuff, sImageInfo);
+		return;
 	}
 
-	ModifyForMednafen (iLevel);
-
-	princethread = SDL_CreateThread (StartGame, "StartGame", NULL);
-	if (princethread == NULL)
+	/*** Only copy onto the areas in arClip, such as the torches. ***/
+	FlushDraws();
+	ProfileCopy (src);
+	for (iClipLoop = 1; iClipLoop <= iClips; iClipLoop++)
 	{
-		printf ("[FAILED] Could not create thread!\n");
-		exit (EXIT_ERROR);
+		clip.x = arClip[iClipLoop].x * iScale;
+		clip.y = arClip[iClipLoop].y * iScale;
+		clip.w = arClip[iClipLoop].w * iScale;
+		clip.h = arClip[iClipLoop].h * iScale;
+		if (Overlap (&clip, &stuff) == 1)
+		{
+			SDL_RenderSetClipRect (ascreen, &clip);
+			if (SDL_RenderCopy (ascreen, src, srcrect, &stuff) != 0)
+			{
+				printf ("[ WARN ] SDL_RenderCopy (%s): %s!\n",
+					sImageInfo, SDL_GetError());
+			}
+		}
 	}
+	SDL_RenderSetClipRect (ascreen, NULL);
 }
 /*****************************************************************************/
-int StartGame (void *unused)
+void QueueDraw (SDL_Texture *img, SDL_Rect *srcrect, SDL_Rect *dstrect,
+	char *sImageInfo)
 /*****************************************************************************/
 {
-	char sSystem[200 + 2];
-	char sSound[200 + 2];
-
-	if (unused != NULL) { } /*** To prevent warnings. ***/
+	struct draw *stDraw;
 
-	PlaySound ("wav/mednafen.wav");
+	if (iDraws == MAX_DRAWS) { FlushDraws(); }
 
-	switch (iNoAudio)
+	iDraws++;
+	stDraw = &arDraws[iDraws];
+	stDraw->img = img;
+	if (srcrect != NULL)
 	{
-#if defined WIN32 || _WIN32 || WIN64 || _WIN64
-		case 0: snprintf (sSound, 200, "%s", " -sound 1"); break;
-#else
-		case 0: snprintf (sSound, 200, "%s", " -sound 1 -sounddriver sdl"); break;
-#endif
-		case 1: snprintf (sSound, 200, "%s", " -sound 0"); break;
+		stDraw->src = *srcrect;
+		stDraw->iPart = 1;
+	} else {
+		stDraw->iPart = 0;
 	}
+	stDraw->dest = *dstrect;
+	stDraw->sImageInfo = sImageInfo;
+	stDraw->iDone = 0;
+}
+/*****************************************************************************/
+void SubmitDraw (struct draw *stDraw)
+/*****************************************************************************/
+{
+	SDL_Rect *srcrect;
 
-	snprintf (sSystem, 200, "mednafen %s %s > %s",
-		sSound, sPathFile, DEVNULL);
-	if (system (sSystem) == -1)
+	if (stDraw->iPart == 1) { srcrect = &stDraw->src; } else { srcrect = NULL; }
+	ProfileCopy (stDraw->img);
+	if (SDL_RenderCopy (ascreen, stDraw->img, srcrect, &stDraw->dest) != 0)
 	{
-		printf ("[ WARN ] Could not execute mednafen!\n");
+		printf ("[ WARN ] SDL_RenderCopy (%s): %s!\n",
+			stDraw->sImageInfo, SDL_GetError());
 	}
-	if (iModified == 1) { ModifyBack(); }
-
-	return (EXIT_NORMAL);
+	stDraw->iDone = 1;
 }
 /*****************************************************************************/
-void ClearRoom (void)
+void FlushDraws (void)
 /*****************************************************************************/
 {
-	int iTileLoop;
+	SDL_Texture *img;
+	int arBlocked[MAX_BLOCKED + 2];
+	int iBlocked;
+	int iFirst;
+	int iMove;
+	struct draw *stDraw;
 
-	/*** Remove tiles. ***/
-	for (iTileLoop = 1; iTileLoop <= 30; iTileLoop++)
+	/*** Used for looping. ***/
+	int iDrawLoop;
+	int iBlockLoop;
+
+	/* Each pass submits the oldest waiting copy, and every later copy from
+	 * the same texture (usually an atlas) that does not overlap a copy that
+	 * is still waiting before it. That keeps the result of the original
+	 * order, with fewer texture switches.
+	 */
+	iFirst = 1;
+	while (iFirst <= iDraws)
 	{
-		SetLocation (iCurRoom, iTileLoop, 0x00);
+		img = arDraws[iFirst].img;
+		iBlocked = 0;
+		for (iDrawLoop = iFirst; iDrawLoop <= iDraws; iDrawLoop++)
+		{
+			stDraw = &arDraws[iDrawLoop];
+			if (stDraw->iDone == 1) { continue; }
+			iMove = 0;
+			if (stDraw->img == img)
+			{
+				iMove = 1;
+				for (iBlockLoop = 1; iBlockLoop <= iBlocked; iBlockLoop++)
+				{
+					if (Overlap (&arDraws[arBlocked[iBlockLoop]].dest,
+						&stDraw->dest) == 1) { iMove = 0; break; }
+				}
+			}
+			if (iMove == 1)
+			{
+				SubmitDraw (stDraw);
+			} else {
+				if (iBlocked == MAX_BLOCKED) { break; }
+				iBlocked++;
+				arBlocked[iBlocked] = iDrawLoop;
+			}
+		}
+		while ((iFirst <= iDraws) && (arDraws[iFirst].iDone == 1)) { iFirst++; }
 	}
-
-	/*** Remove guard. ***/
-	arGuardTile[iCurLevel][iCurRoom] = TILES + 1;
-
-	PlaySound ("wav/ok_close.wav");
-	iChanged++;
+	iDraws = 0;
 }
 /*****************************************************************************/
-void UseTile (int iTile, int iLocation, int iRoom)
+void Present (void)
 /*****************************************************************************/
 {
-	/*** Do not use iSelected in this function. ***/
+	Uint64 llNow;
+	int iDrawMode2;
 
-	/*** Random tile. ***/
-	if (iTile == -1)
+	/*** The overlay is drawn on top, and is part of the frame. ***/
+	if (iProfileHUD == 1)
 	{
-		do {
-			iTile = 1 + (int) (60.0 * rand() / (RAND_MAX + 1.0));
-		} while (Unused (iTile) == 1);
+		iDrawMode2 = iDrawMode;
+		iDrawMode = DRAW_ALL;
+		DisplayText (5, WINDOW_HEIGHT - (4 * (FONT_SIZE_11 + 4)) - 3,
+			FONT_SIZE_11, arProfileText, 4, font2);
+		iDrawMode = iDrawMode2;
 	}
+	FlushDraws();
 
-	/*** Custom tile. ***/
-	if (iTile == -2)
+	/*** Read back before presenting, which may discard the frame. ***/
+	if (strcmp (sShot, "") != 0)
 	{
-		SetLocation (iRoom, iLocation, iCustomTile);
+		Screenshot (sShot);
+		snprintf (sShot, MAX_PATHFILE, "%s", "");
 	}
 
-	/*** Make sure the disabled living can't be used. ***/
-	if ((iCurLevel != 3) && ((iTile == 65) || (iTile == 66))) { return; }
-	if ((iCurLevel != 12) && ((iTile == 67) || (iTile == 68))) { return; }
-	if ((iCurLevel != 13) && ((iTile == 69) || (iTile == 70))) { return; }
-	if (((iCurLevel == 3) || (iCurLevel == 12) || (iCurLevel == 13)) &&
-		((iTile == 63) || (iTile == 64))) { return; }
-
-	switch (iTile)
+	if (Profiling() == 0)
 	{
-		/*** Row 1. ***/
-		case 1: SetLocation (iRoom, iLocation, 0x00); break;
-		case 2: SetLocation (iRoom, iLocation, 0xE0); break;
-		case 3: SetLocation (iRoom, iLocation, 0x20); break;
-		case 4: SetLocation (iRoom, iLocation, 0x40); break;
-		case 5: SetLocation (iRoom, iLocation, 0x60); break;
-		case 6: SetLocation (iRoom, iLocation, 0x01); break;
-		case 7: SetLocation (iRoom, iLocation, 0xE1); break;
-		case 8: SetLocation (iRoom, iLocation, 0x21); break;
-		case 9: SetLocation (iRoom, iLocation, 0x1F); break;
-		case 10: SetLocation (iRoom, iLocation, 0x0E); break;
-
-		/*** Row 2. ***/
-		case 11: SetLocation (iRoom, iLocation, 0x02); break;
-		case 12: SetLocation (iRoom, iLocation, 0x12); break;
-		/***/
-		case 17: SetLocation (iRoom, iLocation, 0x17); break;
-		case 18: SetLocation (iRoom, iLocation, 0x0D); break;
-		case 19: SetLocation (iRoom, iLocation, 0x05); break;
-		/***/
+		SDL_RenderPresent (ascreen);
+		memset (&stFrame, 0, sizeof (stFrame));
+		return;
+	}
 
-		/*** Row 3. ***/
-		case 21: SetLocation (iRoom, iLocation, 0x14); break;
-		case 22: SetLocation (iRoom, iLocation, 0x34); break;
-		case 23: SetLocation (iRoom, iLocation, 0x03); break;
-		case 24: SetLocation (iRoom, iLocation, 0x08); break;
-		case 25: SetLocation (iRoom, iLocation, 0x09); break;
-		case 26: SetLocation (iRoom, iLocation, 0x10); break;
-		case 27: SetLocation (iRoom, iLocation, 0x50); break;
-		case 28: SetLocation (iRoom, iLocation, 0x11); break;
-		/***/
-		case 30: SetLocation (iRoom, iLocation, 0x13); break;
+	llNow = SDL_GetPerformanceCounter();
+	if (llPhaseStart != 0)
+		{ stFrame.arPhaseUs[iPhase]+=ProfileUs (llNow - llPhaseStart); }
+	SDL_RenderPresent (ascreen);
+	stFrame.iPresentUs = ProfileUs (SDL_GetPerformanceCounter() - llNow);
+	ProfileFrame();
 
-		/*** Row 4. ***/
-		case 31: SetLocation (iRoom, iLocation, 0x2A); break;
-		case 32: SetLocation (iRoom, iLocation, 0x4A); break;
-		case 33: SetLocation (iRoom, iLocation, 0x6A); break;
-		case 34: SetLocation (iRoom, iLocation, 0x8A); break;
-		case 35: SetLocation (iRoom, iLocation, 0xAA); break;
-		case 36: SetLocation (iRoom, iLocation, 0x0A); break;
-		/***/
-		/***/
-		case 39: SetLocation (iRoom, iLocation, 0x0B); break;
-		case 40: SetLocation (iRoom, iLocation, 0x2B); break;
+	/*** The totals are per frame. ***/
+	memset (&stFrame, 0, sizeof (stFrame));
+}
+/*****************************************************************************/
+void ProfilePhase (int iNewPhase)
+/*****************************************************************************/
+{
+	Uint64 llNow;
 
-		/*** Row 5. ***/
-		case 41: SetLocation (iRoom, iLocation, 0x16); break;
-		/***/
-		case 43: SetLocation (iRoom, iLocation, 0x44); break;
-		case 44: SetLocation (iRoom, iLocation, 0x24); break;
-		case 45: SetLocation (iRoom, iLocation, 0x0C); break;
-		case 46: SetLocation (iRoom, iLocation, 0x2C); break;
-		case 47: SetLocation (iRoom, iLocation, 0x4C); break;
-		case 48: SetLocation (iRoom, iLocation, 0x27); break;
-		case 49: SetLocation (iRoom, iLocation, 0x47); break;
-		case 50: SetLocation (iRoom, iLocation, 0x07); break;
+	if (Profiling() == 0) { return; }
 
-		/*** Row 6. ***/
-		case 51: SetLocation (iRoom, iLocation, 0x19); break;
-		case 52: SetLocation (iRoom, iLocation, 0x1A); break;
-		case 53: SetLocation (iRoom, iLocation, 0x1B); break;
-		case 54: SetLocation (iRoom, iLocation, 0x1C); break;
-		case 55: SetLocation (iRoom, iLocation, 0x1D); break;
-		case 56: SetLocation (iRoom, iLocation, 0x18); break;
-		case 57: SetLocation (iRoom, iLocation, 0x41); break;
-		case 58: SetLocation (iRoom, iLocation, 0x15); break;
-		case 59: SetLocation (iRoom, iLocation,
-			RaiseDropEvent (0x0F, iChangeEvent, 1)); break;
-		case 60: SetLocation (iRoom, iLocation,
-			RaiseDropEvent (0x06, iChangeEvent, 1)); break;
-		case 61: /*** prince, turned right ***/
-			if ((arStartLocation[iCurLevel][1] != iCurRoom) ||
-				(arStartLocation[iCurLevel][2] != iLocation) ||
-				(arStartLocation[iCurLevel][3] != 0x00))
-			{
-				arStartLocation[iCurLevel][1] = iCurRoom;
-				arStartLocation[iCurLevel][2] = iLocation;
-				arStartLocation[iCurLevel][3] = 0x00;
-				PlaySound ("wav/hum_adj.wav");
-			}
-			break;
-		case 62: /*** prince, turned left ***/
-			if ((arStartLocation[iCurLevel][1] != iCurRoom) ||
-				(arStartLocation[iCurLevel][2] != iLocation) ||
-				(arStartLocation[iCurLevel][3] != 0xFF))
-			{
-				arStartLocation[iCurLevel][1] = iCurRoom;
-				arStartLocation[iCurLevel][2] = iLocation;
-				arStartLocation[iCurLevel][3] = 0xFF;
-				PlaySound ("wav/hum_adj.wav");
-			}
-			break;
-		case 63: case 65: case 67: case 69: /*** living, turned right ***/
-			if ((arGuardTile[iCurLevel][iCurRoom] == iLocation) &&
-				(arGuardDir[iCurLevel][iCurRoom] == 0x00))
-			{
-				arGuardTile[iCurLevel][iCurRoom] = TILES + 1;
-			} else {
-				arGuardTile[iCurLevel][iCurRoom] = iLocation;
-				arGuardDir[iCurLevel][iCurRoom] = 0x00;
-				PlaySound ("wav/hum_adj.wav");
-			}
-			break;
-		case 64: case 66: case 68: case 70: /*** living, turned left ***/
-			if ((arGuardTile[iCurLevel][iCurRoom] == iLocation) &&
-				(arGuardDir[iCurLevel][iCurRoom] == 0xFF))
-			{
-				arGuardTile[iCurLevel][iCurRoom] = TILES + 1;
-			} else {
-				arGuardTile[iCurLevel][iCurRoom] = iLocation;
-				arGuardDir[iCurLevel][iCurRoom] = 0xFF;
-				PlaySound ("wav/hum_adj.wav");
-			}
-			break;
+	/*** The phase that ends keeps its time; a phase may return. ***/
+	llNow = SDL_GetPerformanceCounter();
+	if (llPhaseStart != 0)
+		{ stFrame.arPhaseUs[iPhase]+=ProfileUs (llNow - llPhaseStart); }
+	iPhase = iNewPhase;
+	llPhaseStart = llNow;
+}
+/*****************************************************************************/
+void ProfileCopy (SDL_Texture *img)
+/*****************************************************************************/
+{
+	if (img != imglastcopy)
+	{
+		stFrame.iSwitches++;
+		imglastcopy = img;
 	}
 }
 /*****************************************************************************/
-void Zoom (int iToggleFull)
+void ProfileFrame (void)
+/*****************************************************************************/
+{
+	arFrames[iFrames % PROFILE_FRAMES] = stFrame;
+	iFrames++;
+	imglastcopy = NULL;
+	llPhaseStart = 0;
+	iPhase = PHASE_OTHER;
+
+	/*** Not every frame, since new text also costs TTF renders. ***/
+	if ((iProfileHUD == 1) && ((iFrames % PROFILE_HUD_EVERY) == 0))
+		{ ProfileText(); }
+}
+/*****************************************************************************/
+void ProfileText (void)
 /*****************************************************************************/
 {
-	if (iToggleFull == 1)
+	Uint32 arTotal[PROFILE_WINDOW + 2];
+	Uint32 arPresent[PROFILE_WINDOW + 2];
+	Uint64 llTotal, llPresent;
+	int iCount;
+	struct frame *stLast;
+	SDL_RendererInfo info;
+
+	/*** Used for looping. ***/
+	int iFrameLoop;
+
+	iCount = iFrames;
+	if (iCount > PROFILE_WINDOW) { iCount = PROFILE_WINDOW; }
+	llTotal = 0;
+	llPresent = 0;
+	for (iFrameLoop = 0; iFrameLoop < iCount; iFrameLoop++)
+	{
+		stLast = &arFrames[(iFrames - 1 - iFrameLoop) % PROFILE_FRAMES];
+		arPresent[iFrameLoop] = stLast->iPresentUs;
+		arTotal[iFrameLoop] = FrameUs (stLast);
+		llTotal += arTotal[iFrameLoop];
+		llPresent += arPresent[iFrameLoop];
+	}
+	if (SDL_GetRendererInfo (ascreen, &info) != 0) { info.name = "?"; }
+	if (iCount == 0)
+	{
+		snprintf (arProfileText[0], MAX_TEXT, "%s, no frames yet", info.name);
+		snprintf (arProfileText[1], MAX_TEXT, "%s", "");
+		snprintf (arProfileText[2], MAX_TEXT, "%s", "");
+		snprintf (arProfileText[3], MAX_TEXT, "%s", "");
+		return;
+	}
+	qsort (arTotal, iCount, sizeof (Uint32), CompareTimes);
+	qsort (arPresent, iCount, sizeof (Uint32), CompareTimes);
+	stLast = &arFrames[(iFrames - 1) % PROFILE_FRAMES];
+
+	snprintf (arProfileText[0], MAX_TEXT, "%s, last %i frames (ms):",
+		info.name, iCount);
+	snprintf (arProfileText[1], MAX_TEXT,
+		"frame min %.2f avg %.2f p99 %.2f", arTotal[0] / 1000.0,
+		(llTotal / iCount) / 1000.0, Percentile (arTotal, iCount, 99) / 1000.0);
+	snprintf (arProfileText[2], MAX_TEXT,
+		"present min %.2f avg %.2f p99 %.2f", arPresent[0] / 1000.0,
+		(llPresent / iCount) / 1000.0,
+		Percentile (arPresent, iCount, 99) / 1000.0);
+	snprintf (arProfileText[3], MAX_TEXT,
+		"copies %i, switches %i, TTF %i, textures %i", stLast->iCopies,
+		stLast->iSwitches, stLast->iRenders, stLast->iCreates);
+}
+/*****************************************************************************/
+void ProfileDump (void)
+/*****************************************************************************/
+{
+	FILE *fCSV;
+	struct frame *stThis;
+	SDL_RendererInfo info;
+	int iFirst;
+
+	/*** Used for looping. ***/
+	int iFrameLoop;
+
+	if (iProfile == 0) { return; }
+
+	fCSV = fopen (sProfile, "w");
+	if (fCSV == NULL)
 	{
-		if (iFullscreen == 0)
-		{ iFullscreen = SDL_WINDOW_FULLSCREEN_DESKTOP; }
-			else { iFullscreen = 0; }
-	} else {
-		if (iFullscreen == SDL_WINDOW_FULLSCREEN_DESKTOP)
-		{
-			iFullscreen = 0;
-			iScale = 1;
-		} else if (iScale == 1) {
-			iScale = 2;
-		} else if (iScale == 2) {
-			iFullscreen = SDL_WINDOW_FULLSCREEN_DESKTOP;
-		} else {
-			printf ("[ WARN ] Unknown window state!\n");
-		}
+		printf ("[ WARN ] Could not create \"%s\": %s!\n",
+			sProfile, strerror (errno));
+		return;
+	}
+	fprintf (fCSV, "frame,screen_us,change_us,exe_us,other_us,present_us,"
+		"copies,switches,ttf_renders,texture_creates\n");
+	iFirst = 0;
+	if (iFrames > PROFILE_FRAMES) { iFirst = iFrames - PROFILE_FRAMES; }
+	for (iFrameLoop = iFirst; iFrameLoop < iFrames; iFrameLoop++)
+	{
+		stThis = &arFrames[iFrameLoop % PROFILE_FRAMES];
+		fprintf (fCSV, "%i,%lu,%lu,%lu,%lu,%lu,%i,%i,%i,%i\n", iFrameLoop + 1,
+			(unsigned long)stThis->arPhaseUs[PHASE_SCREEN],
+			(unsigned long)stThis->arPhaseUs[PHASE_CHANGE],
+			(unsigned long)stThis->arPhaseUs[PHASE_EXE],
+			(unsigned long)stThis->arPhaseUs[PHASE_OTHER],
+			(unsigned long)stThis->iPresentUs, stThis->iCopies,
+			stThis->iSwitches, stThis->iRenders, stThis->iCreates);
 	}
+	fclose (fCSV);
 
-	SDL_SetWindowFullscreen (window, iFullscreen);
-	SDL_SetWindowSize (window, (WINDOW_WIDTH) * iScale,
-		(WINDOW_HEIGHT) * iScale);
-	SDL_RenderSetLogicalSize (ascreen, (WINDOW_WIDTH) * iScale,
-		(WINDOW_HEIGHT) * iScale);
-	SDL_SetWindowPosition (window, SDL_WINDOWPOS_CENTERED,
-		SDL_WINDOWPOS_CENTERED);
-	TTF_CloseFont (font1);
-	TTF_CloseFont (font2);
-	TTF_CloseFont (font3);
-	LoadFonts();
+	if (SDL_GetRendererInfo (ascreen, &info) != 0) { info.name = "?"; }
+	printf ("[ INFO ] Wrote %i frames (renderer: %s) to \"%s\".\n",
+		iFrames - iFirst, info.name, sProfile);
 }
 /*****************************************************************************/
-void LinkMinus (void)
+Uint32 ProfileUs (Uint64 llTicks)
 /*****************************************************************************/
 {
-	int iCurrent, iNew;
+	return ((Uint32)((llTicks * 1000000) / SDL_GetPerformanceFrequency()));
+}
+/*****************************************************************************/
+int CompareTimes (const void *vA, const void *vB)
+/*****************************************************************************/
+{
+	Uint32 iA, iB;
 
-	iCurrent = arRoomLinks[iCurLevel][iChangingBrokenRoom][iChangingBrokenSide];
-	if (iCurrent > ROOMS) /*** "?"; high links ***/
+	iA = *(const Uint32 *)vA;
+	iB = *(const Uint32 *)vB;
+	if (iA < iB) { return (-1); }
+	if (iA > iB) { return (1); }
+
+	return (0);
+}
+/*****************************************************************************/
+int Profiling (void)
+/*****************************************************************************/
+{
+	if ((iProfile == 1) || (iProfileHUD == 1) || (iReplay != 0))
+		{ return (1); }
+
+	return (0);
+}
+/*****************************************************************************/
+Uint32 FrameUs (struct frame *stThis)
+/*****************************************************************************/
+{
+	Uint32 iUs;
+
+	/*** Used for looping. ***/
+	int iPhaseLoop;
+
+	iUs = stThis->iPresentUs;
+	for (iPhaseLoop = 0; iPhaseLoop < PHASES; iPhaseLoop++)
+		{ iUs+=stThis->arPhaseUs[iPhaseLoop]; }
+
+	return (iUs);
+}
+/*****************************************************************************/
+Uint32 Percentile (Uint32 *arSorted, int iCount, int iPercent)
+/*****************************************************************************/
+{
+	int iIndex;
+
+	iIndex = (iCount * iPercent) / 100;
+	if (iIndex > iCount - 1) { iIndex = iCount - 1; }
+
+	return (arSorted[iIndex]);
+}
+/*****************************************************************************/
+void RecordOpen (char *sFile)
+/*****************************************************************************/
+{
+	struct recordhead stHead;
+
+	fRecord = fopen (sFile, "wb");
+	if (fRecord == NULL)
 	{
-		iNew = 0;
-	} else if (iCurrent == 0) {
-		iNew = ROOMS;
-	} else {
-		iNew = iCurrent - 1;
+		printf ("[FAILED] Could not open \"%s\": %s!\n",
+			sFile, strerror (errno));
+		exit (EXIT_ERROR);
+	}
+
+	/*** The replay starts from the same ROM, level, zoom and animations. ***/
+	memset (&stHead, 0, sizeof (stHead));
+	memcpy (stHead.sMagic, RECORD_MAGIC, RECORD_MAGIC_SIZE);
+	stHead.iVersion = RECORD_VERSION;
+	stHead.iOrder = SNAPSHOT_ORDER;
+	stHead.iEventSize = sizeof (SDL_Event);
+	stHead.iScale = iScale;
+	stHead.iStartLevel = iStartLevel;
+	stHead.iNoAnim = iNoAnim;
+	stHead.llROMHash = HashBytes (stEdit.sROM, stEdit.iROMSize);
+	if (fwrite (&stHead, sizeof (stHead), 1, fRecord) != 1)
+	{
+		printf ("[FAILED] Could not write to \"%s\": %s!\n",
+			sFile, strerror (errno));
+		exit (EXIT_ERROR);
 	}
-	arRoomLinks[iCurLevel][iChangingBrokenRoom][iChangingBrokenSide] = iNew;
-	iChanged++;
-	arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
-	PlaySound ("wav/hum_adj.wav");
 }
 /*****************************************************************************/
-int BrokenRoomLinks (int iPrint)
+void ReplayLoad (char *sFile)
 /*****************************************************************************/
 {
-	int iBroken;
-	int iRoomLoop;
+	FILE *fIn;
+	struct recordhead stHead;
+	long lSize;
 
-	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+	fIn = fopen (sFile, "rb");
+	if (fIn == NULL)
 	{
-		arDone[iRoomLoop] = 0;
-		arRoomConnectionsBroken[iCurLevel][iRoomLoop][1] = 0;
-		arRoomConnectionsBroken[iCurLevel][iRoomLoop][2] = 0;
-		arRoomConnectionsBroken[iCurLevel][iRoomLoop][3] = 0;
-		arRoomConnectionsBroken[iCurLevel][iRoomLoop][4] = 0;
+		printf ("[FAILED] Could not open \"%s\": %s!\n",
+			sFile, strerror (errno));
+		exit (EXIT_ERROR);
+	}
+	if ((fread (&stHead, sizeof (stHead), 1, fIn) != 1) ||
+		(memcmp (stHead.sMagic, RECORD_MAGIC, RECORD_MAGIC_SIZE) != 0) ||
+		(stHead.iVersion != RECORD_VERSION) ||
+		(stHead.iOrder != SNAPSHOT_ORDER) ||
+		(stHead.iEventSize != (int)sizeof (SDL_Event)))
+	{
+		printf ("[FAILED] \"%s\" is not a recording of this version!\n", sFile);
+		exit (EXIT_ERROR);
+	}
+	if (stHead.llROMHash != HashBytes (stEdit.sROM, stEdit.iROMSize))
+	{
+		printf ("[ WARN ] \"%s\" was recorded with another ROM!\n", sFile);
 	}
-	CheckSides (arStartLocation[iCurLevel][1], 0, 0);
-	iBroken = 0;
 
-	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+	/*** The events are read at once; reading must not be timed. ***/
+	fseek (fIn, 0, SEEK_END);
+	lSize = ftell (fIn) - (long)sizeof (stHead);
+	fseek (fIn, sizeof (stHead), SEEK_SET);
+	iReplayEvents = lSize / (long)sizeof (struct recorded);
+	arReplay = malloc ((iReplayEvents + 1) * sizeof (struct recorded));
+	if (arReplay == NULL)
 	{
-		/*** If the room is in use... ***/
-		if (arDone[iRoomLoop] == 1)
-		{
-			/*** check left ***/
-			if (arRoomLinks[iCurLevel][iRoomLoop][1] != 0)
-			{
-				if ((arRoomLinks[iCurLevel][iRoomLoop][1] == iRoomLoop) ||
-					(arRoomLinks[iCurLevel][arRoomLinks[iCurLevel][iRoomLoop][1]][2]
-					!= iRoomLoop) ||
-					(arRoomLinks[iCurLevel][iRoomLoop][1] > ROOMS))
-				{
-					arRoomConnectionsBroken[iCurLevel][iRoomLoop][1] = 1;
-					iBroken = 1;
-					if ((iDebug == 1) && (iPrint == 1))
-					{
-						printf ("[ INFO ] The left of room %i has a broken link.\n",
-							iRoomLoop);
-					}
-				}
-			}
-			/*** check right ***/
-			if (arRoomLinks[iCurLevel][iRoomLoop][2] != 0)
-			{
-				if ((arRoomLinks[iCurLevel][iRoomLoop][2] == iRoomLoop) ||
-					(arRoomLinks[iCurLevel][arRoomLinks[iCurLevel][iRoomLoop][2]][1]
-					!= iRoomLoop) ||
-					(arRoomLinks[iCurLevel][iRoomLoop][2] > ROOMS))
-				{
-					arRoomConnectionsBroken[iCurLevel][iRoomLoop][2] = 1;
-					iBroken = 1;
-					if ((iDebug == 1) && (iPrint == 1))
-					{
-						printf ("[ INFO ] The right of room %i has a broken link.\n",
-							iRoomLoop);
-					}
-				}
-			}
-			/*** check up ***/
-			if (arRoomLinks[iCurLevel][iRoomLoop][3] != 0)
-			{
-				if ((arRoomLinks[iCurLevel][iRoomLoop][3] == iRoomLoop) ||
-					(arRoomLinks[iCurLevel][arRoomLinks[iCurLevel][iRoomLoop][3]][4]
-					!= iRoomLoop) ||
-					(arRoomLinks[iCurLevel][iRoomLoop][3] > ROOMS))
-				{
-					arRoomConnectionsBroken[iCurLevel][iRoomLoop][3] = 1;
-					iBroken = 1;
-					if ((iDebug == 1) && (iPrint == 1))
-					{
-						printf ("[ INFO ] The top of room %i has a broken link.\n",
-							iRoomLoop);
-					}
-				}
-			}
-			/*** check down ***/
-			if (arRoomLinks[iCurLevel][iRoomLoop][4] != 0)
-			{
-				if ((arRoomLinks[iCurLevel][iRoomLoop][4] == iRoomLoop) ||
-					(arRoomLinks[iCurLevel][arRoomLinks[iCurLevel][iRoomLoop][4]][3]
-					!= iRoomLoop) ||
-					(arRoomLinks[iCurLevel][iRoomLoop][4] > ROOMS))
-				{
-					arRoomConnectionsBroken[iCurLevel][iRoomLoop][4] = 1;
-					iBroken = 1;
-					if ((iDebug == 1) && (iPrint == 1))
-					{
-						printf ("[ INFO ] The bottom of room %i has a broken link.\n",
-							iRoomLoop);
-					}
-				}
-			}
-		}
+		printf ("[FAILED] Could not allocate %li bytes!\n", lSize);
+		exit (EXIT_ERROR);
 	}
+	if ((int)fread (arReplay, sizeof (struct recorded), iReplayEvents, fIn) !=
+		iReplayEvents)
+	{
+		printf ("[FAILED] Could not read from \"%s\"!\n", sFile);
+		exit (EXIT_ERROR);
+	}
+	fclose (fIn);
 
-	return (iBroken);
+	iScale = stHead.iScale;
+	iStartLevel = stHead.iStartLevel;
+	iNoAnim = stHead.iNoAnim;
+	if (iRealTime == 1) { iReplay = REPLAY_REAL; } else { iReplay = REPLAY_FAST; }
+	iReplayNext = 0;
+	iShiftHeld = 0;
 }
 /*****************************************************************************/
-void ChangeEvent (int iAmount, int iChangePos)
+void InputStart (void)
 /*****************************************************************************/
 {
-	int iTile;
-	int iHighNibble, iLowNibble;
+	iRecordStart = SDL_GetTicks();
+	iReplayWall = SDL_GetTicks();
+	iReplayClock = 0;
+	llReplayStart = SDL_GetPerformanceCounter();
+}
+/*****************************************************************************/
+int PollEvent (SDL_Event *event)
+/*****************************************************************************/
+{
+	struct recorded stRec;
 
-	if (((iAmount > 0) && (iChangeEvent != arNrEvents[iCurLevel])) ||
-		((iAmount < 0) && (iChangeEvent > 1)))
+	if (iReplay == 0)
 	{
-		/*** Modify the event number. ***/
-		iChangeEvent+=iAmount;
-		if (iChangeEvent < 1) { iChangeEvent = 1; }
-		if (iChangeEvent > arNrEvents[iCurLevel])
-			{ iChangeEvent = arNrEvents[iCurLevel]; }
-
-		/*** Apply the event number to the selected tile. ***/
-		if (iChangePos == 1)
+		if (SDL_PollEvent (event) == 0) { return (0); }
+		if ((event->type == SDL_USEREVENT) &&
+			(event->user.code == EVENT_GAME_DONE))
 		{
-			iTile = arRoomTiles[iCurLevel][iCurRoom][iSelected];
-			iHighNibble = iTile >> 4;
-			iLowNibble = iTile & 0x0F; /*** 0F = 00001111 ***/
-			if ((iLowNibble == 0x0F) && (IsEven (iHighNibble))) /*** Raise. ***/
-			{
-				arRoomTiles[iCurLevel][iCurRoom][iSelected] =
-					RaiseDropEvent (0x0F, iChangeEvent, iAmount);
-				iChanged++;
-			}
-			if ((iLowNibble == 0x06) && (IsEven (iHighNibble))) /*** Drop. ***/
+			if (iModified == 1) { ModifyBack(); }
+			return (1); /*** Not recorded; a replay starts no games. ***/
+		}
+		if (fRecord != NULL)
+		{
+			memset (&stRec, 0, sizeof (stRec));
+			stRec.iTicks = SDL_GetTicks() - iRecordStart;
+			stRec.event = *event;
+			if (fwrite (&stRec, sizeof (stRec), 1, fRecord) != 1)
 			{
-				arRoomTiles[iCurLevel][iCurRoom][iSelected] =
-					RaiseDropEvent (0x06, iChangeEvent, iAmount);
-				iChanged++;
+				printf ("[ WARN ] Could not write to \"%s\": %s!\n",
+					sRecord, strerror (errno));
+				fclose (fRecord);
+				fRecord = NULL;
 			}
 		}
+		return (1);
+	}
 
-		PlaySound ("wav/plus_minus.wav");
+	/*** Real input is dropped; only quitting and lost textures matter. ***/
+	while (SDL_PollEvent (event) == 1)
+	{
+		if (event->type == SDL_QUIT) { ReplayEnd(); }
+		if (event->type == SDL_RENDER_TARGETS_RESET) { return (1); }
+	}
+
+	if (iReplayNext == iReplayEvents) { ReplayEnd(); }
+	if (arReplay[iReplayNext].iTicks > iReplayClock) { return (0); }
+	*event = arReplay[iReplayNext].event;
+	iReplayNext++;
+
+	/*** For ShiftHeld(); there is no keyboard to ask. ***/
+	if ((event->type == SDL_KEYDOWN) || (event->type == SDL_KEYUP))
+	{
+		if ((event->key.keysym.mod & KMOD_SHIFT) != 0)
+			{ iShiftHeld = 1; } else { iShiftHeld = 0; }
 	}
+
+	return (1);
 }
 /*****************************************************************************/
-void ChangeCustom (int iAmount)
+void WaitEvent (int iTimeout)
 /*****************************************************************************/
 {
-	if (((iAmount > 0) && (iCustomTile < 0xFF)) ||
-		((iAmount < 0) && (iCustomTile > 0x00)))
+	Uint32 iTarget;
+	Uint32 iNow;
+
+	/*** iTimeout is -1 to wait for input only. ***/
+	if (iReplay == 0)
 	{
-		/*** Modify the custom tile. ***/
-		iCustomTile+=iAmount;
-		if (iCustomTile < 0x00) { iCustomTile = 0x00; }
-		if (iCustomTile > 0xFF) { iCustomTile = 0xFF; }
+		if (iTimeout < 0)
+		{
+			SDL_WaitEvent (NULL);
+		} else {
+			SDL_WaitEventTimeout (NULL, iTimeout);
+		}
+		return;
+	}
 
-		PlaySound ("wav/plus_minus.wav");
+	/*** The replay clock jumps to the next event, or to the timeout. ***/
+	if (iReplayNext == iReplayEvents) { return; }
+	iTarget = arReplay[iReplayNext].iTicks;
+	if ((iTimeout >= 0) && (iReplayClock + iTimeout < iTarget))
+		{ iTarget = iReplayClock + iTimeout; }
+	if (iTarget < iReplayClock) { iTarget = iReplayClock; }
+	if (iReplay == REPLAY_REAL)
+	{
+		iNow = SDL_GetTicks() - iReplayWall;
+		if (iTarget > iNow) { SDL_Delay (iTarget - iNow); }
 	}
+	iReplayClock = iTarget;
 }
 /*****************************************************************************/
-void Prev (void)
+Uint32 Ticks (void)
 /*****************************************************************************/
 {
-	if (iCurLevel != 1)
-	{
-		iCurLevel--;
-		LoadLevels(); iChanged = 0; /*** Both are to discard changes. ***/
-		iCurRoom = arStartLocation[iCurLevel][1];
-		iChangeEvent = 1;
-		PlaySound ("wav/level_change.wav");
+	/*** A replay has its own clock, so that it times out the same way. ***/
+	if (iReplay != 0) { return (iReplayClock); }
+
+	return (SDL_GetTicks());
+}
+/*****************************************************************************/
+int ShiftHeld (void)
+/*****************************************************************************/
+{
+	const Uint8 *keystate;
+
+	if (iReplay != 0) { return (iShiftHeld); }
+
+	keystate = SDL_GetKeyboardState (NULL);
+	if ((keystate[SDL_SCANCODE_LSHIFT]) || (keystate[SDL_SCANCODE_RSHIFT]))
+		{ return (1); }
+
+	return (0);
+}
+/*****************************************************************************/
+void ReplayEnd (void)
+/*****************************************************************************/
+{
+	Uint64 llWall;
+	Uint32 *arTimes;
+	int iCount;
+	int iFirst;
+
+	/*** Used for looping. ***/
+	int iFrameLoop;
+
+	llWall = SDL_GetPerformanceCounter() - llReplayStart;
+	iFirst = 0;
+	if (iFrames > PROFILE_FRAMES) { iFirst = iFrames - PROFILE_FRAMES; }
+	iCount = iFrames - iFirst;
+	printf ("[ INFO ] Replayed %i of %i events in %.3f s; %i frames.\n",
+		iReplayNext, iReplayEvents,
+		(double)llWall / SDL_GetPerformanceFrequency(), iFrames);
+	if (iCount != 0)
+	{
+		arTimes = malloc (iCount * sizeof (Uint32));
+		if (arTimes == NULL)
+		{
+			printf ("[FAILED] Could not allocate %i bytes!\n",
+				(int)(iCount * sizeof (Uint32)));
+			exit (EXIT_ERROR);
+		}
+		for (iFrameLoop = 0; iFrameLoop < iCount; iFrameLoop++)
+		{
+			arTimes[iFrameLoop] =
+				FrameUs (&arFrames[(iFirst + iFrameLoop) % PROFILE_FRAMES]);
+		}
+		qsort (arTimes, iCount, sizeof (Uint32), CompareTimes);
+		printf ("[ INFO ] Frame ms: p50 %.2f, p90 %.2f, p99 %.2f, max %.2f.\n",
+			Percentile (arTimes, iCount, 50) / 1000.0,
+			Percentile (arTimes, iCount, 90) / 1000.0,
+			Percentile (arTimes, iCount, 99) / 1000.0,
+			arTimes[iCount - 1] / 1000.0);
+		free (arTimes);
 	}
+
+	/*** Nothing is saved; see CallSave(). ***/
+	ProfileDump();
+	free (arReplay);
+	ROMUnload();
+	TTF_Quit();
+	SDL_Quit();
+	exit (EXIT_NORMAL);
 }
 /*****************************************************************************/
-void Next (void)
+void Screenshot (char *sFile)
 /*****************************************************************************/
 {
-	if (iCurLevel != LEVELS)
+	SDL_Surface *shot;
+
+	/*** Any renderer; not only the offscreen one. ***/
+	shot = SDL_CreateRGBSurfaceWithFormat (0, (WINDOW_WIDTH) * iScale,
+		(WINDOW_HEIGHT) * iScale, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (shot == NULL)
+	{
+		printf ("[FAILED] Unable to create a surface: %s!\n", SDL_GetError());
+		exit (EXIT_ERROR);
+	}
+	if (SDL_RenderReadPixels (ascreen, NULL, SDL_PIXELFORMAT_ARGB8888,
+		shot->pixels, shot->pitch) != 0)
+	{
+		printf ("[FAILED] Could not read the pixels: %s!\n", SDL_GetError());
+		exit (EXIT_ERROR);
+	}
+	if (IMG_SavePNG (shot, sFile) != 0)
 	{
-		iCurLevel++;
-		LoadLevels(); iChanged = 0; /*** Both are to discard changes. ***/
-		iCurRoom = arStartLocation[iCurLevel][1];
-		iChangeEvent = 1;
-		PlaySound ("wav/level_change.wav");
+		printf ("[FAILED] Could not write \"%s\": %s!\n",
+			sFile, IMG_GetError());
+		exit (EXIT_ERROR);
 	}
+	SDL_FreeSurface (shot);
+	iShots++;
+	if (iDebug == 1) { printf ("[  OK  ] Wrote \"%s\".\n", sFile); }
 }
 /*****************************************************************************/
-void CallSave (void)
-/*****************************************************************************/
-{
-	CreateBAK();
-	SaveLevels();
-}
-/*****************************************************************************/
-void Sprinkle (void)
+void Screenshots (void)
 /*****************************************************************************/
 {
-	int iRandom;
+	char sFile[MAX_PATHFILE + 2];
 
 	/*** Used for looping. ***/
+	int iLevelLoop;
 	int iRoomLoop;
-	int iTileLoop;
 
-	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+	iShots = 0;
+	if (strcmp (sScreenshot, "") != 0)
 	{
-		for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-		{
-			/*** space? add wall shadow ***/
-			if ((arRoomTiles[iCurLevel][iRoomLoop][iTileLoop] == 0x00) ||
-				(arRoomTiles[iCurLevel][iRoomLoop][iTileLoop] == 0xE0))
-			{
-				/*** 1-4 ***/
-				iRandom = 1 + (int) (4.0 * rand() / (RAND_MAX + 1.0));
-				switch (iRandom)
-				{
-					case 1: arRoomTiles[iCurLevel][iRoomLoop][iTileLoop] = 0x20; break;
-					case 2: arRoomTiles[iCurLevel][iRoomLoop][iTileLoop] = 0x40; break;
-				}
-			}
+		if (iShotRoom != 0) { iCurRoom = iShotRoom; }
+		ShotScreen (iShotScreen, sScreenshot);
+	}
 
-			/*** empty floor? add wall shadow, rubble, torch, skeleton ***/
-			if ((arRoomTiles[iCurLevel][iRoomLoop][iTileLoop] == 0x01) ||
-				(arRoomTiles[iCurLevel][iRoomLoop][iTileLoop] == 0xE1))
+	/*** Every room of every level, then the other screens per level. ***/
+	if (strcmp (sScreenshots, "") != 0)
+	{
+		for (iLevelLoop = 1; iLevelLoop <= LEVELS; iLevelLoop++)
+		{
+			iCurLevel = iLevelLoop;
+			iChangeEvent = 1;
+			for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
 			{
-				/*** 1-8 ***/
-				iRandom = 1 + (int) (8.0 * rand() / (RAND_MAX + 1.0));
-				switch (iRandom)
-				{
-					case 1: arRoomTiles[iCurLevel][iRoomLoop][iTileLoop] = 0x21; break;
-					case 2: arRoomTiles[iCurLevel][iRoomLoop][iTileLoop] = 0x0E; break;
-					case 3: arRoomTiles[iCurLevel][iRoomLoop][iTileLoop] = 0x13; break;
-					case 4: arRoomTiles[iCurLevel][iRoomLoop][iTileLoop] = 0x15; break;
-				}
+				iCurRoom = iRoomLoop;
+				if (snprintf (sFile, MAX_PATHFILE, "%s%slevel%02i_room%02i.png",
+					sScreenshots, SLASH, iLevelLoop, iRoomLoop) >= MAX_PATHFILE)
+					{ ShotTooLong (sScreenshots); }
+				ShotScreen (SHOT_MAIN, sFile);
 			}
-		}
-	}
+			iCurRoom = stEdit.stRom.arLevel[iCurLevel].arStartLocation[1];
+			if (snprintf (sFile, MAX_PATHFILE, "%s%slevel%02i_links.png",
+				sScreenshots, SLASH, iLevelLoop) >= MAX_PATHFILE)
+				{ ShotTooLong (sScreenshots); }
+			ShotScreen (SHOT_LINKS, sFile);
+			if (snprintf (sFile, MAX_PATHFILE, "%s%slevel%02i_events.png",
+				sScreenshots, SLASH, iLevelLoop) >= MAX_PATHFILE)
+				{ ShotTooLong (sScreenshots); }
+			ShotScreen (SHOT_EVENTS, sFile);
+			if (snprintf (sFile, MAX_PATHFILE, "%s%slevel%02i_tiles.png",
+				sScreenshots, SLASH, iLevelLoop) >= MAX_PATHFILE)
+				{ ShotTooLong (sScreenshots); }
+			ShotScreen (SHOT_TILES, sFile);
+		}
+		if (snprintf (sFile, MAX_PATHFILE, "%s%sexe.png", sScreenshots,
+			SLASH) >= MAX_PATHFILE) { ShotTooLong (sScreenshots); }
+		ShotScreen (SHOT_EXE, sFile);
+	}
+
+	printf ("[  OK  ] Wrote %i screenshot(s).\n", iShots);
+	ProfileDump();
+	ROMUnload();
+	TTF_Quit();
+	SDL_Quit();
+	exit (EXIT_NORMAL);
 }
 /*****************************************************************************/
-void SetLocation (int iRoom, int iLocation, int iTile)
+void ShotTooLong (char *sDir)
 /*****************************************************************************/
 {
-	arRoomTiles[iCurLevel][iRoom][iLocation] = iTile;
-	iLastTile = iTile;
+	/*** Rather than writing PNGs under cut-off names. ***/
+	printf ("[FAILED] The path \"%s\" is too long for screenshots!\n", sDir);
+	exit (EXIT_ERROR);
 }
 /*****************************************************************************/
-void FlipRoom (int iAxis)
+void ShotScreen (int iScreenShot, char *sFile)
 /*****************************************************************************/
 {
-	unsigned char arRoomTilesTemp[TILES + 2];
-	int iTileUse;
-	int iTile;
-
-	/*** Used for looping. ***/
-	int iTileLoop;
-
-	/*** Storing tiles for later use. ***/
-	for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
+	/*** The same drawing code as in the editor; Present() saves it. ***/
+	switch (iScreenShot)
 	{
-		arRoomTilesTemp[iTileLoop] = arRoomTiles[iCurLevel][iCurRoom][iTileLoop];
+		case SHOT_MAIN: iScreen = 1; break;
+		case SHOT_LINKS: iScreen = 2; break;
+		case SHOT_EVENTS: iScreen = 3; break;
+		default: iScreen = 1; break;
 	}
-
-	if (iAxis == 1) /*** horizontal ***/
+	switch (iScreenShot)
 	{
-		/*** tiles ***/
-		for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-		{
-			iTileUse = 0; /*** To prevent warnings. ***/
-			if ((iTileLoop >= 1) && (iTileLoop <= 10))
-				{ iTileUse = 11 - iTileLoop; }
-			if ((iTileLoop >= 11) && (iTileLoop <= 20))
-				{ iTileUse = 31 - iTileLoop; }
-			if ((iTileLoop >= 21) && (iTileLoop <= 30))
-				{ iTileUse = 51 - iTileLoop; }
-			arRoomTiles[iCurLevel][iCurRoom][iTileLoop] = arRoomTilesTemp[iTileUse];
-		}
-
-		/*** prince ***/
-		if (arStartLocation[iCurLevel][1] == iCurRoom)
-		{
-			/*** direction ***/
-			if (arStartLocation[iCurLevel][3] == 0x00)
-				{ arStartLocation[iCurLevel][3] = 0xFF; }
-					else { arStartLocation[iCurLevel][3] = 0x00; }
-			/*** tile ***/
-			iTile = arStartLocation[iCurLevel][2];
-			if ((iTile >= 1) && (iTile <= 10))
-				{ arStartLocation[iCurLevel][2] = 11 - iTile; }
-			if ((iTile >= 11) && (iTile <= 20))
-				{ arStartLocation[iCurLevel][2] = 31 - iTile; }
-			if ((iTile >= 21) && (iTile <= 30))
-				{ arStartLocation[iCurLevel][2] = 51 - iTile; }
-		}
-
-		/*** guard ***/
-		if (arGuardTile[iCurLevel][iCurRoom] <= TILES + 1)
-		{
-			/*** direction ***/
-			if (arGuardDir[iCurLevel][iCurRoom] == 0x00)
-				{ arGuardDir[iCurLevel][iCurRoom] = 0xFF; }
-					else { arGuardDir[iCurLevel][iCurRoom] = 0x00; }
-			/*** tile ***/
-			iTile = arGuardTile[iCurLevel][iCurRoom];
-			if ((iTile >= 1) && (iTile <= 10))
-				{ arGuardTile[iCurLevel][iCurRoom] = 11 - iTile; }
-			if ((iTile >= 11) && (iTile <= 20))
-				{ arGuardTile[iCurLevel][iCurRoom] = 31 - iTile; }
-			if ((iTile >= 21) && (iTile <= 30))
-				{ arGuardTile[iCurLevel][iCurRoom] = 51 - iTile; }
-		}
-	} else { /*** vertical ***/
-		/*** tiles ***/
-		for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-		{
-			iTileUse = 0; /*** To prevent warnings. ***/
-			if ((iTileLoop >= 1) && (iTileLoop <= 10))
-				{ iTileUse = iTileLoop + 20; }
-			if ((iTileLoop >= 11) && (iTileLoop <= 20))
-				{ iTileUse = iTileLoop; }
-			if ((iTileLoop >= 21) && (iTileLoop <= 30))
-				{ iTileUse = iTileLoop - 20; }
-			arRoomTiles[iCurLevel][iCurRoom][iTileLoop] =
-				arRoomTilesTemp[iTileUse];
-		}
-
-		/*** prince ***/
-		if (arStartLocation[iCurLevel][1] == iCurRoom)
-		{
-			/*** tile ***/
-			iTile = arStartLocation[iCurLevel][2];
-			if ((iTile >= 1) && (iTile <= 10))
-				{ arStartLocation[iCurLevel][2] = iTile + 20; }
-			if ((iTile >= 21) && (iTile <= 30))
-				{ arStartLocation[iCurLevel][2] = iTile - 20; }
-		}
-
-		/*** guard ***/
-		if (arGuardTile[iCurLevel][iCurRoom] <= TILES + 1)
-		{
-			/*** tile ***/
-			iTile = arGuardTile[iCurLevel][iCurRoom];
-			if ((iTile >= 1) && (iTile <= 10))
-				{ arGuardTile[iCurLevel][iCurRoom] = iTile + 20; }
-			if ((iTile >= 21) && (iTile <= 30))
-				{ arGuardTile[iCurLevel][iCurRoom] = iTile - 20; }
-		}
+		case SHOT_TILES:
+			ShowScreen(); /*** Sets cCurType. ***/
+			snprintf (sShot, MAX_PATHFILE + 2, "%s", sFile);
+			ShowChange();
+			break;
+		case SHOT_EXE:
+			EXELoad();
+			snprintf (sShot, MAX_PATHFILE + 2, "%s", sFile);
+			ShowEXE();
+			break;
+		default:
+			snprintf (sShot, MAX_PATHFILE + 2, "%s", sFile);
+			ShowScreen();
+			break;
 	}
+	iScreen = 1;
 }
 /*****************************************************************************/
-void CopyPaste (int iAction)
+int Overlap (SDL_Rect *stA, SDL_Rect *stB)
 /*****************************************************************************/
 {
-	/*** Used for looping. ***/
-	int iTileLoop;
+	if ((stA->x >= stB->x + stB->w) || (stB->x >= stA->x + stA->w) ||
+		(stA->y >= stB->y + stB->h) || (stB->y >= stA->y + stA->h))
+		{ return (0); }
 
-	if (iAction == 1) /*** copy ***/
-	{
-		for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-		{
-			arCopyPasteTile[iTileLoop] = arRoomTiles[iCurLevel][iCurRoom][iTileLoop];
-		}
-		cCopyPasteGuardTile = arGuardTile[iCurLevel][iCurRoom];
-		cCopyPasteGuardDir = arGuardDir[iCurLevel][iCurRoom];
-		iCopied = 1;
-	} else { /*** paste ***/
-		if (iCopied == 1)
-		{
-			for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-			{
-				arRoomTiles[iCurLevel][iCurRoom][iTileLoop] =
-					arCopyPasteTile[iTileLoop];
-			}
-			arGuardTile[iCurLevel][iCurRoom] = cCopyPasteGuardTile;
-			arGuardDir[iCurLevel][iCurRoom] = cCopyPasteGuardDir;
-		} else {
-			for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-			{
-				arRoomTiles[iCurLevel][iCurRoom][iTileLoop] = 0x00;
-			}
-			arGuardTile[iCurLevel][iCurRoom] = TILES + 1;
-		}
-	}
+	return (1);
 }
 /*****************************************************************************/
-int InArea (int iUpperLeftX, int iUpperLeftY,
-	int iLowerRightX, int iLowerRightY)
+int ClipArea (int iX, int iY, int iW, int iH)
 /*****************************************************************************/
 {
-	if ((iUpperLeftX * iScale <= iXPos) &&
-		(iLowerRightX * iScale >= iXPos) &&
-		(iUpperLeftY * iScale <= iYPos) &&
-		(iLowerRightY * iScale >= iYPos))
+	SDL_Rect area;
+
+	/*** Used for looping. ***/
+	int iClipLoop;
+
+	if (iDrawMode != DRAW_CLIP) { return (1); }
+
+	area.x = iX;
+	area.y = iY;
+	area.w = iW;
+	area.h = iH;
+	for (iClipLoop = 1; iClipLoop <= iClips; iClipLoop++)
 	{
-		return (1);
-	} else {
-		return (0);
+		if (Overlap (&arClip[iClipLoop], &area) == 1) { return (1); }
 	}
+
+	return (0);
 }
 /*****************************************************************************/
-int MouseSelectAdj (void)
+void CreateBAK (void)
 /*****************************************************************************/
 {
-	/* On the broken room links screen, if you click one of the adjacent
-	 * rooms, this function sets iOnAdj to 1, and also sets both
-	 * iChangingBrokenRoom and iChangingBrokenSide.
+	char arBackups[BACKUPS_MAX + 2][MAX_PATHFILE + 2];
+	int iBackups;
+	char sBackup[MAX_PATHFILE + 2];
+	char sTime[MAX_TEXT + 2];
+	char sName[MAX_PATHFILE + 2];
+	unsigned long long llHash;
+	unsigned char *sDisk;
+	unsigned char *sOld;
+	struct stat stStat;
+	int iSize;
+	int iFd;
+	int iFdROM;
+	int iDone;
+	int iNumber;
+	time_t tm;
+#ifdef COPY_FILE_RANGE
+	loff_t llIn, llOut;
+	ssize_t iMoved;
+#endif
+
+	/*** Used for looping. ***/
+	int iBackupLoop;
+
+	/* The backup is of the ROM as it is on disk, not of the image, since
+	 * the file may have been changed outside the editor.
 	 */
+	iFdROM = open (stEdit.sPathFile, O_RDONLY|O_BINARY);
+	if ((iFdROM == -1) || (fstat (iFdROM, &stStat) == -1))
+	{
+		printf ("[ WARN ] Could not open \"%s\": %s!\n",
+			stEdit.sPathFile, strerror (errno));
+		if (iFdROM != -1) { close (iFdROM); }
+		return;
+	}
+	iSize = stStat.st_size;
+	sDisk = malloc (iSize + 1);
+	if ((sDisk == NULL) || (read (iFdROM, sDisk, iSize) != iSize))
+	{
+		printf ("[ WARN ] Could not read from \"%s\": %s!\n",
+			stEdit.sPathFile, strerror (errno));
+		free (sDisk);
+		close (iFdROM);
+		return;
+	}
 
-	int iOnAdj;
-	int iRoomLoop;
-	int iAdjBaseX;
-	int iAdjBaseY;
+	/*** Keep the ROM as it was before the first save; patches use it. ***/
+	snprintf (sBackup, MAX_PATHFILE, "%s%s%s", ROM_DIR, SLASH, BACKUP_ORIGINAL);
+	if (access (sBackup, F_OK) == -1)
+	{
+		if ((WriteBytes (sBackup, sDisk, iSize) == 1) && (iDebug == 1))
+			{ printf ("[ INFO ] Created backup %s.\n", sBackup); }
+	}
 
-	iOnAdj = 0;
-	for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
+	iBackups = ListBackups (arBackups);
+
+	/*** Skip the backup if the ROM has not changed since the newest one. ***/
+	llHash = HashBytes (sDisk, iSize);
+	if ((iBackupHashKnown == 0) && (iBackups > 0))
 	{
-		switch (iRoomLoop)
-		{
-			case 1: iAdjBaseX = ADJ_BASE_X + (63 * 0);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 0); break;
-			case 2: iAdjBaseX = ADJ_BASE_X + (63 * 1);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 0); break;
-			case 3: iAdjBaseX = ADJ_BASE_X + (63 * 2);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 0); break;
-			case 4: iAdjBaseX = ADJ_BASE_X + (63 * 3);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 0); break;
-			case 5: iAdjBaseX = ADJ_BASE_X + (63 * 0);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 1); break;
-			case 6: iAdjBaseX = ADJ_BASE_X + (63 * 1);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 1); break;
-			case 7: iAdjBaseX = ADJ_BASE_X + (63 * 2);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 1); break;
-			case 8: iAdjBaseX = ADJ_BASE_X + (63 * 3);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 1); break;
-			case 9: iAdjBaseX = ADJ_BASE_X + (63 * 0);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 2); break;
-			case 10: iAdjBaseX = ADJ_BASE_X + (63 * 1);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 2); break;
-			case 11: iAdjBaseX = ADJ_BASE_X + (63 * 2);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 2); break;
-			case 12: iAdjBaseX = ADJ_BASE_X + (63 * 3);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 2); break;
-			case 13: iAdjBaseX = ADJ_BASE_X + (63 * 0);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 3); break;
-			case 14: iAdjBaseX = ADJ_BASE_X + (63 * 1);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 3); break;
-			case 15: iAdjBaseX = ADJ_BASE_X + (63 * 2);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 3); break;
-			case 16: iAdjBaseX = ADJ_BASE_X + (63 * 3);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 3); break;
-			case 17: iAdjBaseX = ADJ_BASE_X + (63 * 0);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 4); break;
-			case 18: iAdjBaseX = ADJ_BASE_X + (63 * 1);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 4); break;
-			case 19: iAdjBaseX = ADJ_BASE_X + (63 * 2);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 4); break;
-			case 20: iAdjBaseX = ADJ_BASE_X + (63 * 3);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 4); break;
-			case 21: iAdjBaseX = ADJ_BASE_X + (63 * 0);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 5); break;
-			case 22: iAdjBaseX = ADJ_BASE_X + (63 * 1);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 5); break;
-			case 23: iAdjBaseX = ADJ_BASE_X + (63 * 2);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 5); break;
-			case 24: iAdjBaseX = ADJ_BASE_X + (63 * 3);
-				iAdjBaseY = ADJ_BASE_Y + (63 * 5); break;
-			default:
-				printf ("[FAILED] iRoomLoop is not in the 1-24 range!\n");
-				exit (EXIT_ERROR);
-		}
-		if (InArea (iAdjBaseX + 1, iAdjBaseY + 16,
-			iAdjBaseX + 15, iAdjBaseY + 30) == 1)
-		{
-			iChangingBrokenRoom = iRoomLoop;
-			iChangingBrokenSide = 1; /*** left ***/
-			iOnAdj = 1;
-		}
-		if (InArea (iAdjBaseX + 31, iAdjBaseY + 16,
-			iAdjBaseX + 45, iAdjBaseY + 30) == 1)
+		snprintf (sBackup, MAX_PATHFILE, "%s%s%s", ROM_DIR, SLASH,
+			arBackups[iBackups]);
+		iFd = open (sBackup, O_RDONLY|O_BINARY);
+		if ((iFd != -1) && (fstat (iFd, &stStat) != -1) &&
+			(stStat.st_size == iSize))
 		{
-			iChangingBrokenRoom = iRoomLoop;
-			iChangingBrokenSide = 2; /*** right ***/
-			iOnAdj = 1;
+			sOld = malloc (iSize + 1);
+			if ((sOld != NULL) && (read (iFd, sOld, iSize) == iSize))
+			{
+				llBackupHash = HashBytes (sOld, iSize);
+				iBackupHashKnown = 1;
+			}
+			free (sOld);
 		}
-		if (InArea (iAdjBaseX + 16, iAdjBaseY + 1,
-			iAdjBaseX + 30, iAdjBaseY + 14) == 1)
+		if (iFd != -1) { close (iFd); }
+	}
+	if ((iBackupHashKnown == 1) && (llBackupHash == llHash))
+	{
+		PrIfDe ("[ INFO ] The ROM has not changed since the last backup.\n");
+		free (sDisk);
+		close (iFdROM);
+		return;
+	}
+
+	/* A new, timestamped name, that sorts after the newest backup. The time
+	 * is UTC, so that it does not go back when daylight saving time ends.
+	 * Backups within the same second continue the number of the newest.
+	 */
+	time (&tm);
+	strftime (sTime, MAX_TEXT, "%Y%m%d_%H%M%S", gmtime (&tm));
+	iNumber = 0;
+	if (iBackups > 0)
+	{
+		snprintf (sName, MAX_PATHFILE, "%s%s_", BACKUP_PREFIX, sTime);
+		if (strncmp (arBackups[iBackups], sName, strlen (sName)) == 0)
+			{ iNumber = atoi (&arBackups[iBackups][strlen (sName)]) + 1; }
+	}
+	snprintf (sName, MAX_PATHFILE, "%s%s_%02i%s",
+		BACKUP_PREFIX, sTime, iNumber, BACKUP_SUFFIX);
+	if ((iNumber > 99) ||
+		((iBackups > 0) && (strcmp (sName, arBackups[iBackups]) <= 0)))
+	{
+		printf ("[ WARN ] No backup made; %s would not be newer than %s!\n",
+			sName, arBackups[iBackups]);
+		free (sDisk);
+		close (iFdROM);
+		return;
+	}
+	if (snprintf (sBackup, MAX_PATHFILE, "%s%s%s", ROM_DIR, SLASH, sName)
+		>= MAX_PATHFILE)
+	{
+		printf ("[FAILED] The path of backup \"%s\" is too long!\n", sName);
+		free (sDisk);
+		close (iFdROM);
+		return;
+	}
+
+	/*** Never overwrite an existing backup. ***/
+	iFd = open (sBackup, O_WRONLY|O_CREAT|O_EXCL|O_BINARY, iROMMode);
+	if (iFd == -1)
+	{
+		printf ("[FAILED] Could not open %s: %s!\n",
+			sBackup, strerror (errno));
+		free (sDisk);
+		close (iFdROM);
+		return;
+	}
+
+	/* Where the file system allows it, the backup shares its data with the
+	 * ROM (reflink), or the kernel copies it (copy_file_range). Otherwise,
+	 * the bytes that were just read are written at once.
+	 */
+	iDone = 0;
+#ifdef FICLONE
+	if (ioctl (iFd, FICLONE, iFdROM) == 0) { iDone = 1; }
+#endif
+#ifdef COPY_FILE_RANGE
+	if (iDone == 0)
+	{
+		llIn = 0;
+		llOut = 0;
+		do {
+			iMoved = copy_file_range (iFdROM, &llIn, iFd, &llOut,
+				iSize - llOut, 0);
+		} while ((iMoved > 0) && (llOut < iSize));
+		if (llOut == iSize) { iDone = 1; }
+			else if (ftruncate (iFd, 0) == -1) { iDone = -1; }
+	}
+#endif
+	close (iFdROM);
+	if (iDone == 0)
+	{
+		if (write (iFd, sDisk, iSize) != iSize) { iDone = -1; }
+	}
+	free (sDisk);
+	if (iDone == -1)
+	{
+		printf ("[FAILED] Could not write to %s: %s!\n",
+			sBackup, strerror (errno));
+		close (iFd);
+		unlink (sBackup);
+		return;
+	}
+	close (iFd);
+	llBackupHash = llHash;
+	iBackupHashKnown = 1;
+	if (iDebug == 1) { printf ("[ INFO ] Created backup %s.\n", sBackup); }
+
+	/*** Remove the oldest backups. ***/
+	iBackups = ListBackups (arBackups);
+	for (iBackupLoop = 1; iBackupLoop <= iBackups - BACKUPS; iBackupLoop++)
+	{
+		snprintf (sBackup, MAX_PATHFILE, "%s%s%s", ROM_DIR, SLASH,
+			arBackups[iBackupLoop]);
+		if (unlink (sBackup) == -1)
 		{
-			iChangingBrokenRoom = iRoomLoop;
-			iChangingBrokenSide = 3; /*** up ***/
-			iOnAdj = 1;
+			printf ("[ WARN ] Could not remove %s: %s!\n",
+				sBackup, strerror (errno));
 		}
-		if (InArea (iAdjBaseX + 16, iAdjBaseY + 31,
-			iAdjBaseX + 30, iAdjBaseY + 45) == 1)
+	}
+}
+/*****************************************************************************/
+int ListBackups (char arBackups[BACKUPS_MAX + 2][MAX_PATHFILE + 2])
+/*****************************************************************************/
+{
+	DIR *dDir;
+	struct dirent *stDirent;
+	int iBackups;
+	int iLength;
+
+	/* Returns the number of backups; their names are in arBackups[1] up to
+	 * and including arBackups[iBackups], oldest first.
+	 */
+	iBackups = 0;
+	dDir = opendir (ROM_DIR);
+	if (dDir == NULL) { return (0); }
+	while ((stDirent = readdir (dDir)) != NULL)
+	{
+		iLength = strlen (stDirent->d_name);
+		if ((strncmp (stDirent->d_name, BACKUP_PREFIX,
+			strlen (BACKUP_PREFIX)) == 0) &&
+			(iLength > (int)strlen (BACKUP_SUFFIX)) &&
+			(iLength <= MAX_PATHFILE) &&
+			(strcmp (&stDirent->d_name[iLength - strlen (BACKUP_SUFFIX)],
+			BACKUP_SUFFIX) == 0) && (iBackups < BACKUPS_MAX))
 		{
-			iChangingBrokenRoom = iRoomLoop;
-			iChangingBrokenSide = 4; /*** down ***/
-			iOnAdj = 1;
+			iBackups++;
+			snprintf (arBackups[iBackups], MAX_PATHFILE, "%s", stDirent->d_name);
 		}
 	}
+	closedir (dDir);
 
-	return (iOnAdj);
+	/*** The timestamps in the names sort by age. ***/
+	qsort (arBackups[1], iBackups, sizeof (arBackups[1]), CompareNames);
+
+	return (iBackups);
 }
 /*****************************************************************************/
-int OnLevelBar (void)
+int CompareNames (const void *vA, const void *vB)
 /*****************************************************************************/
 {
-	if (InArea (28, 3, 602, 22) == 1) { return (1); } else { return (0); }
+	return (strcmp ((const char *)vA, (const char *)vB));
 }
 /*****************************************************************************/
-void ChangePos (void)
+unsigned long long HashBytes (unsigned char *sBytes, int iBytes)
 /*****************************************************************************/
 {
-	int iChanging;
-	SDL_Event event;
-	int iOldXPos, iOldYPos;
-	int iUseTile;
-	int iNowOn;
+	unsigned long long llHash;
 
 	/*** Used for looping. ***/
-	int iRoomLoop;
-	int iTileLoop;
-
-	iChanging = 1;
-	iEventTooltip = 0;
-	iCustomHover = 0;
+	int iByteLoop;
 
-	ShowChange();
-	while (iChanging == 1)
+	/*** 64-bit FNV-1a. ***/
+	llHash = 0xCBF29CE484222325ULL;
+	for (iByteLoop = 0; iByteLoop < iBytes; iByteLoop++)
 	{
-		while (SDL_PollEvent (&event))
-		{
-			switch (event.type)
-			{
-				case SDL_CONTROLLERBUTTONDOWN:
-					/*** Nothing for now. ***/
-					break;
-				case SDL_CONTROLLERBUTTONUP:
-					switch (event.cbutton.button)
-					{
-						case SDL_CONTROLLER_BUTTON_A:
-							if (iOnTile != 0)
-							{
-								UseTile (iOnTile, iSelected, iCurRoom);
-								if (iOnTile <= 60) { iChanging = 0; }
-								iChanged++;
-							}
-							break;
-						case SDL_CONTROLLER_BUTTON_B:
-							iChanging = 0; break;
-						case SDL_CONTROLLER_BUTTON_X:
-							UseTile (-2, iSelected, iCurRoom);
-							iChanging = 0;
-							iChanged++;
-							break;
-						case SDL_CONTROLLER_BUTTON_DPAD_LEFT:
-							ChangePosAction ("left"); break;
-						case SDL_CONTROLLER_BUTTON_DPAD_RIGHT:
-							ChangePosAction ("right"); break;
-						case SDL_CONTROLLER_BUTTON_DPAD_UP:
-							ChangePosAction ("up"); break;
-						case SDL_CONTROLLER_BUTTON_DPAD_DOWN:
-							ChangePosAction ("down"); break;
-						case SDL_CONTROLLER_BUTTON_LEFTSHOULDER:
-							ChangeCustom (-1); break;
-						case SDL_CONTROLLER_BUTTON_RIGHTSHOULDER:
-							ChangeCustom (1); break;
-					}
-					ShowChange();
-					break;
-				case SDL_CONTROLLERAXISMOTION: /*** triggers and analog sticks ***/
-					iXJoy1 = SDL_JoystickGetAxis (joystick, 0);
-					iYJoy1 = SDL_JoystickGetAxis (joystick, 1);
-					iXJoy2 = SDL_JoystickGetAxis (joystick, 3);
-					iYJoy2 = SDL_JoystickGetAxis (joystick, 4);
-					if ((iXJoy1 < -30000) || (iXJoy2 < -30000)) /*** left ***/
-					{
-						if ((SDL_GetTicks() - joyleft) > 300)
-						{
-							ChangeEvent (-1, 1);
-							joyleft = SDL_GetTicks();
-						}
-					}
-					if ((iXJoy1 > 30000) || (iXJoy2 > 30000)) /*** right ***/
-					{
-						if ((SDL_GetTicks() - joyright) > 300)
-						{
-							ChangeEvent (1, 1);
-							joyright = SDL_GetTicks();
-						}
-					}
-					if ((iYJoy1 < -30000) || (iYJoy2 < -30000)) /*** up ***/
-					{
-						if ((SDL_GetTicks() - joyup) > 300)
-						{
-							ChangeEvent (10, 1);
-							joyup = SDL_GetTicks();
-						}
-					}
-					if ((iYJoy1 > 30000) || (iYJoy2 > 30000)) /*** down ***/
-					{
-						if ((SDL_GetTicks() - joydown) > 300)
-						{
-							ChangeEvent (-10, 1);
-							joydown = SDL_GetTicks();
-						}
-					}
-					ShowChange();
-					break;
-				case SDL_KEYDOWN:
-					switch (event.key.keysym.sym)
-					{
-						case SDLK_KP_ENTER:
-						case SDLK_RETURN:
-						case SDLK_SPACE:
-							if (event.key.keysym.mod & KMOD_CTRL)
-							{
-								if ((iOnTile >= 1) && (iOnTile <= 60))
-								{
-									for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-									{
-										for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-											{ UseTile (iOnTile, iTileLoop, iRoomLoop); }
-									}
-									iChanging = 0;
-									iChanged++;
-								}
-							} else if (event.key.keysym.mod & KMOD_SHIFT) {
-								if ((iOnTile >= 1) && (iOnTile <= 60))
-								{
-									for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-										{ UseTile (iOnTile, iTileLoop, iCurRoom); }
-									iChanging = 0;
-									iChanged++;
-								}
-							} else if (iOnTile != 0) {
-								UseTile (iOnTile, iSelected, iCurRoom);
-								if (iOnTile <= 60) { iChanging = 0; }
-								iChanged++;
-							}
-							break;
-						case SDLK_ESCAPE:
-						case SDLK_q:
-						case SDLK_c:
-							iChanging = 0; break;
-						case SDLK_LEFT:
-							if (event.key.keysym.mod & KMOD_CTRL)
-							{
-								ChangeEvent (-10, 1);
-							} else if (event.key.keysym.mod & KMOD_SHIFT) {
-								ChangeEvent (-1, 1);
-							} else {
-								ChangePosAction ("left");
-							}
-							break;
-						case SDLK_RIGHT:
-							if (event.key.keysym.mod & KMOD_CTRL)
-							{
-								ChangeEvent (10, 1);
-							} else if (event.key.keysym.mod & KMOD_SHIFT) {
-								ChangeEvent (1, 1);
-							} else {
-								ChangePosAction ("right");
-							}
-							break;
-						case SDLK_UP: ChangePosAction ("up"); break;
-						case SDLK_DOWN: ChangePosAction ("down"); break;
-						default: break;
-					}
-					ShowChange();
-					break;
-				case SDL_MOUSEMOTION:
-					iOldXPos = iXPos;
-					iOldYPos = iYPos;
-					iXPos = event.motion.x;
-					iYPos = event.motion.y;
-					if ((iOldXPos == iXPos) && (iOldYPos == iYPos)) { break; }
-
-					/*** event tooltip ***/
-					iEventTooltipOld = iEventTooltip;
-					if (InArea (525, 539, 525 + 126, 539 + 29) == 1)
-						{ iEventTooltip = 1; } else { iEventTooltip = 0; }
-					if (iEventTooltip != iEventTooltipOld) { ShowChange(); }
+		llHash^=sBytes[iByteLoop];
+		llHash*=0x100000001B3ULL;
+	}
 
-					/*** custom hover ***/
-					iCustomHoverOld = iCustomHover;
-					if (InArea (395, 491, 395 + 126, 491 + 47) == 1)
-						{ iCustomHover = 1; } else { iCustomHover = 0; }
-					if (iCustomHover != iCustomHoverOld) { ShowChange(); }
+	return (llHash);
+}
+/*****************************************************************************/
+int WriteBytes (char *sFile, unsigned char *sBytes, int iBytes)
+/*****************************************************************************/
+{
+	int iFd;
+	char sTemp[MAX_PATHFILE + 2];
+#if !(defined WIN32 || _WIN32 || WIN64 || _WIN64)
+	char sDir[MAX_PATHFILE + 2];
+	char *sSlash;
+#endif
 
-					iNowOn = OnTile();
-					if ((iOnTile != iNowOn) && (iNowOn != 0))
-					{
-						if (IsDisabled (iNowOn) == 0)
-						{
-							iOnTile = iNowOn;
-							ShowChange();
-						}
-					}
-					break;
-				case SDL_MOUSEBUTTONDOWN:
-					if (event.button.button == 1) /*** left mouse button ***/
-					{
-						if (InArea (656, 0, 656 + 36, 0 + 573) == 1) /*** close ***/
-						{
-							iCloseOn = 1;
-							ShowChange();
-						}
-					}
-					break;
-				case SDL_MOUSEBUTTONUP:
-					iCloseOn = 0;
+	/* The bytes are written to a temporary file next to sFile, that only
+	 * replaces sFile once it is safely on disk. If writing fails or is
+	 * interrupted, sFile stays as it was.
+	 */
+	snprintf (sTemp, MAX_PATHFILE, "%s.tmp", sFile);
+	iFd = open (sTemp, O_WRONLY|O_CREAT|O_TRUNC|O_BINARY, iROMMode);
+	if (iFd == -1)
+	{
+		printf ("[ WARN ] Could not open \"%s\": %s!\n",
+			sTemp, strerror (errno));
+		return (0);
+	}
+	if (write (iFd, sBytes, iBytes) != iBytes)
+	{
+		printf ("[ WARN ] Could not write to \"%s\": %s!\n",
+			sTemp, strerror (errno));
+		close (iFd);
+		unlink (sTemp);
+		return (0);
+	}
+#if defined WIN32 || _WIN32 || WIN64 || _WIN64
+	if (_commit (iFd) == -1)
+#else
+	if (fsync (iFd) == -1)
+#endif
+	{
+		printf ("[ WARN ] Could not sync \"%s\": %s!\n",
+			sTemp, strerror (errno));
+		close (iFd);
+		unlink (sTemp);
+		return (0);
+	}
+	if (close (iFd) == -1)
+	{
+		printf ("[ WARN ] Could not close \"%s\": %s!\n",
+			sTemp, strerror (errno));
+		unlink (sTemp);
+		return (0);
+	}
 
-					/*** On tile or living. ***/
-					iUseTile = 0;
-					if ((InArea (2, 2, 2 + 652, 2 + 488) == 1) ||
-						(InArea (2, 488, 2 + 327, 488 + 83) == 1)) { iUseTile = 1; }
+#if defined WIN32 || _WIN32 || WIN64 || _WIN64
+	if (MoveFileEx (sTemp, sFile,
+		MOVEFILE_REPLACE_EXISTING|MOVEFILE_WRITE_THROUGH) == 0)
+	{
+		printf ("[ WARN ] Could not replace \"%s\": error %lu!\n",
+			sFile, (unsigned long)GetLastError());
+		unlink (sTemp);
+		return (0);
+	}
+#else
+	if (rename (sTemp, sFile) == -1)
+	{
+		printf ("[ WARN ] Could not replace \"%s\": %s!\n",
+			sFile, strerror (errno));
+		unlink (sTemp);
+		return (0);
+	}
 
-					/*** On the custom tile area. ***/
-					if (InArea (395, 491, 395 + 126, 491 + 47) == 1)
-					{
-						iOnTile = -2;
-						iUseTile = 1;
-					}
+	/*** Make sure the rename itself is on disk. ***/
+	snprintf (sDir, MAX_PATHFILE, "%s", sFile);
+	sSlash = strrchr (sDir, SLASH[0]);
+	if (sSlash == NULL) { snprintf (sDir, MAX_PATHFILE, "%s", "."); }
+		else { *sSlash = '\0'; }
+	iFd = open (sDir, O_RDONLY);
+	if (iFd != -1) { fsync (iFd); close (iFd); }
+#endif
 
-					if (event.button.button == 1) /*** left mouse button ***/
-					{
-						/*** Changing the custom tile. ***/
-						if (InArea (402, 543, 402 + 13, 543 + 20) == 1)
-							{ ChangeCustom (-16); }
-						if (InArea (417, 543, 417 + 13, 543 + 20) == 1)
-							{ ChangeCustom (-1); }
-						if (InArea (487, 543, 487 + 13, 543 + 20) == 1)
-							{ ChangeCustom (1); }
-						if (InArea (502, 543, 502 + 13, 543 + 20) == 1)
-							{ ChangeCustom (16); }
+	return (1);
+}
+/*****************************************************************************/
+unsigned char *ReadBase (void)
+/*****************************************************************************/
+{
+	char arBackups[BACKUPS_MAX + 2][MAX_PATHFILE + 2];
+	char sBase[MAX_PATHFILE + 2];
+	unsigned char *sBytes;
+	struct stat stStat;
+	int iFd;
 
-						/*** Changing the event number. ***/
-						if (InArea (532, 543, 532 + 13, 543 + 20) == 1)
-							{ ChangeEvent (-10, 1); }
-						if (InArea (547, 543, 547 + 13, 543 + 20) == 1)
-							{ ChangeEvent (-1, 1); }
-						if (InArea (617, 543, 617 + 13, 543 + 20) == 1)
-							{ ChangeEvent (1, 1); }
-						if (InArea (632, 543, 632 + 13, 543 + 20) == 1)
-							{ ChangeEvent (10, 1); }
+	/* Patches are made against the ROM as it was before the first save. For
+	 * ROMs that were saved before that was kept, the oldest backup is used.
+	 */
+	snprintf (sBase, MAX_PATHFILE, "%s%s%s", ROM_DIR, SLASH, BACKUP_ORIGINAL);
+	if (access (sBase, R_OK) == -1)
+	{
+		if (ListBackups (arBackups) == 0)
+		{
+			printf ("[ WARN ] There is no %s%s%s to compare with; save first!\n",
+				ROM_DIR, SLASH, BACKUP_ORIGINAL);
+			return (NULL);
+		}
+		if (snprintf (sBase, MAX_PATHFILE, "%s%s%s", ROM_DIR, SLASH,
+			arBackups[1]) >= MAX_PATHFILE)
+		{
+			printf ("[ WARN ] The path of backup \"%s\" is too long!\n",
+				arBackups[1]);
+			return (NULL);
+		}
+	}
+	if (iDebug == 1)
+		{ printf ("[ INFO ] Comparing with \"%s\".\n", sBase); }
 
-						/*** On close. ***/
-						if (InArea (656, 0, 656 + 36, 0 + 573) == 1) { iChanging = 0; }
+	iFd = open (sBase, O_RDONLY|O_BINARY);
+	if (iFd == -1)
+	{
+		printf ("[ WARN ] Could not open \"%s\": %s!\n",
+			sBase, strerror (errno));
+		return (NULL);
+	}
+	if ((fstat (iFd, &stStat) == -1) || (stStat.st_size != stEdit.iROMSize))
+	{
+		printf ("[ WARN ] The size of \"%s\" differs from the ROM!\n", sBase);
+		close (iFd);
+		return (NULL);
+	}
+	sBytes = malloc (stEdit.iROMSize);
+	if (sBytes == NULL)
+	{
+		printf ("[ WARN ] Could not allocate %i bytes!\n", stEdit.iROMSize);
+		close (iFd);
+		return (NULL);
+	}
+	if (read (iFd, sBytes, stEdit.iROMSize) != stEdit.iROMSize)
+	{
+		printf ("[ WARN ] Could not read from \"%s\": %s!\n",
+			sBase, strerror (errno));
+		free (sBytes);
+		close (iFd);
+		return (NULL);
+	}
+	close (iFd);
 
-						if (iUseTile == 1)
-						{
-							UseTile (iOnTile, iSelected, iCurRoom);
-							if (iOnTile <= 60) { iChanging = 0; }
-							iChanged++;
-						}
-					}
+	return (sBytes);
+}
+/*****************************************************************************/
+int ExportPatch (char *sFile, int iFormat)
+/*****************************************************************************/
+{
+	unsigned char *sBase;
+	unsigned char *sTarget;
+	unsigned char *sPatch;
+	int iOffset;
+	int iBytes;
+	int iSize;
+	int iResult;
 
-					if (event.button.button == 2)
-					{
-						if ((iUseTile == 1) && (iOnTile != 0) && (iOnTile <= 60))
-						{
-							for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-							{
-								UseTile (iOnTile, iTileLoop, iCurRoom);
-							}
-							iChanging = 0;
-							iChanged++;
-						}
-					}
+	/*** Used for looping. ***/
+	int iAreaLoop;
 
-					if (event.button.button == 3)
-					{
-						if ((iUseTile == 1) && (iOnTile != 0) && (iOnTile <= 60))
-						{
-							for (iRoomLoop = 1; iRoomLoop <= ROOMS; iRoomLoop++)
-							{
-								for (iTileLoop = 1; iTileLoop <= TILES; iTileLoop++)
-								{
-									UseTile (iOnTile, iTileLoop, iRoomLoop);
-								}
-							}
-							iChanging = 0;
-							iChanged++;
-						}
-					}
+	sBase = ReadBase();
+	if (sBase == NULL) { return (0); }
+	sTarget = malloc (stEdit.iROMSize);
+	sPatch = malloc ((stEdit.iROMSize * 2) + 64); /*** More than the worst case. ***/
+	if ((sTarget == NULL) || (sPatch == NULL))
+	{
+		printf ("[ WARN ] Could not allocate %i bytes!\n", stEdit.iROMSize * 3);
+		free (sBase); free (sTarget); free (sPatch);
+		return (0);
+	}
 
-					ShowChange();
-					break;
-				case SDL_WINDOWEVENT:
-					if (event.window.event == SDL_WINDOWEVENT_EXPOSED)
-						{ ShowChange(); } break;
-				case SDL_QUIT:
-					Quit(); break;
-			}
-		}
+	/*** Only what the editor writes is taken from the ROM image. ***/
+	memcpy (sTarget, sBase, stEdit.iROMSize);
+	for (iAreaLoop = 0; iAreaLoop < PATCH_AREAS; iAreaLoop++)
+	{
+		iOffset = arPatchAreas[iAreaLoop][0];
+		iBytes = arPatchAreas[iAreaLoop][1];
+		if (iOffset + iBytes > stEdit.iROMSize)
+			{ iBytes = stEdit.iROMSize - iOffset; }
+		if (iBytes > 0)
+			{ memcpy (&sTarget[iOffset], &stEdit.sROM[iOffset], iBytes); }
+	}
 
-		/*** prevent CPU eating ***/
-		gamespeed = REFRESH;
-		while ((SDL_GetTicks() - looptime) < gamespeed)
-		{
-			SDL_Delay (10);
-		}
-		looptime = SDL_GetTicks();
+	if (iFormat == PATCH_IPS)
+	{
+		iSize = MakeIPS (sBase, sTarget, sPatch);
+	} else {
+		iSize = MakeBPS (sBase, sTarget, sPatch);
 	}
-	PlaySound ("wav/ok_close.wav");
+	iResult = WriteBytes (sFile, sPatch, iSize);
+	if (iResult == 1)
+	{
+		printf ("[  OK  ] Created patch \"%s\" (%i bytes).\n", sFile, iSize);
+	}
+
+	free (sBase);
+	free (sTarget);
+	free (sPatch);
+
+	return (iResult);
 }
 /*****************************************************************************/
-void RemoveOldRoom (void)
+void ExportPatches (void)
 /*****************************************************************************/
 {
-	arMovingRooms[iMovingOldX][iMovingOldY] = 0;
+	char sStem[MAX_PATHFILE + 2];
+	char sIPS[MAX_PATHFILE + 2];
+	char sBPS[MAX_PATHFILE + 2];
+	char *sDot;
+	int iDone;
 
-	/* Change the links of the rooms around
-	 * the removed room.
-	 */
+	if (iReplay != 0) { return; } /*** A replay writes no files. ***/
 
-	/*** left of removed ***/
-	if ((iMovingOldX >= 2) && (iMovingOldX <= 24))
+	/*** Patches are of the saved ROM, without the changes for Mednafen. ***/
+	if (iModified == 1) { ModifyBack(); }
+
+	/*** Next to the ROM: rom/PoP1.ips and rom/PoP1.bps ***/
+	snprintf (sStem, MAX_PATHFILE + 2, "%s", stEdit.sPathFile);
+	sDot = strrchr (sStem, '.');
+	if (sDot != NULL) { *sDot = '\0'; }
+
+	if ((snprintf (sIPS, MAX_PATHFILE, "%s.ips", sStem) >= MAX_PATHFILE) ||
+		(snprintf (sBPS, MAX_PATHFILE, "%s.bps", sStem) >= MAX_PATHFILE))
 	{
-		if (arMovingRooms[iMovingOldX - 1][iMovingOldY] != 0)
-		{
-			arRoomLinks[iCurLevel][arMovingRooms[iMovingOldX - 1]
-				[iMovingOldY]][2] = 0; /*** remove right ***/
-		}
+		printf ("[ WARN ] The path \"%s\" is too long for patches!\n", sStem);
+		iDone = 0;
+	} else {
+		iDone = ExportPatch (sIPS, PATCH_IPS);
+		iDone+=ExportPatch (sBPS, PATCH_BPS);
 	}
 
-	/*** right of removed ***/
-	if ((iMovingOldX >= 1) && (iMovingOldX <= 23))
+	if (iDone == 2)
 	{
-		if (arMovingRooms[iMovingOldX + 1][iMovingOldY] != 0)
-		{
-			arRoomLinks[iCurLevel][arMovingRooms[iMovingOldX + 1]
-				[iMovingOldY]][1] = 0; /*** remove left ***/
-		}
+		PlaySound ("wav/save.wav");
+	} else {
+		SDL_ShowSimpleMessageBox (SDL_MESSAGEBOX_ERROR, "Error",
+			"Could not create the patches. See the console for details.", window);
 	}
+}
+/*****************************************************************************/
+void ApplyPatch (char *sFile)
+/*****************************************************************************/
+{
+	unsigned char *sPatch;
+	unsigned char *sSource;
+	unsigned char *sTarget;
+	struct stat stStat;
+	int iFd;
+	int iPatchSize;
+	int iResult;
 
-	/*** above removed ***/
-	if ((iMovingOldY >= 2) && (iMovingOldY <= 24))
+	iFd = open (sFile, O_RDONLY|O_BINARY);
+	if (iFd == -1)
 	{
-		if (arMovingRooms[iMovingOldX][iMovingOldY - 1] != 0)
-		{
-			arRoomLinks[iCurLevel][arMovingRooms[iMovingOldX]
-				[iMovingOldY - 1]][4] = 0; /*** remove below ***/
-		}
+		printf ("[FAILED] Could not open \"%s\": %s!\n",
+			sFile, strerror (errno));
+		exit (EXIT_ERROR);
+	}
+	if (fstat (iFd, &stStat) == -1)
+	{
+		printf ("[FAILED] Could not stat \"%s\": %s!\n",
+			sFile, strerror (errno));
+		exit (EXIT_ERROR);
+	}
+	iPatchSize = stStat.st_size;
+	sPatch = malloc (iPatchSize + 1);
+	sSource = malloc (stEdit.iROMSize);
+	sTarget = malloc (stEdit.iROMSize);
+	if ((sPatch == NULL) || (sSource == NULL) || (sTarget == NULL))
+	{
+		printf ("[FAILED] Could not allocate %i bytes!\n",
+			iPatchSize + (stEdit.iROMSize * 2));
+		exit (EXIT_ERROR);
+	}
+	if (read (iFd, sPatch, iPatchSize) != iPatchSize)
+	{
+		printf ("[FAILED] Could not read from \"%s\": %s!\n",
+			sFile, strerror (errno));
+		exit (EXIT_ERROR);
 	}
+	close (iFd);
 
-	/*** below removed ***/
-	if ((iMovingOldY >= 1) && (iMovingOldY <= 23))
+	/*** The patch is applied to copies; the image changes only if it fits. ***/
+	memcpy (sSource, stEdit.sROM, stEdit.iROMSize);
+	memcpy (sTarget, stEdit.sROM, stEdit.iROMSize);
+	if ((iPatchSize >= 5) && (memcmp (sPatch, "PATCH", 5) == 0))
 	{
-		if (arMovingRooms[iMovingOldX][iMovingOldY + 1] != 0)
-		{
-			arRoomLinks[iCurLevel][arMovingRooms[iMovingOldX]
-				[iMovingOldY + 1]][3] = 0; /*** remove above ***/
-		}
+		iResult = ApplyIPS (sPatch, iPatchSize, sTarget);
+	} else if ((iPatchSize >= 4) && (memcmp (sPatch, "BPS1", 4) == 0)) {
+		iResult = ApplyBPS (sPatch, iPatchSize, sSource, sTarget);
+	} else {
+		printf ("[FAILED] File \"%s\" is not an IPS or BPS patch!\n", sFile);
+		iResult = 0;
+	}
+	if (iResult == 0)
+	{
+		printf ("[FAILED] Could not apply patch \"%s\"!\n", sFile);
+		exit (EXIT_ERROR);
 	}
+
+	/*** Keep the ROM as it is on disk, before it can be saved patched. ***/
+	CreateBAK();
+
+	ROMSetBytes (0, sTarget, stEdit.iROMSize);
+	printf ("[  OK  ] Applied patch \"%s\"; save to keep the changes.\n", sFile);
+
+	free (sPatch);
+	free (sSource);
+	free (sTarget);
 }
 /*****************************************************************************/
-void AddNewRoom (int iX, int iY, int iRoom)
+int MakeIPS (unsigned char *sBase, unsigned char *sTarget,
+	unsigned char *sPatch)
 /*****************************************************************************/
 {
-	arMovingRooms[iX][iY] = iRoom;
+	int iSize;
+	int iStart;
+	int iEnd;
+	int iOffset;
+	int iRun;
+	int iLast;
+	int iMax;
 
-	/* Change the links of the rooms around
-	 * the new room and the room itself.
-	 */
+	/*** Used for looping. ***/
+	int iAreaLoop;
+	int iByteLoop;
 
-	arRoomLinks[iCurLevel][iRoom][1] = 0;
-	arRoomLinks[iCurLevel][iRoom][2] = 0;
-	arRoomLinks[iCurLevel][iRoom][3] = 0;
-	arRoomLinks[iCurLevel][iRoom][4] = 0;
+	memcpy (sPatch, "PATCH", 5);
+	iSize = 5;
 
-	if ((iX >= 2) && (iX <= 24)) /*** left of added ***/
+	/* One linear pass over the areas. A record ends after IPS_GAP unchanged
+	 * bytes, and long runs of one byte get an RLE record.
+	 */
+	for (iAreaLoop = 0; iAreaLoop < PATCH_AREAS; iAreaLoop++)
 	{
-		if (arMovingRooms[iX - 1][iY] != 0)
+		iStart = arPatchAreas[iAreaLoop][0];
+		iEnd = iStart + arPatchAreas[iAreaLoop][1];
+		if (iEnd > stEdit.iROMSize) { iEnd = stEdit.iROMSize; }
+
+		iOffset = iStart;
+		while (iOffset < iEnd)
 		{
-			arRoomLinks[iCurLevel][arMovingRooms[iX - 1]
-				[iY]][2] = iRoom; /*** add room right ***/
-			arRoomLinks[iCurLevel][iRoom][1] = arMovingRooms[iX - 1][iY];
+			if (sBase[iOffset] == sTarget[iOffset]) { iOffset++; continue; }
+
+			iMax = iEnd - iOffset;
+			if (iMax > IPS_RECORD) { iMax = IPS_RECORD; }
+			iRun = MatchLength (&sTarget[iOffset], &sTarget[iOffset + 1], iMax - 1)
+				+ 1;
+			if (iRun >= IPS_RUN)
+			{
+				iSize = IPSRecord (sPatch, iSize, iOffset, 0);
+				sPatch[iSize++] = (iRun >> 8) & 0xFF;
+				sPatch[iSize++] = (iRun >> 0) & 0xFF;
+				sPatch[iSize++] = sTarget[iOffset];
+				iOffset+=iRun;
+				continue;
+			}
+
+			iLast = iOffset;
+			for (iByteLoop = iOffset + 1; iByteLoop < iOffset + iMax; iByteLoop++)
+			{
+				if (sBase[iByteLoop] != sTarget[iByteLoop])
+				{
+					if ((iEnd - iByteLoop >= IPS_RUN) &&
+						(MatchLength (&sTarget[iByteLoop], &sTarget[iByteLoop + 1],
+						IPS_RUN - 1) == IPS_RUN - 1)) { break; }
+					iLast = iByteLoop;
+				} else if (iByteLoop - iLast > IPS_GAP) { break; }
+			}
+			iSize = IPSRecord (sPatch, iSize, iOffset, iLast - iOffset + 1);
+			memcpy (&sPatch[iSize], &sTarget[iOffset], iLast - iOffset + 1);
+			iSize+=iLast - iOffset + 1;
+			iOffset = iLast + 1;
 		}
 	}
 
-	if ((iX >= 1) && (iX <= 23)) /*** right of added ***/
+	memcpy (&sPatch[iSize], "EOF", 3);
+	iSize+=3;
+
+	return (iSize);
+}
+/*****************************************************************************/
+int IPSRecord (unsigned char *sPatch, int iSize, int iOffset, int iBytes)
+/*****************************************************************************/
+{
+	/*** Big-endian; a size of 0 means RLE. ***/
+	sPatch[iSize++] = (iOffset >> 16) & 0xFF;
+	sPatch[iSize++] = (iOffset >> 8) & 0xFF;
+	sPatch[iSize++] = (iOffset >> 0) & 0xFF;
+	sPatch[iSize++] = (iBytes >> 8) & 0xFF;
+	sPatch[iSize++] = (iBytes >> 0) & 0xFF;
+
+	return (iSize);
+}
+/*****************************************************************************/
+int ApplyIPS (unsigned char *sPatch, int iPatchSize, unsigned char *sTarget)
+/*****************************************************************************/
+{
+	int iPos;
+	int iOffset;
+	int iBytes;
+
+	iPos = 5;
+	while (1)
 	{
-		if (arMovingRooms[iX + 1][iY] != 0)
+		if (iPos + 3 > iPatchSize)
 		{
-			arRoomLinks[iCurLevel][arMovingRooms[iX + 1]
-				[iY]][1] = iRoom; /*** add room left ***/
-			arRoomLinks[iCurLevel][iRoom][2] = arMovingRooms[iX + 1][iY];
+			printf ("[FAILED] The IPS patch has no end!\n");
+			return (0);
+		}
+		if (memcmp (&sPatch[iPos], "EOF", 3) == 0) { break; }
+		if (iPos + 5 > iPatchSize)
+		{
+			printf ("[FAILED] The IPS patch is truncated!\n");
+			return (0);
+		}
+		iOffset = (sPatch[iPos] << 16) + (sPatch[iPos + 1] << 8) +
+			sPatch[iPos + 2];
+		iBytes = (sPatch[iPos + 3] << 8) + sPatch[iPos + 4];
+		iPos+=5;
+
+		if (iBytes == 0) /*** RLE ***/
+		{
+			if (iPos + 3 > iPatchSize)
+			{
+				printf ("[FAILED] The IPS patch is truncated!\n");
+				return (0);
+			}
+			iBytes = (sPatch[iPos] << 8) + sPatch[iPos + 1];
+			if (iOffset + iBytes > stEdit.iROMSize)
+			{
+				printf ("[FAILED] The IPS patch writes past the ROM!\n");
+				return (0);
+			}
+			memset (&sTarget[iOffset], sPatch[iPos + 2], iBytes);
+			iPos+=3;
+		} else {
+			if ((iPos + iBytes > iPatchSize) || (iOffset + iBytes > stEdit.iROMSize))
+			{
+				printf ("[FAILED] The IPS patch is truncated or writes past"
+					" the ROM!\n");
+				return (0);
+			}
+			memcpy (&sTarget[iOffset], &sPatch[iPos], iBytes);
+			iPos+=iBytes;
 		}
 	}
 
-	if ((iY >= 2) && (iY <= 24)) /*** above added ***/
+	return (1);
+}
+/*****************************************************************************/
+int MakeBPS (unsigned char *sBase, unsigned char *sTarget,
+	unsigned char *sPatch)
+/*****************************************************************************/
+{
+	int arFrom[LEVELS + 2 + 2];
+	int iSize;
+	int iOut;
+	int iLiteral;
+	int iMatch;
+	int iBest;
+	int iBestFrom;
+	int iFrom;
+	int iRelative;
+	int iSourceOffset;
+	int iMax;
+
+	/*** Used for looping. ***/
+	int iEntryLoop;
+
+	memcpy (sPatch, "BPS1", 4);
+	iSize = 4;
+	iSize = BPSNumber (sPatch, iSize, stEdit.iROMSize); /*** source ***/
+	iSize = BPSNumber (sPatch, iSize, stEdit.iROMSize); /*** target ***/
+	iSize = BPSNumber (sPatch, iSize, 0); /*** metadata ***/
+
+	/* Levels move when an earlier level grows or shrinks. How far each level
+	 * moved follows from the two offsets tables, so moved levels can be
+	 * copied from the base instead of being stored again.
+	 */
+	for (iEntryLoop = 0; iEntryLoop < LEVELS + 2; iEntryLoop++)
 	{
-		if (arMovingRooms[iX][iY - 1] != 0)
+		iFrom = OFFSET_TABLE + (iEntryLoop * 2);
+		arFrom[iEntryLoop] = (sBase[iFrom] + (sBase[iFrom + 1] << 8)) -
+			(sTarget[iFrom] + (sTarget[iFrom + 1] << 8));
+	}
+
+	/*** One linear pass; equal bytes are read from the base in place. ***/
+	iOut = 0;
+	iLiteral = 0;
+	iSourceOffset = 0;
+	while (iOut < stEdit.iROMSize)
+	{
+		iMatch = MatchLength (&sBase[iOut], &sTarget[iOut], stEdit.iROMSize - iOut);
+		if (iMatch >= BPS_MATCH)
 		{
-			arRoomLinks[iCurLevel][arMovingRooms[iX]
-				[iY - 1]][4] = iRoom; /*** add room below ***/
-			arRoomLinks[iCurLevel][iRoom][3] = arMovingRooms[iX][iY - 1];
+			iSize = BPSLiteral (sPatch, iSize, &sTarget[iOut - iLiteral], iLiteral);
+			iLiteral = 0;
+			iSize = BPSNumber (sPatch, iSize, ((iMatch - 1) << 2) | 0);
+			iOut+=iMatch;
+			continue;
 		}
-	}
 
-	if ((iY >= 1) && (iY <= 23)) /*** below added ***/
-	{
-		if (arMovingRooms[iX][iY + 1] != 0)
+		iBest = 0;
+		iBestFrom = 0;
+		if (iOut >= OFFSET_LEVEL0)
 		{
-			arRoomLinks[iCurLevel][arMovingRooms[iX]
-				[iY + 1]][3] = iRoom; /*** add room above ***/
-			arRoomLinks[iCurLevel][iRoom][4] = arMovingRooms[iX][iY + 1];
+			for (iEntryLoop = 0; iEntryLoop < LEVELS + 2; iEntryLoop++)
+			{
+				iFrom = iOut + arFrom[iEntryLoop];
+				if ((arFrom[iEntryLoop] == 0) || (iFrom < 0) ||
+					(iFrom >= stEdit.iROMSize)) { continue; }
+				iMax = stEdit.iROMSize - iFrom;
+				if (iMax > stEdit.iROMSize - iOut)
+					{ iMax = stEdit.iROMSize - iOut; }
+				iMatch = MatchLength (&sBase[iFrom], &sTarget[iOut], iMax);
+				if (iMatch > iBest) { iBest = iMatch; iBestFrom = iFrom; }
+			}
+		}
+		if (iBest >= BPS_MATCH)
+		{
+			iSize = BPSLiteral (sPatch, iSize, &sTarget[iOut - iLiteral], iLiteral);
+			iLiteral = 0;
+			iSize = BPSNumber (sPatch, iSize, ((iBest - 1) << 2) | 2);
+			iRelative = iBestFrom - iSourceOffset;
+			if (iRelative < 0)
+			{
+				iSize = BPSNumber (sPatch, iSize, ((-iRelative) << 1) | 1);
+			} else {
+				iSize = BPSNumber (sPatch, iSize, iRelative << 1);
+			}
+			iSourceOffset = iBestFrom + iBest;
+			iOut+=iBest;
+			continue;
 		}
+
+		iLiteral++;
+		iOut++;
 	}
+	iSize = BPSLiteral (sPatch, iSize, &sTarget[iOut - iLiteral], iLiteral);
 
-	PlaySound ("wav/move_room.wav");
+	iSize = PutCRC32 (sPatch, iSize, CRC32 (sBase, stEdit.iROMSize));
+	iSize = PutCRC32 (sPatch, iSize, CRC32 (sTarget, stEdit.iROMSize));
+	iSize = PutCRC32 (sPatch, iSize, CRC32 (sPatch, iSize));
+
+	return (iSize);
 }
 /*****************************************************************************/
-void LinkPlus (void)
+int BPSNumber (unsigned char *sPatch, int iSize, unsigned long long llNumber)
 /*****************************************************************************/
 {
-	int iCurrent, iNew;
+	int iByte;
 
-	iCurrent = arRoomLinks[iCurLevel][iChangingBrokenRoom][iChangingBrokenSide];
-	if (iCurrent > ROOMS) /*** "?"; high links ***/
+	/*** 7 bits per byte; the last byte has the high bit set. ***/
+	while (1)
 	{
-		iNew = 0;
-	} else if (iCurrent == ROOMS) {
-		iNew = 0;
-	} else {
-		iNew = iCurrent + 1;
+		iByte = llNumber & 0x7F;
+		llNumber >>= 7;
+		if (llNumber == 0) { sPatch[iSize++] = 0x80 | iByte; break; }
+		sPatch[iSize++] = iByte;
+		llNumber--;
 	}
-	arRoomLinks[iCurLevel][iChangingBrokenRoom][iChangingBrokenSide] = iNew;
-	iChanged++;
-	arBrokenRoomLinks[iCurLevel] = BrokenRoomLinks (0);
-	PlaySound ("wav/hum_adj.wav");
+
+	return (iSize);
 }
 /*****************************************************************************/
-void EventRoom (int iRoom, int iFromTo)
+int BPSReadNumber (unsigned char *sPatch, int iEnd, int *iOffset,
+	int *iNumber)
 /*****************************************************************************/
 {
-	switch (iFromTo)
+	unsigned long long llNumber;
+	unsigned long long llShift;
+	int iByte;
+
+	llNumber = 0;
+	llShift = 1;
+	while (1)
 	{
-		case 0: arEventsFromRoom[iCurLevel][iChangeEvent] = iRoom; break;
-		case 1: arEventsToRoom[iCurLevel][iChangeEvent] = iRoom; break;
+		if (*iOffset >= iEnd) { return (0); }
+		iByte = sPatch[(*iOffset)++];
+		llNumber+=(iByte & 0x7F) * llShift;
+		if ((iByte & 0x80) != 0) { break; }
+		llShift <<= 7;
+		llNumber+=llShift;
+		if (llShift > 0x7FFFFFFF) { return (0); }
 	}
-	PlaySound ("wav/check_box.wav");
-	iChanged++;
+	if (llNumber > 0x7FFFFFFF) { return (0); }
+	*iNumber = llNumber;
+
+	return (1);
 }
 /*****************************************************************************/
-void EventTile (int iX, int iY, int iFromTo)
+int BPSLiteral (unsigned char *sPatch, int iSize,
+	unsigned char *sBytes, int iBytes)
 /*****************************************************************************/
 {
-	int iTile;
+	if (iBytes == 0) { return (iSize); }
+	iSize = BPSNumber (sPatch, iSize, ((iBytes - 1) << 2) | 1);
+	memcpy (&sPatch[iSize], sBytes, iBytes);
 
-	iTile = ((iY - 1) * 10) + iX;
-	switch (iFromTo)
-	{
-		case 0: arEventsFromTile[iCurLevel][iChangeEvent] = iTile; break;
-		case 1: arEventsToTile[iCurLevel][iChangeEvent] = iTile; break;
-	}
-	PlaySound ("wav/check_box.wav");
-	iChanged++;
+	return (iSize + iBytes);
 }
 /*****************************************************************************/
-void ShowImage (SDL_Texture *img, int iX, int iY, char *sImageInfo)
+int ApplyBPS (unsigned char *sPatch, int iPatchSize,
+	unsigned char *sSource, unsigned char *sTarget)
 /*****************************************************************************/
 {
-	SDL_Rect dest;
-	SDL_Rect loc;
-	int iWidth, iHeight;
-	int iInfoC;
-	char arText[9 + 2][MAX_TEXT + 2];
-	int iHighNibble, iLowNibble;
-	int iTileValue;
-	int iGreen;
-	char sTileValue[MAX_OPTION + 2];
+	int iEnd;
+	int iPos;
+	int iSourceSize;
+	int iTargetSize;
+	int iMetaSize;
+	int iNumber;
+	int iAction;
+	int iLength;
+	int iRelative;
+	int iOut;
+	int iSourceOffset;
+	int iTargetOffset;
 
-	iInfoC = 0;
+	/*** Used for looping. ***/
+	int iByteLoop;
 
-	iGreen = 1;
-	if (strncmp (sImageInfo, "tile=", 5) == 0)
+	if ((iPatchSize < 4 + 3 + 12) ||
+		(CRC32 (sPatch, iPatchSize - 4) != GetCRC32 (&sPatch[iPatchSize - 4])))
 	{
-		GetOptionValue (sImageInfo, sTileValue);
-		iTileValue = atoi (sTileValue);
-	} else if (strncmp (sImageInfo, "high=", 5) == 0) {
-		iGreen = 2;
-		GetOptionValue (sImageInfo, sTileValue);
-		iTileValue = atoi (sTileValue);
-	} else {
-		iTileValue = -1;
+		printf ("[FAILED] The BPS patch is damaged!\n");
+		return (0);
 	}
-
-	if (iInfo == 1)
+	iEnd = iPatchSize - 12;
+	iPos = 4;
+	if ((BPSReadNumber (sPatch, iEnd, &iPos, &iSourceSize) == 0) ||
+		(BPSReadNumber (sPatch, iEnd, &iPos, &iTargetSize) == 0) ||
+		(BPSReadNumber (sPatch, iEnd, &iPos, &iMetaSize) == 0) ||
+		(iMetaSize > iEnd - iPos))
 	{
-		snprintf (arText[0], MAX_TEXT, "0x%02x", iTileValue);
+		printf ("[FAILED] The BPS patch is damaged!\n");
+		return (0);
 	}
-
-	/*** Raise and drop buttons. ***/
-	if (iTileValue != -1)
+	iPos+=iMetaSize;
+	if ((iSourceSize != stEdit.iROMSize) ||
+		(CRC32 (sSource, stEdit.iROMSize) != GetCRC32 (&sPatch[iPatchSize - 12])))
 	{
-		iHighNibble = iTileValue >> 4;
-		iLowNibble = iTileValue & 0x0F; /*** 0F = 00001111 ***/
-
-		if ((iLowNibble == 0x0F) && (IsEven (iHighNibble))) /*** Raise. ***/
-		{
-			switch (cCurType)
-			{
-				case 'd': img = imgd[0x0F][iGreen]; break;
-				case 'p': img = imgp[0x0F][iGreen]; break;
-			}
-			if (iInfo != 1)
-				{ snprintf (arText[0], MAX_TEXT, "N:%i", iHighNibble); }
-			iInfoC = 1;
-		}
-
-		if ((iLowNibble == 0x06) && (IsEven (iHighNibble))) /*** Drop. ***/
-		{
-			switch (cCurType)
-			{
-				case 'd': img = imgd[0x06][iGreen]; break;
-				case 'p': img = imgp[0x06][iGreen]; break;
-			}
-			if (iInfo != 1)
-				{ snprintf (arText[0], MAX_TEXT, "N:%i", iHighNibble); }
-			iInfoC = 1;
-		}
+		printf ("[FAILED] The BPS patch is for a different ROM!\n");
+		return (0);
 	}
-
-	/*** Custom tile. ***/
-	if ((iInfoC == 0) && (imgd[iTileValue][1] == NULL))
+	if (iTargetSize != stEdit.iROMSize)
 	{
-		snprintf (arText[0], MAX_TEXT, "0x%02X", iTileValue);
-		iInfoC = 1;
+		printf ("[FAILED] The BPS patch changes the ROM size!\n");
+		return (0);
 	}
 
-	if ((iNoAnim == 0) && (strcmp (sImageInfo, "tile=19") == 0))
+	iOut = 0;
+	iSourceOffset = 0;
+	iTargetOffset = 0;
+	while (iPos < iEnd)
 	{
-		switch (cCurType)
+		if (BPSReadNumber (sPatch, iEnd, &iPos, &iNumber) == 0)
 		{
-			case 'd': img = imgspriteflamed; break;
-			case 'p': img = imgspriteflamep; break;
+			printf ("[FAILED] The BPS patch is damaged!\n");
+			return (0);
 		}
+		iAction = iNumber & 3;
+		iLength = (iNumber >> 2) + 1;
+		if (iLength > iTargetSize - iOut)
+		{
+			printf ("[FAILED] The BPS patch writes past the ROM!\n");
+			return (0);
+		}
+		switch (iAction)
+		{
+			case 0: /*** SourceRead ***/
+				memcpy (&sTarget[iOut], &sSource[iOut], iLength);
+				break;
+			case 1: /*** TargetRead ***/
+				if (iLength > iEnd - iPos)
+				{
+					printf ("[FAILED] The BPS patch is damaged!\n");
+					return (0);
+				}
+				memcpy (&sTarget[iOut], &sPatch[iPos], iLength);
+				iPos+=iLength;
+				break;
+			default: /*** SourceCopy, TargetCopy ***/
+				if (BPSReadNumber (sPatch, iEnd, &iPos, &iNumber) == 0)
+				{
+					printf ("[FAILED] The BPS patch is damaged!\n");
+					return (0);
+				}
+				iRelative = iNumber >> 1;
+				if ((iNumber & 1) != 0) { iRelative = -iRelative; }
+				if (iAction == 2)
+				{
+					iSourceOffset+=iRelative;
+					if ((iSourceOffset < 0) || (iSourceOffset > iSourceSize - iLength))
+					{
+						printf ("[FAILED] The BPS patch reads past the ROM!\n");
+						return (0);
+					}
+					memcpy (&sTarget[iOut], &sSource[iSourceOffset], iLength);
+					iSourceOffset+=iLength;
+				} else {
+					iTargetOffset+=iRelative;
+					if ((iTargetOffset < 0) || (iTargetOffset >= iOut))
+					{
+						printf ("[FAILED] The BPS patch is damaged!\n");
+						return (0);
+					}
+					/*** May overlap; byte by byte on purpose. ***/
+					for (iByteLoop = 0; iByteLoop < iLength; iByteLoop++)
+					{
+						sTarget[iOut + iByteLoop] = sTarget[iTargetOffset + iByteLoop];
+					}
+					iTargetOffset+=iLength;
+				}
+				break;
+		}
+		iOut+=iLength;
 	}
-	SDL_QueryTexture (img, NULL, NULL, &iWidth, &iHeight);
-	loc.x = 0;
-	loc.y = 0;
-	loc.w = iWidth;
-	loc.h = iHeight;
-	dest.x = iX;
-	dest.y = iY;
-	dest.w = iWidth;
-	dest.h = iHeight;
-	if ((iNoAnim == 0) && (strcmp (sImageInfo, "tile=19") == 0))
-	{
-		loc.x = (iFlameFrame - 1) * 130;
-		loc.w = loc.w / 4;
-		dest.w = dest.w / 4;
-	}
-	CustomRenderCopy (img, &loc, &dest, sImageInfo);
 
-	/*** Info ("i"). ***/
-	if ((iTileValue != -1) && ((iInfo == 1) || (iInfoC == 1)))
+	if ((iOut != iTargetSize) ||
+		(CRC32 (sTarget, iTargetSize) != GetCRC32 (&sPatch[iPatchSize - 8])))
 	{
-		DisplayText (dest.x, dest.y + 162 - 12 - FONT_SIZE_11,
-			FONT_SIZE_11, arText, 1, font2);
+		printf ("[FAILED] The BPS patch did not produce the expected ROM!\n");
+		return (0);
 	}
+
+	return (1);
 }
 /*****************************************************************************/
-void CustomRenderCopy (SDL_Texture* src, SDL_Rect* srcrect,
-	SDL_Rect *dstrect, char *sImageInfo)
+int MatchLength (unsigned char *sA, unsigned char *sB, int iMax)
 /*****************************************************************************/
 {
-	SDL_Rect stuff;
+	int iLength;
 
-	stuff.x = dstrect->x * iScale;
-	stuff.y = dstrect->y * iScale;
-	if (srcrect != NULL) /*** image ***/
-	{
-		stuff.w = dstrect->w * iScale;
-		stuff.h = dstrect->h * iScale;
-	} else { /*** font ***/
-		stuff.w = dstrect->w;
-		stuff.h = dstrect->h;
-	}
-	if (SDL_RenderCopy (ascreen, src, srcrect, &stuff) != 0)
-	{
-		printf ("[ WARN ] SDL_RenderCopy (%s): %s!\n",
-			sImageInfo, SDL_GetError());
-	}
+	iLength = 0;
+	while ((iLength < iMax) && (sA[iLength] == sB[iLength])) { iLength++; }
+
+	return (iLength);
 }
 /*****************************************************************************/
-void CreateBAK (void)
+unsigned long CRC32 (unsigned char *sBytes, int iBytes)
 /*****************************************************************************/
 {
-	FILE *fDAT;
-	FILE *fBAK;
-	int iData;
-
-	fDAT = fopen (sPathFile, "rb");
-	if (fDAT == NULL)
-		{ printf ("[FAILED] Could not open %s: %s!\n",
-			sPathFile, strerror (errno)); }
+	unsigned long lCRC;
 
-	fBAK = fopen (BACKUP, "wb");
-	if (fBAK == NULL)
-		{ printf ("[FAILED] Could not open %s: %s!\n",
-			BACKUP, strerror (errno)); }
+	/*** Used for looping. ***/
+	int iByteLoop;
+	int iBitLoop;
 
-	while (1)
+	lCRC = 0xFFFFFFFF;
+	for (iByteLoop = 0; iByteLoop < iBytes; iByteLoop++)
 	{
-		iData = fgetc (fDAT);
-		if (iData == EOF) { break; }
-			else { putc (iData, fBAK); }
+		lCRC^=sBytes[iByteLoop];
+		for (iBitLoop = 0; iBitLoop < 8; iBitLoop++)
+		{
+			if ((lCRC & 1) != 0)
+			{
+				lCRC = (lCRC >> 1) ^ 0xEDB88320;
+			} else {
+				lCRC = lCRC >> 1;
+			}
+		}
 	}
 
-	fclose (fDAT);
-	fclose (fBAK);
+	return ((lCRC ^ 0xFFFFFFFF) & 0xFFFFFFFF);
+}
+/*****************************************************************************/
+int PutCRC32 (unsigned char *sOut, int iSize, unsigned long lCRC)
+/*****************************************************************************/
+{
+	/*** Little-endian. ***/
+	sOut[iSize++] = (lCRC >> 0) & 0xFF;
+	sOut[iSize++] = (lCRC >> 8) & 0xFF;
+	sOut[iSize++] = (lCRC >> 16) & 0xFF;
+	sOut[iSize++] = (lCRC >> 24) & 0xFF;
+
+	return (iSize);
+}
+/*****************************************************************************/
+unsigned long GetCRC32 (unsigned char *sIn)
+/*****************************************************************************/
+{
+	return ((unsigned long)sIn[0] | ((unsigned long)sIn[1] << 8) |
+		((unsigned long)sIn[2] << 16) | ((unsigned long)sIn[3] << 24));
 }
 /*****************************************************************************/
 void DisplayText (int iStartX, int iStartY, int iFontSize,
@@ -7176,9 +11867,8 @@ void DisplayText (int iStartX, int iStartY, int iFontSize,
 	{
 		if (strcmp (arText[iTemp], "") != 0)
 		{
-			message = TTF_RenderText_Shaded (font,
-				arText[iTemp], color_bl, color_wh);
-			messaget = SDL_CreateTextureFromSurface (ascreen, message);
+			messaget = TextTexture (font, arText[iTemp], color_bl, color_wh, 0,
+				&offset.w, &offset.h);
 			if ((strcmp (arText[iTemp], "single tile (change or select)") == 0) ||
 				(strcmp (arText[iTemp], "entire room (clear or fill)") == 0) ||
 				(strcmp (arText[iTemp], "entire level (randomize or fill)") == 0))
@@ -7188,9 +11878,7 @@ void DisplayText (int iStartX, int iStartY, int iFontSize,
 				offset.x = iStartX;
 			}
 			offset.y = iStartY + (iTemp * (iFontSize + 4));
-			offset.w = message->w; offset.h = message->h;
 			CustomRenderCopy (messaget, NULL, &offset, "message");
-			SDL_DestroyTexture (messaget); SDL_FreeSurface (message);
 		}
 	}
 }
@@ -7224,7 +11912,7 @@ void WhereToStart (void)
 	{
 		arDone[iRoomLoop] = 0;
 	}
-	CheckSides (arStartLocation[iCurLevel][1], 0, 0);
+	CheckSides (stEdit.stRom.arLevel[iCurLevel].arStartLocation[1], 0, 0);
 
 	iStartRoomsX = round (12 - (((float)iMinX + (float)iMaxX) / 2));
 	iStartRoomsY = round (12 - (((float)iMinY + (float)iMaxY) / 2));
@@ -7233,6 +11921,10 @@ void WhereToStart (void)
 void CheckSides (int iRoom, int iX, int iY)
 /*****************************************************************************/
 {
+	struct level *stLevel;
+
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
 	if (iX < iMinX) { iMinX = iX; }
 	if (iY < iMinY) { iMinY = iY; }
 	if (iX > iMaxX) { iMaxX = iX; }
@@ -7240,28 +11932,31 @@ void CheckSides (int iRoom, int iX, int iY)
 
 	arDone[iRoom] = 1;
 
-	if ((arRoomLinks[iCurLevel][iRoom][1] != 0) &&
-		(arDone[arRoomLinks[iCurLevel][iRoom][1]] != 1))
-		{ CheckSides (arRoomLinks[iCurLevel][iRoom][1], iX - 1, iY); }
+	if ((stLevel->arRoomLinks[iRoom][1] != 0) &&
+		(arDone[stLevel->arRoomLinks[iRoom][1]] != 1))
+		{ CheckSides (stLevel->arRoomLinks[iRoom][1], iX - 1, iY); }
 
-	if ((arRoomLinks[iCurLevel][iRoom][2] != 0) &&
-		(arDone[arRoomLinks[iCurLevel][iRoom][2]] != 1))
-		{ CheckSides (arRoomLinks[iCurLevel][iRoom][2], iX + 1, iY); }
+	if ((stLevel->arRoomLinks[iRoom][2] != 0) &&
+		(arDone[stLevel->arRoomLinks[iRoom][2]] != 1))
+		{ CheckSides (stLevel->arRoomLinks[iRoom][2], iX + 1, iY); }
 
-	if ((arRoomLinks[iCurLevel][iRoom][3] != 0) &&
-		(arDone[arRoomLinks[iCurLevel][iRoom][3]] != 1))
-		{ CheckSides (arRoomLinks[iCurLevel][iRoom][3], iX, iY - 1); }
+	if ((stLevel->arRoomLinks[iRoom][3] != 0) &&
+		(arDone[stLevel->arRoomLinks[iRoom][3]] != 1))
+		{ CheckSides (stLevel->arRoomLinks[iRoom][3], iX, iY - 1); }
 
-	if ((arRoomLinks[iCurLevel][iRoom][4] != 0) &&
-		(arDone[arRoomLinks[iCurLevel][iRoom][4]] != 1))
-		{ CheckSides (arRoomLinks[iCurLevel][iRoom][4], iX, iY + 1); }
+	if ((stLevel->arRoomLinks[iRoom][4] != 0) &&
+		(arDone[stLevel->arRoomLinks[iRoom][4]] != 1))
+		{ CheckSides (stLevel->arRoomLinks[iRoom][4], iX, iY + 1); }
 }
 /*****************************************************************************/
 void ShowRooms (int iRoom, int iX, int iY, int iNext)
 /*****************************************************************************/
 {
+	struct level *stLevel;
 	int iShowX, iShowY;
 
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
 	if (iX == 25) /*** side pane ***/
 	{
 		iShowX = 272;
@@ -7278,7 +11973,7 @@ void ShowRooms (int iRoom, int iX, int iY, int iNext)
 		{
 			ShowImage (imgsrc, iShowX, iShowY, "imgsrc"); /*** green stripes ***/
 		}
-		if (arStartLocation[iCurLevel][1] == iRoom)
+		if (stLevel->arStartLocation[1] == iRoom)
 		{
 			ShowImage (imgsrs, iShowX, iShowY, "imgsrs"); /*** blue border ***/
 		}
@@ -7305,21 +12000,21 @@ void ShowRooms (int iRoom, int iX, int iY, int iNext)
 
 	if (iNext == 1)
 	{
-		if ((arRoomLinks[iCurLevel][iRoom][1] != 0) &&
-			(arDone[arRoomLinks[iCurLevel][iRoom][1]] != 1))
-			{ ShowRooms (arRoomLinks[iCurLevel][iRoom][1], iX - 1, iY, 1); }
+		if ((stLevel->arRoomLinks[iRoom][1] != 0) &&
+			(arDone[stLevel->arRoomLinks[iRoom][1]] != 1))
+			{ ShowRooms (stLevel->arRoomLinks[iRoom][1], iX - 1, iY, 1); }
 
-		if ((arRoomLinks[iCurLevel][iRoom][2] != 0) &&
-			(arDone[arRoomLinks[iCurLevel][iRoom][2]] != 1))
-			{ ShowRooms (arRoomLinks[iCurLevel][iRoom][2], iX + 1, iY, 1); }
+		if ((stLevel->arRoomLinks[iRoom][2] != 0) &&
+			(arDone[stLevel->arRoomLinks[iRoom][2]] != 1))
+			{ ShowRooms (stLevel->arRoomLinks[iRoom][2], iX + 1, iY, 1); }
 
-		if ((arRoomLinks[iCurLevel][iRoom][3] != 0) &&
-			(arDone[arRoomLinks[iCurLevel][iRoom][3]] != 1))
-			{ ShowRooms (arRoomLinks[iCurLevel][iRoom][3], iX, iY - 1, 1); }
+		if ((stLevel->arRoomLinks[iRoom][3] != 0) &&
+			(arDone[stLevel->arRoomLinks[iRoom][3]] != 1))
+			{ ShowRooms (stLevel->arRoomLinks[iRoom][3], iX, iY - 1, 1); }
 
-		if ((arRoomLinks[iCurLevel][iRoom][4] != 0) &&
-			(arDone[arRoomLinks[iCurLevel][iRoom][4]] != 1))
-			{ ShowRooms (arRoomLinks[iCurLevel][iRoom][4], iX, iY + 1, 1); }
+		if ((stLevel->arRoomLinks[iRoom][4] != 0) &&
+			(arDone[stLevel->arRoomLinks[iRoom][4]] != 1))
+			{ ShowRooms (stLevel->arRoomLinks[iRoom][4], iX, iY + 1, 1); }
 	}
 }
 /*****************************************************************************/
@@ -7382,10 +12077,14 @@ void BrokenRoomChange (int iRoom, int iSide, int *iX, int *iY)
 void ShowChange (void)
 /*****************************************************************************/
 {
+	struct level *stLevel;
 	int iX, iY;
 	int iOldTile;
 	int iHighNibble, iLowNibble;
 
+	ProfilePhase (PHASE_CHANGE);
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
 	/*** background ***/
 	switch (cCurType)
 	{
@@ -7405,7 +12104,7 @@ void ShowChange (void)
 	DisableSome();
 
 	/*** old tile ***/
-	iOldTile = arRoomTiles[iCurLevel][iCurRoom][iSelected];
+	iOldTile = stLevel->arRoomTiles[iCurRoom][iSelected];
 	iHighNibble = iOldTile >> 4;
 	iLowNibble = iOldTile & 0x0F; /*** 0F = 00001111 ***/
 	if ((iLowNibble == 0x0F) && (IsEven (iHighNibble))) /*** Raise. ***/
@@ -7494,10 +12193,10 @@ void ShowChange (void)
 	}
 
 	/*** prince ***/
-	if ((iCurRoom == arStartLocation[iCurLevel][1]) &&
-		(iSelected == arStartLocation[iCurLevel][2]))
+	if ((iCurRoom == stLevel->arStartLocation[1]) &&
+		(iSelected == stLevel->arStartLocation[2]))
 	{
-		switch (arStartLocation[iCurLevel][3])
+		switch (stLevel->arStartLocation[3])
 		{
 			case 0x00: /*** r ***/
 				ShowImage (imgbordersl, 2, 488, "imgbordersl"); break;
@@ -7507,10 +12206,10 @@ void ShowChange (void)
 	}
 
 	/*** guard ***/
-	if (iSelected == arGuardTile[iCurLevel][iCurRoom])
+	if (iSelected == stLevel->arGuardTile[iCurRoom])
 	{
 		iY = 488;
-		switch (arGuardDir[iCurLevel][iCurRoom])
+		switch (stLevel->arGuardDir[iCurRoom])
 		{
 			case 0x00: /*** r ***/
 				if (iCurLevel == 3)
@@ -7580,7 +12279,7 @@ void ShowChange (void)
 		{ ShowImage (imgchover, 395, 491, "imgchover"); }
 
 	/*** refresh screen ***/
-	SDL_RenderPresent (ascreen);
+	Present();
 }
 /*****************************************************************************/
 int OnTile (void)
@@ -7774,12 +12473,8 @@ void CenterNumber (int iNumber, int iX, int iY,
 	} else {
 		snprintf (sText, MAX_TEXT, "%02X", iNumber);
 	}
-	/* The 100000 is a workaround for 0 being broken. SDL devs have fixed that
-	 * see e.g. https://hg.libsdl.org/SDL_ttf/rev/72b8861dbc01 but
-	 * Ubuntu et al. still ship an sdl-ttf that is >10 years(!) old.
-	 */
-	message = TTF_RenderText_Blended_Wrapped (font3, sText, fore, 100000);
-	messaget = SDL_CreateTextureFromSurface (ascreen, message);
+	messaget = TextTexture (font3, sText, fore, fore, 1,
+		&offset.w, &offset.h);
 	if (iHex == 0)
 	{
 		if ((iNumber >= -9) && (iNumber <= -1))
@@ -7796,9 +12491,111 @@ void CenterNumber (int iNumber, int iX, int iY,
 		offset.x = iX + 14;
 	}
 	offset.y = iY - 1;
-	offset.w = message->w; offset.h = message->h;
 	CustomRenderCopy (messaget, NULL, &offset, "message");
-	SDL_DestroyTexture (messaget); SDL_FreeSurface (message);
+}
+/*****************************************************************************/
+SDL_Texture *TextTexture (TTF_Font *font, char *sText, SDL_Color fore,
+	SDL_Color back, int iBlended, int *iWidth, int *iHeight)
+/*****************************************************************************/
+{
+	Uint32 iFore, iBack;
+	unsigned long long llHash;
+	struct text *stText;
+	SDL_Surface *message;
+
+	/*** Used for looping. ***/
+	int iTextLoop;
+
+	iFore = (fore.r << 24) | (fore.g << 16) | (fore.b << 8) | fore.a;
+	iBack = (back.r << 24) | (back.g << 16) | (back.b << 8) | back.a;
+	llHash = HashBytes ((unsigned char *)sText, strlen (sText));
+
+	/*** Look for the rendered text; otherwise replace the oldest. ***/
+	stText = &arTexts[1];
+	for (iTextLoop = 1; iTextLoop <= TEXT_CACHE; iTextLoop++)
+	{
+		if ((arTexts[iTextLoop].font == font) &&
+			(arTexts[iTextLoop].llHash == llHash) &&
+			(arTexts[iTextLoop].iBlended == iBlended) &&
+			(arTexts[iTextLoop].iFore == iFore) &&
+			(arTexts[iTextLoop].iBack == iBack) &&
+			(strcmp (arTexts[iTextLoop].sText, sText) == 0))
+		{
+			stText = &arTexts[iTextLoop];
+			break;
+		}
+		if (arTexts[iTextLoop].iUsed < stText->iUsed)
+			{ stText = &arTexts[iTextLoop]; }
+	}
+
+	if (iTextLoop > TEXT_CACHE)
+	{
+		if (stText->img != NULL)
+		{
+			FlushDraws(); /*** A waiting copy may use this texture. ***/
+			SDL_DestroyTexture (stText->img);
+		}
+		if (iBlended == 1)
+		{
+			/* The 100000 is a workaround for 0 being broken. SDL devs have fixed
+			 * that see e.g. https://hg.libsdl.org/SDL_ttf/rev/72b8861dbc01 but
+			 * Ubuntu et al. still ship an sdl-ttf that is >10 years(!) old.
+			 */
+			message = TTF_RenderText_Blended_Wrapped (font, sText, fore, 100000);
+		} else {
+			message = TTF_RenderText_Shaded (font, sText, fore, back);
+		}
+		stFrame.iRenders++;
+		if (message == NULL)
+		{
+			printf ("[FAILED] Could not render \"%s\": %s!\n",
+				sText, TTF_GetError());
+			exit (EXIT_ERROR);
+		}
+		stText->img = SDL_CreateTextureFromSurface (ascreen, message);
+		stFrame.iCreates++;
+		if (stText->img == NULL)
+		{
+			printf ("[FAILED] SDL_CreateTextureFromSurface: %s!\n",
+				SDL_GetError());
+			exit (EXIT_ERROR);
+		}
+		stText->font = font;
+		stText->iBlended = iBlended;
+		stText->iFore = iFore;
+		stText->iBack = iBack;
+		stText->llHash = llHash;
+		snprintf (stText->sText, MAX_TEXT, "%s", sText);
+		stText->iWidth = message->w;
+		stText->iHeight = message->h;
+		SDL_FreeSurface (message);
+	}
+
+	iTextClock++;
+	stText->iUsed = iTextClock;
+	*iWidth = stText->iWidth;
+	*iHeight = stText->iHeight;
+
+	return (stText->img);
+}
+/*****************************************************************************/
+void DropTexts (void)
+/*****************************************************************************/
+{
+	/*** Used for looping. ***/
+	int iTextLoop;
+
+	FlushDraws();
+	for (iTextLoop = 1; iTextLoop <= TEXT_CACHE; iTextLoop++)
+	{
+		if (arTexts[iTextLoop].img != NULL)
+		{
+			SDL_DestroyTexture (arTexts[iTextLoop].img);
+			arTexts[iTextLoop].img = NULL;
+		}
+		arTexts[iTextLoop].font = NULL;
+		arTexts[iTextLoop].iUsed = 0;
+	}
 }
 /*****************************************************************************/
 int Unused (int iTile)
@@ -7855,52 +12652,28 @@ if (pid == 0)
 void EXELoad (void)
 /*****************************************************************************/
 {
-	int iFdEXE;
-	unsigned char sRead[2 + 2];
-	char sReadW[10 + 2];
 	int iSlideNr, iSlideLine, iSlideChar;
 
 	/*** Used for looping. ***/
 	int iSlidesLoop;
 	int iSlideLoop, iLineLoop, iCharLoop;
 
-	iFdEXE = open (sPathFile, O_RDONLY|O_BINARY);
-	if (iFdEXE == -1)
-	{
-		printf ("[FAILED] Error opening %s: %s!\n",
-			sPathFile, strerror (errno));
-		exit (EXIT_ERROR);
-	}
-
 	/*** Starting minutes left. ***/
-	lseek (iFdEXE, 0x191, SEEK_SET);
-	read (iFdEXE, sRead, 1);
-	iEXEMinutesLeft = sRead[0];
+	iEXEMinutesLeft = ROMByte (0x191);
 
 	/*** Starting hit points. ***/
-	lseek (iFdEXE, 0x80D, SEEK_SET);
-	read (iFdEXE, sRead, 1);
-	iEXEHitPoints = sRead[0];
+	iEXEHitPoints = ROMByte (0x80D);
 
 	/*** Hair. ***/
-	lseek (iFdEXE, 0xB1A2, SEEK_SET);
-	read (iFdEXE, sRead, 2);
-	snprintf (sReadW, 10, "%02x%02x", sRead[1], sRead[0]);
-	iEXEHair = strtoul (sReadW, NULL, 16);
+	iEXEHair = ROMWord (0xB1A2);
 	ToFiveBitRGB (iEXEHair, &iEXEHairR, &iEXEHairG, &iEXEHairB);
 
 	/*** Skin. ***/
-	lseek (iFdEXE, 0xB1A4, SEEK_SET);
-	read (iFdEXE, sRead, 2);
-	snprintf (sReadW, 10, "%02x%02x", sRead[1], sRead[0]);
-	iEXESkin = strtoul (sReadW, NULL, 16);
+	iEXESkin = ROMWord (0xB1A4);
 	ToFiveBitRGB (iEXESkin, &iEXESkinR, &iEXESkinG, &iEXESkinB);
 
 	/*** Suit. ***/
-	lseek (iFdEXE, 0xB1A6, SEEK_SET);
-	read (iFdEXE, sRead, 2);
-	snprintf (sReadW, 10, "%02x%02x", sRead[1], sRead[0]);
-	iEXESuit = strtoul (sReadW, NULL, 16);
+	iEXESuit = ROMWord (0xB1A6);
 	ToFiveBitRGB (iEXESuit, &iEXESuitR, &iEXESuitG, &iEXESuitB);
 
 	/*** Intro slides. ***/
@@ -7914,8 +12687,8 @@ void EXELoad (void)
 			}
 		}
 	}
-	lseek (iFdEXE, SLIDES_OFFSET, SEEK_SET);
-	read (iFdEXE, sIntroSlides, SLIDES_BYTES);
+	ROMByte (SLIDES_OFFSET + SLIDES_BYTES - 1); /*** Checks the offset. ***/
+	memcpy (sIntroSlides, &stEdit.sROM[SLIDES_OFFSET], SLIDES_BYTES);
 	iSlideNr = 1;
 	iSlideLine = 1;
 	iSlideChar = 0;
@@ -7962,96 +12735,57 @@ void EXELoad (void)
 		}
 	}
 	IntroSlides();
-
-	close (iFdEXE);
 }
 /*****************************************************************************/
-void EXESave (void)
+int EXESave (void)
 /*****************************************************************************/
 {
-	int iFdEXE;
-	char sToWrite[MAX_TOWRITE + 2];
-
 	/*** Used for looping. ***/
 	int iNrFFLoop;
 
-	iFdEXE = open (sPathFile, O_RDWR|O_BINARY);
-	if (iFdEXE == -1)
-	{
-		printf ("[FAILED] Error opening %s: %s!\n",
-			sPathFile, strerror (errno));
-		exit (EXIT_ERROR);
-	}
+	if (iReplay != 0) { return (1); } /*** A replay leaves the ROM alone. ***/
+
+	/*** Never save the changes for Mednafen. ***/
+	if (iModified == 1) { ModifyBack(); }
 
 	/*** Starting minutes left. ***/
-	lseek (iFdEXE, 0x191, SEEK_SET);
-	snprintf (sToWrite, MAX_TOWRITE, "%c", iEXEMinutesLeft);
-	write (iFdEXE, sToWrite, 1);
+	ROMSetByte (0x191, iEXEMinutesLeft);
 
 	/*** Starting hit points. ***/
-	lseek (iFdEXE, 0x80D, SEEK_SET);
-	snprintf (sToWrite, MAX_TOWRITE, "%c", iEXEHitPoints);
-	write (iFdEXE, sToWrite, 1);
+	ROMSetByte (0x80D, iEXEHitPoints);
 
 	/*** Hair. ***/
-	lseek (iFdEXE, 0xB1A2, SEEK_SET); /*** 1,2,3,4,8,9,12a,12b,v,t1,t2 ***/
 	iEXEHair = iEXEHairB << 10;
 	iEXEHair += iEXEHairG << 5;
 	iEXEHair += iEXEHairR;
-	sToWrite[0] = (iEXEHair >> 0) & 0xFF;
-	sToWrite[1] = (iEXEHair >> 8) & 0xFF;
-	write (iFdEXE, sToWrite, 2);
-	/***/
-	lseek (iFdEXE, 0xB1E2, SEEK_SET); /*** 6,7 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB222, SEEK_SET); /*** 5 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB262, SEEK_SET); /*** 10 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB2A2, SEEK_SET); /*** 11 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB2E2, SEEK_SET); /*** 12c ***/
-	write (iFdEXE, sToWrite, 2);
+	ROMSetWord (0xB1A2, iEXEHair); /*** 1,2,3,4,8,9,12a,12b,v,t1,t2 ***/
+	ROMSetWord (0xB1E2, iEXEHair); /*** 6,7 ***/
+	ROMSetWord (0xB222, iEXEHair); /*** 5 ***/
+	ROMSetWord (0xB262, iEXEHair); /*** 10 ***/
+	ROMSetWord (0xB2A2, iEXEHair); /*** 11 ***/
+	ROMSetWord (0xB2E2, iEXEHair); /*** 12c ***/
 
 	/*** Skin. ***/
-	lseek (iFdEXE, 0xB1A4, SEEK_SET);
 	iEXESkin = iEXESkinB << 10;
 	iEXESkin += iEXESkinG << 5;
 	iEXESkin += iEXESkinR;
-	sToWrite[0] = (iEXESkin >> 0) & 0xFF;
-	sToWrite[1] = (iEXESkin >> 8) & 0xFF;
-	write (iFdEXE, sToWrite, 2);
-	/***/
-	lseek (iFdEXE, 0xB1E4, SEEK_SET); /*** 6,7 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB224, SEEK_SET); /*** 5 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB264, SEEK_SET); /*** 10 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB2A4, SEEK_SET); /*** 11 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB2E4, SEEK_SET); /*** 12c ***/
-	write (iFdEXE, sToWrite, 2);
+	ROMSetWord (0xB1A4, iEXESkin);
+	ROMSetWord (0xB1E4, iEXESkin); /*** 6,7 ***/
+	ROMSetWord (0xB224, iEXESkin); /*** 5 ***/
+	ROMSetWord (0xB264, iEXESkin); /*** 10 ***/
+	ROMSetWord (0xB2A4, iEXESkin); /*** 11 ***/
+	ROMSetWord (0xB2E4, iEXESkin); /*** 12c ***/
 
 	/*** Suit. ***/
-	lseek (iFdEXE, 0xB1A6, SEEK_SET);
 	iEXESuit = iEXESuitB << 10;
 	iEXESuit += iEXESuitG << 5;
 	iEXESuit += iEXESuitR;
-	sToWrite[0] = (iEXESuit >> 0) & 0xFF;
-	sToWrite[1] = (iEXESuit >> 8) & 0xFF;
-	write (iFdEXE, sToWrite, 2);
-	/***/
-	lseek (iFdEXE, 0xB1E6, SEEK_SET); /*** 6,7 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB226, SEEK_SET); /*** 5 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB266, SEEK_SET); /*** 10 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB2A6, SEEK_SET); /*** 11 ***/
-	write (iFdEXE, sToWrite, 2);
-	lseek (iFdEXE, 0xB2E6, SEEK_SET); /*** 12c ***/
-	write (iFdEXE, sToWrite, 2);
+	ROMSetWord (0xB1A6, iEXESuit);
+	ROMSetWord (0xB1E6, iEXESuit); /*** 6,7 ***/
+	ROMSetWord (0xB226, iEXESuit); /*** 5 ***/
+	ROMSetWord (0xB266, iEXESuit); /*** 10 ***/
+	ROMSetWord (0xB2A6, iEXESuit); /*** 11 ***/
+	ROMSetWord (0xB2E6, iEXESuit); /*** 12c ***/
 
 	/*** Intro slides. ***/
 	IntroSlides();
@@ -8061,17 +12795,19 @@ void EXESave (void)
 			(arSlideSizes[3] == 37) && (arSlideSizes[4] == 31) &&
 			(arSlideSizes[5] == 29))
 		{
-			lseek (iFdEXE, SLIDES_OFFSET, SEEK_SET);
-			write (iFdEXE, sIntroSlides, strlen ((char *)sIntroSlides));
+			ROMSetBytes (SLIDES_OFFSET, sIntroSlides,
+				strlen ((char *)sIntroSlides));
 
 			/* Fill the rest with 0xFF. Currently, this never happens because of
 			 * the if-check above.
 			 */
 			if (iBytesLeft > 0)
 			{
-				snprintf (sToWrite, MAX_TOWRITE, "%c", 0xFF);
 				for (iNrFFLoop = 1; iNrFFLoop <= iBytesLeft; iNrFFLoop++)
-					{ write (iFdEXE, sToWrite, 1); }
+				{
+					ROMSetByte (SLIDES_OFFSET + strlen ((char *)sIntroSlides)
+						+ iNrFFLoop - 1, 0xFF);
+				}
 			}
 		} else {
 			printf ("[ WARN ] One or more incorrect slide sizes!\n");
@@ -8080,9 +12816,17 @@ void EXESave (void)
 		printf ("[ WARN ] Not enough free bytes!\n");
 	}
 
-	close (iFdEXE);
+	if (ROMFlush() == 0)
+	{
+		printf ("[FAILED] Could not save the EXE changes!\n");
+		SDL_ShowSimpleMessageBox (SDL_MESSAGEBOX_ERROR, "Error",
+			"Could not save the changes. See the console for details.", window);
+		return (0);
+	}
 
 	PlaySound ("wav/save.wav");
+
+	return (1);
 }
 /*****************************************************************************/
 int PlusMinus (int *iWhat, int iX, int iY,
@@ -8112,6 +12856,7 @@ void ColorRect (int iX, int iY, int iW, int iH, int iR, int iG, int iB)
 	rect.w = iW * iScale;
 	rect.h = iH * iScale;
 	SDL_SetRenderDrawColor (ascreen, iR, iG, iB, SDL_ALPHA_OPAQUE);
+	FlushDraws();
 	SDL_RenderFillRect (ascreen, &rect);
 }
 /*****************************************************************************/
@@ -8135,25 +12880,30 @@ void ToFiveBitRGB (int iIn, int *iR, int *iG, int *iB)
 void TotalEvents (int iAmount)
 /*****************************************************************************/
 {
-	if (((iAmount > 0) && (arNrEvents[iCurLevel] != 255)) ||
-		((iAmount < 0) && (arNrEvents[iCurLevel] != 0)))
+	struct level *stLevel;
+
+	stLevel = &stEdit.stRom.arLevel[iCurLevel];
+
+	if (((iAmount > 0) && (stLevel->iNrEvents != 255)) ||
+		((iAmount < 0) && (stLevel->iNrEvents != 0)))
 	{
 		/*** Modify the event number. ***/
-		arNrEvents[iCurLevel]+=iAmount;
-		if (arNrEvents[iCurLevel] < 0) { arNrEvents[iCurLevel] = 0; }
-		if (arNrEvents[iCurLevel] > 255) { arNrEvents[iCurLevel] = 255; }
+		stLevel->iNrEvents+=iAmount;
+		if (stLevel->iNrEvents < 0) { stLevel->iNrEvents = 0; }
+		if (stLevel->iNrEvents > 255) { stLevel->iNrEvents = 255; }
 
 		/*** If necessary, modify iChangeEvent. ***/
-		if ((iChangeEvent == 0) && (arNrEvents[iCurLevel] != 0))
+		if ((iChangeEvent == 0) && (stLevel->iNrEvents != 0))
 		{
 			iChangeEvent = 1;
 		}
-		if (iChangeEvent > arNrEvents[iCurLevel])
+		if (iChangeEvent > stLevel->iNrEvents)
 		{
-			iChangeEvent = arNrEvents[iCurLevel];
+			iChangeEvent = stLevel->iNrEvents;
 		}
 
 		PlaySound ("wav/plus_minus.wav");
+		stEdit.arLevelDirty[iCurLevel] = 1;
 		iChanged++;
 	}
 }
@@ -8343,22 +13093,11 @@ void IntroSlides (void)
 	iBytesLeft = SLIDES_BYTES - iSize;
 }
 /*****************************************************************************/
-void ModifyForMednafen (int iLevel)
+int ModifyForMednafen (int iLevel)
 /*****************************************************************************/
 {
-	int iFd;
-	char sToWrite[MAX_TOWRITE + 2];
 	int iToLevel;
 
-	/*** Open file. ***/
-	iFd = open (sPathFile, O_RDWR|O_BINARY, 0600);
-	if (iFd == -1)
-	{
-		printf ("[FAILED] Error opening %s: %s!\n",
-			sPathFile, strerror (errno));
-		exit (EXIT_ERROR);
-	}
-
 	/*** Make training the active in-editor level. ***/
 	switch (iLevel)
 	{
@@ -8367,57 +13106,48 @@ void ModifyForMednafen (int iLevel)
 		case 17: iToLevel = 17; break; /*** Does not work. ***/
 		default: iToLevel = iLevel - 1; break;
 	}
-	lseek (iFd, OFFSET_TRAINING, SEEK_SET);
-	snprintf (sToWrite, MAX_TOWRITE, "%c", iToLevel);
-	write (iFd, sToWrite, 1);
+	ROMSetByte (OFFSET_TRAINING, iToLevel);
 
 	/*** Start training. ***/
-	lseek (iFd, OFFSET_START, SEEK_SET);
-	snprintf (sToWrite, MAX_TOWRITE, "%c%c%c", 0xC3, 0x63, 0x06);
-	write (iFd, sToWrite, 3);
+	ROMSetByte (OFFSET_START, 0xC3);
+	ROMSetByte (OFFSET_START + 1, 0x63);
+	ROMSetByte (OFFSET_START + 2, 0x06);
 
 	/*** Skip Red Orb screen. ***/
-	lseek (iFd, OFFSET_REDORB, SEEK_SET);
-	snprintf (sToWrite, MAX_TOWRITE, "%c%c", 0x18, 0x19);
-	write (iFd, sToWrite, 2);
-
-	close (iFd);
+	ROMSetByte (OFFSET_REDORB, 0x18);
+	ROMSetByte (OFFSET_REDORB + 1, 0x19);
 
 	iModified = 1;
+
+	if (ROMFlush() == 0)
+	{
+		ModifyBack();
+		SDL_ShowSimpleMessageBox (SDL_MESSAGEBOX_ERROR, "Error",
+			"Could not prepare the ROM for Mednafen. See the console for"
+			" details.", window);
+		return (0);
+	}
+
+	return (1);
 }
 /*****************************************************************************/
 void ModifyBack (void)
 /*****************************************************************************/
 {
-	int iFd;
-	char sToWrite[MAX_TOWRITE + 2];
-
-	/*** Open file. ***/
-	iFd = open (sPathFile, O_RDWR|O_BINARY, 0600);
-	if (iFd == -1)
-	{
-		printf ("[FAILED] Error opening %s: %s!\n",
-			sPathFile, strerror (errno));
-		exit (EXIT_ERROR);
-	}
-
 	/*** [Undo] Make training the active in-editor level. ***/
-	lseek (iFd, OFFSET_TRAINING, SEEK_SET);
-	snprintf (sToWrite, MAX_TOWRITE, "%c", 0x10);
-	write (iFd, sToWrite, 1);
+	ROMSetByte (OFFSET_TRAINING, 0x10);
 
 	/*** [Undo] Start training. ***/
-	lseek (iFd, OFFSET_START, SEEK_SET);
-	snprintf (sToWrite, MAX_TOWRITE, "%c%c%c", 0xCD, 0x5F, 0x20);
-	write (iFd, sToWrite, 3);
+	ROMSetByte (OFFSET_START, 0xCD);
+	ROMSetByte (OFFSET_START + 1, 0x5F);
+	ROMSetByte (OFFSET_START + 2, 0x20);
 
 	/*** [Undo] Skip Red Orb screen. ***/
-	lseek (iFd, OFFSET_REDORB, SEEK_SET);
-	snprintf (sToWrite, MAX_TOWRITE, "%c%c", 0x38, 0xF7);
-	write (iFd, sToWrite, 2);
-
-	close (iFd);
+	ROMSetByte (OFFSET_REDORB, 0x38);
+	ROMSetByte (OFFSET_REDORB + 1, 0xF7);
 
+	/*** If this fails, the next save writes the restored image. ***/
 	iModified = 0;
+	ROMFlush();
 }
 /*****************************************************************************/